@@ -4,4 +4,6 @@
 #define PACKAGE "${PROJECT_NAME}"
 #define VERSION "${PROJECT_VERSION}"
 
+#cmakedefine HAVE_SYS_EPOLL_H 1
+
 #endif
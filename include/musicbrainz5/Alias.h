@@ -43,17 +43,21 @@ namespace MusicBrainz5
 		CAlias(const XMLNode& Node);
 		CAlias(const CAlias& Other);
 		CAlias& operator =(const CAlias& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CAlias(CAlias&& Other);
+		CAlias& operator =(CAlias&& Other);
+#endif
 		virtual ~CAlias();
 
 		virtual CAlias *Clone();
 
-		std::string Locale() const;
-		std::string Text() const;
-		std::string SortName() const;
-		std::string Type() const;
-		std::string Primary() const;
-		std::string BeginDate() const;
-		std::string EndDate() const;
+		const std::string& Locale() const;
+		const std::string& Text() const;
+		const std::string& SortName() const;
+		const std::string& Type() const;
+		const std::string& Primary() const;
+		const std::string& BeginDate() const;
+		const std::string& EndDate() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -63,7 +67,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAliasPrivate * const m_d;
+		CAliasPrivate *m_d;
 	};
 }
 
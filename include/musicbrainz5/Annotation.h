@@ -43,14 +43,18 @@ namespace MusicBrainz5
 		CAnnotation(const XMLNode& Node);
 		CAnnotation(const CAnnotation& Other);
 		CAnnotation& operator =(const CAnnotation& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CAnnotation(CAnnotation&& Other);
+		CAnnotation& operator =(CAnnotation&& Other);
+#endif
 		virtual ~CAnnotation();
 
 		virtual CAnnotation *Clone();
 
-		std::string Type() const;
-		std::string Entity() const;
-		std::string Name() const;
-		std::string Text() const;
+		const std::string& Type() const;
+		const std::string& Entity() const;
+		const std::string& Name() const;
+		const std::string& Text() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -60,7 +64,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAnnotationPrivate * const m_d;
+		CAnnotationPrivate *m_d;
 	};
 }
 
@@ -30,6 +30,7 @@
 #include <iostream>
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/IPIList.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/AliasList.h"
@@ -56,30 +57,48 @@ namespace MusicBrainz5
 		CArtist(const XMLNode& Node=XMLNode::emptyNode());
 		CArtist(const CArtist& Other);
 		CArtist& operator =(const CArtist& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CArtist(CArtist&& Other);
+		CArtist& operator =(CArtist&& Other);
+#endif
 		virtual ~CArtist();
 
 		virtual CArtist *Clone();
 
-		std::string ID() const;
-		std::string Type() const;
-		std::string Name() const;
-		std::string SortName() const;
-		std::string Gender() const;
-		std::string Country() const;
-		std::string Disambiguation() const;
-		CIPIList *IPIList() const;
-		CLifespan *Lifespan() const;
-		CAliasList *AliasList() const;
-		CRecordingList *RecordingList() const;
-		CReleaseList *ReleaseList() const;
-		CReleaseGroupList *ReleaseGroupList() const;
-		CLabelList *LabelList() const;
-		CWorkList *WorkList() const;
-		CRelationListList *RelationListList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Type() const;
+		const std::string& Name() const;
+		const std::string& SortName() const;
+		const std::string& Gender() const;
+		const std::string& Country() const;
+		const std::string& Disambiguation() const;
+		const CIPIList *IPIList() const;
+		CIPIList *IPIList();
+		const CLifespan *Lifespan() const;
+		CLifespan *Lifespan();
+		const CAliasList *AliasList() const;
+		CAliasList *AliasList();
+		const CRecordingList *RecordingList() const;
+		CRecordingList *RecordingList();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
+		const CReleaseGroupList *ReleaseGroupList() const;
+		CReleaseGroupList *ReleaseGroupList();
+		const CLabelList *LabelList() const;
+		CLabelList *LabelList();
+		const CWorkList *WorkList() const;
+		CWorkList *WorkList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -89,9 +108,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CArtistPrivate * const m_d;
+		CArtistPrivate *m_d;
 	};
 }
 
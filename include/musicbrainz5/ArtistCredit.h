@@ -43,11 +43,16 @@ namespace MusicBrainz5
 		CArtistCredit(const XMLNode& Node=XMLNode::emptyNode());
 		CArtistCredit(const CArtistCredit& Other);
 		CArtistCredit& operator =(const CArtistCredit& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CArtistCredit(CArtistCredit&& Other);
+		CArtistCredit& operator =(CArtistCredit&& Other);
+#endif
 		virtual ~CArtistCredit();
 
 		virtual CArtistCredit *Clone();
 
-		CNameCreditList *NameCreditList() const;
+		const CNameCreditList *NameCreditList() const;
+		CNameCreditList *NameCreditList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,9 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CArtistCreditPrivate * const m_d;
+		CArtistCreditPrivate *m_d;
 	};
 }
 
@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CAttribute(const XMLNode& Node=XMLNode::emptyNode());
 		CAttribute(const CAttribute& Other);
 		CAttribute& operator =(const CAttribute& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CAttribute(CAttribute&& Other);
+		CAttribute& operator =(CAttribute&& Other);
+#endif
 		virtual ~CAttribute();
 
 		virtual CAttribute *Clone();
 
-		std::string Text() const;
+		const std::string& Text() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,7 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CAttributePrivate * const m_d;
+		CAttributePrivate *m_d;
 	};
 }
 
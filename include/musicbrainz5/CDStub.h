@@ -44,16 +44,21 @@ namespace MusicBrainz5
 		CCDStub(const XMLNode& Node);
 		CCDStub(const CCDStub& Other);
 		CCDStub& operator =(const CCDStub& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CCDStub(CCDStub&& Other);
+		CCDStub& operator =(CCDStub&& Other);
+#endif
 		virtual ~CCDStub();
 
 		virtual CCDStub *Clone();
 
-		std::string ID() const;
-		std::string Title() const;
-		std::string Artist() const;
-		std::string Barcode() const;
-		std::string Comment() const;
-		CNonMBTrackList *NonMBTrackList() const;
+		const std::string& ID() const;
+		const std::string& Title() const;
+		const std::string& Artist() const;
+		const std::string& Barcode() const;
+		const std::string& Comment() const;
+		const CNonMBTrackList *NonMBTrackList() const;
+		CNonMBTrackList *NonMBTrackList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -63,9 +68,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CCDStubPrivate * const m_d;
+		CCDStubPrivate *m_d;
 	};
 }
 
@@ -27,6 +27,7 @@
 #define _MUSICBRAINZ5_COLLECTION_H
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/ReleaseList.h"
 
 #include "musicbrainz5/xmlParser.h"
@@ -41,14 +42,20 @@ namespace MusicBrainz5
 		CCollection(const XMLNode& Node);
 		CCollection(const CCollection& Other);
 		CCollection& operator =(const CCollection& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CCollection(CCollection&& Other);
+		CCollection& operator =(CCollection&& Other);
+#endif
 		virtual ~CCollection();
 
 		virtual CCollection *Clone();
 
-		std::string ID() const;
-		std::string Name() const;
-		std::string Editor() const;
-		CReleaseList *ReleaseList() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Name() const;
+		const std::string& Editor() const;
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -58,9 +65,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CCollectionPrivate * const m_d;
+		CCollectionPrivate *m_d;
 	};
 }
 
@@ -47,14 +47,20 @@ namespace MusicBrainz5
 		CDisc(const XMLNode& Node=XMLNode::emptyNode());
 		CDisc(const CDisc& Other);
 		CDisc& operator =(const CDisc& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CDisc(CDisc&& Other);
+		CDisc& operator =(CDisc&& Other);
+#endif
 		virtual ~CDisc();
 
 		virtual CDisc *Clone();
 
-		std::string ID() const;
+		const std::string& ID() const;
 		int Sectors() const;
-		COffsetList *OffsetList() const;
-		CReleaseList *ReleaseList() const;
+		const COffsetList *OffsetList() const;
+		COffsetList *OffsetList();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -64,9 +70,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CDiscPrivate * const m_d;
+		CDiscPrivate *m_d;
 	};
 }
 
@@ -0,0 +1,319 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_DISK_CACHE_H
+#define _MUSICBRAINZ5_DISK_CACHE_H
+
+#include <string>
+
+namespace MusicBrainz5
+{
+	class CDiskCachePrivate;
+
+	/**
+	 * @brief Persistent cache of query responses
+	 *
+	 * Keeps the bodies of responses in a directory, so that they survive between runs
+	 * of a program. Bodies are compressed and appended to segment files, and a memory
+	 * mapped hash index locates the newest body stored for each key. Each record also
+	 * holds its key, which is compared before the record is used, so two keys with
+	 * the same hash are never confused.
+	 *
+	 * Each record in a segment carries a checksum, which is verified before it is
+	 * returned, so a record left incomplete by a crash is never used. If the index
+	 * itself can't be trusted it is rebuilt from the segments when the cache is opened.
+	 *
+	 * Responses are not flushed to disk as they are stored, so nothing is lost if the
+	 * program crashes, but responses stored shortly before an operating system crash
+	 * or power failure may be. The segments and the index are flushed whenever the
+	 * index is rewritten, so compaction can't lose responses that were already safe.
+	 *
+	 * When the segments grow larger than the maximum size, the oldest segment is
+	 * discarded along with the responses in it. Once more than half of the space used
+	 * is taken by responses that have been replaced, the live responses are copied to
+	 * new segments and the old ones removed (see Compact).
+	 *
+	 * The ETag and Last-Modified headers of each response are stored with it, so that
+	 * an expired response can be revalidated with a conditional request.
+	 *
+	 * Requests for entities that don't exist can be recorded with PutNotFound. A Bloom
+	 * filter of these requests is kept in the directory alongside the responses, so
+	 * that NotFound can rule out most keys without taking any lock.
+	 *
+	 * A cache may be shared between threads, between MusicBrainz5::CQuery objects, and
+	 * between processes using the same directory.
+	 *
+	 * @see MusicBrainz5::CQuery::SetDiskCache
+	 */
+	class CDiskCache
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Open the cache in a directory, which is created if it doesn't exist
+		 *
+		 * @param Directory Directory to keep the cache in
+		 * @param MaxSize Maximum total size, in bytes, of the segment files
+		 * @param TTL Number of seconds a response remains valid for
+		 */
+
+		CDiskCache(const std::string& Directory, size_t MaxSize=256*1024*1024, int TTL=7*24*60*60);
+		~CDiskCache();
+
+		/**
+		 * @brief Whether the cache could be opened
+		 *
+		 * @return true if the cache directory could be used. If it couldn't, every
+		 *		lookup misses and nothing is stored.
+		 */
+
+		bool Valid() const;
+
+		/**
+		 * @brief Cache directory
+		 *
+		 * @return Directory the cache is kept in
+		 */
+
+		std::string Directory() const;
+
+		/**
+		 * @brief Set the maximum size of the cache
+		 *
+		 * @param MaxSize Maximum total size, in bytes, of the segment files
+		 */
+
+		void SetMaxSize(size_t MaxSize);
+
+		/**
+		 * @brief Maximum size of the cache
+		 *
+		 * @return Maximum total size, in bytes, of the segment files
+		 */
+
+		size_t MaxSize() const;
+
+		/**
+		 * @brief Set the time to live
+		 *
+		 * @param TTL Number of seconds a response remains valid for
+		 */
+
+		void SetTTL(int TTL);
+
+		/**
+		 * @brief Time to live
+		 *
+		 * @return Number of seconds a response remains valid for
+		 */
+
+		int TTL() const;
+
+		/**
+		 * @brief Set the negative time to live
+		 *
+		 * @param NegativeTTL Number of seconds a request recorded by PutNotFound is
+		 *		known not to exist for. The default is one day.
+		 */
+
+		void SetNegativeTTL(int NegativeTTL);
+
+		/**
+		 * @brief Negative time to live
+		 *
+		 * @return Number of seconds a missing entity is remembered for
+		 */
+
+		int NegativeTTL() const;
+
+		/**
+		 * @brief Retrieve a response
+		 *
+		 * Look up the response body stored for a key
+		 *
+		 * @param Key Key identifying the request
+		 * @param Data Filled in with the response body if it is found
+		 *
+		 * @return true if a valid response was found
+		 */
+
+		bool Get(const std::string& Key, std::string& Data);
+
+		/**
+		 * @brief Retrieve a response, even if it has expired
+		 *
+		 * Look up the response body stored for a key, along with its validators. This
+		 * does not count as a hit or a miss.
+		 *
+		 * @param Key Key identifying the request
+		 * @param Data Filled in with the response body if it is found
+		 * @param ETag Filled in with the ETag header the response was received with
+		 * @param LastModified Filled in with the Last-Modified header the response was
+		 *		received with
+		 *
+		 * @return true if a response was found
+		 */
+
+		bool GetStale(const std::string& Key, std::string& Data, std::string& ETag, std::string& LastModified);
+
+		/**
+		 * @brief Store a response
+		 *
+		 * Store the response body for a request, replacing any body already stored
+		 * for the key
+		 *
+		 * @param Key Key identifying the request
+		 * @param Data Response body
+		 * @param ETag ETag header the response was received with
+		 * @param LastModified Last-Modified header the response was received with
+		 *
+		 * @return true if the response was stored
+		 */
+
+		bool Put(const std::string& Key, const std::string& Data, const std::string& ETag="", const std::string& LastModified="");
+
+		/**
+		 * @brief Record that a request found nothing
+		 *
+		 * Record that the server replied to a request that the entity doesn't exist,
+		 * replacing any response stored for the key
+		 *
+		 * @param Key Key identifying the request
+		 *
+		 * @return true if the request was recorded
+		 */
+
+		bool PutNotFound(const std::string& Key);
+
+		/**
+		 * @brief Whether a request is known to find nothing
+		 *
+		 * @param Key Key identifying the request
+		 *
+		 * @return true if PutNotFound was called for the key within the negative time
+		 *		to live, and no response has been stored since
+		 */
+
+		bool NotFound(const std::string& Key);
+
+		/**
+		 * @brief Mark a response as valid again
+		 *
+		 * Restart the time to live of a stored response, for example after the server
+		 * has confirmed that it hasn't changed.
+		 *
+		 * @param Key Key identifying the request
+		 *
+		 * @return true if a response was stored for the key
+		 */
+
+		bool Refresh(const std::string& Key);
+
+		/**
+		 * @brief Remove a response
+		 *
+		 * @param Key Key identifying the request
+		 */
+
+		void Remove(const std::string& Key);
+
+		/**
+		 * @brief Remove responses whose keys start with a prefix
+		 *
+		 * The index only holds a hash of each key, so the key of every stored response
+		 * is read back from its segment. This is much slower than Remove.
+		 *
+		 * @param Prefix Start of the keys to remove
+		 */
+
+		void RemovePrefix(const std::string& Prefix);
+
+		/**
+		 * @brief Remove all responses
+		 */
+
+		void Clear();
+
+		/**
+		 * @brief Compact the cache
+		 *
+		 * Copy the valid responses into new segment files and remove the old ones,
+		 * releasing the space taken by responses that have been replaced or have
+		 * expired. This happens automatically when the space wasted grows too large.
+		 */
+
+		void Compact();
+
+		/**
+		 * @brief Number of responses held
+		 *
+		 * @return Number of responses currently in the cache
+		 */
+
+		int NumEntries() const;
+
+		/**
+		 * @brief Size of the cache
+		 *
+		 * @return Total size, in bytes, of the segment files
+		 */
+
+		size_t Size() const;
+
+		/**
+		 * @brief Number of hits
+		 *
+		 * @return Number of times Get has found a valid response in this process
+		 */
+
+		unsigned long Hits() const;
+
+		/**
+		 * @brief Number of misses
+		 *
+		 * @return Number of times Get has not found a valid response in this process
+		 */
+
+		unsigned long Misses() const;
+
+		/**
+		 * @brief Number of evictions
+		 *
+		 * @return Number of responses this process has discarded to keep the cache
+		 *		within its maximum size
+		 */
+
+		unsigned long Evictions() const;
+
+	private:
+		CDiskCachePrivate * const m_d;
+
+		CDiskCache(const CDiskCache&);
+		CDiskCache& operator =(const CDiskCache&);
+	};
+}
+
+#endif
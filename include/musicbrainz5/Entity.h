@@ -31,28 +31,56 @@
 #include <sstream>
 #include <map>
 
+#include "musicbrainz5/defines.h"
 #include "musicbrainz5/xmlParser.h"
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+#include <utility>
+#endif
+
 namespace MusicBrainz5
 {
 	class CEntityPrivate;
 
 	class CRelationListList;
 
+	/**
+	 * @brief Base class of all entities
+	 *
+	 * Copying an entity, or calling Clone, is cheap: the copies share their data,
+	 * which is only duplicated if one of them is parsed into again. The const
+	 * accessors of an entity return const pointers to entities shared between all its
+	 * copies. The non-const accessors first give the entity its own copy of its
+	 * children, so that changes made through the returned pointer are only seen by
+	 * that entity; any later copies of it get their own children too.
+	 *
+	 * An entity that has been moved from, by move construction or move assignment,
+	 * is left empty, as if it had been default constructed, and can be used again.
+	 *
+	 * The string accessors, and ExtAttributes and ExtElements, return references to
+	 * data held by the entity. A reference is valid until the entity is destroyed,
+	 * assigned to, parsed into or has a non-const accessor called on it, so the value
+	 * should be copied if it is read from a temporary, such as the entity returned by
+	 * MusicBrainz5::CQuery::LookupRelease.
+	 */
 	class CEntity
 	{
 	public:
 		CEntity();
 		CEntity(const CEntity& Other);
 		CEntity& operator =(const CEntity& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CEntity(CEntity&& Other);
+		CEntity& operator =(CEntity&& Other);
+#endif
 		virtual ~CEntity();
 
 		virtual CEntity *Clone()=0;
 
 		void Parse(const XMLNode& Node);
 
-		std::map<std::string,std::string> ExtAttributes() const;
-		std::map<std::string,std::string> ExtElements() const;
+		const std::map<std::string,std::string>& ExtAttributes() const;
+		const std::map<std::string,std::string>& ExtElements() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -106,13 +134,25 @@ namespace MusicBrainz5
 				RetVal=Node.getText();
 		}
 
+		//Numbers are parsed as std::istream would in the "C" locale, but without
+		//constructing a stream for each value
+
+		void ProcessItem(const XMLNode& Node, int& RetVal);
+		void ProcessItem(const XMLNode& Node, double& RetVal);
+		void ProcessItem(const std::string& Text, int& RetVal);
+		void ProcessItem(const std::string& Text, double& RetVal);
+		void ProcessItem(const std::string& Text, std::string& RetVal);
+
+		//Fields with few distinct values point to a string in CStringPool
+
+		void InternItem(const XMLNode& Node, const std::string*& RetVal);
+		void InternItem(const std::string& Text, const std::string*& RetVal);
+
 		virtual void ParseAttribute(const std::string& Name, const std::string& Value)=0;
 		virtual void ParseElement(const XMLNode& Node)=0;
 
 	private:
 		CEntityPrivate *m_d;
-
-		void Cleanup();
 	};
 }
 
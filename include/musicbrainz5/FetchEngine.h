@@ -0,0 +1,299 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_FETCH_ENGINE_H
+#define _MUSICBRAINZ5_FETCH_ENGINE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace MusicBrainz5
+{
+	class CFetchCompletionPrivate;
+	class CFetchEnginePrivate;
+
+	/**
+	 * @brief Result of a request made through a MusicBrainz5::CFetchEngine
+	 */
+	class CFetchCompletion
+	{
+	public:
+		CFetchCompletion();
+		CFetchCompletion(const CFetchCompletion& Other);
+		CFetchCompletion& operator =(const CFetchCompletion& Other);
+		~CFetchCompletion();
+
+		/**
+		 * @brief Request ID
+		 *
+		 * @return ID returned by MusicBrainz5::CFetchEngine::Add when the request was added
+		 */
+
+		int ID() const;
+
+		/**
+		 * @brief URL requested
+		 *
+		 * @return URL requested
+		 */
+
+		std::string URL() const;
+
+		/**
+		 * @brief Transport result code
+		 *
+		 * Return the result code of the transfer. This will be 0 if a response was
+		 * received from the server, otherwise it is an errno value describing the failure.
+		 *
+		 * @return Transport result code
+		 */
+
+		int Result() const;
+
+		/**
+		 * @brief HTTP status code
+		 *
+		 * @return HTTP status code of the response, or 0 if no response was received
+		 */
+
+		int Status() const;
+
+		/**
+		 * @brief Error message
+		 *
+		 * @return Description of the failure if no response was received
+		 */
+
+		std::string ErrorMessage() const;
+
+		/**
+		 * @brief Return a header from the response
+		 *
+		 * @param Name Name of the header (case insensitive)
+		 *
+		 * @return Value of the header, or an empty string if it wasn't present
+		 */
+
+		std::string ResponseHeader(const std::string& Name) const;
+
+		/**
+		 * @brief Return the headers from the response
+		 *
+		 * @return Headers from the response, keyed on the lower case header name
+		 */
+
+		std::map<std::string,std::string> ResponseHeaders() const;
+
+		/**
+		 * @brief Response body
+		 *
+		 * @return Body of the response
+		 */
+
+		std::vector<unsigned char> Data() const;
+
+	private:
+		friend class CFetchEnginePrivate;
+
+		CFetchCompletionPrivate * const m_d;
+	};
+
+	/**
+	 * @brief Interface for receiving notification of completed requests
+	 *
+	 * @see MusicBrainz5::CFetchEngine::SetCallback
+	 */
+	class CFetchCallback
+	{
+	public:
+		virtual ~CFetchCallback();
+
+		/**
+		 * @brief Called when a request completes
+		 *
+		 * Called from within MusicBrainz5::CFetchEngine::Run when a request completes,
+		 * successfully or not. New requests may be added from within the callback.
+		 *
+		 * @param Completion Result of the request
+		 */
+
+		virtual void Completed(const CFetchCompletion& Completion)=0;
+	};
+
+	/**
+	 * @brief Engine for making many concurrent requests from a single thread
+	 *
+	 * Multiplexes requests to a single server over a number of non-blocking keep-alive
+	 * connections, using epoll where it is available. Requests are queued using Add and
+	 * processed by calling Run. Completed requests are either passed to a callback or
+	 * placed on a completion queue to be retrieved using NextCompletion.
+	 *
+	 * No rate limiting is applied by the engine itself, and authentication, proxy and
+	 * compression are not supported. MusicBrainz5::CFetchEngineTransport runs an engine
+	 * on behalf of a MusicBrainz5::CQuery, which rate limits its requests as usual.
+	 *
+	 * An engine is not thread safe, and apart from Interrupt should only be used from
+	 * a single thread.
+	 */
+	class CFetchEngine
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param UserAgent User agent string to send
+		 * @param Host Host name to connect to
+		 * @param Port Port to connect to (80 by default)
+		 * @param MaxConnections Maximum number of simultaneous connections to the server
+		 */
+
+		CFetchEngine(const std::string& UserAgent, const std::string& Host, int Port=80, int MaxConnections=16);
+		~CFetchEngine();
+
+		/**
+		 * @brief Set the callback for completed requests
+		 *
+		 * Set the callback that completed requests are passed to. If no callback is
+		 * set, completed requests are placed on the completion queue.
+		 *
+		 * @param Callback Callback to use. Ownership remains with the caller. Pass NULL
+		 *		to use the completion queue.
+		 */
+
+		void SetCallback(CFetchCallback *Callback);
+
+		/**
+		 * @brief Set the request timeout
+		 *
+		 * Set the number of seconds a request may take, including any time spent queued
+		 * waiting for a connection, before it fails with ETIMEDOUT.
+		 *
+		 * @param Timeout Request timeout in seconds (30 by default)
+		 */
+
+		void SetTimeout(int Timeout);
+
+		/**
+		 * @brief Set the maximum number of connections
+		 *
+		 * @param MaxConnections Maximum number of simultaneous connections to the server
+		 */
+
+		void SetMaxConnections(int MaxConnections);
+
+		/**
+		 * @brief Set the idle connection timeout
+		 *
+		 * Set the number of seconds a keep-alive connection may stay open without
+		 * being used. Idle connections are closed the next time Run is called after
+		 * they time out.
+		 *
+		 * @param IdleTimeout Idle timeout in seconds (30 by default)
+		 */
+
+		void SetIdleTimeout(int IdleTimeout);
+
+		/**
+		 * @brief Queue a request
+		 *
+		 * Queue a GET request for the specified URL. The request is made during
+		 * subsequent calls to Run.
+		 *
+		 * @param URL URL to request (e.g. /ws/2/release/ID)
+		 * @param Headers Additional headers to send with the request (e.g. If-None-Match)
+		 *
+		 * @return ID identifying the request in its MusicBrainz5::CFetchCompletion
+		 */
+
+		int Add(const std::string& URL, const std::map<std::string,std::string>& Headers=std::map<std::string,std::string>());
+
+		/**
+		 * @brief Process requests
+		 *
+		 * Make queued requests and process responses until all requests have completed,
+		 * the timeout expires or Interrupt is called. Connections that have been idle
+		 * for longer than the idle timeout are closed.
+		 *
+		 * @param Timeout Maximum number of milliseconds to wait for, or -1 to wait until
+		 *		all requests have completed
+		 *
+		 * @return Number of requests that completed during the call
+		 *
+		 * @throw CFetchError The engine was unable to create the descriptors it waits on
+		 */
+
+		int Run(int Timeout=-1);
+
+		/**
+		 * @brief Interrupt Run
+		 *
+		 * Make a call to Run in progress on another thread return as soon as possible,
+		 * so that the thread can add more requests. If Run isn't in progress, the next
+		 * call returns early instead. This may be called from any thread.
+		 */
+
+		void Interrupt();
+
+		/**
+		 * @brief Number of outstanding requests
+		 *
+		 * @return Number of requests that are queued or in progress
+		 */
+
+		int NumPending() const;
+
+		/**
+		 * @brief Number of open connections
+		 *
+		 * @return Number of connections currently open to the server
+		 */
+
+		int NumConnections() const;
+
+		/**
+		 * @brief Retrieve the next completed request
+		 *
+		 * Remove the oldest entry from the completion queue. Completions are only
+		 * queued if no callback has been set.
+		 *
+		 * @param Completion Filled in with the completed request
+		 *
+		 * @return true if a completion was retrieved, false if the queue was empty
+		 */
+
+		bool NextCompletion(CFetchCompletion& Completion);
+
+	private:
+		CFetchEnginePrivate * const m_d;
+
+		CFetchEngine(const CFetchEngine&);
+		CFetchEngine& operator =(const CFetchEngine&);
+	};
+}
+
+#endif
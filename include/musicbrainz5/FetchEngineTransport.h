@@ -0,0 +1,71 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+#ifndef _MUSICBRAINZ5_FETCH_ENGINE_TRANSPORT_H
+#define _MUSICBRAINZ5_FETCH_ENGINE_TRANSPORT_H
+
+#include "musicbrainz5/Transport.h"
+
+namespace MusicBrainz5
+{
+	class CFetchEngineTransportPrivate;
+
+	/**
+	 * @brief Transport that makes requests through a MusicBrainz5::CFetchEngine
+	 *
+	 * Requests for each server are passed to a single thread, which multiplexes them
+	 * over a limited number of keep-alive connections using a MusicBrainz5::CFetchEngine.
+	 * This allows the threads used by MusicBrainz5::CQuery::LookupBatch and the
+	 * asynchronous queries to share connections, rather than each opening its own.
+	 * Requests are still rate limited by the MusicBrainz5::CQuery making them.
+	 *
+	 * Only GET requests are supported. Authentication, proxy and compression settings
+	 * are ignored, so collections can't be edited through this transport.
+	 */
+	class CFetchEngineTransport: public CTransport
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param MaxConnections Maximum number of simultaneous connections to each server
+		 * @param IdleTimeout Number of seconds after which an unused connection is closed
+		 */
+
+		CFetchEngineTransport(int MaxConnections=4, int IdleTimeout=30);
+		virtual ~CFetchEngineTransport();
+
+		virtual CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+	private:
+		CFetchEngineTransportPrivate * const m_d;
+
+		CFetchEngineTransport(const CFetchEngineTransport&);
+		CFetchEngineTransport& operator =(const CFetchEngineTransport&);
+	};
+}
+
+#endif
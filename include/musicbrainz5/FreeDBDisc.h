@@ -44,16 +44,21 @@ namespace MusicBrainz5
 		CFreeDBDisc(const XMLNode& Node);
 		CFreeDBDisc(const CFreeDBDisc& Other);
 		CFreeDBDisc& operator =(const CFreeDBDisc& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CFreeDBDisc(CFreeDBDisc&& Other);
+		CFreeDBDisc& operator =(CFreeDBDisc&& Other);
+#endif
 		virtual ~CFreeDBDisc();
 
 		virtual CFreeDBDisc *Clone();
 
-		std::string ID() const;
-		std::string Title() const;
-		std::string Artist() const;
-		std::string Category() const;
-		std::string Year() const;
-		CNonMBTrackList *NonMBTrackList() const;
+		const std::string& ID() const;
+		const std::string& Title() const;
+		const std::string& Artist() const;
+		const std::string& Category() const;
+		const std::string& Year() const;
+		const CNonMBTrackList *NonMBTrackList() const;
+		CNonMBTrackList *NonMBTrackList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -63,9 +68,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CFreeDBDiscPrivate * const m_d;
+		CFreeDBDiscPrivate *m_d;
 	};
 }
 
@@ -29,9 +29,12 @@
 #include <string>
 #include <vector>
 
+#include "musicbrainz5/Transport.h"
+
 namespace MusicBrainz5
 {
 	class CHTTPFetchPrivate;
+	class CHTTPSessionPool;
 
 	class CExceptionBase: public std::exception
 	{
@@ -134,13 +137,27 @@ namespace MusicBrainz5
 			}
 	};
 
+	/**
+	 * Exception thrown when the server is temporarily unable to handle the request
+	 * (usually because too many requests are being made)
+	 */
+
+	class CServiceUnavailableError: public CFetchError
+	{
+	public:
+			CServiceUnavailableError(const std::string& ErrorMessage)
+			: CFetchError(ErrorMessage)
+			{
+			}
+	};
+
 	/**
 	 * @brief Object for make HTTP requests
 	 *
 	 * Object to be used to make HTTP requests
 	 *
 	 */
-	class CHTTPFetch
+	class CHTTPFetch: public CFetch
 	{
 	public:
 		/**
@@ -158,64 +175,16 @@ namespace MusicBrainz5
 		~CHTTPFetch();
 
 		/**
-		 * @brief Set the user name to use
-		 *
-		 * Set the user name to use when authenticating with the web server
-		 *
-		 * @param UserName User name to use
-		 */
-
-		void SetUserName(const std::string& UserName);
-
-		/**
-		 * @brief Set the password to use
-		 *
-		 * Set the password to use when authenticating with the web server
-		 *
-		 * @param Password Password to use
-		 */
-
-		void SetPassword(const std::string& Password);
-
-		/**
-		 * @brief Set the proxy server to use
+		 * @brief Set the session pool to use
 		 *
-		 * Set the proxy server to use when connecting with the web server
+		 * Set the pool from which to take (and return) HTTP sessions. Sessions taken
+		 * from a pool keep their connection to the server open between requests.
+		 * If no pool is set, a new connection is made for each request.
 		 *
-		 * @param ProxyHost Proxy server to use
+		 * @param SessionPool Session pool to use. Ownership remains with the caller.
 		 */
 
-		void SetProxyHost(const std::string& ProxyHost);
-
-		/**
-		 * @brief Set the proxy port to use
-		 *
-		 * Set the proxy server port to use when connecting to the web server
-		 *
-		 * @param ProxyPort Proxy server port to use
-		 */
-
-		void SetProxyPort(int ProxyPort);
-
-		/**
-		 * @brief Set the proxy user name to use
-		 *
-		 * Set the user name to use when authenticating with the proxy server
-		 *
-		 * @param ProxyUserName Proxy user name to use
-		 */
-
-		void SetProxyUserName(const std::string& ProxyUserName);
-
-		/**
-		 * @brief Set the proxy password to use
-		 *
-		 * Set the password to use when authenticating with the proxy server
-		 *
-		 * @param ProxyPassword Proxy server password to use
-		 */
-
-		void SetProxyPassword(const std::string& ProxyPassword);
+		void SetSessionPool(CHTTPSessionPool *SessionPool);
 
 		/**
 		 * @brief Make a request to the server
@@ -231,51 +200,22 @@ namespace MusicBrainz5
 		 * @throw CTimeoutError A timeout occurred when connecting to the web server
 		 * @throw CAuthenticationError An authentication error occurred
 		 * @throw CFetchError An error occurred fetching data
+		 * @throw CServiceUnavailableError The server is busy (a CFetchError)
 		 * @throw CRequestError The request was invalid
 		 * @throw CResourceNotFoundError The requested resource was not found
 		 */
 
 		int Fetch(const std::string& URL, const std::string& Request="GET");
 
+	protected:
 		/**
-		 * @brief Get the data receieved
-		 *
-		 * Get the data received from the request
-		 *
-		 * @return Data received
-		 */
-
-		std::vector<unsigned char> Data() const;
-
-		/**
-		 * @brief libneon result code from the request
-		 *
-		 * Return the result code from the request
-		 *
-		 * @return libneon result code from the request
-		 */
-
-		int Result() const;
-
-		/**
-		 * @brief Status
-		 *
-		 * Return the HTTP status code from the request
-		 *
-		 * @return HTTP status code from the request
-		 */
-
-		int Status() const;
-
-		/**
-		 * @brief Return the error message from the request
-		 *
-		 * Return the error message from the request
+		 * @brief Key of the pooled sessions this fetch can use
 		 *
-		 * @return Error message from the request
+		 * @return The server, proxy and user name a session is set up for, as used to
+		 *		find an idle session in the session pool
 		 */
 
-		std::string ErrorMessage() const;
+		std::string SessionKey() const;
 
 	private:
 		CHTTPFetchPrivate * const m_d;
@@ -283,6 +223,7 @@ namespace MusicBrainz5
 		static int httpAuth(void *userdata, const char *realm, int attempts, char *username, char *password);
 		static int proxyAuth(void *userdata, const char *realm, int attempts, char *username, char *password);
 		static int httpResponseReader(void *userdata, const char *buf, size_t len);
+		static int httpCompressedReader(void *userdata, const char *buf, size_t len);
 	};
 }
 
@@ -0,0 +1,162 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_HTTP_SESSION_POOL_H
+#define _MUSICBRAINZ5_HTTP_SESSION_POOL_H
+
+#include <string>
+
+#include <time.h>
+
+struct ne_session_s;
+
+namespace MusicBrainz5
+{
+	class CHTTPSessionPoolPrivate;
+
+	/**
+	 * @brief Pool of persistent HTTP sessions
+	 *
+	 * Keeps idle HTTP sessions open between requests so that subsequent requests
+	 * to the same server can reuse the existing (keep-alive) connection rather than
+	 * performing a new DNS lookup and TCP handshake.
+	 *
+	 * Sessions are keyed on the server and proxy they connect to. Sessions that have
+	 * been idle for longer than the idle timeout are closed, and no more than the
+	 * configured maximum number of idle sessions are kept open.
+	 *
+	 * A pool may be used from several threads at once.
+	 */
+	class CHTTPSessionPool
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param MaxSessions Maximum number of idle sessions to keep open
+		 * @param IdleTimeout Number of seconds after which an idle session is closed
+		 */
+
+		CHTTPSessionPool(int MaxSessions=4, int IdleTimeout=30);
+		virtual ~CHTTPSessionPool();
+
+		/**
+		 * @brief Set the maximum number of idle sessions
+		 *
+		 * Set the maximum number of idle sessions to keep open. Setting this to 0
+		 * disables connection reuse.
+		 *
+		 * @param MaxSessions Maximum number of idle sessions
+		 */
+
+		void SetMaxSessions(int MaxSessions);
+
+		/**
+		 * @brief Set the idle timeout
+		 *
+		 * Set the number of seconds after which an idle session will be closed
+		 *
+		 * @param IdleTimeout Idle timeout in seconds
+		 */
+
+		void SetIdleTimeout(int IdleTimeout);
+
+		/**
+		 * @brief Maximum number of idle sessions
+		 *
+		 * @return Maximum number of idle sessions
+		 */
+
+		int MaxSessions() const;
+
+		/**
+		 * @brief Idle timeout
+		 *
+		 * @return Idle timeout in seconds
+		 */
+
+		int IdleTimeout() const;
+
+		/**
+		 * @brief Number of idle sessions
+		 *
+		 * @return Number of idle sessions currently held open
+		 */
+
+		int NumSessions() const;
+
+		/**
+		 * @brief Close all idle sessions
+		 *
+		 * Close all idle sessions held in the pool
+		 */
+
+		void Clear();
+
+	protected:
+		/**
+		 * @brief Take an idle session from the pool
+		 *
+		 * @param Key Server, proxy and user the session is for
+		 *
+		 * @return The most recently used idle session for Key, which is removed from
+		 *		the pool, or 0 if there is none
+		 */
+
+		ne_session_s *Acquire(const std::string& Key);
+
+		/**
+		 * @brief Return a session to the pool
+		 *
+		 * Hand a session back once a request on it has finished, so that it may be
+		 * reused. The least recently used sessions are closed if this takes the pool
+		 * over its maximum size.
+		 *
+		 * @param Key Server, proxy and user the session is for
+		 * @param Session Session to return, which the pool takes ownership of
+		 */
+
+		void Release(const std::string& Key, ne_session_s *Session);
+
+		/**
+		 * @brief Current time
+		 *
+		 * @return The time used to decide when a session has been idle for too long
+		 */
+
+		virtual time_t Now() const;
+
+	private:
+		friend class CHTTPFetch;
+
+		CHTTPSessionPoolPrivate * const m_d;
+
+		void Expire();
+	};
+}
+
+#endif
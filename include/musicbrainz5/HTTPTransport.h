@@ -0,0 +1,66 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_HTTP_TRANSPORT_H
+#define _MUSICBRAINZ5_HTTP_TRANSPORT_H
+
+#include "musicbrainz5/Transport.h"
+
+namespace MusicBrainz5
+{
+	class CHTTPTransportPrivate;
+	class CHTTPSessionPool;
+
+	/**
+	 * @brief Transport that makes HTTP requests using libneon
+	 *
+	 * This is the transport used by MusicBrainz5::CQuery unless another is
+	 * specified. Connections to the server are kept open between requests in
+	 * the transport's session pool.
+	 */
+	class CHTTPTransport: public CTransport
+	{
+	public:
+		CHTTPTransport();
+		virtual ~CHTTPTransport();
+
+		virtual CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+		/**
+		 * @brief Session pool
+		 *
+		 * Return the pool of idle HTTP sessions used by this transport
+		 *
+		 * @return Session pool
+		 */
+
+		CHTTPSessionPool& SessionPool() const;
+
+	private:
+		CHTTPTransportPrivate * const m_d;
+	};
+}
+
+#endif
@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CIPI(const XMLNode& Node=XMLNode::emptyNode());
 		CIPI(const CIPI& Other);
 		CIPI& operator =(const CIPI& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CIPI(CIPI&& Other);
+		CIPI& operator =(CIPI&& Other);
+#endif
 		virtual ~CIPI();
 
 		virtual CIPI *Clone();
 
-		std::string IPI() const;
+		const std::string& IPI() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,7 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CIPIPrivate * const m_d;
+		CIPIPrivate *m_d;
 	};
 }
 
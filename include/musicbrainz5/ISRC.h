@@ -41,12 +41,17 @@ namespace MusicBrainz5
 		CISRC(const XMLNode& Node=XMLNode::emptyNode());
 		CISRC(const CISRC& Other);
 		CISRC& operator =(const CISRC& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CISRC(CISRC&& Other);
+		CISRC& operator =(CISRC&& Other);
+#endif
 		virtual ~CISRC();
 
 		virtual CISRC *Clone();
 
-		std::string ID() const;
-		CRecordingList *RecordingList() const;
+		const std::string& ID() const;
+		const CRecordingList *RecordingList() const;
+		CRecordingList *RecordingList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -56,9 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CISRCPrivate * const m_d;
+		CISRCPrivate *m_d;
 	};
 }
 
@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CISWC(const XMLNode& Node=XMLNode::emptyNode());
 		CISWC(const CISWC& Other);
 		CISWC& operator =(const CISWC& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CISWC(CISWC&& Other);
+		CISWC& operator =(CISWC&& Other);
+#endif
 		virtual ~CISWC();
 
 		virtual CISWC *Clone();
 
-		std::string ISWC() const;
+		const std::string& ISWC() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,9 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CISWCPrivate * const m_d;
+		CISWCPrivate *m_d;
 	};
 }
 
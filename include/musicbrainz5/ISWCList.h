@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CISWCList(const XMLNode& Node=XMLNode::emptyNode());
 		CISWCList(const CISWCList& Other);
 		CISWCList& operator =(const CISWCList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CISWCList(CISWCList&& Other);
+		CISWCList& operator =(CISWCList&& Other);
+#endif
 		virtual ~CISWCList();
 
 		virtual CISWCList *Clone();
@@ -56,7 +60,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CISWCListPrivate * const m_d;
+		CISWCListPrivate *m_d;
 	};
 }
 
@@ -30,6 +30,7 @@
 #include <iostream>
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/IPIList.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/AliasList.h"
@@ -53,26 +54,40 @@ namespace MusicBrainz5
 		CLabel(const XMLNode& Node=XMLNode::emptyNode());
 		CLabel(const CLabel& Other);
 		CLabel& operator =(const CLabel& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CLabel(CLabel&& Other);
+		CLabel& operator =(CLabel&& Other);
+#endif
 		virtual ~CLabel();
 
 		virtual CLabel *Clone();
 
-		std::string ID() const;
-		std::string Type() const;
-		std::string Name() const;
-		std::string SortName() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Type() const;
+		const std::string& Name() const;
+		const std::string& SortName() const;
 		int LabelCode() const;
-		CIPIList *IPIList() const;
-		std::string Disambiguation() const;
-		std::string Country() const;
-		CLifespan *Lifespan() const;
-		CAliasList *AliasList() const;
-		CReleaseList *ReleaseList() const;
-		CRelationListList *RelationListList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
+		const CIPIList *IPIList() const;
+		CIPIList *IPIList();
+		const std::string& Disambiguation() const;
+		const std::string& Country() const;
+		const CLifespan *Lifespan() const;
+		CLifespan *Lifespan();
+		const CAliasList *AliasList() const;
+		CAliasList *AliasList();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -82,9 +97,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CLabelPrivate * const m_d;
+		CLabelPrivate *m_d;
 	};
 }
 
@@ -45,12 +45,17 @@ namespace MusicBrainz5
 		CLabelInfo(const XMLNode& Node=XMLNode::emptyNode());
 		CLabelInfo(const CLabelInfo& Other);
 		CLabelInfo& operator =(const CLabelInfo& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CLabelInfo(CLabelInfo&& Other);
+		CLabelInfo& operator =(CLabelInfo&& Other);
+#endif
 		virtual ~CLabelInfo();
 
 		virtual CLabelInfo *Clone();
 
-		std::string CatalogNumber() const;
-		CLabel *Label() const;
+		const std::string& CatalogNumber() const;
+		const CLabel *Label() const;
+		CLabel *Label();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -60,9 +65,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CLabelInfoPrivate * const m_d;
+		CLabelInfoPrivate *m_d;
 	};
 }
 
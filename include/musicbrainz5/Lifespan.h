@@ -43,13 +43,17 @@ namespace MusicBrainz5
 		CLifespan(const XMLNode& Node=XMLNode::emptyNode());
 		CLifespan(const CLifespan& Other);
 		CLifespan& operator =(const CLifespan& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CLifespan(CLifespan&& Other);
+		CLifespan& operator =(CLifespan&& Other);
+#endif
 		virtual ~CLifespan();
 
 		virtual CLifespan *Clone();
 
-		std::string Begin() const;
-		std::string End() const;
-		std::string Ended() const;
+		const std::string& Begin() const;
+		const std::string& End() const;
+		const std::string& Ended() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -59,7 +63,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CLifespanPrivate * const m_d;
+		CLifespanPrivate *m_d;
 	};
 }
 
@@ -40,6 +40,10 @@ namespace MusicBrainz5
 		CList();
 		CList(const CList& Other);
 		CList& operator =(const CList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CList(CList&& Other);
+		CList& operator =(CList&& Other);
+#endif
 		virtual ~CList();
 
 		virtual CList *Clone();
@@ -56,12 +60,11 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 		void AddItem(CEntity *Item);
-		CEntity *Item(int Item) const;
+		const CEntity *Item(int Item) const;
+		CEntity *Item(int Item);
 
 	private:
 		CListPrivate *m_d;
-
-		void Cleanup();
 	};
 }
 
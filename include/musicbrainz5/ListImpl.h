@@ -46,9 +46,8 @@ namespace MusicBrainz5
 		}
 
 		CListImpl(const CListImpl<T>& Other)
-		:	CList()
+		:	CList(Other)
 		{
-			*this=Other;
 		}
 
 		MusicBrainz5::CListImpl<T>& operator =(const CListImpl<T>& Other)
@@ -61,6 +60,23 @@ namespace MusicBrainz5
 			return *this;
 		}
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CListImpl(CListImpl<T>&& Other)
+		:	CList(std::move(Other))
+		{
+		}
+
+		MusicBrainz5::CListImpl<T>& operator =(CListImpl<T>&& Other)
+		{
+			if (this!=&Other)
+			{
+				CList::operator =(std::move(Other));
+			}
+
+			return *this;
+		}
+#endif
+
 		virtual ~CListImpl()
 		{
 		}
@@ -78,7 +94,7 @@ namespace MusicBrainz5
 
 			for (int count=0;count<NumItems();count++)
 			{
-				T *ThisItem=Item(count);
+				const T *ThisItem=Item(count);
 
 				os << *ThisItem << std::endl;
 			}
@@ -91,7 +107,12 @@ namespace MusicBrainz5
 			return "";
 		}
 
-		T *Item(int Item) const
+		const T *Item(int Item) const
+		{
+			return dynamic_cast<const T *>(CList::Item(Item));
+		}
+
+		T *Item(int Item)
 		{
 			return dynamic_cast<T *>(CList::Item(Item));
 		}
@@ -104,9 +125,7 @@ namespace MusicBrainz5
 	protected:
 		void ParseElement(const XMLNode& Node)
 		{
-			std::string NodeName=Node.getName();
-
-			if (T::GetElementName()==NodeName)
+			if (T::GetElementName()==Node.getName())
 			{
 				T *Item=0;
 
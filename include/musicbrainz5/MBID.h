@@ -0,0 +1,158 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_MBID_H
+#define _MUSICBRAINZ5_MBID_H
+
+#include <string>
+#include <iostream>
+#include <string.h>
+
+#include "musicbrainz5/defines.h"
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+#include <functional>
+#endif
+
+namespace MusicBrainz5
+{
+	/**
+	 * @brief MusicBrainz identifier
+	 *
+	 * Holds the 16 bytes of a MusicBrainz ID (a UUID such as
+	 * 'f27ec8db-af05-4f36-916e-3d57f91ecf5e'), so that it can be stored, compared and
+	 * hashed without keeping the 36 character text.
+	 *
+	 * IDs are ordered by their bytes, which is the same order as their text.
+	 */
+	class CMBID
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Construct the nil ID, in which all bytes are 0
+		 */
+
+		CMBID();
+
+		/**
+		 * @brief Constructor
+		 *
+		 * Construct an ID from its text
+		 *
+		 * @param Text ID in the form 'xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx'. If this isn't
+		 *		a valid ID, the nil ID is constructed.
+		 */
+
+		explicit CMBID(const std::string& Text);
+
+		/**
+		 * @brief Check the text of an ID
+		 *
+		 * @param Text Text to check
+		 *
+		 * @return true if the text is 32 hex digits (upper or lower case) separated by
+		 *		hyphens in groups of 8, 4, 4, 4 and 12
+		 */
+
+		static bool IsValid(const std::string& Text);
+
+		/**
+		 * @brief Set the ID from its text
+		 *
+		 * @param Text ID in the form 'xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx'
+		 *
+		 * @return true if the text was a valid ID. If it wasn't, the ID is unchanged.
+		 */
+
+		bool Parse(const std::string& Text);
+
+		/**
+		 * @brief Whether this is the nil ID
+		 *
+		 * @return true if all bytes of the ID are 0
+		 */
+
+		bool IsNil() const;
+
+		/**
+		 * @brief Text of the ID
+		 *
+		 * @return ID in the form 'xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx', in lower case
+		 */
+
+		std::string ToString() const;
+
+		/**
+		 * @brief Bytes of the ID
+		 *
+		 * @return The 16 bytes of the ID, in the order they appear in the text
+		 */
+
+		const unsigned char *Bytes() const { return m_Bytes; }
+
+		/**
+		 * @brief Hash of the ID
+		 *
+		 * @return Hash value for use in hash tables
+		 */
+
+		size_t Hash() const;
+
+		bool operator ==(const CMBID& Other) const { return 0==memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes)); }
+		bool operator !=(const CMBID& Other) const { return 0!=memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes)); }
+		bool operator <(const CMBID& Other) const { return memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes))<0; }
+		bool operator >(const CMBID& Other) const { return memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes))>0; }
+		bool operator <=(const CMBID& Other) const { return memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes))<=0; }
+		bool operator >=(const CMBID& Other) const { return memcmp(m_Bytes,Other.m_Bytes,sizeof(m_Bytes))>=0; }
+
+	private:
+		unsigned char m_Bytes[16];
+	};
+
+	/**
+	 * @brief Hash function object for MusicBrainz5::CMBID
+	 */
+	struct CMBIDHash
+	{
+		size_t operator ()(const CMBID& MBID) const { return MBID.Hash(); }
+	};
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+namespace std
+{
+	template <>
+	struct hash<MusicBrainz5::CMBID>
+	{
+		size_t operator ()(const MusicBrainz5::CMBID& MBID) const { return MBID.Hash(); }
+	};
+}
+#endif
+
+std::ostream& operator << (std::ostream& os, const MusicBrainz5::CMBID& MBID);
+
+#endif
@@ -45,15 +45,21 @@ namespace MusicBrainz5
 		CMedium(const XMLNode& Node=XMLNode::emptyNode());
 		CMedium(const CMedium& Other);
 		CMedium& operator =(const CMedium& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CMedium(CMedium&& Other);
+		CMedium& operator =(CMedium&& Other);
+#endif
 		virtual ~CMedium();
 
 		virtual CMedium *Clone();
 
-		std::string Title() const;
+		const std::string& Title() const;
 		int Position() const;
-		std::string Format() const;
-		CDiscList *DiscList() const;
-		CTrackList *TrackList() const;
+		const std::string& Format() const;
+		const CDiscList *DiscList() const;
+		CDiscList *DiscList();
+		const CTrackList *TrackList() const;
+		CTrackList *TrackList();
 
 		bool ContainsDiscID(const std::string& DiscID) const;
 
@@ -65,9 +71,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CMediumPrivate * const m_d;
+		CMediumPrivate *m_d;
 	};
 }
 
@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CMediumList(const XMLNode& Node=XMLNode::emptyNode());
 		CMediumList(const CMediumList& Other);
 		CMediumList& operator =(const CMediumList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CMediumList(CMediumList&& Other);
+		CMediumList& operator =(CMediumList&& Other);
+#endif
 		virtual ~CMediumList();
 
 		virtual CMediumList *Clone();
@@ -58,7 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CMediumListPrivate * const m_d;
+		CMediumListPrivate *m_d;
 	};
 }
 
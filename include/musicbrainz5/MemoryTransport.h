@@ -0,0 +1,128 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_MEMORY_TRANSPORT_H
+#define _MUSICBRAINZ5_MEMORY_TRANSPORT_H
+
+#include <map>
+
+#include "musicbrainz5/Transport.h"
+
+namespace MusicBrainz5
+{
+	class CMemoryTransportPrivate;
+
+	/**
+	 * @brief Transport that serves canned responses without using the network
+	 *
+	 * Responses can either be added directly using AddResponse, or loaded on demand
+	 * from files in a directory. The file used to answer a request is named after
+	 * the request URL with the leading '/ws/2/' removed, any '/', '?' or '&' characters
+	 * replaced by '_' and '.xml' appended. For example, the response to
+	 * '/ws/2/release/ID?inc=artists' is read from 'release_ID_inc=artists.xml'.
+	 *
+	 * Requests that can't be answered result in a 404 (resource not found) error.
+	 * Collection edits (PUT and DELETE requests) are only answered by queued
+	 * responses, and otherwise succeed with an empty body.
+	 * Responses are served exactly as added, so the compression setting is ignored.
+	 *
+	 * Responses may be added while other threads are making requests.
+	 */
+	class CMemoryTransport: public CTransport
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param Directory Directory to load responses from. If empty, only
+		 *		responses added using AddResponse will be served.
+		 */
+
+		CMemoryTransport(const std::string& Directory="");
+		virtual ~CMemoryTransport();
+
+		virtual CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+		/**
+		 * @brief Add a response
+		 *
+		 * Add a response to be served for the specified URL. This takes precedence
+		 * over any response loaded from the directory.
+		 *
+		 * @param URL URL to serve the response for (e.g. /ws/2/release/ID)
+		 * @param Body Body of the response
+		 * @param Status HTTP status code of the response
+		 */
+
+		void AddResponse(const std::string& URL, const std::string& Body, int Status=200);
+
+		/**
+		 * @brief Queue a response to be served once
+		 *
+		 * Queue a response to be served for the next request for the specified URL.
+		 * Queued responses are served in the order they were queued, each only once,
+		 * and take precedence over responses added using AddResponse. This allows a
+		 * sequence of responses, such as a 503 (service unavailable) followed by a
+		 * success, to be served.
+		 *
+		 * @param URL URL to serve the response for (e.g. /ws/2/release/ID)
+		 * @param Body Body of the response
+		 * @param Status HTTP status code of the response
+		 * @param Headers Headers of the response (e.g. Retry-After or ETag)
+		 */
+
+		void QueueResponse(const std::string& URL, const std::string& Body, int Status=200,
+				const std::map<std::string,std::string>& Headers=std::map<std::string,std::string>());
+
+		/**
+		 * @brief Number of requests served
+		 *
+		 * @return Number of GET requests made through this transport
+		 */
+
+		int NumRequests() const;
+
+		/**
+		 * @brief Return the file name a response is loaded from
+		 *
+		 * @param URL URL of the request
+		 *
+		 * @return Name of the file, relative to the directory
+		 */
+
+		static std::string FileName(const std::string& URL);
+
+	private:
+		friend class CMemoryFetch;
+
+		CMemoryTransportPrivate * const m_d;
+
+		bool Response(const std::string& URL, const std::string& Request, std::string& Body, int& Status, std::map<std::string,std::string>& Headers);
+	};
+}
+
+#endif
@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CMessage(const XMLNode& Node);
 		CMessage(const CMessage& Other);
 		CMessage& operator =(const CMessage& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CMessage(CMessage&& Other);
+		CMessage& operator =(CMessage&& Other);
+#endif
 		virtual ~CMessage();
 
 		virtual CMessage *Clone();
 
-		std::string Text() const;
+		const std::string& Text() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,7 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CMessagePrivate * const m_d;
+		CMessagePrivate *m_d;
 	};
 }
 
@@ -72,42 +72,74 @@ namespace MusicBrainz5
 		CMetadata(const XMLNode& Node=XMLNode::emptyNode());
 		CMetadata(const CMetadata& Other);
 		CMetadata& operator =(const CMetadata& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CMetadata(CMetadata&& Other);
+		CMetadata& operator =(CMetadata&& Other);
+#endif
 		virtual ~CMetadata();
 
 		virtual CMetadata *Clone();
 
-		std::string XMLNS() const;
-		std::string XMLNSExt() const;
-		std::string Generator() const;
-		std::string Created() const;
-		CArtist *Artist() const;
-		CRelease *Release() const;
-		CReleaseGroup *ReleaseGroup() const;
-		CRecording *Recording() const;
-		CLabel *Label() const;
-		CWork *Work() const;
-		CPUID *PUID() const;
-		CISRC *ISRC() const;
-		CDisc *Disc() const;
-		CLabelInfoList *LabelInfoList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
-		CCollection *Collection() const;
-		CArtistList *ArtistList() const;
-		CReleaseList *ReleaseList() const;
-		CReleaseGroupList *ReleaseGroupList() const;
-		CRecordingList *RecordingList() const;
-		CLabelList *LabelList() const;
-		CWorkList *WorkList() const;
-		CISRCList *ISRCList() const;
-		CAnnotationList *AnnotationList() const;
-		CCDStubList *CDStubList() const;
-		CFreeDBDiscList *FreeDBDiscList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CCollectionList *CollectionList() const;
-		CCDStub *CDStub() const;
-		CMessage *Message() const;
+		const std::string& XMLNS() const;
+		const std::string& XMLNSExt() const;
+		const std::string& Generator() const;
+		const std::string& Created() const;
+		const CArtist *Artist() const;
+		CArtist *Artist();
+		const CRelease *Release() const;
+		CRelease *Release();
+		const CReleaseGroup *ReleaseGroup() const;
+		CReleaseGroup *ReleaseGroup();
+		const CRecording *Recording() const;
+		CRecording *Recording();
+		const CLabel *Label() const;
+		CLabel *Label();
+		const CWork *Work() const;
+		CWork *Work();
+		const CPUID *PUID() const;
+		CPUID *PUID();
+		const CISRC *ISRC() const;
+		CISRC *ISRC();
+		const CDisc *Disc() const;
+		CDisc *Disc();
+		const CLabelInfoList *LabelInfoList() const;
+		CLabelInfoList *LabelInfoList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
+		const CCollection *Collection() const;
+		CCollection *Collection();
+		const CArtistList *ArtistList() const;
+		CArtistList *ArtistList();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
+		const CReleaseGroupList *ReleaseGroupList() const;
+		CReleaseGroupList *ReleaseGroupList();
+		const CRecordingList *RecordingList() const;
+		CRecordingList *RecordingList();
+		const CLabelList *LabelList() const;
+		CLabelList *LabelList();
+		const CWorkList *WorkList() const;
+		CWorkList *WorkList();
+		const CISRCList *ISRCList() const;
+		CISRCList *ISRCList();
+		const CAnnotationList *AnnotationList() const;
+		CAnnotationList *AnnotationList();
+		const CCDStubList *CDStubList() const;
+		CCDStubList *CDStubList();
+		const CFreeDBDiscList *FreeDBDiscList() const;
+		CFreeDBDiscList *FreeDBDiscList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CCollectionList *CollectionList() const;
+		CCollectionList *CollectionList();
+		const CCDStub *CDStub() const;
+		CCDStub *CDStub();
+		const CMessage *Message() const;
+		CMessage *Message();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -117,9 +149,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CMetadataPrivate * const m_d;
+		CMetadataPrivate *m_d;
 	};
 }
 
@@ -45,13 +45,18 @@ namespace MusicBrainz5
 		CNameCredit(const XMLNode& Node=XMLNode::emptyNode());
 		CNameCredit(const CNameCredit& Other);
 		CNameCredit& operator =(const CNameCredit& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CNameCredit(CNameCredit&& Other);
+		CNameCredit& operator =(CNameCredit&& Other);
+#endif
 		virtual ~CNameCredit();
 
 		virtual CNameCredit *Clone();
 
-		std::string JoinPhrase() const;
-		std::string Name() const;
-		CArtist *Artist() const;
+		const std::string& JoinPhrase() const;
+		const std::string& Name() const;
+		const CArtist *Artist() const;
+		CArtist *Artist();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -61,9 +66,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CNameCreditPrivate * const m_d;
+		CNameCreditPrivate *m_d;
 	};
 }
 
@@ -43,12 +43,16 @@ namespace MusicBrainz5
 		CNonMBTrack(const XMLNode& Node);
 		CNonMBTrack(const CNonMBTrack& Other);
 		CNonMBTrack& operator =(const CNonMBTrack& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CNonMBTrack(CNonMBTrack&& Other);
+		CNonMBTrack& operator =(CNonMBTrack&& Other);
+#endif
 		virtual ~CNonMBTrack();
 
 		virtual CNonMBTrack *Clone();
 
-		std::string Title() const;
-		std::string Artist() const;
+		const std::string& Title() const;
+		const std::string& Artist() const;
 		int Length() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
@@ -59,7 +63,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CNonMBTrackPrivate * const m_d;
+		CNonMBTrackPrivate *m_d;
 	};
 }
 
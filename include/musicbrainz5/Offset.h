@@ -43,6 +43,10 @@ namespace MusicBrainz5
 		COffset(const XMLNode& Node=XMLNode::emptyNode());
 		COffset(const COffset& Other);
 		COffset& operator =(const COffset& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		COffset(COffset&& Other);
+		COffset& operator =(COffset&& Other);
+#endif
 		virtual ~COffset();
 
 		virtual COffset *Clone();
@@ -58,9 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		COffsetPrivate * const m_d;
+		COffsetPrivate *m_d;
 	};
 }
 
@@ -43,12 +43,17 @@ namespace MusicBrainz5
 		CPUID(const XMLNode& Node=XMLNode::emptyNode());
 		CPUID(const CPUID& Other);
 		CPUID& operator =(const CPUID& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CPUID(CPUID&& Other);
+		CPUID& operator =(CPUID&& Other);
+#endif
 		virtual ~CPUID();
 
 		virtual CPUID *Clone();
 
-		std::string ID() const;
-		CRecordingList *RecordingList() const;
+		const std::string& ID() const;
+		const CRecordingList *RecordingList() const;
+		CRecordingList *RecordingList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -58,9 +63,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CPUIDPrivate * const m_d;
+		CPUIDPrivate *m_d;
 	};
 }
 
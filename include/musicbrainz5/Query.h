@@ -158,6 +158,20 @@ catch (MusicBrainz5::CResourceNotFoundError& Error)
 namespace MusicBrainz5
 {
 	class CQueryPrivate;
+	class CLookupResult;
+	class CLookupResultPrivate;
+	class CQueryBatch;
+	class CQueryCallback;
+	class CQueryFuture;
+	class CQueryFuturePrivate;
+	class CQueryExecutor;
+	class CQueryTask;
+	class CInFlightQuery;
+	class CTransport;
+	class CFetch;
+	class CRateLimiter;
+	class CResponseCache;
+	class CDiskCache;
 
 	/**
 	 * @brief Main object for generating queries to MusicBrainz
@@ -181,6 +195,17 @@ namespace MusicBrainz5
 	 * with the library. The caller should not delete any pointer returned from the
 	 * library. Users of the C library should take note of the documentation for each
 	 * individual function in mb5_c.h
+	 *
+	 * @b Note Once it has been configured, a CQuery object may be used to make queries
+	 * from several threads at once. The status of each query is returned by Lookup in a
+	 * MusicBrainz5::CLookupResult, and the Last* functions report the status of the
+	 * last query made by the calling thread. The Set* functions must not be called
+	 * while queries are in progress.
+	 *
+	 * If a thread makes a query while the same query (after its parameters have been
+	 * normalised, as for MusicBrainz5::CResponseCache::Key) is already being made by
+	 * another thread, it waits for that query to finish and shares its result, rather
+	 * than sending the request again.
 	 */
 	class CQuery
 	{
@@ -218,6 +243,28 @@ namespace MusicBrainz5
 
 		CQuery(const std::string& UserAgent, const std::string& Server="musicbrainz.org", int Port=80);
 
+		/**
+		 * @brief Constructor for MusicBrainz::CQuery object using a specific transport
+		 *
+		 * This is the constructor for the MusicBrainz::CQuery object, specifying the
+		 * transport to use to make requests. This allows, for example, queries to be
+		 * answered from canned responses using MusicBrainz5::CMemoryTransport, or the
+		 * requests of several threads to share connections using
+		 * MusicBrainz5::CFetchEngineTransport.
+		 *
+		 * @param UserAgent User agent to use in any queries and submissions. The format
+		 * 		is @c "application-version", where application is your application's name
+		 *		and version is a version number which may not contain a '-' character.
+		 * @param Transport Transport to use. Ownership remains with the caller, and the
+		 *		transport must not be deleted before this object. If NULL, the default
+		 *		HTTP transport is used.
+		 * @param Server Server to be used (defaults to musicbrainz.org if not specified)
+		 * @param Port Port to use (defaults to 80 if not specified)
+		 *
+		 */
+
+		CQuery(const std::string& UserAgent, CTransport *Transport, const std::string& Server="musicbrainz.org", int Port=80);
+
 		~CQuery();
 
 		/**
@@ -288,6 +335,126 @@ namespace MusicBrainz5
 
 		void SetProxyPassword(const std::string& ProxyPassword);
 
+		/**
+		 * @brief Set the maximum number of idle connections
+		 *
+		 * Set the maximum number of idle (keep-alive) connections to the server that
+		 * will be kept open between queries. Reusing an open connection avoids a DNS
+		 * lookup and TCP handshake for each query. Setting this to 0 will cause a new
+		 * connection to be made for every query. The default is 4. This only applies
+		 * to the default HTTP transport.
+		 *
+		 * @param MaxIdleConnections Maximum number of idle connections
+		 */
+
+		void SetMaxIdleConnections(int MaxIdleConnections);
+
+		/**
+		 * @brief Set the idle connection timeout
+		 *
+		 * Set the number of seconds after which an idle connection to the server will
+		 * be closed. The default is 30 seconds.
+		 *
+		 * @param IdleTimeout Idle timeout in seconds
+		 */
+
+		void SetConnectionIdleTimeout(int IdleTimeout);
+
+		/**
+		 * @brief Set the rate limiter to use
+		 *
+		 * Set the rate limiter used to space out requests to the server. By default
+		 * the process wide limiter returned by MusicBrainz5::CRateLimiter::Default is
+		 * used, which is shared by all CQuery objects.
+		 *
+		 * @param RateLimiter Rate limiter to use. Ownership remains with the caller.
+		 *		Pass NULL to use the default limiter.
+		 */
+
+		void SetRateLimiter(CRateLimiter *RateLimiter);
+
+		/**
+		 * @brief Set the response cache to use
+		 *
+		 * Set a cache to hold the responses to queries, so that repeated queries are
+		 * answered without contacting the server. By default no cache is used.
+		 *
+		 * Queries that fail with CResourceNotFoundError are also recorded, in this cache
+		 * and in the disk cache, and fail again without contacting the server until the
+		 * cache's negative time to live has passed.
+		 *
+		 * @param ResponseCache Response cache to use. Ownership remains with the caller.
+		 *		Pass NULL to stop using a cache.
+		 */
+
+		void SetResponseCache(CResponseCache *ResponseCache);
+
+		/**
+		 * @brief Set the disk cache to use
+		 *
+		 * Set a persistent cache to hold the responses to queries. Queries not answered
+		 * by the response cache are looked for in the disk cache before contacting the
+		 * server, and responses found there are added to the response cache. By default
+		 * no disk cache is used.
+		 *
+		 * When a cached response has expired, it is revalidated with a conditional
+		 * request, and reused if the server replies that it hasn't changed.
+		 *
+		 * @param DiskCache Disk cache to use. Ownership remains with the caller.
+		 *		Pass NULL to stop using a disk cache.
+		 */
+
+		void SetDiskCache(CDiskCache *DiskCache);
+
+		/**
+		 * @brief Set whether expired responses are returned while they are refreshed
+		 *
+		 * When a query is answered by a response in the response or disk cache that
+		 * has expired, return it immediately rather than waiting for the server, and
+		 * fetch a new response in the background. The new response replaces the old
+		 * one in the caches, so the next query sees it. Background fetches use the
+		 * same threads as QueryAsync, and go through the rate limiter like any other
+		 * request. This is off by default.
+		 *
+		 * @param ServeStale true to return expired responses
+		 * @param RefreshCallback Callback to call, from the background thread, when a
+		 *		background fetch returns a response that differs from the one that was
+		 *		returned. Ownership remains with the caller. May be NULL.
+		 *
+		 * @see MusicBrainz5::CLookupResult::Stale
+		 */
+
+		void SetServeStale(bool ServeStale, CQueryCallback *RefreshCallback=0);
+
+		/**
+		 * @brief Set the number of times to retry a busy server
+		 *
+		 * Set the number of times a query is retried when the server reports that
+		 * it is overloaded (HTTP status 503). Each retry waits for at least the delay
+		 * requested by the server, and for an exponentially increasing, randomised,
+		 * delay. The rate limiter is told about each rejection so it can slow down.
+		 *
+		 * @param MaxRetries Maximum number of retries (3 by default). Set to 0 to
+		 *		fail immediately.
+		 */
+
+		void SetMaxRetries(int MaxRetries);
+
+		/**
+		 * @brief Set whether to request compressed responses
+		 *
+		 * Ask the server to compress its responses (using gzip). Compressed responses
+		 * are decompressed as they are received. This is off by default.
+		 *
+		 * Only the default HTTP transport supports compression. MusicBrainz5::CSocketTransport,
+		 * MusicBrainz5::CFetchEngineTransport and MusicBrainz5::CMemoryTransport ignore
+		 * this setting.
+		 *
+		 * @param Compression true to request compressed responses
+		 */
+
+		void SetCompression(bool Compression);
+
 		/**
 		 * @brief Return a list of releases that match a disc ID
 		 *
@@ -319,6 +486,105 @@ namespace MusicBrainz5
 
 		CRelease LookupRelease(const std::string& ReleaseID);
 
+		/**
+		 * @brief Return full information about a number of releases
+		 *
+		 * Look up a number of releases, requesting the same information as LookupRelease.
+		 *
+		 * @param ReleaseIDs MusicBrainz release IDs to lookup
+		 *
+		 * @return Results of the lookups, in the same order as ReleaseIDs
+		 *
+		 * @see LookupBatch
+		 */
+
+		std::vector<CLookupResult> LookupReleases(const std::vector<std::string>& ReleaseIDs);
+
+		/**
+		 * @brief Look up a number of artists
+		 *
+		 * @param ArtistIDs MusicBrainz artist IDs to lookup
+		 * @param Params Map of parameters to add to each query (e.g. inc)
+		 *
+		 * @return Results of the lookups, in the same order as ArtistIDs
+		 *
+		 * @see LookupBatch
+		 */
+
+		std::vector<CLookupResult> LookupArtists(const std::vector<std::string>& ArtistIDs, const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Look up a number of recordings
+		 *
+		 * @param RecordingIDs MusicBrainz recording IDs to lookup
+		 * @param Params Map of parameters to add to each query (e.g. inc)
+		 *
+		 * @return Results of the lookups, in the same order as RecordingIDs
+		 *
+		 * @see LookupBatch
+		 */
+
+		std::vector<CLookupResult> LookupRecordings(const std::vector<std::string>& RecordingIDs, const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Look up a number of labels
+		 *
+		 * @param LabelIDs MusicBrainz label IDs to lookup
+		 * @param Params Map of parameters to add to each query (e.g. inc)
+		 *
+		 * @return Results of the lookups, in the same order as LabelIDs
+		 *
+		 * @see LookupBatch
+		 */
+
+		std::vector<CLookupResult> LookupLabels(const std::vector<std::string>& LabelIDs, const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Look up a number of works
+		 *
+		 * @param WorkIDs MusicBrainz work IDs to lookup
+		 * @param Params Map of parameters to add to each query (e.g. inc)
+		 *
+		 * @return Results of the lookups, in the same order as WorkIDs
+		 *
+		 * @see LookupBatch
+		 */
+
+		std::vector<CLookupResult> LookupWorks(const std::vector<std::string>& WorkIDs, const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Look up a number of entities
+		 *
+		 * Look up a number of entities of the same type. Each ID is only requested
+		 * once, however many times it appears. Requests are made from a number of
+		 * threads at once (see SetBatchConcurrency), so the time spent waiting for
+		 * one response overlaps with others, but the rate limiter is still respected.
+		 *
+		 * Errors don't throw exceptions. Instead, the status of each lookup is
+		 * recorded in its result. LastResult, LastHTTPCode and LastErrorMessage are
+		 * not updated.
+		 *
+		 * @param Entity Entity to lookup (e.g. artist, release)
+		 * @param IDs MusicBrainz IDs to lookup
+		 * @param Params Map of parameters to add to each query (e.g. inc)
+		 *
+		 * @return Results of the lookups, in the same order as IDs
+		 */
+
+		std::vector<CLookupResult> LookupBatch(const std::string& Entity, const std::vector<std::string>& IDs, const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Set the number of concurrent requests for batch lookups
+		 *
+		 * Set the number of requests that LookupBatch may have in progress at once.
+		 * The transport must support being used from several threads if this is
+		 * greater than 1.
+		 *
+		 * @param Concurrency Number of concurrent requests (4 by default)
+		 */
+
+		void SetBatchConcurrency(int Concurrency);
+
 		/**
 		 * @brief Perform a generic query
 		 *
@@ -336,6 +602,10 @@ namespace MusicBrainz5
 		 *
 		 * If any of ID or Resource are empty, those components will be omitted from the query.
 		 *
+		 * If Entity is looked up by MusicBrainz ID (e.g. artist or release) and ID is not a
+		 * valid MusicBrainz ID (see MusicBrainz5::CMBID::IsValid), CRequestError is thrown
+		 * without making a request. The same check is made by the other lookup functions.
+		 *
 		 * For full details about generating queries, see the
 		 * <a target="_blank" href="http://musicbrainz.org/doc/XML_Web_Service/Version_2">web service</a>
 		 * documentation.
@@ -357,6 +627,72 @@ namespace MusicBrainz5
 
 		CMetadata Query(const std::string& Entity,const std::string& ID="",const std::string& Resource="",const tParamMap& Params=tParamMap());
 
+		/**
+		 * @brief Perform a generic query, returning its status
+		 *
+		 * Perform the same query as Query, but return the status of the query along with
+		 * its result rather than throwing an exception if it fails. The status is not
+		 * recorded for the Last* functions, so this may safely be called from several
+		 * threads at once.
+		 *
+		 * @param Entity Entity to lookup (e.g. artist, release, discid)
+		 * @param ID The MusicBrainz ID of the entity
+		 * @param Resource The resource (currently only used for collections)
+		 * @param Params Map of parameters to add to the query (e.g. inc)
+		 *
+		 * @return Status and result of the query
+		 */
+
+		CLookupResult Lookup(const std::string& Entity,const std::string& ID="",const std::string& Resource="",const tParamMap& Params=tParamMap());
+
+		/**
+		 * @brief Perform a generic query without waiting for it to complete
+		 *
+		 * Queue a query to be performed by a background thread (see SetAsyncThreads),
+		 * and return immediately. The parameters are the same as for Query.
+		 *
+		 * @param Entity Entity to lookup (e.g. artist, release, discid)
+		 * @param ID The MusicBrainz ID of the entity
+		 * @param Resource The resource (currently only used for collections)
+		 * @param Params Map of parameters to add to the query (e.g. inc)
+		 * @param Callback Callback to call, from the background thread, when the query
+		 *		completes. Ownership remains with the caller. May be NULL.
+		 *
+		 * @return Handle that can be used to wait for and retrieve the result
+		 */
+
+		CQueryFuture QueryAsync(const std::string& Entity,const std::string& ID="",const std::string& Resource="",const tParamMap& Params=tParamMap(),CQueryCallback *Callback=0);
+
+		/**
+		 * @brief Return full information about a release without waiting
+		 *
+		 * Queue a lookup of a release, requesting the same information as LookupRelease,
+		 * and return immediately. The release is available from the metadata returned
+		 * by the handle.
+		 *
+		 * @param ReleaseID MusicBrainz release ID to lookup
+		 * @param Callback Callback to call, from the background thread, when the lookup
+		 *		completes. Ownership remains with the caller. May be NULL.
+		 *
+		 * @return Handle that can be used to wait for and retrieve the result
+		 */
+
+		CQueryFuture LookupReleaseAsync(const std::string& ReleaseID, CQueryCallback *Callback=0);
+
+		/**
+		 * @brief Set the number of threads used for asynchronous queries
+		 *
+		 * Set the maximum number of background threads used to perform queries made with
+		 * QueryAsync and LookupReleaseAsync. Threads are started as they are needed. Reducing
+		 * the number doesn't stop threads that have already been started.
+		 *
+		 * Any queries still waiting to start when the CQuery object is destroyed are cancelled.
+		 *
+		 * @param Threads Maximum number of threads (2 by default)
+		 */
+
+		void SetAsyncThreads(int Threads);
+
 		/**
 		 * @brief Add entries to the specified collection
 		 *
@@ -371,7 +707,7 @@ namespace MusicBrainz5
 		 * @throw CTimeoutError A timeout occurred when connecting to the web server
 		 * @throw CAuthenticationError An authentication error occurred
 		 * @throw CFetchError An error occurred fetching data
-		 * @throw CRequestError The request was invalid
+		 * @throw CRequestError The request was invalid, or an ID was not a valid MusicBrainz ID
 		 * @throw CResourceNotFoundError The requested resource was not found
 		 */
 
@@ -391,7 +727,7 @@ namespace MusicBrainz5
 		 * @throw CTimeoutError A timeout occurred when connecting to the web server
 		 * @throw CAuthenticationError An authentication error occurred
 		 * @throw CFetchError An error occurred fetching data
-		 * @throw CRequestError The request was invalid
+		 * @throw CRequestError The request was invalid, or an ID was not a valid MusicBrainz ID
 		 * @throw CResourceNotFoundError The requested resource was not found
 		 */
 
@@ -400,7 +736,7 @@ namespace MusicBrainz5
 		/**
 		 * @brief Return result of the last query
 		 *
-		 * Return the result of the last query
+		 * Return the result of the last query made by the calling thread
 		 *
 		 * @return Result of last query
 		 */
@@ -410,7 +746,7 @@ namespace MusicBrainz5
 		/**
 		 * @brief Return HTTP code of the last query
 		 *
-		 * Return the HTTP code of the last query
+		 * Return the HTTP code of the last query made by the calling thread
 		 *
 		 * @return HTTP code of last query
 		 */
@@ -419,12 +755,33 @@ namespace MusicBrainz5
 		/**
 		 * @brief Return error message from the last query
 		 *
-		 * Return the error message from the last query
+		 * Return the error message from the last query made by the calling thread
 		 *
 		 * @return Error message from last query
 		 */
 		std::string LastErrorMessage() const;
 
+		/**
+		 * @brief Return compressed size of the last response
+		 *
+		 * Return the number of bytes of response body received for the last query made by
+		 * the calling thread.
+		 * If the response was not compressed this is the same as LastUncompressedSize.
+		 *
+		 * @return Compressed size of the last response
+		 */
+		int LastCompressedSize() const;
+
+		/**
+		 * @brief Return uncompressed size of the last response
+		 *
+		 * Return the number of bytes of response body received for the last query made by
+		 * the calling thread, after decompression.
+		 *
+		 * @return Uncompressed size of the last response
+		 */
+		int LastUncompressedSize() const;
+
 		/**
 		 * @brief Return the library version
 		 *
@@ -435,15 +792,261 @@ namespace MusicBrainz5
 		std::string Version() const;
 
 	private:
+		friend class CQueryBatch;
+		friend class CQueryTask;
+
 		CQueryPrivate * const m_d;
 
+		CFetch *CreateFetch() const;
 		CMetadata PerformQuery(const std::string& Query);
+		CMetadata PerformQuery(const std::string& Query, CLookupResult& Result, bool Refresh=false);
+		CMetadata FetchQuery(const std::string& Query, const std::string& CacheKey, CLookupResult& Result, bool Refresh);
+		void FinishQuery(const std::string& Key, CInFlightQuery *InFlight, const CLookupResult& Result, const CMetadata& Metadata);
+		std::string RequestKey(const std::string& Query) const;
+		void SubmitTask(CQueryTask *Task);
+		void SubmitBatchTask(CQueryTask *Task);
+		void RefreshFinished(const std::string& Query);
 		void WaitRequest() const;
+		std::string BuildQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params);
 		std::string UserAgent() const;
 		bool EditCollection(const std::string& CollectionID, const std::vector<std::string>& Entries, const std::string& Action);
+		void ForgetCollection(const std::string& CollectionID);
 		std::string URIEscape(const std::string& URI);
 		std::string URLEncode(const std::map<std::string,std::string>& Params);
 	};
+
+	/**
+	 * @brief Status and result of a single query
+	 *
+	 * Returned by MusicBrainz5::CQuery::Lookup and MusicBrainz5::CQuery::LookupBatch, and
+	 * passed to asynchronous query callbacks.
+	 */
+	class CLookupResult
+	{
+	public:
+		CLookupResult(const std::string& ID="");
+		CLookupResult(const CLookupResult& Other);
+		CLookupResult& operator =(const CLookupResult& Other);
+		~CLookupResult();
+
+		/**
+		 * @brief ID looked up
+		 *
+		 * @return The MusicBrainz ID that was looked up
+		 */
+
+		std::string ID() const;
+
+		/**
+		 * @brief Result of the lookup
+		 *
+		 * @return Result of the lookup
+		 */
+
+		CQuery::tQueryResult Result() const;
+
+		/**
+		 * @brief HTTP status code
+		 *
+		 * @return HTTP status code of the response
+		 */
+
+		int HTTPCode() const;
+
+		/**
+		 * @brief Error message
+		 *
+		 * @return Description of the error, if the lookup failed
+		 */
+
+		std::string ErrorMessage() const;
+
+		/**
+		 * @brief Compressed size of the response
+		 *
+		 * @return Number of bytes of response body received
+		 */
+
+		int CompressedSize() const;
+
+		/**
+		 * @brief Uncompressed size of the response
+		 *
+		 * @return Number of bytes of response body after decompression
+		 */
+
+		int UncompressedSize() const;
+
+		/**
+		 * @brief Time spent waiting
+		 *
+		 * @return Number of seconds the query spent waiting for the rate limiter, and
+		 *		backing off before retries
+		 */
+
+		double WaitTime() const;
+
+		/**
+		 * @brief Time spent fetching
+		 *
+		 * @return Number of seconds the query spent making requests and parsing responses
+		 */
+
+		double FetchTime() const;
+
+		/**
+		 * @brief Total time taken
+		 *
+		 * @return Number of seconds the query took in total
+		 */
+
+		double TotalTime() const;
+
+		/**
+		 * @brief Number of retries
+		 *
+		 * @return Number of times the request was retried because the server was overloaded
+		 */
+
+		int Retries() const;
+
+		/**
+		 * @brief Whether the response came from the cache
+		 *
+		 * @return true if the query was answered from the response cache, either
+		 *		without contacting the server or because the server reported that an
+		 *		expired response hadn't changed
+		 *
+		 * @see MusicBrainz5::CQuery::SetResponseCache
+		 */
+
+		bool Cached() const;
+
+		/**
+		 * @brief Whether the response had expired
+		 *
+		 * @return true if an expired response was returned from the cache while a new
+		 *		one is fetched in the background
+		 *
+		 * @see MusicBrainz5::CQuery::SetServeStale
+		 */
+
+		bool Stale() const;
+
+		/**
+		 * @brief Metadata returned
+		 *
+		 * @return The metadata returned by the lookup. This will be empty if the lookup failed.
+		 */
+
+		CMetadata Metadata() const;
+
+	private:
+		friend class CQuery;
+		friend class CQueryBatch;
+		friend class CQueryTask;
+
+		CLookupResultPrivate * const m_d;
+	};
+
+	/**
+	 * @brief Interface for receiving notification of completed asynchronous queries
+	 *
+	 * @see MusicBrainz5::CQuery::QueryAsync
+	 */
+	class CQueryCallback
+	{
+	public:
+		virtual ~CQueryCallback();
+
+		/**
+		 * @brief Called when a query completes
+		 *
+		 * Called from a background thread when a query completes, successfully or not.
+		 *
+		 * @param Result Result of the query
+		 */
+
+		virtual void Completed(const CLookupResult& Result)=0;
+	};
+
+	/**
+	 * @brief Handle to the result of an asynchronous query
+	 *
+	 * Returned by MusicBrainz5::CQuery::QueryAsync. Copies of a handle all refer to
+	 * the same query. A handle remains valid after the query it refers to has
+	 * completed, and after the MusicBrainz5::CQuery object has been destroyed.
+	 */
+	class CQueryFuture
+	{
+	public:
+		CQueryFuture();
+		CQueryFuture(const CQueryFuture& Other);
+		CQueryFuture& operator =(const CQueryFuture& Other);
+		~CQueryFuture();
+
+		/**
+		 * @brief Whether the handle refers to a query
+		 *
+		 * @return true if the handle refers to a query, false if it was default constructed
+		 */
+
+		bool Valid() const;
+
+		/**
+		 * @brief Whether the query has completed
+		 *
+		 * @return true if the query has completed
+		 */
+
+		bool Ready() const;
+
+		/**
+		 * @brief Wait for the query to complete
+		 *
+		 * @param Timeout Maximum number of milliseconds to wait, or -1 to wait until
+		 *		the query completes
+		 *
+		 * @return true if the query has completed
+		 */
+
+		bool Wait(int Timeout=-1) const;
+
+		/**
+		 * @brief Status of the query
+		 *
+		 * Wait for the query to complete, and return its status and metadata.
+		 *
+		 * @return Result of the query
+		 */
+
+		CLookupResult Result() const;
+
+		/**
+		 * @brief Metadata returned by the query
+		 *
+		 * Wait for the query to complete, and return its metadata. If the query
+		 * failed, the exception that the equivalent synchronous call would have thrown
+		 * is thrown.
+		 *
+		 * @return MusicBrainz5::CMetadata object
+		 *
+		 * @throw CConnectionError An error occurred connecting to the web server
+		 * @throw CTimeoutError A timeout occurred when connecting to the web server
+		 * @throw CAuthenticationError An authentication error occurred
+		 * @throw CFetchError An error occurred fetching data
+		 * @throw CRequestError The request was invalid
+		 * @throw CResourceNotFoundError The requested resource was not found
+		 */
+
+		CMetadata Get() const;
+
+	private:
+		friend class CQuery;
+		friend class CQueryTask;
+
+		CQueryFuturePrivate *m_d;
+	};
 }
 
 #endif
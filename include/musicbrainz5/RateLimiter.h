@@ -0,0 +1,227 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_RATE_LIMITER_H
+#define _MUSICBRAINZ5_RATE_LIMITER_H
+
+#include <string>
+
+namespace MusicBrainz5
+{
+	class CRateLimiterPrivate;
+
+	/**
+	 * @brief Thread safe, per host, request rate limiter
+	 *
+	 * Limits the rate at which requests are made to a host using a token bucket.
+	 * Each host with a limit has a bucket holding up to a burst size of tokens,
+	 * which refills at the configured number of requests per second. A request
+	 * takes one token, and must wait until one is available if the bucket is empty.
+	 *
+	 * A limit applies to the host it is set for and to any of its sub-domains, so a
+	 * limit set for 'musicbrainz.org' also applies to 'test.musicbrainz.org'. These
+	 * hosts then share a single bucket. Hosts without a limit are not limited.
+	 *
+	 * A limiter may be shared between threads and between MusicBrainz5::CQuery objects.
+	 * By default, every MusicBrainz5::CQuery uses the limiter returned by Default.
+	 *
+	 * The rate for a host adapts to the server's responses. Each time the server reports
+	 * that it is overloaded (see Throttled) the rate is halved, and each successful
+	 * request (see Succeeded) adds back a tenth of the configured rate, until the
+	 * configured rate is reached again.
+	 *
+	 * Limiters in different processes can share their buckets by calling SetSharedFile
+	 * with the same file. The state of each bucket is then kept in the memory mapped
+	 * file and updated atomically, so all processes on a machine draw from a single
+	 * budget for each host, and all slow down when any one of them is throttled. Each
+	 * process must still set the limits it wants to apply, and never exceeds its own
+	 * limit.
+	 */
+	class CRateLimiter
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Construct a limiter with no limits set
+		 */
+
+		CRateLimiter();
+		virtual ~CRateLimiter();
+
+		/**
+		 * @brief The process wide limiter
+		 *
+		 * Return the limiter used by default by all MusicBrainz5::CQuery objects. This
+		 * initially limits requests to 'musicbrainz.org' to one every two seconds.
+		 *
+		 * @return The process wide limiter
+		 */
+
+		static CRateLimiter& Default();
+
+		/**
+		 * @brief Set the limit for a host
+		 *
+		 * Set the rate at which requests may be made to a host and its sub-domains.
+		 * The bucket for the host starts full.
+		 *
+		 * @param Host Host to limit
+		 * @param RequestsPerSecond Sustained number of requests allowed per second.
+		 *		A value of zero or less removes the limit.
+		 * @param Burst Number of requests that may be made back to back before the
+		 *		sustained rate applies
+		 */
+
+		void SetLimit(const std::string& Host, double RequestsPerSecond, int Burst=1);
+
+		/**
+		 * @brief Remove the limit for a host
+		 *
+		 * @param Host Host to remove the limit for
+		 */
+
+		void RemoveLimit(const std::string& Host);
+
+		/**
+		 * @brief Reserve a request
+		 *
+		 * Reserve the next available slot for a request to a host. The reservation is
+		 * made immediately, so the caller must make its request once the returned
+		 * delay has elapsed.
+		 *
+		 * @param Host Host the request will be made to
+		 *
+		 * @return Number of seconds the caller must wait before making its request,
+		 *		or 0 if it may go immediately
+		 */
+
+		double Reserve(const std::string& Host);
+
+		/**
+		 * @brief Try to make a request without waiting
+		 *
+		 * Take a token for a host only if one is available now.
+		 *
+		 * @param Host Host the request will be made to
+		 *
+		 * @return true if the request may be made immediately, false if the caller
+		 *		would need to wait (in which case no reservation is made)
+		 */
+
+		bool TryAcquire(const std::string& Host);
+
+		/**
+		 * @brief Wait until a request may be made
+		 *
+		 * Reserve a slot for a request to a host and sleep until it arrives.
+		 *
+		 * @param Host Host the request will be made to
+		 */
+
+		void Acquire(const std::string& Host);
+
+		/**
+		 * @brief Report that the server is overloaded
+		 *
+		 * Report that a request to a host was rejected because the server is overloaded
+		 * (for example, with HTTP status 503). This halves the current rate for the host,
+		 * and holds back further requests until the server's retry delay has passed.
+		 *
+		 * @param Host Host the request was made to
+		 * @param RetryAfter Number of seconds the server asked the client to wait for
+		 *		(from its Retry-After header), or 0 if it didn't specify
+		 */
+
+		void Throttled(const std::string& Host, double RetryAfter=0);
+
+		/**
+		 * @brief Report a successful request
+		 *
+		 * Report that a request to a host succeeded. This increases the current rate for
+		 * the host if it has previously been reduced by Throttled.
+		 *
+		 * @param Host Host the request was made to
+		 */
+
+		void Succeeded(const std::string& Host);
+
+		/**
+		 * @brief Current rate for a host
+		 *
+		 * @param Host Host to return the rate for
+		 *
+		 * @return Number of requests per second currently allowed to the host, or 0 if
+		 *		the host is not limited
+		 */
+
+		double Rate(const std::string& Host) const;
+
+		/**
+		 * @brief Share buckets with other processes
+		 *
+		 * Keep the state of all buckets in the specified file, which is created if
+		 * it doesn't exist. Every process that uses the same file shares the request
+		 * budget for each host.
+		 *
+		 * @param FileName File to keep the shared state in
+		 *
+		 * @return true if the file could be used, false if it couldn't be opened or
+		 *		mapped (in which case the limiter continues to use its own state)
+		 */
+
+		bool SetSharedFile(const std::string& FileName);
+
+		/**
+		 * @brief Shared state file
+		 *
+		 * @return File the limiter shares its state through, or an empty string if
+		 *		the state is private to this limiter
+		 */
+
+		std::string SharedFile() const;
+
+	protected:
+		/**
+		 * @brief Current time
+		 *
+		 * Return the time used to schedule requests. Limiters sharing a file must all
+		 * use the same clock.
+		 *
+		 * @return Number of seconds since an arbitrary point, from a clock that
+		 *		never goes backwards
+		 */
+
+		virtual double Now() const;
+
+	private:
+		CRateLimiterPrivate * const m_d;
+
+		CRateLimiter(const CRateLimiter&);
+		CRateLimiter& operator =(const CRateLimiter&);
+	};
+}
+
+#endif
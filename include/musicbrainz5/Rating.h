@@ -42,6 +42,10 @@ namespace MusicBrainz5
 		CRating(const XMLNode& Node=XMLNode::emptyNode());
 		CRating(const CRating& Other);
 		CRating& operator =(const CRating& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRating(CRating&& Other);
+		CRating& operator =(CRating&& Other);
+#endif
 		virtual ~CRating();
 
 		virtual CRating *Clone();
@@ -57,7 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CRatingPrivate * const m_d;
+		CRatingPrivate *m_d;
 	};
 }
 
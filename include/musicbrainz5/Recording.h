@@ -35,6 +35,7 @@ namespace MusicBrainz5
 }
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/PUIDList.h"
 #include "musicbrainz5/ISRCList.h"
@@ -58,23 +59,37 @@ namespace MusicBrainz5
 		CRecording(const XMLNode& Node=XMLNode::emptyNode());
 		CRecording(const CRecording& Other);
 		CRecording& operator =(const CRecording& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRecording(CRecording&& Other);
+		CRecording& operator =(CRecording&& Other);
+#endif
 		virtual ~CRecording();
 
 		virtual CRecording *Clone();
 
-		std::string ID() const;
-		std::string Title() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Title() const;
 		int Length() const;
-		std::string Disambiguation() const;
-		CArtistCredit *ArtistCredit() const;
-		CReleaseList *ReleaseList() const;
-		CPUIDList *PUIDList() const;
-		CISRCList *ISRCList() const;
-		CRelationListList *RelationListList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
+		const std::string& Disambiguation() const;
+		const CArtistCredit *ArtistCredit() const;
+		CArtistCredit *ArtistCredit();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
+		const CPUIDList *PUIDList() const;
+		CPUIDList *PUIDList();
+		const CISRCList *ISRCList() const;
+		CISRCList *ISRCList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -84,9 +99,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CRecordingPrivate * const m_d;
+		CRecordingPrivate *m_d;
 	};
 }
 
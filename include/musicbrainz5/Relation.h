@@ -30,6 +30,7 @@
 #include <iostream>
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/AttributeList.h"
 
 #include "musicbrainz5/xmlParser.h"
@@ -51,23 +52,35 @@ namespace MusicBrainz5
 		CRelation(const XMLNode& Node=XMLNode::emptyNode());
 		CRelation(const CRelation& Other);
 		CRelation& operator =(const CRelation& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRelation(CRelation&& Other);
+		CRelation& operator =(CRelation&& Other);
+#endif
 		virtual ~CRelation();
 
 		virtual CRelation *Clone();
 
-		std::string Type() const;
-		std::string Target() const;
-		std::string Direction() const;
-		CAttributeList *AttributeList() const;
-		std::string Begin() const;
-		std::string End() const;
-		std::string Ended() const;
-		CArtist *Artist() const;
-		CRelease *Release() const;
-		CReleaseGroup *ReleaseGroup() const;
-		CRecording *Recording() const;
-		CLabel *Label() const;
-		CWork *Work() const;
+		const std::string& Type() const;
+		const std::string& Target() const;
+		CMBID TargetMBID() const;
+		const std::string& Direction() const;
+		const CAttributeList *AttributeList() const;
+		CAttributeList *AttributeList();
+		const std::string& Begin() const;
+		const std::string& End() const;
+		const std::string& Ended() const;
+		const CArtist *Artist() const;
+		CArtist *Artist();
+		const CRelease *Release() const;
+		CRelease *Release();
+		const CReleaseGroup *ReleaseGroup() const;
+		CReleaseGroup *ReleaseGroup();
+		const CRecording *Recording() const;
+		CRecording *Recording();
+		const CLabel *Label() const;
+		CLabel *Label();
+		const CWork *Work() const;
+		CWork *Work();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -77,9 +90,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CRelationPrivate * const m_d;
+		CRelationPrivate *m_d;
 	};
 }
 
@@ -44,11 +44,15 @@ namespace MusicBrainz5
 		CRelationList(const XMLNode& Node);
 		CRelationList(const CRelationList& Other);
 		CRelationList& operator =(const CRelationList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRelationList(CRelationList&& Other);
+		CRelationList& operator =(CRelationList&& Other);
+#endif
 		virtual ~CRelationList();
 
 		virtual CRelationList *Clone();
 
-		std::string TargetType() const;
+		const std::string& TargetType() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -58,7 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CRelationListPrivate * const m_d;
+		CRelationListPrivate *m_d;
 	};
 }
 
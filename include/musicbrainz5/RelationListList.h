@@ -28,8 +28,13 @@
 
 #include <iostream>
 
+#include "musicbrainz5/defines.h"
 #include "musicbrainz5/xmlParser.h"
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+#include <utility>
+#endif
+
 namespace MusicBrainz5
 {
 	class CRelationListListPrivate;
@@ -42,20 +47,23 @@ namespace MusicBrainz5
 		CRelationListList();
 		CRelationListList(const CRelationListList& Other);
 		CRelationListList& operator =(const CRelationListList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRelationListList(CRelationListList&& Other);
+		CRelationListList& operator =(CRelationListList&& Other);
+#endif
 		virtual ~CRelationListList();
 
 		void Add(CRelationList *RelationList);
 		int NumItems() const;
-		CRelationList *Item(int Item) const;
+		const CRelationList *Item(int Item) const;
+		CRelationList *Item(int Item);
 		int Offset() const { return 0; }
 		int Count() const { return NumItems(); }
 
 		std::ostream& Serialise(std::ostream& os) const;
 
 	private:
-		void Cleanup();
-
-		CRelationListListPrivate * const m_d;
+		CRelationListListPrivate *m_d;
 	};
 }
 
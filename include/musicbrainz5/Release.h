@@ -27,6 +27,7 @@
 #define _MUSICBRAINZ5_RELEASE_H
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/LabelInfoList.h"
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/MediumList.h"
@@ -52,27 +53,39 @@ namespace MusicBrainz5
 		CRelease(const XMLNode& Node=XMLNode::emptyNode());
 		CRelease(const CRelease& Other);
 		CRelease& operator =(const CRelease& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CRelease(CRelease&& Other);
+		CRelease& operator =(CRelease&& Other);
+#endif
 		virtual ~CRelease();
 
 		virtual CRelease *Clone();
 
-		std::string ID() const;
-		std::string Title() const;
-		std::string Status() const;
-		std::string Quality() const;
-		std::string Disambiguation() const;
-		std::string Packaging() const;
-		CTextRepresentation *TextRepresentation() const;
-		CArtistCredit *ArtistCredit() const;
-		CReleaseGroup *ReleaseGroup() const;
-		std::string Date() const;
-		std::string Country() const;
-		std::string Barcode() const;
-		std::string ASIN() const;
-		CLabelInfoList *LabelInfoList() const;
-		CMediumList *MediumList() const;
-		CRelationListList *RelationListList() const;
-		CCollectionList *CollectionList() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Title() const;
+		const std::string& Status() const;
+		const std::string& Quality() const;
+		const std::string& Disambiguation() const;
+		const std::string& Packaging() const;
+		const CTextRepresentation *TextRepresentation() const;
+		CTextRepresentation *TextRepresentation();
+		const CArtistCredit *ArtistCredit() const;
+		CArtistCredit *ArtistCredit();
+		const CReleaseGroup *ReleaseGroup() const;
+		CReleaseGroup *ReleaseGroup();
+		const std::string& Date() const;
+		const std::string& Country() const;
+		const std::string& Barcode() const;
+		const std::string& ASIN() const;
+		const CLabelInfoList *LabelInfoList() const;
+		CLabelInfoList *LabelInfoList();
+		const CMediumList *MediumList() const;
+		CMediumList *MediumList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CCollectionList *CollectionList() const;
+		CCollectionList *CollectionList();
 
 		CMediumList MediaMatchingDiscID(const std::string& DiscID) const;
 
@@ -84,9 +97,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CReleasePrivate * const m_d;
+		CReleasePrivate *m_d;
 	};
 }
 
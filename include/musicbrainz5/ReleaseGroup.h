@@ -30,6 +30,7 @@
 #include <iostream>
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/TagList.h"
@@ -53,23 +54,36 @@ namespace MusicBrainz5
 		CReleaseGroup(const XMLNode& Node=XMLNode::emptyNode());
 		CReleaseGroup(const CReleaseGroup& Other);
 		CReleaseGroup& operator =(const CReleaseGroup& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CReleaseGroup(CReleaseGroup&& Other);
+		CReleaseGroup& operator =(CReleaseGroup&& Other);
+#endif
 		virtual ~CReleaseGroup();
 
 		virtual CReleaseGroup *Clone();
 
-		std::string ID() const;
-		std::string PrimaryType() const;
-		std::string Title() const;
-		std::string Disambiguation() const;
-		std::string FirstReleaseDate() const;
-		CArtistCredit *ArtistCredit() const;
-		CReleaseList *ReleaseList() const;
-		CRelationListList *RelationListList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
-		CSecondaryTypeList *SecondaryTypeList() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& PrimaryType() const;
+		const std::string& Title() const;
+		const std::string& Disambiguation() const;
+		const std::string& FirstReleaseDate() const;
+		const CArtistCredit *ArtistCredit() const;
+		CArtistCredit *ArtistCredit();
+		const CReleaseList *ReleaseList() const;
+		CReleaseList *ReleaseList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
+		const CSecondaryTypeList *SecondaryTypeList() const;
+		CSecondaryTypeList *SecondaryTypeList();
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -79,9 +93,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CReleaseGroupPrivate * const m_d;
+		CReleaseGroupPrivate *m_d;
 	};
 }
 
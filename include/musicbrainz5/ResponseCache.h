@@ -0,0 +1,324 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_RESPONSE_CACHE_H
+#define _MUSICBRAINZ5_RESPONSE_CACHE_H
+
+#include <string>
+
+#include "musicbrainz5/Metadata.h"
+
+namespace MusicBrainz5
+{
+	class CResponseCachePrivate;
+
+	/**
+	 * @brief Thread safe, size bounded, cache of query responses
+	 *
+	 * Holds the parsed responses to recent queries, so that repeated lookups of the same
+	 * entity don't need to go to the server. When the cache is full, the least recently
+	 * used responses are discarded to make room for new ones. Responses expire once they
+	 * have been in the cache for longer than the time to live.
+	 *
+	 * Expired responses are kept, along with the ETag and Last-Modified headers they
+	 * were received with, so that they can be revalidated with a conditional request
+	 * and reused if the server reports that they haven't changed.
+	 *
+	 * Requests for entities that don't exist (those that fail with
+	 * MusicBrainz5::CResourceNotFoundError) can also be recorded, so that they fail
+	 * without contacting the server until the negative time to live has passed.
+	 *
+	 * Responses are stored against a key identifying the request, as returned by Key.
+	 * Queries which only differ in the order of their parameters, or the order of the
+	 * values in their inc parameter, share the same key.
+	 *
+	 * A cache may be shared between threads and between MusicBrainz5::CQuery objects.
+	 *
+	 * @see MusicBrainz5::CQuery::SetResponseCache
+	 */
+	class CResponseCache
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param MaxSize Maximum total size, in bytes, of the responses held
+		 * @param TTL Number of seconds a response remains valid for
+		 */
+
+		CResponseCache(size_t MaxSize=16*1024*1024, int TTL=24*60*60);
+		~CResponseCache();
+
+		/**
+		 * @brief Set the maximum size of the cache
+		 *
+		 * Set the maximum total size of the responses held. Responses are discarded
+		 * immediately if the cache is now larger than this.
+		 *
+		 * @param MaxSize Maximum total size, in bytes, of the responses held
+		 */
+
+		void SetMaxSize(size_t MaxSize);
+
+		/**
+		 * @brief Maximum size of the cache
+		 *
+		 * @return Maximum total size, in bytes, of the responses held
+		 */
+
+		size_t MaxSize() const;
+
+		/**
+		 * @brief Set the time to live
+		 *
+		 * Set the number of seconds a response remains valid for. This applies to
+		 * responses already in the cache as well as new ones.
+		 *
+		 * @param TTL Number of seconds a response remains valid for
+		 */
+
+		void SetTTL(int TTL);
+
+		/**
+		 * @brief Time to live
+		 *
+		 * @return Number of seconds a response remains valid for
+		 */
+
+		int TTL() const;
+
+		/**
+		 * @brief Set the negative time to live
+		 *
+		 * Set the number of seconds a request recorded by PutNotFound is known not to
+		 * exist for. The default is one hour.
+		 *
+		 * @param NegativeTTL Number of seconds a missing entity is remembered for
+		 */
+
+		void SetNegativeTTL(int NegativeTTL);
+
+		/**
+		 * @brief Negative time to live
+		 *
+		 * @return Number of seconds a missing entity is remembered for
+		 */
+
+		int NegativeTTL() const;
+
+		/**
+		 * @brief Retrieve a response
+		 *
+		 * Look up the response stored for a key. A response that has expired is
+		 * not returned.
+		 *
+		 * @param Key Key identifying the request
+		 * @param Metadata Filled in with the response if it is found
+		 *
+		 * @return true if a valid response was found
+		 */
+
+		bool Get(const std::string& Key, CMetadata& Metadata);
+
+		/**
+		 * @brief Retrieve a response, even if it has expired
+		 *
+		 * Look up the response stored for a key, along with its validators. This does
+		 * not count as a hit or a miss.
+		 *
+		 * @param Key Key identifying the request
+		 * @param Metadata Filled in with the response if it is found
+		 * @param ETag Filled in with the ETag header the response was received with
+		 * @param LastModified Filled in with the Last-Modified header the response was
+		 *		received with
+		 *
+		 * @return true if a response was found
+		 */
+
+		bool GetStale(const std::string& Key, CMetadata& Metadata, std::string& ETag, std::string& LastModified);
+
+		/**
+		 * @brief Retrieve a response and its size, even if it has expired
+		 *
+		 * As GetStale above, also returning the size the response was stored with, so
+		 * that it can be stored again with the same size.
+		 *
+		 * @param Key Key identifying the request
+		 * @param Metadata Filled in with the response if it is found
+		 * @param ETag Filled in with the ETag header the response was received with
+		 * @param LastModified Filled in with the Last-Modified header the response was
+		 *		received with
+		 * @param Size Filled in with the size of the response in bytes
+		 *
+		 * @return true if a response was found
+		 */
+
+		bool GetStale(const std::string& Key, CMetadata& Metadata, std::string& ETag, std::string& LastModified, size_t& Size);
+
+		/**
+		 * @brief Store a response
+		 *
+		 * Store the response to a request, replacing any response already stored for
+		 * the key. Responses larger than the maximum size of the cache are not stored.
+		 *
+		 * @param Key Key identifying the request
+		 * @param Metadata Response to store
+		 * @param Size Size of the response in bytes, used to account for the space
+		 *		it takes
+		 * @param ETag ETag header the response was received with
+		 * @param LastModified Last-Modified header the response was received with
+		 */
+
+		void Put(const std::string& Key, const CMetadata& Metadata, size_t Size, const std::string& ETag="", const std::string& LastModified="");
+
+		/**
+		 * @brief Record that a request found nothing
+		 *
+		 * Record that the server replied to a request that the entity doesn't exist,
+		 * replacing any response stored for the key.
+		 *
+		 * @param Key Key identifying the request
+		 */
+
+		void PutNotFound(const std::string& Key);
+
+		/**
+		 * @brief Whether a request is known to find nothing
+		 *
+		 * @param Key Key identifying the request
+		 *
+		 * @return true if PutNotFound was called for the key within the negative time
+		 *		to live, and no response has been stored since
+		 */
+
+		bool NotFound(const std::string& Key);
+
+		/**
+		 * @brief Mark a response as valid again
+		 *
+		 * Restart the time to live of a stored response, for example after the server
+		 * has confirmed that it hasn't changed.
+		 *
+		 * @param Key Key identifying the request
+		 *
+		 * @return true if a response was stored for the key
+		 */
+
+		bool Refresh(const std::string& Key);
+
+		/**
+		 * @brief Remove a response
+		 *
+		 * @param Key Key identifying the request
+		 */
+
+		void Remove(const std::string& Key);
+
+		/**
+		 * @brief Remove responses whose keys start with a prefix
+		 *
+		 * Remove every response whose key starts with Prefix, for example all responses
+		 * for a resource that has been changed, whatever parameters they were requested
+		 * with.
+		 *
+		 * @param Prefix Start of the keys to remove
+		 */
+
+		void RemovePrefix(const std::string& Prefix);
+
+		/**
+		 * @brief Remove all responses
+		 *
+		 * Remove all responses from the cache. The statistics are not reset.
+		 */
+
+		void Clear();
+
+		/**
+		 * @brief Number of responses held
+		 *
+		 * @return Number of responses currently in the cache
+		 */
+
+		int NumEntries() const;
+
+		/**
+		 * @brief Size of the responses held
+		 *
+		 * @return Total size, in bytes, of the responses currently in the cache
+		 */
+
+		size_t Size() const;
+
+		/**
+		 * @brief Number of hits
+		 *
+		 * @return Number of times Get has found a valid response
+		 */
+
+		unsigned long Hits() const;
+
+		/**
+		 * @brief Number of misses
+		 *
+		 * @return Number of times Get has not found a valid response
+		 */
+
+		unsigned long Misses() const;
+
+		/**
+		 * @brief Number of evictions
+		 *
+		 * @return Number of responses discarded to make room for others
+		 */
+
+		unsigned long Evictions() const;
+
+		/**
+		 * @brief Generate the key for a request
+		 *
+		 * Generate a key identifying a request, in which the parameters are sorted by
+		 * name and the values of the inc parameter are sorted and separated by '+'.
+		 *
+		 * @param Host Server the request is made to, including any port and user name
+		 *		that affects the response
+		 * @param URL URL requested (e.g. /ws/2/release/ID?inc=artists+labels)
+		 *
+		 * @return Key identifying the request
+		 */
+
+		static std::string Key(const std::string& Host, const std::string& URL);
+
+	private:
+		CResponseCachePrivate * const m_d;
+
+		CResponseCache(const CResponseCache&);
+		CResponseCache& operator =(const CResponseCache&);
+	};
+}
+
+#endif
@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CSecondaryType(const XMLNode& Node=XMLNode::emptyNode());
 		CSecondaryType(const CSecondaryType& Other);
 		CSecondaryType& operator =(const CSecondaryType& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CSecondaryType(CSecondaryType&& Other);
+		CSecondaryType& operator =(CSecondaryType&& Other);
+#endif
 		virtual ~CSecondaryType();
 
 		virtual CSecondaryType *Clone();
 
-		std::string SecondaryType() const;
+		const std::string& SecondaryType() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,9 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CSecondaryTypePrivate * const m_d;
+		CSecondaryTypePrivate *m_d;
 	};
 }
 
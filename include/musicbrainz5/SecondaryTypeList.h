@@ -44,6 +44,10 @@ namespace MusicBrainz5
 		CSecondaryTypeList(const XMLNode& Node=XMLNode::emptyNode());
 		CSecondaryTypeList(const CSecondaryTypeList& Other);
 		CSecondaryTypeList& operator =(const CSecondaryTypeList& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CSecondaryTypeList(CSecondaryTypeList&& Other);
+		CSecondaryTypeList& operator =(CSecondaryTypeList&& Other);
+#endif
 		virtual ~CSecondaryTypeList();
 
 		virtual CSecondaryTypeList *Clone();
@@ -56,7 +60,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CSecondaryTypeListPrivate * const m_d;
+		CSecondaryTypeListPrivate *m_d;
 	};
 }
 
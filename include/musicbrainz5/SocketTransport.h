@@ -0,0 +1,73 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_SOCKET_TRANSPORT_H
+#define _MUSICBRAINZ5_SOCKET_TRANSPORT_H
+
+#include "musicbrainz5/Transport.h"
+
+namespace MusicBrainz5
+{
+	class CSocketTransportPrivate;
+
+	/**
+	 * @brief Transport that makes HTTP requests over a local (unix domain) socket
+	 *
+	 * Sends simple HTTP/1.0 requests to a server listening on a local socket rather
+	 * than connecting to the host over the network. This allows a local mirror, or
+	 * a test server, to be used without any network configuration.
+	 *
+	 * Authentication, proxy and compression settings are ignored by this transport.
+	 */
+	class CSocketTransport: public CTransport
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param SocketPath Path of the socket the server is listening on
+		 */
+
+		CSocketTransport(const std::string& SocketPath);
+		virtual ~CSocketTransport();
+
+		virtual CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+		/**
+		 * @brief Socket path
+		 *
+		 * @return Path of the socket requests are sent to
+		 */
+
+		std::string SocketPath() const;
+
+	private:
+		CSocketTransportPrivate * const m_d;
+	};
+}
+
+#endif
@@ -0,0 +1,109 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_STRING_POOL_H
+#define _MUSICBRAINZ5_STRING_POOL_H
+
+#include <string>
+
+#include <stddef.h>
+
+namespace MusicBrainz5
+{
+	/**
+	 * @brief Process wide table of interned strings
+	 *
+	 * Interning a string returns a reference to the single copy of it held by the
+	 * pool, so equal strings interned anywhere in the process are the same object and
+	 * can be compared by address.
+	 *
+	 * Strings are never removed from the pool, since references to them may be held
+	 * anywhere, so the pool grows with every distinct value interned and its memory
+	 * is only released when the process exits. Only values drawn from a small,
+	 * fixed vocabulary should be interned; interning free text such as titles or
+	 * names would make the pool grow without bound. NumStrings can be used to check
+	 * its size.
+	 *
+	 * Fields that take one of a small number of values are interned as they are
+	 * parsed, so that entities share their storage. These are:
+	 *
+	 * CArtist::Type and CArtist::Gender<br>
+	 * CMedium::Format<br>
+	 * CRelation::Type and CRelation::Direction<br>
+	 * CRelationList::TargetType<br>
+	 * CRelease::Status, CRelease::Quality, CRelease::Packaging and CRelease::Country<br>
+	 * CSecondaryType::SecondaryType
+	 *
+	 * The pool may be used from any number of threads.
+	 */
+	class CStringPool
+	{
+	public:
+		/**
+		 * @brief Intern a string
+		 *
+		 * @param Value String to intern
+		 *
+		 * @return The copy of Value held by the pool, which remains valid for the life
+		 *		of the process
+		 */
+
+		static const std::string& Intern(const std::string& Value);
+
+		/**
+		 * @brief Intern a string held in a character buffer
+		 *
+		 * The same as Intern(const std::string&), but if the value is already in the
+		 * pool no std::string is constructed.
+		 *
+		 * @param Value Characters of the string to intern, which need not be null
+		 *		terminated
+		 * @param Length Number of characters in Value
+		 *
+		 * @return The copy of the value held by the pool, which remains valid for the
+		 *		life of the process
+		 */
+
+		static const std::string& Intern(const char *Value, size_t Length);
+
+		/**
+		 * @brief Interned empty string
+		 *
+		 * @return The copy of the empty string held by the pool
+		 */
+
+		static const std::string& Empty();
+
+		/**
+		 * @brief Number of strings interned
+		 *
+		 * @return Number of distinct strings held by the pool
+		 */
+
+		static int NumStrings();
+	};
+}
+
+#endif
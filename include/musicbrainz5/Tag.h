@@ -43,12 +43,16 @@ namespace MusicBrainz5
 		CTag(const XMLNode& Node);
 		CTag(const CTag& Other);
 		CTag& operator =(const CTag& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CTag(CTag&& Other);
+		CTag& operator =(CTag&& Other);
+#endif
 		virtual ~CTag();
 
 		virtual CTag *Clone();
 
 		int Count() const;
-		std::string Name() const;
+		const std::string& Name() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -58,7 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CTagPrivate * const m_d;
+		CTagPrivate *m_d;
 	};
 }
 
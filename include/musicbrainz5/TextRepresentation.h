@@ -43,12 +43,16 @@ namespace MusicBrainz5
 		CTextRepresentation(const XMLNode& Node=XMLNode::emptyNode());
 		CTextRepresentation(const CTextRepresentation& Other);
 		CTextRepresentation& operator =(const CTextRepresentation& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CTextRepresentation(CTextRepresentation&& Other);
+		CTextRepresentation& operator =(CTextRepresentation&& Other);
+#endif
 		virtual ~CTextRepresentation();
 
 		virtual CTextRepresentation *Clone();
 
-		std::string Language() const;
-		std::string Script() const;
+		const std::string& Language() const;
+		const std::string& Script() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -58,7 +62,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CTextRepresentationPrivate * const m_d;
+		CTextRepresentationPrivate *m_d;
 	};
 }
 
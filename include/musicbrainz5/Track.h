@@ -46,16 +46,22 @@ namespace MusicBrainz5
 		CTrack(const XMLNode& Node=XMLNode::emptyNode());
 		CTrack(const CTrack& Other);
 		CTrack& operator =(const CTrack& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CTrack(CTrack&& Other);
+		CTrack& operator =(CTrack&& Other);
+#endif
 		virtual ~CTrack();
 
 		virtual CTrack *Clone();
 
 		int Position() const;
-		std::string Title() const;
-		CRecording *Recording() const;
+		const std::string& Title() const;
+		const CRecording *Recording() const;
+		CRecording *Recording();
 		int Length() const;
-		CArtistCredit *ArtistCredit() const;
-		std::string Number() const;
+		const CArtistCredit *ArtistCredit() const;
+		CArtistCredit *ArtistCredit();
+		const std::string& Number() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -65,9 +71,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CTrackPrivate * const m_d;
+		CTrackPrivate *m_d;
 	};
 }
 
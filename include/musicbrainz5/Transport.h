@@ -0,0 +1,359 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_TRANSPORT_H
+#define _MUSICBRAINZ5_TRANSPORT_H
+
+#include <string>
+#include <map>
+#include <vector>
+
+#include <stddef.h>
+
+namespace MusicBrainz5
+{
+	class CFetchPrivate;
+
+	/**
+	 * @brief Interface for receiving the body of a response as it arrives
+	 *
+	 * A reader may be passed to MusicBrainz5::CFetch::SetResponseReader to process
+	 * the body of a response as it is received, rather than waiting for the whole
+	 * response to be collected.
+	 */
+	class CResponseReader
+	{
+	public:
+		virtual ~CResponseReader();
+
+		/**
+		 * @brief Process the next part of the response body
+		 *
+		 * @param Data Data received
+		 * @param Len Length of data received
+		 */
+
+		virtual void Read(const char *Data, size_t Len)=0;
+	};
+
+	/**
+	 * @brief Base class for a single request to the web service
+	 *
+	 * Holds the settings for, and the results of, a single request made through
+	 * a MusicBrainz5::CTransport. Derived classes implement the actual transfer.
+	 *
+	 */
+	class CFetch
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 *
+		 * Constructor
+		 *
+		 * @param UserAgent User agent string to send
+		 * @param Host Host name to connect to
+		 * @param Port Port to connect to (80 by default)
+		 */
+
+		CFetch(const std::string& UserAgent, const std::string& Host, int Port=80);
+		virtual ~CFetch();
+
+		/**
+		 * @brief Set the user name to use
+		 *
+		 * Set the user name to use when authenticating with the web server
+		 *
+		 * @param UserName User name to use
+		 */
+
+		void SetUserName(const std::string& UserName);
+
+		/**
+		 * @brief Set the password to use
+		 *
+		 * Set the password to use when authenticating with the web server
+		 *
+		 * @param Password Password to use
+		 */
+
+		void SetPassword(const std::string& Password);
+
+		/**
+		 * @brief Set the proxy server to use
+		 *
+		 * Set the proxy server to use when connecting with the web server
+		 *
+		 * @param ProxyHost Proxy server to use
+		 */
+
+		void SetProxyHost(const std::string& ProxyHost);
+
+		/**
+		 * @brief Set the proxy port to use
+		 *
+		 * Set the proxy server port to use when connecting to the web server
+		 *
+		 * @param ProxyPort Proxy server port to use
+		 */
+
+		void SetProxyPort(int ProxyPort);
+
+		/**
+		 * @brief Set the proxy user name to use
+		 *
+		 * Set the user name to use when authenticating with the proxy server
+		 *
+		 * @param ProxyUserName Proxy user name to use
+		 */
+
+		void SetProxyUserName(const std::string& ProxyUserName);
+
+		/**
+		 * @brief Set the proxy password to use
+		 *
+		 * Set the password to use when authenticating with the proxy server
+		 *
+		 * @param ProxyPassword Proxy server password to use
+		 */
+
+		void SetProxyPassword(const std::string& ProxyPassword);
+
+		/**
+		 * @brief Set the reader for the response body
+		 *
+		 * Pass the body of the response to the specified reader as it is received.
+		 * When a reader is set, the response body is not stored and Data will
+		 * return an empty buffer.
+		 *
+		 * @param Reader Reader to pass the response to. Ownership remains with the
+		 *		caller. Pass NULL to store the response body.
+		 */
+
+		void SetResponseReader(CResponseReader *Reader);
+
+		/**
+		 * @brief Set whether to request a compressed response
+		 *
+		 * Ask the server to compress the response. Compressed responses are
+		 * decompressed as they are received. Transports that don't support
+		 * compression ignore this setting; of those in this library only
+		 * MusicBrainz5::CHTTPFetch supports it.
+		 *
+		 * @param Compression true to request a compressed response
+		 */
+
+		void SetCompression(bool Compression);
+
+		/**
+		 * @brief Whether a compressed response will be requested
+		 *
+		 * @return true if a compressed response will be requested
+		 */
+
+		bool Compression() const;
+
+		/**
+		 * @brief Set a header to send with the request
+		 *
+		 * Set an additional header to send with the request, replacing any value
+		 * previously set for the header. This is used to make conditional requests.
+		 *
+		 * @param Name Name of the header (e.g. If-None-Match)
+		 * @param Value Value of the header. Pass an empty string to stop sending the header.
+		 */
+
+		void SetRequestHeader(const std::string& Name, const std::string& Value);
+
+		/**
+		 * @brief Return the additional headers to send with the request
+		 *
+		 * @return Headers set by SetRequestHeader, keyed on the header name
+		 */
+
+		std::map<std::string,std::string> RequestHeaders() const;
+
+		/**
+		 * @brief Make a request to the server
+		 *
+		 * Make a request to the server
+		 *
+		 * @param URL URL to request
+		 * @param Request Request type (GET by default)
+		 *
+		 * @return Number of bytes received. This will be 0 if the server replied to a
+		 *		conditional request with status 304 (not modified).
+		 *
+		 * @throw CConnectionError An error occurred connecting to the web server
+		 * @throw CTimeoutError A timeout occurred when connecting to the web server
+		 * @throw CAuthenticationError An authentication error occurred
+		 * @throw CFetchError An error occurred fetching data
+		 * @throw CServiceUnavailableError The server is busy (a CFetchError)
+		 * @throw CRequestError The request was invalid
+		 * @throw CResourceNotFoundError The requested resource was not found
+		 */
+
+		virtual int Fetch(const std::string& URL, const std::string& Request="GET")=0;
+
+		/**
+		 * @brief Get the data receieved
+		 *
+		 * Get the data received from the request, if no response reader was set
+		 *
+		 * @return Data received
+		 */
+
+		std::vector<unsigned char> Data() const;
+
+		/**
+		 * @brief Transport result code from the request
+		 *
+		 * Return the transport specific result code from the request. This will
+		 * be 0 if the request was transferred successfully.
+		 *
+		 * @return Transport result code from the request
+		 */
+
+		int Result() const;
+
+		/**
+		 * @brief Status
+		 *
+		 * Return the HTTP status code from the request
+		 *
+		 * @return HTTP status code from the request
+		 */
+
+		int Status() const;
+
+		/**
+		 * @brief Return the error message from the request
+		 *
+		 * Return the error message from the request
+		 *
+		 * @return Error message from the request
+		 */
+
+		std::string ErrorMessage() const;
+
+		/**
+		 * @brief Return a header from the response
+		 *
+		 * @param Name Name of the header (case insensitive)
+		 *
+		 * @return Value of the header, or an empty string if it wasn't present
+		 */
+
+		std::string ResponseHeader(const std::string& Name) const;
+
+		/**
+		 * @brief Return the headers from the response
+		 *
+		 * @return Headers from the response, keyed on the lower case header name
+		 */
+
+		std::map<std::string,std::string> ResponseHeaders() const;
+
+		/**
+		 * @brief Compressed size of the response
+		 *
+		 * Return the number of bytes of response body received from the server.
+		 * If the response was not compressed this will be the same as UncompressedSize.
+		 *
+		 * @return Compressed size of the response
+		 */
+
+		size_t CompressedSize() const;
+
+		/**
+		 * @brief Uncompressed size of the response
+		 *
+		 * Return the number of bytes of response body after any decompression
+		 *
+		 * @return Uncompressed size of the response
+		 */
+
+		size_t UncompressedSize() const;
+
+	protected:
+		std::string UserAgent() const;
+		std::string Host() const;
+		int Port() const;
+		std::string UserName() const;
+		std::string Password() const;
+		std::string ProxyHost() const;
+		int ProxyPort() const;
+		std::string ProxyUserName() const;
+		std::string ProxyPassword() const;
+
+		void Reset();
+		void AddData(const char *Data, size_t Len);
+		size_t DataSize() const;
+		void AddCompressedSize(size_t Len);
+		void SetResult(int Result);
+		void SetStatus(int Status);
+		void SetErrorMessage(const std::string& ErrorMessage);
+		void AddResponseHeader(const std::string& Name, const std::string& Value);
+		void CheckStatus() const;
+
+	private:
+		CFetchPrivate * const m_d;
+	};
+
+	/**
+	 * @brief Interface for the transport used to talk to the web service
+	 *
+	 * A transport creates the MusicBrainz5::CFetch objects used by MusicBrainz5::CQuery
+	 * to make its requests. Providing an alternative transport allows queries to be
+	 * answered without making requests over the network.
+	 *
+	 * MusicBrainz5::CQuery::LookupBatch creates and uses fetch objects from several
+	 * threads at once, so transports should be safe to use in this way.
+	 *
+	 * @see MusicBrainz5::CHTTPTransport
+	 * @see MusicBrainz5::CMemoryTransport
+	 * @see MusicBrainz5::CSocketTransport
+	 * @see MusicBrainz5::CFetchEngineTransport
+	 */
+	class CTransport
+	{
+	public:
+		virtual ~CTransport();
+
+		/**
+		 * @brief Create an object to make a single request
+		 *
+		 * @param UserAgent User agent string to send
+		 * @param Host Host name to connect to
+		 * @param Port Port to connect to
+		 *
+		 * @return Newly created fetch object. This must be deleted by the caller.
+		 */
+
+		virtual CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)=0;
+	};
+}
+
+#endif
@@ -42,6 +42,10 @@ namespace MusicBrainz5
 		CUserRating(const XMLNode& Node);
 		CUserRating(const CUserRating& Other);
 		CUserRating& operator =(const CUserRating& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CUserRating(CUserRating&& Other);
+		CUserRating& operator =(CUserRating&& Other);
+#endif
 		virtual ~CUserRating();
 
 		virtual CUserRating *Clone();
@@ -56,7 +60,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CUserRatingPrivate * const m_d;
+		CUserRatingPrivate *m_d;
 	};
 }
 
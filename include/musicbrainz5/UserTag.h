@@ -43,11 +43,15 @@ namespace MusicBrainz5
 		CUserTag(const XMLNode& Node);
 		CUserTag(const CUserTag& Other);
 		CUserTag& operator =(const CUserTag& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CUserTag(CUserTag&& Other);
+		CUserTag& operator =(CUserTag&& Other);
+#endif
 		virtual ~CUserTag();
 
 		virtual CUserTag *Clone();
 
-		std::string Name() const;
+		const std::string& Name() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -57,7 +61,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		CUserTagPrivate * const m_d;
+		CUserTagPrivate *m_d;
 	};
 }
 
@@ -29,6 +29,7 @@
 #include <string>
 
 #include "musicbrainz5/Entity.h"
+#include "musicbrainz5/MBID.h"
 #include "musicbrainz5/AliasList.h"
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/TagList.h"
@@ -52,23 +53,36 @@ namespace MusicBrainz5
 		CWork(const XMLNode& Node=XMLNode::emptyNode());
 		CWork(const CWork& Other);
 		CWork& operator =(const CWork& Other);
+#ifdef LIBMB5_MOVE_SEMANTICS
+		CWork(CWork&& Other);
+		CWork& operator =(CWork&& Other);
+#endif
 		virtual ~CWork();
 
 		virtual CWork *Clone();
 
-		std::string ID() const;
-		std::string Type() const;
-		std::string Title() const;
-		CArtistCredit *ArtistCredit() const;
-		CISWCList *ISWCList() const;
-		std::string Disambiguation() const;
-		CAliasList *AliasList() const;
-		CRelationListList *RelationListList() const;
-		CTagList *TagList() const;
-		CUserTagList *UserTagList() const;
-		CRating *Rating() const;
-		CUserRating *UserRating() const;
-		std::string Language() const;
+		const std::string& ID() const;
+		CMBID MBID() const;
+		const std::string& Type() const;
+		const std::string& Title() const;
+		const CArtistCredit *ArtistCredit() const;
+		CArtistCredit *ArtistCredit();
+		const CISWCList *ISWCList() const;
+		CISWCList *ISWCList();
+		const std::string& Disambiguation() const;
+		const CAliasList *AliasList() const;
+		CAliasList *AliasList();
+		const CRelationListList *RelationListList() const;
+		CRelationListList *RelationListList();
+		const CTagList *TagList() const;
+		CTagList *TagList();
+		const CUserTagList *UserTagList() const;
+		CUserTagList *UserTagList();
+		const CRating *Rating() const;
+		CRating *Rating();
+		const CUserRating *UserRating() const;
+		CUserRating *UserRating();
+		const std::string& Language() const;
 
 		virtual std::ostream& Serialise(std::ostream& os) const;
 		static std::string GetElementName();
@@ -78,9 +92,7 @@ namespace MusicBrainz5
 		virtual void ParseElement(const XMLNode& Node);
 
 	private:
-		void Cleanup();
-
-		CWorkPrivate * const m_d;
+		CWorkPrivate *m_d;
 	};
 }
 
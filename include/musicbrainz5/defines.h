@@ -40,4 +40,10 @@
 
 #endif
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+
+#define LIBMB5_MOVE_SEMANTICS
+
+#endif
+
 #endif
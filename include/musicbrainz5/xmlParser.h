@@ -36,6 +36,15 @@ typedef _xmlDoc* xmlDocPtr;
 struct _xmlAttr;
 typedef _xmlAttr* xmlAttrPtr;
 
+struct _xmlParserCtxt;
+typedef _xmlParserCtxt* xmlParserCtxtPtr;
+
+/* Compact, read only, tree built by XMLPushParser */
+struct XMLElement;
+struct XMLElementAttribute;
+class XMLArena;
+class XMLTreeBuilder;
+
 struct XMLResults
 {
     std::string message;
@@ -68,8 +77,11 @@ class XMLNode
 
     protected:
         XMLNode(xmlNodePtr node);
+        XMLNode(const XMLElement *element);
 
+        /* Only one of these is set, depending on how the document was parsed */
         xmlNodePtr mNode;
+        const XMLElement *mElement;
 
     private:
         xmlAttrPtr getAttributeRaw(const char *name) const;
@@ -86,9 +98,42 @@ class XMLRootNode: public XMLNode
         virtual ~XMLRootNode();
 
     private:
+        friend class XMLPushParser;
+
         XMLRootNode(xmlDocPtr doc);
+        XMLRootNode(XMLArena *arena, const XMLElement *root);
 
         xmlDocPtr mDoc;
+        XMLArena *mArena;
+};
+
+/* Incremental parser, for parsing a document as it arrives rather than
+ * collecting the whole of it before parsing.
+ *
+ * Rather than a libxml2 document, this builds a compact tree directly from
+ * the SAX events, holding only element names (shared between elements),
+ * attributes and the text of each element. Whitespace between elements, and
+ * text following an element's first child, isn't kept, since getText()
+ * never returns it. The nodes returned can be used in the same way as those
+ * from XMLRootNode::parseString. */
+class XMLPushParser
+{
+    public:
+        XMLPushParser();
+        ~XMLPushParser();
+
+        bool parseChunk(const char *chunk, int size);
+        XMLNode* finish(XMLResults *results);
+
+        static XMLNode* parseString(const std::string &xml, XMLResults *results);
+
+    private:
+        XMLPushParser(const XMLPushParser &);
+        XMLPushParser &operator =(const XMLPushParser &);
+
+        xmlParserCtxtPtr mCtxt;
+        XMLTreeBuilder *mBuilder;
+        bool mFinished;
 };
 
 class XMLAttribute
@@ -103,7 +148,9 @@ class XMLAttribute
 
     private:
         XMLAttribute(xmlAttrPtr attr);
+        XMLAttribute(const XMLElementAttribute *attr);
         xmlAttrPtr mAttr;
+        const XMLElementAttribute *mElementAttr;
 };
 
 #endif
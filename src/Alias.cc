@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Alias.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CAliasPrivate
+class MusicBrainz5::CAliasPrivate: public CSharedPrivate
 {
 public:
 		std::string m_Locale;
@@ -56,10 +57,9 @@ MusicBrainz5::CAlias::CAlias(const XMLNode& Node)
 }
 
 MusicBrainz5::CAlias::CAlias(const CAlias& Other)
-:	CEntity(),
-	m_d(new CAliasPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CAlias& MusicBrainz5::CAlias::operator =(const CAlias& Other)
@@ -68,21 +68,35 @@ MusicBrainz5::CAlias& MusicBrainz5::CAlias::operator =(const CAlias& Other)
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Locale=Other.m_d->m_Locale;
-		m_d->m_Text=Other.m_d->m_Text;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Primary=Other.m_d->m_Primary;
-		m_d->m_BeginDate=Other.m_d->m_BeginDate;
-		m_d->m_EndDate=Other.m_d->m_EndDate;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CAlias::CAlias(CAlias&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CAliasPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CAlias& MusicBrainz5::CAlias::operator =(CAlias&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CAlias::~CAlias()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CAlias *MusicBrainz5::CAlias::Clone()
@@ -92,6 +106,8 @@ MusicBrainz5::CAlias *MusicBrainz5::CAlias::Clone()
 
 void MusicBrainz5::CAlias::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("locale"==Name)
 		m_d->m_Locale=Value;
 	else if ("sort-name"==Name)
@@ -114,9 +130,10 @@ void MusicBrainz5::CAlias::ParseAttribute(const std::string& Name, const std::st
 
 void MusicBrainz5::CAlias::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised alias element: '" << NodeName << std::endl;
+	std::cerr << "Unrecognised alias element: '" << Node.getName() << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -125,37 +142,37 @@ std::string MusicBrainz5::CAlias::GetElementName()
 	return "alias";
 }
 
-std::string MusicBrainz5::CAlias::Locale() const
+const std::string& MusicBrainz5::CAlias::Locale() const
 {
 	return m_d->m_Locale;
 }
 
-std::string MusicBrainz5::CAlias::Text() const
+const std::string& MusicBrainz5::CAlias::Text() const
 {
 	return m_d->m_Text;
 }
 
-std::string MusicBrainz5::CAlias::SortName() const
+const std::string& MusicBrainz5::CAlias::SortName() const
 {
 	return m_d->m_SortName;
 }
 
-std::string MusicBrainz5::CAlias::Type() const
+const std::string& MusicBrainz5::CAlias::Type() const
 {
 	return m_d->m_Type;
 }
 
-std::string MusicBrainz5::CAlias::Primary() const
+const std::string& MusicBrainz5::CAlias::Primary() const
 {
 	return m_d->m_Primary;
 }
 
-std::string MusicBrainz5::CAlias::BeginDate() const
+const std::string& MusicBrainz5::CAlias::BeginDate() const
 {
 	return m_d->m_BeginDate;
 }
 
-std::string MusicBrainz5::CAlias::EndDate() const
+const std::string& MusicBrainz5::CAlias::EndDate() const
 {
 	return m_d->m_EndDate;
 }
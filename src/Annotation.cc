@@ -27,10 +27,12 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Annotation.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CAnnotationPrivate
+class MusicBrainz5::CAnnotationPrivate: public CSharedPrivate
 {
-public:
+	public:
 		std::string m_Type;
 		std::string m_Entity;
 		std::string m_Name;
@@ -50,10 +52,9 @@ MusicBrainz5::CAnnotation::CAnnotation(const XMLNode& Node)
 }
 
 MusicBrainz5::CAnnotation::CAnnotation(const CAnnotation& Other)
-:	CEntity(),
-	m_d(new CAnnotationPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CAnnotation& MusicBrainz5::CAnnotation::operator =(const CAnnotation& Other)
@@ -62,18 +63,35 @@ MusicBrainz5::CAnnotation& MusicBrainz5::CAnnotation::operator =(const CAnnotati
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Entity=Other.m_d->m_Entity;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_Text=Other.m_d->m_Text;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CAnnotation::CAnnotation(CAnnotation&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CAnnotationPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CAnnotation& MusicBrainz5::CAnnotation::operator =(CAnnotation&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CAnnotation::~CAnnotation()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CAnnotation *MusicBrainz5::CAnnotation::Clone()
@@ -83,6 +101,8 @@ MusicBrainz5::CAnnotation *MusicBrainz5::CAnnotation::Clone()
 
 void MusicBrainz5::CAnnotation::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("type"==Name)
 		m_d->m_Type=Value;
 	else
@@ -95,25 +115,27 @@ void MusicBrainz5::CAnnotation::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CAnnotation::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("entity"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Entity);
-	}
-	else if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("text"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Text);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementEntity:
+			ProcessItem(Node,m_d->m_Entity);
+			break;
+
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElementText:
+			ProcessItem(Node,m_d->m_Text);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised annotation element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised annotation element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -122,22 +144,22 @@ std::string MusicBrainz5::CAnnotation::GetElementName()
 	return "annotation";
 }
 
-std::string MusicBrainz5::CAnnotation::Type() const
+const std::string& MusicBrainz5::CAnnotation::Type() const
 {
 	return m_d->m_Type;
 }
 
-std::string MusicBrainz5::CAnnotation::Entity() const
+const std::string& MusicBrainz5::CAnnotation::Entity() const
 {
 	return m_d->m_Entity;
 }
 
-std::string MusicBrainz5::CAnnotation::Name() const
+const std::string& MusicBrainz5::CAnnotation::Name() const
 {
 	return m_d->m_Name;
 }
 
-std::string MusicBrainz5::CAnnotation::Text() const
+const std::string& MusicBrainz5::CAnnotation::Text() const
 {
 	return m_d->m_Text;
 }
@@ -51,12 +51,17 @@
 #include "musicbrainz5/Tag.h"
 #include "musicbrainz5/UserTagList.h"
 #include "musicbrainz5/UserTag.h"
+#include "ElementTables.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CArtistPrivate
+class MusicBrainz5::CArtistPrivate: public CSharedPrivate
 {
 	public:
 		CArtistPrivate()
-		:	m_IPIList(0),
+		:	m_Type(&CStringPool::Empty()),
+			m_Gender(&CStringPool::Empty()),
+			m_IPIList(0),
 			m_Lifespan(0),
 			m_AliasList(0),
 			m_RecordingList(0),
@@ -72,11 +77,91 @@ class MusicBrainz5::CArtistPrivate
 		{
 		}
 
+		CArtistPrivate(const CArtistPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Type(Other.m_Type),
+			m_Name(Other.m_Name),
+			m_SortName(Other.m_SortName),
+			m_Gender(Other.m_Gender),
+			m_Country(Other.m_Country),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_IPIList(0),
+			m_Lifespan(0),
+			m_AliasList(0),
+			m_RecordingList(0),
+			m_ReleaseList(0),
+			m_ReleaseGroupList(0),
+			m_LabelList(0),
+			m_WorkList(0),
+			m_RelationListList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_Rating(0),
+			m_UserRating(0)
+		{
+			if (Other.m_IPIList)
+				m_IPIList=new CIPIList(*Other.m_IPIList);
+
+			if (Other.m_Lifespan)
+				m_Lifespan=new CLifespan(*Other.m_Lifespan);
+
+			if (Other.m_AliasList)
+				m_AliasList=new CAliasList(*Other.m_AliasList);
+
+			if (Other.m_RecordingList)
+				m_RecordingList=new CRecordingList(*Other.m_RecordingList);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+
+			if (Other.m_ReleaseGroupList)
+				m_ReleaseGroupList=new CReleaseGroupList(*Other.m_ReleaseGroupList);
+
+			if (Other.m_LabelList)
+				m_LabelList=new CLabelList(*Other.m_LabelList);
+
+			if (Other.m_WorkList)
+				m_WorkList=new CWorkList(*Other.m_WorkList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+		}
+
+		~CArtistPrivate()
+		{
+			delete m_IPIList;
+			delete m_Lifespan;
+			delete m_AliasList;
+			delete m_RecordingList;
+			delete m_ReleaseList;
+			delete m_ReleaseGroupList;
+			delete m_LabelList;
+			delete m_WorkList;
+			delete m_RelationListList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_Rating;
+			delete m_UserRating;
+		}
+
 		std::string m_ID;
-		std::string m_Type;
+		const std::string *m_Type;
 		std::string m_Name;
 		std::string m_SortName;
-		std::string m_Gender;
+		const std::string *m_Gender;
 		std::string m_Country;
 		std::string m_Disambiguation;
 		CIPIList *m_IPIList;
@@ -107,118 +192,46 @@ MusicBrainz5::CArtist::CArtist(const XMLNode& Node)
 }
 
 MusicBrainz5::CArtist::CArtist(const CArtist& Other)
-:	CEntity(),
-	m_d(new CArtistPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CArtist& MusicBrainz5::CArtist::operator =(const CArtist& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_Gender=Other.m_d->m_Gender;
-		m_d->m_Country=Other.m_d->m_Country;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-
-		if (Other.m_d->m_IPIList)
-			m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
-
-		if (Other.m_d->m_Lifespan)
-			m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
-
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
-
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
-
-		if (Other.m_d->m_ReleaseGroupList)
-			m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
-
-		if (Other.m_d->m_LabelList)
-			m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
-
-		if (Other.m_d->m_WorkList)
-			m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
-
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
-
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
-
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CArtist::~CArtist()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CArtist::CArtist(CArtist&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CArtistPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CArtist::Cleanup()
+MusicBrainz5::CArtist& MusicBrainz5::CArtist::operator =(CArtist&& Other)
 {
-	delete m_d->m_IPIList;
-	m_d->m_IPIList=0;
-
-	delete m_d->m_Lifespan;
-	m_d->m_Lifespan=0;
-
-	delete m_d->m_AliasList;
-	m_d->m_AliasList=0;
-
-	delete m_d->m_RecordingList;
-	m_d->m_RecordingList=0;
-
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
-
-	delete m_d->m_ReleaseGroupList;
-	m_d->m_ReleaseGroupList=0;
-
-	delete m_d->m_LabelList;
-	m_d->m_LabelList=0;
-
-	delete m_d->m_WorkList;
-	m_d->m_WorkList=0;
-
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
-
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
-
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+MusicBrainz5::CArtist::~CArtist()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CArtist *MusicBrainz5::CArtist::Clone()
@@ -228,10 +241,12 @@ MusicBrainz5::CArtist *MusicBrainz5::CArtist::Clone()
 
 void MusicBrainz5::CArtist::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else if ("type"==Name)
-		m_d->m_Type=Value;
+		InternItem(Value,m_d->m_Type);
 	else
 	{
 #ifdef _MB5_DEBUG_
@@ -242,89 +257,91 @@ void MusicBrainz5::CArtist::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CArtist::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("sort-name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SortName);
-	}
-	else if ("gender"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Gender);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("ipi"==NodeName)
-	{
-		//Ignore IPI
-	}
-	else if ("ipi-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_IPIList);
-	}
-	else if ("life-span"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Lifespan);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("recording-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_RecordingList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("release-group-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroupList);
-	}
-	else if ("label-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelList);
-	}
-	else if ("work-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_WorkList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElementSortName:
+			ProcessItem(Node,m_d->m_SortName);
+			break;
+
+		case eElementGender:
+			InternItem(Node,m_d->m_Gender);
+			break;
+
+		case eElementCountry:
+			ProcessItem(Node,m_d->m_Country);
+			break;
+
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElementIpi:
+			//Ignore IPI
+			break;
+
+		case eElementIpiList:
+			ProcessItem(Node,m_d->m_IPIList);
+			break;
+
+		case eElementLifeSpan:
+			ProcessItem(Node,m_d->m_Lifespan);
+			break;
+
+		case eElementAliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElementRecordingList:
+			ProcessItem(Node,m_d->m_RecordingList);
+			break;
+
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElementReleaseGroupList:
+			ProcessItem(Node,m_d->m_ReleaseGroupList);
+			break;
+
+		case eElementLabelList:
+			ProcessItem(Node,m_d->m_LabelList);
+			break;
+
+		case eElementWorkList:
+			ProcessItem(Node,m_d->m_WorkList);
+			break;
+
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised artist element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised artist element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -333,103 +350,199 @@ std::string MusicBrainz5::CArtist::GetElementName()
 	return "artist";
 }
 
-std::string MusicBrainz5::CArtist::ID() const
+const std::string& MusicBrainz5::CArtist::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CArtist::Type() const
+MusicBrainz5::CMBID MusicBrainz5::CArtist::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CArtist::Type() const
 {
-	return m_d->m_Type;
+	return *m_d->m_Type;
 }
 
-std::string MusicBrainz5::CArtist::Name() const
+const std::string& MusicBrainz5::CArtist::Name() const
 {
 	return m_d->m_Name;
 }
 
-std::string MusicBrainz5::CArtist::SortName() const
+const std::string& MusicBrainz5::CArtist::SortName() const
 {
 	return m_d->m_SortName;
 }
 
-std::string MusicBrainz5::CArtist::Gender() const
+const std::string& MusicBrainz5::CArtist::Gender() const
 {
-	return m_d->m_Gender;
+	return *m_d->m_Gender;
 }
 
-std::string MusicBrainz5::CArtist::Country() const
+const std::string& MusicBrainz5::CArtist::Country() const
 {
 	return m_d->m_Country;
 }
 
-std::string MusicBrainz5::CArtist::Disambiguation() const
+const std::string& MusicBrainz5::CArtist::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-MusicBrainz5::CIPIList *MusicBrainz5::CArtist::IPIList() const
+const MusicBrainz5::CIPIList *MusicBrainz5::CArtist::IPIList() const
+{
+	return m_d->m_IPIList;
+}
+
+MusicBrainz5::CIPIList *MusicBrainz5::CArtist::IPIList()
 {
+	Unshare(m_d);
+
 	return m_d->m_IPIList;
 }
 
-MusicBrainz5::CLifespan *MusicBrainz5::CArtist::Lifespan() const
+const MusicBrainz5::CLifespan *MusicBrainz5::CArtist::Lifespan() const
 {
 	return m_d->m_Lifespan;
 }
 
-MusicBrainz5::CAliasList *MusicBrainz5::CArtist::AliasList() const
+MusicBrainz5::CLifespan *MusicBrainz5::CArtist::Lifespan()
 {
+	Unshare(m_d);
+
+	return m_d->m_Lifespan;
+}
+
+const MusicBrainz5::CAliasList *MusicBrainz5::CArtist::AliasList() const
+{
+	return m_d->m_AliasList;
+}
+
+MusicBrainz5::CAliasList *MusicBrainz5::CArtist::AliasList()
+{
+	Unshare(m_d);
+
 	return m_d->m_AliasList;
 }
 
-MusicBrainz5::CRecordingList *MusicBrainz5::CArtist::RecordingList() const
+const MusicBrainz5::CRecordingList *MusicBrainz5::CArtist::RecordingList() const
+{
+	return m_d->m_RecordingList;
+}
+
+MusicBrainz5::CRecordingList *MusicBrainz5::CArtist::RecordingList()
 {
+	Unshare(m_d);
+
 	return m_d->m_RecordingList;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CArtist::ReleaseList() const
+const MusicBrainz5::CReleaseList *MusicBrainz5::CArtist::ReleaseList() const
+{
+	return m_d->m_ReleaseList;
+}
+
+MusicBrainz5::CReleaseList *MusicBrainz5::CArtist::ReleaseList()
 {
+	Unshare(m_d);
+
 	return m_d->m_ReleaseList;
 }
 
-MusicBrainz5::CReleaseGroupList *MusicBrainz5::CArtist::ReleaseGroupList() const
+const MusicBrainz5::CReleaseGroupList *MusicBrainz5::CArtist::ReleaseGroupList() const
+{
+	return m_d->m_ReleaseGroupList;
+}
+
+MusicBrainz5::CReleaseGroupList *MusicBrainz5::CArtist::ReleaseGroupList()
 {
+	Unshare(m_d);
+
 	return m_d->m_ReleaseGroupList;
 }
 
-MusicBrainz5::CLabelList *MusicBrainz5::CArtist::LabelList() const
+const MusicBrainz5::CLabelList *MusicBrainz5::CArtist::LabelList() const
+{
+	return m_d->m_LabelList;
+}
+
+MusicBrainz5::CLabelList *MusicBrainz5::CArtist::LabelList()
 {
+	Unshare(m_d);
+
 	return m_d->m_LabelList;
 }
 
-MusicBrainz5::CWorkList *MusicBrainz5::CArtist::WorkList() const
+const MusicBrainz5::CWorkList *MusicBrainz5::CArtist::WorkList() const
 {
 	return m_d->m_WorkList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CArtist::RelationListList() const
+MusicBrainz5::CWorkList *MusicBrainz5::CArtist::WorkList()
+{
+	Unshare(m_d);
+
+	return m_d->m_WorkList;
+}
+
+const MusicBrainz5::CRelationListList *MusicBrainz5::CArtist::RelationListList() const
+{
+	return m_d->m_RelationListList;
+}
+
+MusicBrainz5::CRelationListList *MusicBrainz5::CArtist::RelationListList()
 {
+	Unshare(m_d);
+
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CArtist::TagList() const
+const MusicBrainz5::CTagList *MusicBrainz5::CArtist::TagList() const
+{
+	return m_d->m_TagList;
+}
+
+MusicBrainz5::CTagList *MusicBrainz5::CArtist::TagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CArtist::UserTagList() const
+const MusicBrainz5::CUserTagList *MusicBrainz5::CArtist::UserTagList() const
+{
+	return m_d->m_UserTagList;
+}
+
+MusicBrainz5::CUserTagList *MusicBrainz5::CArtist::UserTagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CArtist::Rating() const
+const MusicBrainz5::CRating *MusicBrainz5::CArtist::Rating() const
+{
+	return m_d->m_Rating;
+}
+
+MusicBrainz5::CRating *MusicBrainz5::CArtist::Rating()
 {
+	Unshare(m_d);
+
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CArtist::UserRating() const
+const MusicBrainz5::CUserRating *MusicBrainz5::CArtist::UserRating() const
+{
+	return m_d->m_UserRating;
+}
+
+MusicBrainz5::CUserRating *MusicBrainz5::CArtist::UserRating()
 {
+	Unshare(m_d);
+
 	return m_d->m_UserRating;
 }
 
@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/NameCreditList.h"
 #include "musicbrainz5/NameCredit.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CArtistCreditPrivate
+class MusicBrainz5::CArtistCreditPrivate: public CSharedPrivate
 {
 	public:
 		CArtistCreditPrivate()
@@ -39,6 +41,19 @@ class MusicBrainz5::CArtistCreditPrivate
 		{
 		}
 
+		CArtistCreditPrivate(const CArtistCreditPrivate& Other)
+		:	CSharedPrivate(),
+			m_NameCreditList(0)
+		{
+			if (Other.m_NameCreditList)
+				m_NameCreditList=new CNameCreditList(*Other.m_NameCreditList);
+		}
+
+		~CArtistCreditPrivate()
+		{
+			delete m_NameCreditList;
+		}
+
 		CNameCreditList *m_NameCreditList;
 };
 
@@ -57,38 +72,46 @@ MusicBrainz5::CArtistCredit::CArtistCredit(const XMLNode& Node)
 }
 
 MusicBrainz5::CArtistCredit::CArtistCredit(const CArtistCredit& Other)
-:	CEntity(),
-	m_d(new CArtistCreditPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CArtistCredit& MusicBrainz5::CArtistCredit::operator =(const CArtistCredit& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		if (Other.m_d->m_NameCreditList)
-			m_d->m_NameCreditList=new CNameCreditList(*Other.m_d->m_NameCreditList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CArtistCredit::~CArtistCredit()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CArtistCredit::CArtistCredit(CArtistCredit&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CArtistCreditPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CArtistCredit& MusicBrainz5::CArtistCredit::operator =(CArtistCredit&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CArtistCredit::Cleanup()
+MusicBrainz5::CArtistCredit::~CArtistCredit()
 {
-	delete m_d->m_NameCreditList;
-	m_d->m_NameCreditList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CArtistCredit *MusicBrainz5::CArtistCredit::Clone()
@@ -107,18 +130,18 @@ void MusicBrainz5::CArtistCredit::ParseAttribute(const std::string& Name, const
 
 void MusicBrainz5::CArtistCredit::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
-	if ("name-credit"==NodeName)
-	{
-		//The artist credit element is a special case, in that all it contains is a list of name-credits
-		//Parsing of this list is handled in the constructor
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementNameCredit:
+			//The artist credit element is a special case, in that all it contains is a list of name-credits
+			//Parsing of this list is handled in the constructor
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised artistcredit element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised artistcredit element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -127,11 +150,18 @@ std::string MusicBrainz5::CArtistCredit::GetElementName()
 	return "artist-credit";
 }
 
-MusicBrainz5::CNameCreditList *MusicBrainz5::CArtistCredit::NameCreditList() const
+const MusicBrainz5::CNameCreditList *MusicBrainz5::CArtistCredit::NameCreditList() const
 {
 	return m_d->m_NameCreditList;
 }
 
+MusicBrainz5::CNameCreditList *MusicBrainz5::CArtistCredit::NameCreditList()
+{
+	Unshare(m_d);
+
+	return m_d->m_NameCreditList;
+}
+
 std::ostream& MusicBrainz5::CArtistCredit::Serialise(std::ostream& os) const
 {
 	os << "Artist credit:" << std::endl;
@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Attribute.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CAttributePrivate
+class MusicBrainz5::CAttributePrivate: public CSharedPrivate
 {
 	public:
 		std::string m_Text;
@@ -50,10 +51,9 @@ MusicBrainz5::CAttribute::CAttribute(const XMLNode& Node)
 }
 
 MusicBrainz5::CAttribute::CAttribute(const CAttribute& Other)
-:	CEntity(),
-	m_d(new CAttributePrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CAttribute& MusicBrainz5::CAttribute::operator =(const CAttribute& Other)
@@ -62,15 +62,35 @@ MusicBrainz5::CAttribute& MusicBrainz5::CAttribute::operator =(const CAttribute&
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Text=Other.m_d->m_Text;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CAttribute::CAttribute(CAttribute&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CAttributePrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CAttribute& MusicBrainz5::CAttribute::operator =(CAttribute&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CAttribute::~CAttribute()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CAttribute *MusicBrainz5::CAttribute::Clone()
@@ -89,10 +109,10 @@ void MusicBrainz5::CAttribute::ParseAttribute(const std::string& Name, const std
 
 void MusicBrainz5::CAttribute::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised attribute element: '" << NodeName << "'" << std::endl;
+	std::cerr << "Unrecognised attribute element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -101,7 +121,7 @@ std::string MusicBrainz5::CAttribute::GetElementName()
 	return "attribute";
 }
 
-std::string MusicBrainz5::CAttribute::Text() const
+const std::string& MusicBrainz5::CAttribute::Text() const
 {
 	return m_d->m_Text;
 }
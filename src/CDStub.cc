@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/NonMBTrackList.h"
 #include "musicbrainz5/NonMBTrack.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CCDStubPrivate
+class MusicBrainz5::CCDStubPrivate: public CSharedPrivate
 {
 	public:
 		CCDStubPrivate()
@@ -39,6 +41,24 @@ class MusicBrainz5::CCDStubPrivate
 		{
 		}
 
+		CCDStubPrivate(const CCDStubPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Title(Other.m_Title),
+			m_Artist(Other.m_Artist),
+			m_Barcode(Other.m_Barcode),
+			m_Comment(Other.m_Comment),
+			m_NonMBTrackList(0)
+		{
+			if (Other.m_NonMBTrackList)
+				m_NonMBTrackList=new CNonMBTrackList(*Other.m_NonMBTrackList);
+		}
+
+		~CCDStubPrivate()
+		{
+			delete m_NonMBTrackList;
+		}
+
 		std::string m_ID;
 		std::string m_Title;
 		std::string m_Artist;
@@ -60,44 +80,46 @@ MusicBrainz5::CCDStub::CCDStub(const XMLNode& Node)
 }
 
 MusicBrainz5::CCDStub::CCDStub(const CCDStub& Other)
-:	CEntity(),
-	m_d(new CCDStubPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CCDStub& MusicBrainz5::CCDStub::operator =(const CCDStub& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Barcode=Other.m_d->m_Barcode;
-		m_d->m_Comment=Other.m_d->m_Comment;
-
-		if (Other.m_d->m_NonMBTrackList)
-			m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CCDStub::~CCDStub()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CCDStub::CCDStub(CCDStub&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CCDStubPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CCDStub& MusicBrainz5::CCDStub::operator =(CCDStub&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CCDStub::Cleanup()
+MusicBrainz5::CCDStub::~CCDStub()
 {
-	delete m_d->m_NonMBTrackList;
-	m_d->m_NonMBTrackList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CCDStub *MusicBrainz5::CCDStub::Clone()
@@ -107,6 +129,8 @@ MusicBrainz5::CCDStub *MusicBrainz5::CCDStub::Clone()
 
 void MusicBrainz5::CCDStub::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -119,33 +143,35 @@ void MusicBrainz5::CCDStub::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CCDStub::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("barcode"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Barcode);
-	}
-	else if ("comment"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Comment);
-	}
-	else if ("track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_NonMBTrackList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElementBarcode:
+			ProcessItem(Node,m_d->m_Barcode);
+			break;
+
+		case eElementComment:
+			ProcessItem(Node,m_d->m_Comment);
+			break;
+
+		case eElementTrackList:
+			ProcessItem(Node,m_d->m_NonMBTrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised cd stub element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised cd stub element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -154,36 +180,43 @@ std::string MusicBrainz5::CCDStub::GetElementName()
 	return "cdstub";
 }
 
-std::string MusicBrainz5::CCDStub::ID() const
+const std::string& MusicBrainz5::CCDStub::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CCDStub::Title() const
+const std::string& MusicBrainz5::CCDStub::Title() const
 {
 	return m_d->m_Title;
 }
 
-std::string MusicBrainz5::CCDStub::Artist() const
+const std::string& MusicBrainz5::CCDStub::Artist() const
 {
 	return m_d->m_Artist;
 }
 
-std::string MusicBrainz5::CCDStub::Barcode() const
+const std::string& MusicBrainz5::CCDStub::Barcode() const
 {
 	return m_d->m_Barcode;
 }
 
-std::string MusicBrainz5::CCDStub::Comment() const
+const std::string& MusicBrainz5::CCDStub::Comment() const
 {
 	return m_d->m_Comment;
 }
 
-MusicBrainz5::CNonMBTrackList *MusicBrainz5::CCDStub::NonMBTrackList() const
+const MusicBrainz5::CNonMBTrackList *MusicBrainz5::CCDStub::NonMBTrackList() const
 {
 	return m_d->m_NonMBTrackList;
 }
 
+MusicBrainz5::CNonMBTrackList *MusicBrainz5::CCDStub::NonMBTrackList()
+{
+	Unshare(m_d);
+
+	return m_d->m_NonMBTrackList;
+}
+
 std::ostream& MusicBrainz5::CCDStub::Serialise(std::ostream& os) const
 {
 	os << "CDStub:" << std::endl;
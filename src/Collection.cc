@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CCollectionPrivate
+class MusicBrainz5::CCollectionPrivate: public CSharedPrivate
 {
 	public:
 		CCollectionPrivate()
@@ -39,6 +41,22 @@ class MusicBrainz5::CCollectionPrivate
 		{
 		}
 
+		CCollectionPrivate(const CCollectionPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Name(Other.m_Name),
+			m_Editor(Other.m_Editor),
+			m_ReleaseList(0)
+		{
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+		}
+
+		~CCollectionPrivate()
+		{
+			delete m_ReleaseList;
+		}
+
 		std::string m_ID;
 		std::string m_Name;
 		std::string m_Editor;
@@ -57,42 +75,46 @@ MusicBrainz5::CCollection::CCollection(const XMLNode& Node)
 }
 
 MusicBrainz5::CCollection::CCollection(const CCollection& Other)
-:	CEntity(),
-	m_d(new CCollectionPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CCollection& MusicBrainz5::CCollection::operator =(const CCollection& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_Editor=Other.m_d->m_Editor;
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CCollection::~CCollection()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CCollection::CCollection(CCollection&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CCollectionPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CCollection& MusicBrainz5::CCollection::operator =(CCollection&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CCollection::Cleanup()
+MusicBrainz5::CCollection::~CCollection()
 {
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CCollection *MusicBrainz5::CCollection::Clone()
@@ -102,6 +124,8 @@ MusicBrainz5::CCollection *MusicBrainz5::CCollection::Clone()
 
 void MusicBrainz5::CCollection::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -114,25 +138,27 @@ void MusicBrainz5::CCollection::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CCollection::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("editor"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Editor);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElementEditor:
+			ProcessItem(Node,m_d->m_Editor);
+			break;
+
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised collection element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised collection element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -141,26 +167,38 @@ std::string MusicBrainz5::CCollection::GetElementName()
 	return "collection";
 }
 
-std::string MusicBrainz5::CCollection::ID() const
+const std::string& MusicBrainz5::CCollection::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CCollection::Name() const
+MusicBrainz5::CMBID MusicBrainz5::CCollection::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CCollection::Name() const
 {
 	return m_d->m_Name;
 }
 
-std::string MusicBrainz5::CCollection::Editor() const
+const std::string& MusicBrainz5::CCollection::Editor() const
 {
 	return m_d->m_Editor;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CCollection::ReleaseList() const
+const MusicBrainz5::CReleaseList *MusicBrainz5::CCollection::ReleaseList() const
 {
 	return m_d->m_ReleaseList;
 }
 
+MusicBrainz5::CReleaseList *MusicBrainz5::CCollection::ReleaseList()
+{
+	Unshare(m_d);
+
+	return m_d->m_ReleaseList;
+}
+
 std::ostream& MusicBrainz5::CCollection::Serialise(std::ostream& os) const
 {
 	os << "Collection:" << std::endl;
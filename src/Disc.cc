@@ -32,8 +32,10 @@
 #include "musicbrainz5/Offset.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CDiscPrivate
+class MusicBrainz5::CDiscPrivate: public CSharedPrivate
 {
 	public:
 		CDiscPrivate()
@@ -43,6 +45,26 @@ class MusicBrainz5::CDiscPrivate
 		{
 		}
 
+		CDiscPrivate(const CDiscPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Sectors(Other.m_Sectors),
+			m_OffsetList(0),
+			m_ReleaseList(0)
+		{
+			if (Other.m_OffsetList)
+				m_OffsetList=new COffsetList(*Other.m_OffsetList);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+		}
+
+		~CDiscPrivate()
+		{
+			delete m_OffsetList;
+			delete m_ReleaseList;
+		}
+
 		std::string m_ID;
 		int m_Sectors;
 		COffsetList *m_OffsetList;
@@ -62,45 +84,46 @@ MusicBrainz5::CDisc::CDisc(const XMLNode& Node)
 }
 
 MusicBrainz5::CDisc::CDisc(const CDisc& Other)
-:	CEntity(),
-	m_d(new CDiscPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CDisc& MusicBrainz5::CDisc::operator =(const CDisc& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Sectors=Other.m_d->m_Sectors;
-
-		if (Other.m_d->m_OffsetList)
-			m_d->m_OffsetList=new COffsetList(*Other.m_d->m_OffsetList);
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CDisc::~CDisc()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CDisc::CDisc(CDisc&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CDiscPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
 
-	delete m_d;
+MusicBrainz5::CDisc& MusicBrainz5::CDisc::operator =(CDisc&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CDisc::Cleanup()
+MusicBrainz5::CDisc::~CDisc()
 {
-	delete m_d->m_OffsetList;
-	m_d->m_OffsetList=0;
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CDisc *MusicBrainz5::CDisc::Clone()
@@ -110,6 +133,8 @@ MusicBrainz5::CDisc *MusicBrainz5::CDisc::Clone()
 
 void MusicBrainz5::CDisc::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		ProcessItem(Value,m_d->m_ID);
 	else
@@ -122,24 +147,27 @@ void MusicBrainz5::CDisc::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CDisc::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("sectors"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Sectors);
-	}
-	else if ("offset-list"==NodeName) {
-		ProcessItem(Node,m_d->m_OffsetList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementSectors:
+			ProcessItem(Node,m_d->m_Sectors);
+			break;
+
+		case eElementOffsetList:
+			ProcessItem(Node,m_d->m_OffsetList);
+			break;
+
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised disc element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised disc element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -148,7 +176,7 @@ std::string MusicBrainz5::CDisc::GetElementName()
 	return "disc";
 }
 
-std::string MusicBrainz5::CDisc::ID() const
+const std::string& MusicBrainz5::CDisc::ID() const
 {
 	return m_d->m_ID;
 }
@@ -158,13 +186,27 @@ int MusicBrainz5::CDisc::Sectors() const
 	return m_d->m_Sectors;
 }
 
-MusicBrainz5::COffsetList *MusicBrainz5::CDisc::OffsetList() const
+const MusicBrainz5::COffsetList *MusicBrainz5::CDisc::OffsetList() const
 {
 	return m_d->m_OffsetList;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CDisc::ReleaseList() const
+MusicBrainz5::COffsetList *MusicBrainz5::CDisc::OffsetList()
 {
+	Unshare(m_d);
+
+	return m_d->m_OffsetList;
+}
+
+const MusicBrainz5::CReleaseList *MusicBrainz5::CDisc::ReleaseList() const
+{
+	return m_d->m_ReleaseList;
+}
+
+MusicBrainz5::CReleaseList *MusicBrainz5::CDisc::ReleaseList()
+{
+	Unshare(m_d);
+
 	return m_d->m_ReleaseList;
 }
 
@@ -0,0 +1,1303 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/DiskCache.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+//Layout of the index file and of the records in the segment files. A record is
+//a header followed by the key, the validators (the ETag and Last-Modified headers,
+//separated by a newline), and the compressed body.
+//
+//Requests that found nothing are recorded with an empty body. A Bloom filter of
+//their keys is kept in a separate file, so that most keys can be ruled out
+//without taking the lock.
+
+namespace
+{
+	const unsigned int IndexMagic=0x4342354d;
+	const unsigned int IndexVersion=3;
+	const unsigned int RecordMagic=0x5342354d;
+	const unsigned int MinBuckets=1024;
+	const unsigned int BloomBits=1024*1024;
+	const unsigned int BloomHashes=7;
+
+	enum tRecordFlags
+	{
+		eRecordRemoved=1,
+		eRecordNotFound=2
+	};
+
+	struct CIndexHeader
+	{
+		unsigned int m_Magic;
+		unsigned int m_Version;
+		unsigned int m_Dirty;
+		unsigned int m_NumBuckets;
+		unsigned int m_NumUsed;
+		unsigned int m_NumLive;
+		unsigned int m_FirstSegment;
+		unsigned int m_ActiveSegment;
+		unsigned long long m_ActiveSize;
+		unsigned long long m_TotalSize;
+		unsigned long long m_LiveSize;
+		unsigned long long m_Reserved;
+	};
+
+	//An empty slot has a hash of zero, and a slot whose response has been removed
+	//has a length of zero
+
+	struct CIndexSlot
+	{
+		unsigned long long m_Hash;
+		unsigned long long m_Offset;
+		unsigned int m_Segment;
+		unsigned int m_Length;
+		long long m_Stored;
+		unsigned int m_Flags;
+		unsigned int m_Reserved;
+	};
+
+	struct CRecordHeader
+	{
+		unsigned int m_Magic;
+		unsigned int m_KeyLength;
+		unsigned int m_ValidatorLength;
+		unsigned int m_DataLength;
+		unsigned int m_UncompressedLength;
+		unsigned int m_Flags;
+		long long m_Stored;
+		unsigned int m_CRC;
+		unsigned int m_Reserved;
+	};
+
+	bool SlotOrder(const CIndexSlot& Left, const CIndexSlot& Right)
+	{
+		if (Left.m_Segment!=Right.m_Segment)
+			return Left.m_Segment<Right.m_Segment;
+
+		return Left.m_Offset<Right.m_Offset;
+	}
+}
+
+class MusicBrainz5::CDiskCachePrivate
+{
+	public:
+		CDiskCachePrivate()
+		:	m_MaxSize(0),
+			m_TTL(0),
+			m_NegativeTTL(24*60*60),
+			m_IndexFD(-1),
+			m_Map(0),
+			m_MapSize(0),
+			m_Header(0),
+			m_Slots(0),
+			m_BloomFD(-1),
+			m_Bloom(0),
+			m_Hits(0),
+			m_Misses(0),
+			m_Evictions(0)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CDiskCachePrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		std::string m_Directory;
+		size_t m_MaxSize;
+		int m_TTL;
+		int m_NegativeTTL;
+		mutable pthread_mutex_t m_Mutex;
+		int m_IndexFD;
+		void *m_Map;
+		size_t m_MapSize;
+		CIndexHeader *m_Header;
+		CIndexSlot *m_Slots;
+		int m_BloomFD;
+		unsigned char *m_Bloom;
+		std::map<unsigned int,int> m_Segments;
+		unsigned long m_Hits;
+		unsigned long m_Misses;
+		unsigned long m_Evictions;
+
+		static unsigned long long Hash(const std::string& Key);
+		static size_t IndexSize(unsigned int NumBuckets);
+
+		size_t SegmentSize() const;
+		std::string SegmentName(unsigned int Number) const;
+		int Segment(unsigned int Number, bool Create);
+		void RemoveSegment(unsigned int Number);
+		std::vector<unsigned int> ListSegments() const;
+		unsigned long long ScanSegment(unsigned int Number, std::map<unsigned long long,CIndexSlot>& Found);
+
+		bool Map();
+		void Unmap();
+		void SyncIndex(bool HeaderOnly);
+		void MapBloom();
+		void BloomAdd(unsigned long long Hash);
+		bool BloomTest(unsigned long long Hash) const;
+		bool Check();
+		bool Rebuild();
+		bool Reindex(CIndexHeader Header, const std::vector<CIndexSlot>& Slots);
+		CIndexSlot *Find(unsigned long long Hash, bool Free);
+		bool Matches(const CIndexSlot& Slot, const std::string& Key);
+		void Insert(const CIndexSlot& Slot);
+		void Erase(CIndexSlot& Slot);
+		bool Expired(const CIndexSlot& Slot) const;
+		void Evict(unsigned int Number);
+		bool Append(const std::vector<unsigned char>& Record, CIndexSlot *Slot=0);
+		void Maintain();
+		void Compact();
+		bool Read(const std::string& Key, bool Stale, std::string& Data, std::string& Validators);
+		static std::vector<unsigned char> MakeRecord(const std::string& Key, const std::string& Validators, const std::string& Data, int Flags);
+};
+
+//Holds both the mutex, which serialises threads, and the lock on the index file,
+//which serialises processes, for as long as it is in scope
+
+class CDiskCacheLock
+{
+	public:
+		CDiskCacheLock(pthread_mutex_t *Mutex, int FD)
+		:	m_Mutex(Mutex),
+			m_FD(FD)
+		{
+			pthread_mutex_lock(m_Mutex);
+
+			if (-1!=m_FD)
+				while (0!=flock(m_FD,LOCK_EX) && EINTR==errno)
+					;
+		}
+
+		~CDiskCacheLock()
+		{
+			if (-1!=m_FD)
+				flock(m_FD,LOCK_UN);
+
+			pthread_mutex_unlock(m_Mutex);
+		}
+
+	private:
+		pthread_mutex_t *m_Mutex;
+		int m_FD;
+};
+
+unsigned long long MusicBrainz5::CDiskCachePrivate::Hash(const std::string& Key)
+{
+	//64 bit FNV-1a, avoiding the value that marks an empty slot
+
+	unsigned long long Ret=14695981039346656037ULL;
+
+	for (std::string::size_type Pos=0;Pos<Key.length();Pos++)
+	{
+		Ret^=(unsigned char)Key[Pos];
+		Ret*=1099511628211ULL;
+	}
+
+	return Ret ? Ret : 1;
+}
+
+size_t MusicBrainz5::CDiskCachePrivate::IndexSize(unsigned int NumBuckets)
+{
+	return sizeof(CIndexHeader)+NumBuckets*sizeof(CIndexSlot);
+}
+
+size_t MusicBrainz5::CDiskCachePrivate::SegmentSize() const
+{
+	size_t Ret=m_MaxSize/8;
+
+	if (Ret<64*1024)
+		Ret=64*1024;
+
+	if (Ret>64*1024*1024)
+		Ret=64*1024*1024;
+
+	return Ret;
+}
+
+std::string MusicBrainz5::CDiskCachePrivate::SegmentName(unsigned int Number) const
+{
+	char Name[16];
+	snprintf(Name,sizeof(Name),"%08x.seg",Number);
+
+	return m_Directory+"/"+Name;
+}
+
+int MusicBrainz5::CDiskCachePrivate::Segment(unsigned int Number, bool Create)
+{
+	std::map<unsigned int,int>::iterator ThisSegment=m_Segments.find(Number);
+	if (ThisSegment!=m_Segments.end())
+	{
+		//Another process may have removed the file since it was opened
+
+		struct stat Info;
+		if (!Create || (0==fstat((*ThisSegment).second,&Info) && Info.st_nlink>0))
+			return (*ThisSegment).second;
+
+		close((*ThisSegment).second);
+		m_Segments.erase(ThisSegment);
+	}
+
+	int FD=open(SegmentName(Number).c_str(),Create ? O_RDWR|O_CREAT : O_RDWR,0644);
+	if (-1!=FD)
+		m_Segments[Number]=FD;
+
+	return FD;
+}
+
+void MusicBrainz5::CDiskCachePrivate::RemoveSegment(unsigned int Number)
+{
+	std::map<unsigned int,int>::iterator ThisSegment=m_Segments.find(Number);
+	if (ThisSegment!=m_Segments.end())
+	{
+		close((*ThisSegment).second);
+		m_Segments.erase(ThisSegment);
+	}
+
+	unlink(SegmentName(Number).c_str());
+}
+
+std::vector<unsigned int> MusicBrainz5::CDiskCachePrivate::ListSegments() const
+{
+	std::vector<unsigned int> Ret;
+
+	DIR *Dir=opendir(m_Directory.c_str());
+	if (Dir)
+	{
+		struct dirent *Entry;
+
+		while (0!=(Entry=readdir(Dir)))
+		{
+			char *End=0;
+			unsigned long Number=strtoul(Entry->d_name,&End,16);
+
+			if (End==Entry->d_name+8 && 0==strcmp(End,".seg"))
+				Ret.push_back(Number);
+		}
+
+		closedir(Dir);
+	}
+
+	std::sort(Ret.begin(),Ret.end());
+
+	return Ret;
+}
+
+unsigned long long MusicBrainz5::CDiskCachePrivate::ScanSegment(unsigned int Number, std::map<unsigned long long,CIndexSlot>& Found)
+{
+	//Returns the length of the segment up to the first record that isn't complete
+
+	unsigned long long Offset=0;
+
+	int FD=Segment(Number,false);
+	if (-1==FD)
+		return Offset;
+
+	struct stat Info;
+	if (0!=fstat(FD,&Info))
+		return Offset;
+
+	unsigned long long Size=Info.st_size;
+	std::vector<unsigned char> Buffer;
+
+	while (Offset+sizeof(CRecordHeader)<=Size)
+	{
+		CRecordHeader Record;
+		if (sizeof(Record)!=pread(FD,&Record,sizeof(Record),Offset))
+			break;
+
+		unsigned long long Length=(unsigned long long)sizeof(Record)+Record.m_KeyLength+Record.m_ValidatorLength+Record.m_DataLength;
+		if (RecordMagic!=Record.m_Magic || 0==Record.m_KeyLength || Offset+Length>Size)
+			break;
+
+		Buffer.resize(Length-sizeof(Record));
+		if ((ssize_t)Buffer.size()!=pread(FD,&Buffer[0],Buffer.size(),Offset+sizeof(Record)))
+			break;
+
+		if (Record.m_CRC!=crc32(0,&Buffer[0],Buffer.size()))
+			break;
+
+		CIndexSlot Slot;
+		Slot.m_Hash=Hash(std::string(Buffer.begin(),Buffer.begin()+Record.m_KeyLength));
+		Slot.m_Offset=Offset;
+		Slot.m_Segment=Number;
+		Slot.m_Length=Length;
+		Slot.m_Stored=Record.m_Stored;
+		Slot.m_Flags=Record.m_Flags&eRecordNotFound;
+		Slot.m_Reserved=0;
+
+		if (Record.m_Flags&eRecordRemoved)
+			Found.erase(Slot.m_Hash);
+		else
+			Found[Slot.m_Hash]=Slot;
+
+		Offset+=Length;
+	}
+
+	return Offset;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Map()
+{
+	Unmap();
+
+	struct stat Info;
+	if (0!=fstat(m_IndexFD,&Info))
+		return false;
+
+	if ((size_t)Info.st_size<sizeof(CIndexHeader))
+		return true;
+
+	m_Map=mmap(0,Info.st_size,PROT_READ|PROT_WRITE,MAP_SHARED,m_IndexFD,0);
+	if (MAP_FAILED==m_Map)
+	{
+		m_Map=0;
+		return false;
+	}
+
+	m_MapSize=Info.st_size;
+	m_Header=static_cast<CIndexHeader *>(m_Map);
+	m_Slots=reinterpret_cast<CIndexSlot *>(m_Header+1);
+
+	return true;
+}
+
+void MusicBrainz5::CDiskCachePrivate::Unmap()
+{
+	if (m_Map)
+		munmap(m_Map,m_MapSize);
+
+	m_Map=0;
+	m_MapSize=0;
+	m_Header=0;
+	m_Slots=0;
+}
+
+void MusicBrainz5::CDiskCachePrivate::SyncIndex(bool HeaderOnly)
+{
+	if (m_Map)
+		msync(m_Map,HeaderOnly ? sizeof(CIndexHeader) : m_MapSize,MS_SYNC);
+}
+
+void MusicBrainz5::CDiskCachePrivate::MapBloom()
+{
+	//Called with the lock held. Without the filter, every key is checked in the index.
+
+	if (-1==m_BloomFD)
+		return;
+
+	struct stat Info;
+	if (0!=fstat(m_BloomFD,&Info) || ((size_t)Info.st_size!=BloomBits/8 && 0!=ftruncate(m_BloomFD,BloomBits/8)))
+		return;
+
+	void *Map=mmap(0,BloomBits/8,PROT_READ|PROT_WRITE,MAP_SHARED,m_BloomFD,0);
+	if (MAP_FAILED!=Map)
+		m_Bloom=static_cast<unsigned char *>(Map);
+}
+
+void MusicBrainz5::CDiskCachePrivate::BloomAdd(unsigned long long Hash)
+{
+	if (!m_Bloom)
+		return;
+
+	//Double hashing, using the two halves of the key's hash
+
+	unsigned int Hash1=Hash;
+	unsigned int Hash2=(Hash>>32)|1;
+
+	for (unsigned int count=0;count<BloomHashes;count++)
+	{
+		unsigned int Bit=(Hash1+count*Hash2)%BloomBits;
+		__sync_fetch_and_or(&m_Bloom[Bit/8],(unsigned char)(1<<(Bit%8)));
+	}
+}
+
+bool MusicBrainz5::CDiskCachePrivate::BloomTest(unsigned long long Hash) const
+{
+	if (!m_Bloom)
+		return true;
+
+	unsigned int Hash1=Hash;
+	unsigned int Hash2=(Hash>>32)|1;
+
+	for (unsigned int count=0;count<BloomHashes;count++)
+	{
+		unsigned int Bit=(Hash1+count*Hash2)%BloomBits;
+		if (0==(m_Bloom[Bit/8]&(1<<(Bit%8))))
+			return false;
+	}
+
+	return true;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Check()
+{
+	//Called with the lock held, before the index is used. Another process may have
+	//resized the index, or crashed while rebuilding it.
+
+	if (-1==m_IndexFD)
+		return false;
+
+	if (!m_Header || m_MapSize!=IndexSize(m_Header->m_NumBuckets))
+	{
+		if (!Map())
+			return false;
+	}
+
+	if (!m_Header ||
+			IndexMagic!=m_Header->m_Magic ||
+			IndexVersion!=m_Header->m_Version ||
+			0==m_Header->m_NumBuckets ||
+			0!=(m_Header->m_NumBuckets&(m_Header->m_NumBuckets-1)) ||
+			m_MapSize!=IndexSize(m_Header->m_NumBuckets) ||
+			m_Header->m_Dirty)
+	{
+		if (!Rebuild())
+			return false;
+	}
+
+	//Segments before the first have been removed, perhaps by another process, and
+	//keeping them open would stop their space being freed
+
+	while (!m_Segments.empty() && (*m_Segments.begin()).first<m_Header->m_FirstSegment)
+	{
+		close((*m_Segments.begin()).second);
+		m_Segments.erase(m_Segments.begin());
+	}
+
+	return true;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Rebuild()
+{
+	std::vector<unsigned int> Numbers=ListSegments();
+	std::map<unsigned long long,CIndexSlot> Found;
+
+	CIndexHeader Header;
+	memset(&Header,0,sizeof(Header));
+
+	Header.m_FirstSegment=Numbers.empty() ? 1 : Numbers.front();
+	Header.m_ActiveSegment=Numbers.empty() ? 1 : Numbers.back();
+
+	for (std::vector<unsigned int>::size_type count=0;count<Numbers.size();count++)
+	{
+		unsigned long long Size=ScanSegment(Numbers[count],Found);
+
+		Header.m_TotalSize+=Size;
+
+		if (count==Numbers.size()-1)
+		{
+			//Drop anything left incomplete at the end of the segment being written to
+
+			int FD=Segment(Numbers[count],false);
+			if (-1!=FD && 0!=ftruncate(FD,Size))
+				Size=0;
+
+			Header.m_ActiveSize=Size;
+		}
+	}
+
+	std::vector<CIndexSlot> Slots;
+
+	std::map<unsigned long long,CIndexSlot>::const_iterator ThisSlot=Found.begin();
+	while (ThisSlot!=Found.end())
+	{
+		Slots.push_back((*ThisSlot).second);
+		++ThisSlot;
+	}
+
+	return Reindex(Header,Slots);
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Reindex(CIndexHeader Header, const std::vector<CIndexSlot>& Slots)
+{
+	//The index is marked dirty until it is complete, so that it is rebuilt if this
+	//process dies part way through. The mark is flushed to disk first, and the whole
+	//index once it is complete, so that the same holds if the system crashes.
+
+	unsigned int NumBuckets=MinBuckets;
+	while (NumBuckets<Slots.size()*2)
+		NumBuckets*=2;
+
+	if (m_Header)
+	{
+		m_Header->m_Dirty=1;
+		__sync_synchronize();
+		SyncIndex(true);
+	}
+
+	if (0!=ftruncate(m_IndexFD,IndexSize(NumBuckets)) || !Map() || !m_Header)
+		return false;
+
+	m_Header->m_Dirty=1;
+	__sync_synchronize();
+	SyncIndex(true);
+
+	memset(m_Slots,0,NumBuckets*sizeof(CIndexSlot));
+
+	Header.m_Magic=IndexMagic;
+	Header.m_Version=IndexVersion;
+	Header.m_Dirty=1;
+	Header.m_NumBuckets=NumBuckets;
+	Header.m_NumUsed=0;
+	Header.m_NumLive=0;
+	Header.m_LiveSize=0;
+
+	*m_Header=Header;
+
+	//Keys can't be removed from the Bloom filter, so it is rebuilt along with the
+	//index to stop it filling up with keys that have expired
+
+	if (m_Bloom)
+		memset(m_Bloom,0,BloomBits/8);
+
+	for (std::vector<CIndexSlot>::size_type count=0;count<Slots.size();count++)
+	{
+		if (Slots[count].m_Flags&eRecordNotFound)
+			BloomAdd(Slots[count].m_Hash);
+
+		Insert(Slots[count]);
+	}
+
+	__sync_synchronize();
+	m_Header->m_Dirty=0;
+	SyncIndex(false);
+
+	return true;
+}
+
+CIndexSlot *MusicBrainz5::CDiskCachePrivate::Find(unsigned long long Hash, bool Free)
+{
+	//Linear probing. If Free is set, returns the slot a new entry should go in when
+	//the hash isn't found.
+
+	unsigned int Mask=m_Header->m_NumBuckets-1;
+	unsigned int Pos=Hash&Mask;
+
+	for (unsigned int count=0;count<m_Header->m_NumBuckets;count++)
+	{
+		CIndexSlot& Slot=m_Slots[Pos];
+
+		if (Hash==Slot.m_Hash)
+			return &Slot;
+
+		if (0==Slot.m_Hash)
+			return Free ? &Slot : 0;
+
+		Pos=(Pos+1)&Mask;
+	}
+
+	return 0;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Matches(const CIndexSlot& Slot, const std::string& Key)
+{
+	//Slots are found by their hash alone, so the key in the record is compared to
+	//rule out a different key with the same hash
+
+	int FD=Segment(Slot.m_Segment,false);
+	if (-1==FD || Slot.m_Length<sizeof(CRecordHeader)+Key.length())
+		return false;
+
+	std::vector<char> Buffer(sizeof(CRecordHeader)+Key.length());
+	if ((ssize_t)Buffer.size()!=pread(FD,&Buffer[0],Buffer.size(),Slot.m_Offset))
+		return false;
+
+	CRecordHeader Record;
+	memcpy(&Record,&Buffer[0],sizeof(Record));
+
+	return RecordMagic==Record.m_Magic &&
+		Key.length()==Record.m_KeyLength &&
+		0==Key.compare(0,Key.length(),&Buffer[sizeof(Record)],Key.length());
+}
+
+void MusicBrainz5::CDiskCachePrivate::Insert(const CIndexSlot& New)
+{
+	CIndexSlot *Slot=Find(New.m_Hash,true);
+	if (!Slot)
+		return;
+
+	if (0==Slot->m_Hash)
+		m_Header->m_NumUsed++;
+	else if (Slot->m_Length)
+		Erase(*Slot);
+
+	Slot->m_Offset=New.m_Offset;
+	Slot->m_Segment=New.m_Segment;
+	Slot->m_Length=New.m_Length;
+	Slot->m_Stored=New.m_Stored;
+	Slot->m_Flags=New.m_Flags;
+	Slot->m_Reserved=0;
+	__sync_synchronize();
+	Slot->m_Hash=New.m_Hash;
+
+	m_Header->m_NumLive++;
+	m_Header->m_LiveSize+=New.m_Length;
+}
+
+void MusicBrainz5::CDiskCachePrivate::Erase(CIndexSlot& Slot)
+{
+	m_Header->m_NumLive--;
+	m_Header->m_LiveSize-=Slot.m_Length;
+
+	Slot.m_Length=0;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Expired(const CIndexSlot& Slot) const
+{
+	return time(0)-Slot.m_Stored>=(Slot.m_Flags&eRecordNotFound ? m_NegativeTTL : m_TTL);
+}
+
+void MusicBrainz5::CDiskCachePrivate::Evict(unsigned int Number)
+{
+	for (unsigned int count=0;count<m_Header->m_NumBuckets;count++)
+	{
+		CIndexSlot& Slot=m_Slots[count];
+
+		if (Slot.m_Hash && Slot.m_Length && Number==Slot.m_Segment)
+		{
+			Erase(Slot);
+			m_Evictions++;
+		}
+	}
+
+	struct stat Info;
+	if (0==stat(SegmentName(Number).c_str(),&Info))
+		m_Header->m_TotalSize-=std::min((unsigned long long)Info.st_size,m_Header->m_TotalSize);
+
+	RemoveSegment(Number);
+
+	if (Number==m_Header->m_FirstSegment)
+		m_Header->m_FirstSegment++;
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Append(const std::vector<unsigned char>& Record, CIndexSlot *Slot)
+{
+	if (m_Header->m_ActiveSize && m_Header->m_ActiveSize+Record.size()>SegmentSize())
+	{
+		m_Header->m_ActiveSegment++;
+		m_Header->m_ActiveSize=0;
+	}
+
+	int FD=Segment(m_Header->m_ActiveSegment,true);
+	if (-1==FD || (ssize_t)Record.size()!=pwrite(FD,&Record[0],Record.size(),m_Header->m_ActiveSize))
+		return false;
+
+	if (Slot)
+	{
+		Slot->m_Offset=m_Header->m_ActiveSize;
+		Slot->m_Segment=m_Header->m_ActiveSegment;
+		Slot->m_Length=Record.size();
+	}
+
+	m_Header->m_ActiveSize+=Record.size();
+	m_Header->m_TotalSize+=Record.size();
+
+	return true;
+}
+
+void MusicBrainz5::CDiskCachePrivate::Maintain()
+{
+	while (m_Header->m_TotalSize>m_MaxSize && m_Header->m_FirstSegment<m_Header->m_ActiveSegment)
+		Evict(m_Header->m_FirstSegment);
+
+	if (m_Header->m_TotalSize>SegmentSize() && m_Header->m_TotalSize>2*m_Header->m_LiveSize)
+		Compact();
+	else if (m_Header->m_NumUsed*10ULL>m_Header->m_NumBuckets*7ULL)
+	{
+		//Too full, or too many removed entries, for probing to stay quick
+
+		std::vector<CIndexSlot> Slots;
+
+		for (unsigned int count=0;count<m_Header->m_NumBuckets;count++)
+			if (m_Slots[count].m_Hash && m_Slots[count].m_Length)
+				Slots.push_back(m_Slots[count]);
+
+		Reindex(*m_Header,Slots);
+	}
+}
+
+void MusicBrainz5::CDiskCachePrivate::Compact()
+{
+	std::vector<CIndexSlot> Slots;
+
+	for (unsigned int count=0;count<m_Header->m_NumBuckets;count++)
+	{
+		const CIndexSlot& Slot=m_Slots[count];
+
+		if (Slot.m_Hash && Slot.m_Length)
+		{
+			if (Expired(Slot))
+				m_Evictions++;
+			else
+				Slots.push_back(Slot);
+		}
+	}
+
+	std::sort(Slots.begin(),Slots.end(),SlotOrder);
+
+	//Live records are copied to new segments. Until the index is rewritten it is
+	//marked dirty, so a crash leaves both copies to be found by a rebuild.
+
+	m_Header->m_Dirty=1;
+	__sync_synchronize();
+	SyncIndex(true);
+
+	CIndexHeader Header=*m_Header;
+	unsigned int OldFirst=Header.m_FirstSegment;
+	unsigned int OldActive=Header.m_ActiveSegment;
+
+	Header.m_FirstSegment=OldActive+1;
+	Header.m_ActiveSegment=OldActive+1;
+	Header.m_ActiveSize=0;
+	Header.m_TotalSize=0;
+
+	std::vector<CIndexSlot> Moved;
+	std::vector<unsigned char> Buffer;
+
+	for (std::vector<CIndexSlot>::size_type count=0;count<Slots.size();count++)
+	{
+		CIndexSlot Slot=Slots[count];
+
+		int From=Segment(Slot.m_Segment,false);
+		if (-1==From)
+			continue;
+
+		Buffer.resize(Slot.m_Length);
+		if ((ssize_t)Buffer.size()!=pread(From,&Buffer[0],Buffer.size(),Slot.m_Offset))
+			continue;
+
+		if (Header.m_ActiveSize && Header.m_ActiveSize+Slot.m_Length>SegmentSize())
+		{
+			Header.m_ActiveSegment++;
+			Header.m_ActiveSize=0;
+		}
+
+		int To=Segment(Header.m_ActiveSegment,true);
+		if (-1==To || (ssize_t)Buffer.size()!=pwrite(To,&Buffer[0],Buffer.size(),Header.m_ActiveSize))
+		{
+			//Leave the old segments in place, and index whatever is there
+
+			Rebuild();
+			return;
+		}
+
+		Slot.m_Segment=Header.m_ActiveSegment;
+		Slot.m_Offset=Header.m_ActiveSize;
+		Moved.push_back(Slot);
+
+		Header.m_ActiveSize+=Slot.m_Length;
+		Header.m_TotalSize+=Slot.m_Length;
+	}
+
+	//The copies must be on disk before the originals are removed
+
+	for (unsigned int Number=OldActive+1;Number<=Header.m_ActiveSegment;Number++)
+	{
+		int FD=Segment(Number,false);
+		if (-1!=FD)
+			fdatasync(FD);
+	}
+
+	for (unsigned int Number=OldFirst;Number<=OldActive;Number++)
+		RemoveSegment(Number);
+
+	Reindex(Header,Moved);
+}
+
+bool MusicBrainz5::CDiskCachePrivate::Read(const std::string& Key, bool Stale, std::string& Data, std::string& Validators)
+{
+	CRecordHeader Record;
+	std::vector<unsigned char> Buffer;
+
+	{
+		CDiskCacheLock Lock(&m_Mutex,m_IndexFD);
+
+		CIndexSlot *Slot=0;
+		if (Check())
+			Slot=Find(Hash(Key),false);
+
+		int FD=-1;
+		if (Slot && Slot->m_Length && 0==(Slot->m_Flags&eRecordNotFound) && (Stale || !Expired(*Slot)))
+			FD=Segment(Slot->m_Segment,false);
+
+		bool Found=false;
+
+		if (-1!=FD && Slot->m_Length>sizeof(Record)+Key.length())
+		{
+			Buffer.resize(Slot->m_Length);
+
+			if ((ssize_t)Buffer.size()==pread(FD,&Buffer[0],Buffer.size(),Slot->m_Offset))
+			{
+				memcpy(&Record,&Buffer[0],sizeof(Record));
+
+				Found=RecordMagic==Record.m_Magic &&
+					0==(Record.m_Flags&(eRecordRemoved|eRecordNotFound)) &&
+					Key.length()==Record.m_KeyLength &&
+					Buffer.size()==sizeof(Record)+Record.m_KeyLength+Record.m_ValidatorLength+Record.m_DataLength &&
+					0==Key.compare(0,Key.length(),(const char *)&Buffer[sizeof(Record)],Key.length()) &&
+					Record.m_CRC==crc32(0,&Buffer[sizeof(Record)],Buffer.size()-sizeof(Record));
+			}
+		}
+
+		if (!Stale)
+		{
+			if (Found)
+				m_Hits++;
+			else
+				m_Misses++;
+		}
+
+		if (!Found)
+			return false;
+	}
+
+	//The body is decompressed without holding the lock
+
+	const unsigned char *Start=&Buffer[sizeof(Record)+Record.m_KeyLength];
+	Validators.assign((const char *)Start,Record.m_ValidatorLength);
+	Start+=Record.m_ValidatorLength;
+
+	std::vector<char> Uncompressed(Record.m_UncompressedLength+1);
+	uLongf Length=Record.m_UncompressedLength;
+
+	if (Z_OK!=uncompress((Bytef *)&Uncompressed[0],&Length,Start,Record.m_DataLength) ||
+			Length!=Record.m_UncompressedLength)
+		return false;
+
+	Data.assign(&Uncompressed[0],Length);
+
+	return true;
+}
+
+std::vector<unsigned char> MusicBrainz5::CDiskCachePrivate::MakeRecord(const std::string& Key, const std::string& Validators, const std::string& Data, int Flags)
+{
+	//Returns an empty buffer if the body couldn't be compressed
+
+	size_t Start=sizeof(CRecordHeader)+Key.length()+Validators.length();
+
+	uLongf Length=compressBound(Data.length());
+	std::vector<unsigned char> Buffer(Start+Length);
+
+	if (Z_OK!=compress((Bytef *)&Buffer[Start],&Length,(const Bytef *)Data.c_str(),Data.length()))
+		return std::vector<unsigned char>();
+
+	Buffer.resize(Start+Length);
+	memcpy(&Buffer[sizeof(CRecordHeader)],Key.c_str(),Key.length());
+	if (!Validators.empty())
+		memcpy(&Buffer[sizeof(CRecordHeader)+Key.length()],Validators.c_str(),Validators.length());
+
+	CRecordHeader Record;
+	memset(&Record,0,sizeof(Record));
+	Record.m_Magic=RecordMagic;
+	Record.m_KeyLength=Key.length();
+	Record.m_ValidatorLength=Validators.length();
+	Record.m_DataLength=Length;
+	Record.m_UncompressedLength=Data.length();
+	Record.m_Flags=Flags;
+	Record.m_Stored=time(0);
+	Record.m_CRC=crc32(0,&Buffer[sizeof(Record)],Buffer.size()-sizeof(Record));
+	memcpy(&Buffer[0],&Record,sizeof(Record));
+
+	return Buffer;
+}
+
+MusicBrainz5::CDiskCache::CDiskCache(const std::string& Directory, size_t MaxSize, int TTL)
+:	m_d(new CDiskCachePrivate)
+{
+	m_d->m_Directory=Directory;
+	m_d->m_MaxSize=MaxSize;
+	m_d->m_TTL=TTL;
+
+	if (0==mkdir(Directory.c_str(),0755) || EEXIST==errno)
+	{
+		m_d->m_IndexFD=open((Directory+"/index").c_str(),O_RDWR|O_CREAT,0644);
+		m_d->m_BloomFD=open((Directory+"/negative.bloom").c_str(),O_RDWR|O_CREAT,0644);
+	}
+
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	m_d->MapBloom();
+
+	if (!m_d->Check() && -1!=m_d->m_IndexFD)
+	{
+		m_d->Unmap();
+
+		close(m_d->m_IndexFD);
+		m_d->m_IndexFD=-1;
+	}
+}
+
+MusicBrainz5::CDiskCache::~CDiskCache()
+{
+	m_d->Unmap();
+
+	if (m_d->m_Bloom)
+		munmap(m_d->m_Bloom,BloomBits/8);
+
+	if (-1!=m_d->m_BloomFD)
+		close(m_d->m_BloomFD);
+
+	std::map<unsigned int,int>::const_iterator ThisSegment=m_d->m_Segments.begin();
+	while (ThisSegment!=m_d->m_Segments.end())
+	{
+		close((*ThisSegment).second);
+		++ThisSegment;
+	}
+
+	if (-1!=m_d->m_IndexFD)
+		close(m_d->m_IndexFD);
+
+	delete m_d;
+}
+
+bool MusicBrainz5::CDiskCache::Valid() const
+{
+	return -1!=m_d->m_IndexFD;
+}
+
+std::string MusicBrainz5::CDiskCache::Directory() const
+{
+	return m_d->m_Directory;
+}
+
+void MusicBrainz5::CDiskCache::SetMaxSize(size_t MaxSize)
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	m_d->m_MaxSize=MaxSize;
+
+	if (m_d->Check())
+		m_d->Maintain();
+}
+
+size_t MusicBrainz5::CDiskCache::MaxSize() const
+{
+	return m_d->m_MaxSize;
+}
+
+void MusicBrainz5::CDiskCache::SetTTL(int TTL)
+{
+	m_d->m_TTL=TTL;
+}
+
+int MusicBrainz5::CDiskCache::TTL() const
+{
+	return m_d->m_TTL;
+}
+
+void MusicBrainz5::CDiskCache::SetNegativeTTL(int NegativeTTL)
+{
+	m_d->m_NegativeTTL=NegativeTTL;
+}
+
+int MusicBrainz5::CDiskCache::NegativeTTL() const
+{
+	return m_d->m_NegativeTTL;
+}
+
+bool MusicBrainz5::CDiskCache::Get(const std::string& Key, std::string& Data)
+{
+	std::string Validators;
+
+	return m_d->Read(Key,false,Data,Validators);
+}
+
+bool MusicBrainz5::CDiskCache::GetStale(const std::string& Key, std::string& Data, std::string& ETag, std::string& LastModified)
+{
+	std::string Validators;
+
+	if (!m_d->Read(Key,true,Data,Validators))
+		return false;
+
+	std::string::size_type Separator=Validators.find('\n');
+	ETag=Validators.substr(0,Separator);
+	LastModified=Separator!=std::string::npos ? Validators.substr(Separator+1) : "";
+
+	return true;
+}
+
+bool MusicBrainz5::CDiskCache::Put(const std::string& Key, const std::string& Data, const std::string& ETag, const std::string& LastModified)
+{
+	if (Key.empty() || !Valid())
+		return false;
+
+	//Compress the body without holding the lock
+
+	std::string Validators;
+	if (!ETag.empty() || !LastModified.empty())
+		Validators=ETag+"\n"+LastModified;
+
+	std::vector<unsigned char> Buffer=CDiskCachePrivate::MakeRecord(Key,Validators,Data,0);
+	if (Buffer.empty())
+		return false;
+
+	CRecordHeader Record;
+	memcpy(&Record,&Buffer[0],sizeof(Record));
+
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (!m_d->Check())
+		return false;
+
+	//The record is written before the index refers to it, so a crash can only
+	//lose the new record
+
+	CIndexSlot Slot;
+	Slot.m_Hash=CDiskCachePrivate::Hash(Key);
+	Slot.m_Stored=Record.m_Stored;
+	Slot.m_Flags=0;
+
+	if (!m_d->Append(Buffer,&Slot))
+		return false;
+
+	m_d->Insert(Slot);
+	m_d->Maintain();
+
+	return true;
+}
+
+bool MusicBrainz5::CDiskCache::PutNotFound(const std::string& Key)
+{
+	if (Key.empty() || !Valid())
+		return false;
+
+	std::vector<unsigned char> Buffer=CDiskCachePrivate::MakeRecord(Key,"","",eRecordNotFound);
+	if (Buffer.empty())
+		return false;
+
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (!m_d->Check())
+		return false;
+
+	CIndexSlot Slot;
+	Slot.m_Hash=CDiskCachePrivate::Hash(Key);
+	Slot.m_Stored=time(0);
+	Slot.m_Flags=eRecordNotFound;
+
+	if (!m_d->Append(Buffer,&Slot))
+		return false;
+
+	//The filter is updated first, so that any process that finds the key in the
+	//index will also find it in the filter
+
+	m_d->BloomAdd(Slot.m_Hash);
+	m_d->Insert(Slot);
+	m_d->Maintain();
+
+	return true;
+}
+
+bool MusicBrainz5::CDiskCache::NotFound(const std::string& Key)
+{
+	if (!Valid())
+		return false;
+
+	unsigned long long Hash=CDiskCachePrivate::Hash(Key);
+
+	if (!m_d->BloomTest(Hash))
+		return false;
+
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (!m_d->Check())
+		return false;
+
+	CIndexSlot *Slot=m_d->Find(Hash,false);
+
+	return Slot && Slot->m_Length && (Slot->m_Flags&eRecordNotFound) && !m_d->Expired(*Slot) &&
+		m_d->Matches(*Slot,Key);
+}
+
+bool MusicBrainz5::CDiskCache::Refresh(const std::string& Key)
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (m_d->Check())
+	{
+		//Only the index is updated, so if it is rebuilt the response will be
+		//revalidated again sooner than necessary
+
+		CIndexSlot *Slot=m_d->Find(CDiskCachePrivate::Hash(Key),false);
+		if (Slot && Slot->m_Length && 0==(Slot->m_Flags&eRecordNotFound) && m_d->Matches(*Slot,Key))
+		{
+			Slot->m_Stored=time(0);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MusicBrainz5::CDiskCache::Remove(const std::string& Key)
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (m_d->Check())
+	{
+		CIndexSlot *Slot=m_d->Find(CDiskCachePrivate::Hash(Key),false);
+		if (Slot && Slot->m_Length && m_d->Matches(*Slot,Key))
+		{
+			//A removal record stops the response coming back if the index is rebuilt
+
+			std::vector<unsigned char> Buffer=CDiskCachePrivate::MakeRecord(Key,"","",eRecordRemoved);
+
+			if (!Buffer.empty())
+				m_d->Append(Buffer);
+
+			m_d->Erase(*Slot);
+		}
+	}
+}
+
+void MusicBrainz5::CDiskCache::RemovePrefix(const std::string& Prefix)
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (m_d->Check())
+	{
+		for (unsigned int count=0;count<m_d->m_Header->m_NumBuckets;count++)
+		{
+			CIndexSlot& Slot=m_d->m_Slots[count];
+			if (0==Slot.m_Hash || Slot.m_Length<sizeof(CRecordHeader)+Prefix.length())
+				continue;
+
+			int FD=m_d->Segment(Slot.m_Segment,false);
+			if (-1==FD)
+				continue;
+
+			CRecordHeader Record;
+			if ((ssize_t)sizeof(Record)!=pread(FD,&Record,sizeof(Record),Slot.m_Offset) ||
+					RecordMagic!=Record.m_Magic ||
+					Record.m_KeyLength<Prefix.length() ||
+					sizeof(Record)+Record.m_KeyLength>Slot.m_Length)
+				continue;
+
+			std::vector<char> Key(Record.m_KeyLength+1);
+			if ((ssize_t)Record.m_KeyLength!=pread(FD,&Key[0],Record.m_KeyLength,Slot.m_Offset+sizeof(Record)) ||
+					0!=Prefix.compare(0,Prefix.length(),&Key[0],Prefix.length()))
+				continue;
+
+			std::vector<unsigned char> Buffer=CDiskCachePrivate::MakeRecord(std::string(&Key[0],Record.m_KeyLength),"","",eRecordRemoved);
+
+			if (!Buffer.empty())
+				m_d->Append(Buffer);
+
+			m_d->Erase(Slot);
+		}
+	}
+}
+
+void MusicBrainz5::CDiskCache::Clear()
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (m_d->Check())
+	{
+		CIndexHeader Header=*m_d->m_Header;
+
+		m_d->m_Header->m_Dirty=1;
+		__sync_synchronize();
+
+		for (unsigned int Number=Header.m_FirstSegment;Number<=Header.m_ActiveSegment;Number++)
+			m_d->RemoveSegment(Number);
+
+		//Segment numbers aren't reused, in case another process still has one open
+
+		Header.m_FirstSegment=Header.m_ActiveSegment+1;
+		Header.m_ActiveSegment=Header.m_FirstSegment;
+		Header.m_ActiveSize=0;
+		Header.m_TotalSize=0;
+
+		m_d->Reindex(Header,std::vector<CIndexSlot>());
+	}
+}
+
+void MusicBrainz5::CDiskCache::Compact()
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	if (m_d->Check())
+		m_d->Compact();
+}
+
+int MusicBrainz5::CDiskCache::NumEntries() const
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	return m_d->Check() ? m_d->m_Header->m_NumLive : 0;
+}
+
+size_t MusicBrainz5::CDiskCache::Size() const
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,m_d->m_IndexFD);
+
+	return m_d->Check() ? m_d->m_Header->m_TotalSize : 0;
+}
+
+unsigned long MusicBrainz5::CDiskCache::Hits() const
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,-1);
+
+	return m_d->m_Hits;
+}
+
+unsigned long MusicBrainz5::CDiskCache::Misses() const
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,-1);
+
+	return m_d->m_Misses;
+}
+
+unsigned long MusicBrainz5::CDiskCache::Evictions() const
+{
+	CDiskCacheLock Lock(&m_d->m_Mutex,-1);
+
+	return m_d->m_Evictions;
+}
@@ -28,10 +28,16 @@
 
 #include "musicbrainz5/Entity.h"
 
+#include <string.h>
+#include <limits.h>
+
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/RelationListList.h"
+#include "musicbrainz5/StringPool.h"
+
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CEntityPrivate
+class MusicBrainz5::CEntityPrivate: public CSharedPrivate
 {
 	public:
 		CEntityPrivate()
@@ -48,37 +54,47 @@ MusicBrainz5::CEntity::CEntity()
 }
 
 MusicBrainz5::CEntity::CEntity(const CEntity& Other)
-:	m_d(new CEntityPrivate)
+:	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CEntity& MusicBrainz5::CEntity::operator =(const CEntity& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
-		m_d->m_ExtAttributes=Other.m_d->m_ExtAttributes;
-		m_d->m_ExtElements=Other.m_d->m_ExtElements;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CEntity::~CEntity()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CEntity::CEntity(CEntity&& Other)
+:	m_d(SharedEmpty<CEntityPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CEntity& MusicBrainz5::CEntity::operator =(CEntity&& Other)
 {
-	Cleanup();
+	if (this!=&Other)
+	{
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CEntity::Cleanup()
+MusicBrainz5::CEntity::~CEntity()
 {
+	m_d->Unref();
 }
 
 void MusicBrainz5::CEntity::Parse(const XMLNode& Node)
 {
+	Detach(m_d);
+
 	if (!Node.isEmpty())
 	{
 		for (XMLAttribute Attr = Node.getAttribute();
@@ -100,25 +116,28 @@ void MusicBrainz5::CEntity::Parse(const XMLNode& Node)
 		     !ChildNode.isEmpty();
 		     ChildNode = ChildNode.next())
 		{
-			std::string Name=ChildNode.getName();
-			std::string Value;
-			if (ChildNode.getText())
-				Value=ChildNode.getText();
+			const char *Name=ChildNode.getName();
 
-			if ("ext:"==Name.substr(0,4))
-				m_d->m_ExtElements[Name.substr(4)]=Value;
+			if (0==strncmp(Name,"ext:",4))
+			{
+				std::string Value;
+				if (ChildNode.getText())
+					Value=ChildNode.getText();
+
+				m_d->m_ExtElements[Name+4]=Value;
+			}
 			else
 				ParseElement(ChildNode);
 		}
 	}
 }
 
-std::map<std::string,std::string> MusicBrainz5::CEntity::ExtAttributes() const
+const std::map<std::string,std::string>& MusicBrainz5::CEntity::ExtAttributes() const
 {
 	return m_d->m_ExtAttributes;
 }
 
-std::map<std::string,std::string> MusicBrainz5::CEntity::ExtElements() const
+const std::map<std::string,std::string>& MusicBrainz5::CEntity::ExtElements() const
 {
 	return m_d->m_ExtElements;
 }
@@ -134,12 +153,205 @@ void MusicBrainz5::CEntity::ProcessRelationList(const XMLNode& Node, CRelationLi
 	delete RelationList;
 }
 
+static bool IsSpace(char Char)
+{
+	return ' '==Char || '\t'==Char || '\n'==Char || '\v'==Char || '\f'==Char || '\r'==Char;
+}
+
+static bool IsDigit(char Char)
+{
+	return Char>='0' && Char<='9';
+}
+
+static void ReportParseError(const char *Text)
+{
+#ifdef _MB5_DEBUG_
+	std::cerr << "Error parsing value '";
+	if (Text)
+		std::cerr << Text;
+	std::cerr << "'" << std::endl;
+#else
+	(void)Text;
+#endif
+}
+
+//Parse an integer as 'std::istream >> int' does in the "C" locale. Leading white
+//space is skipped and parsing stops at the first character that isn't a digit. If
+//there is nothing but white space RetVal is left alone, if there are no digits it
+//is set to 0, and if the value is out of range it is clamped.
+
+static bool ParseInt(const char *Text, int& RetVal)
+{
+	if (!Text)
+		return false;
+
+	while (IsSpace(*Text))
+		Text++;
+
+	if (!*Text)
+		return false;
+
+	bool Negative=false;
+	if ('+'==*Text || '-'==*Text)
+		Negative='-'==*Text++;
+
+	if (!IsDigit(*Text))
+	{
+		RetVal=0;
+		return false;
+	}
+
+	//The magnitude of INT_MIN is one more than INT_MAX
+	unsigned long Limit=Negative ? (unsigned long)INT_MAX+1 : (unsigned long)INT_MAX;
+	unsigned long Value=0;
+	bool Overflow=false;
+
+	while (IsDigit(*Text))
+	{
+		unsigned long Digit=*Text-'0';
+
+		//Check before multiplying, as Value*10 may not fit in an unsigned long
+
+		if (!Overflow)
+		{
+			Overflow=Value>(Limit-Digit)/10;
+			if (!Overflow)
+				Value=Value*10+Digit;
+		}
+
+		Text++;
+	}
+
+	if (Overflow)
+	{
+		RetVal=Negative ? INT_MIN : INT_MAX;
+		return false;
+	}
+
+	if (Negative)
+		RetVal=Value ? -(int)(Value-1)-1 : 0;
+	else
+		RetVal=(int)Value;
+	return true;
+}
+
+//Parse a floating point number as 'std::istream >> double' does in the "C" locale.
+//Plain decimals of up to 15 digits, which is everything the web service returns,
+//are converted directly. These are exactly representable as a double before being
+//divided by an exactly representable power of ten, so the result is correctly
+//rounded. Anything else is handed to a stream using the classic locale.
+
+static bool ParseDouble(const char *Text, double& RetVal)
+{
+	static const double PowersOfTen[]=
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15
+	};
+
+	if (!Text)
+		return false;
+
+	const char *Start=Text;
+
+	while (IsSpace(*Text))
+		Text++;
+
+	bool Negative=false;
+	if ('+'==*Text || '-'==*Text)
+		Negative='-'==*Text++;
+
+	unsigned long long Mantissa=0;
+	int NumDigits=0;
+	int NumFractionDigits=0;
+
+	while (IsDigit(*Text) && NumDigits<=15)
+	{
+		Mantissa=Mantissa*10+(*Text++-'0');
+		NumDigits++;
+	}
+
+	if ('.'==*Text)
+	{
+		Text++;
+
+		while (IsDigit(*Text) && NumDigits<=15)
+		{
+			Mantissa=Mantissa*10+(*Text++-'0');
+			NumDigits++;
+			NumFractionDigits++;
+		}
+	}
+
+	if (NumDigits>0 && NumDigits<=15 && !IsDigit(*Text) && '.'!=*Text && 'e'!=*Text && 'E'!=*Text)
+	{
+		RetVal=(double)Mantissa/PowersOfTen[NumFractionDigits];
+		if (Negative)
+			RetVal=-RetVal;
+
+		return true;
+	}
+
+	std::istringstream os(Start);
+	os.imbue(std::locale::classic());
+	os >> RetVal;
+
+	return !os.fail();
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const XMLNode& Node, int& RetVal)
+{
+	if (!ParseInt(Node.getText(),RetVal))
+		ReportParseError(Node.getText());
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const XMLNode& Node, double& RetVal)
+{
+	if (!ParseDouble(Node.getText(),RetVal))
+		ReportParseError(Node.getText());
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const std::string& Text, int& RetVal)
+{
+	if (!ParseInt(Text.c_str(),RetVal))
+		ReportParseError(Text.c_str());
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const std::string& Text, double& RetVal)
+{
+	if (!ParseDouble(Text.c_str(),RetVal))
+		ReportParseError(Text.c_str());
+}
+
+void MusicBrainz5::CEntity::ProcessItem(const std::string& Text, std::string& RetVal)
+{
+	//As with 'std::istream >> std::string', take the first word
+
+	std::string::size_type Start=Text.find_first_not_of(" \t\n\v\f\r");
+	if (std::string::npos==Start)
+		ReportParseError(Text.c_str());
+	else
+		RetVal.assign(Text,Start,Text.find_first_of(" \t\n\v\f\r",Start)-Start);
+}
+
+void MusicBrainz5::CEntity::InternItem(const XMLNode& Node, const std::string*& RetVal)
+{
+	const char *Text=Node.getText();
+	if (Text)
+		RetVal=&CStringPool::Intern(Text,strlen(Text));
+}
+
+void MusicBrainz5::CEntity::InternItem(const std::string& Text, const std::string*& RetVal)
+{
+	RetVal=&CStringPool::Intern(Text);
+}
+
 std::ostream& MusicBrainz5::CEntity::Serialise(std::ostream& os) const
 {
-	if (!ExtAttributes().empty())
+	const std::map<std::string,std::string>& ExtAttrs=m_d->m_ExtAttributes;
+	if (!ExtAttrs.empty())
 	{
 		os << "Ext attrs: " << std::endl;
-		std::map<std::string,std::string> ExtAttrs=ExtAttributes();
 		std::map<std::string,std::string>::const_iterator ThisExtAttr=ExtAttrs.begin();
 		while (ThisExtAttr!=ExtAttrs.end())
 		{
@@ -149,10 +361,10 @@ std::ostream& MusicBrainz5::CEntity::Serialise(std::ostream& os) const
 		}
 	}
 
-	if (!ExtElements().empty())
+	const std::map<std::string,std::string>& ExtElems=m_d->m_ExtElements;
+	if (!ExtElems.empty())
 	{
 		os << "Ext elements: " << std::endl;
-		std::map<std::string,std::string> ExtElems=ExtElements();
 		std::map<std::string,std::string>::const_iterator ThisExtElement=ExtElems.begin();
 		while (ThisExtElement!=ExtElems.end())
 		{
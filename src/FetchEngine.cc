@@ -0,0 +1,1227 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/FetchEngine.h"
+
+#include <deque>
+#include <list>
+#include <sstream>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "musicbrainz5/HTTPFetch.h"
+
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+class MusicBrainz5::CFetchCompletionPrivate
+{
+	public:
+		CFetchCompletionPrivate()
+		:	m_ID(0),
+			m_Result(0),
+			m_Status(0)
+		{
+		}
+
+		int m_ID;
+		std::string m_URL;
+		int m_Result;
+		int m_Status;
+		std::string m_ErrorMessage;
+		std::map<std::string,std::string> m_Headers;
+		std::vector<unsigned char> m_Data;
+};
+
+MusicBrainz5::CFetchCompletion::CFetchCompletion()
+:	m_d(new CFetchCompletionPrivate)
+{
+}
+
+MusicBrainz5::CFetchCompletion::CFetchCompletion(const CFetchCompletion& Other)
+:	m_d(new CFetchCompletionPrivate)
+{
+	*this=Other;
+}
+
+MusicBrainz5::CFetchCompletion& MusicBrainz5::CFetchCompletion::operator =(const CFetchCompletion& Other)
+{
+	if (this!=&Other)
+		*m_d=*Other.m_d;
+
+	return *this;
+}
+
+MusicBrainz5::CFetchCompletion::~CFetchCompletion()
+{
+	delete m_d;
+}
+
+int MusicBrainz5::CFetchCompletion::ID() const
+{
+	return m_d->m_ID;
+}
+
+std::string MusicBrainz5::CFetchCompletion::URL() const
+{
+	return m_d->m_URL;
+}
+
+int MusicBrainz5::CFetchCompletion::Result() const
+{
+	return m_d->m_Result;
+}
+
+int MusicBrainz5::CFetchCompletion::Status() const
+{
+	return m_d->m_Status;
+}
+
+std::string MusicBrainz5::CFetchCompletion::ErrorMessage() const
+{
+	return m_d->m_ErrorMessage;
+}
+
+std::string MusicBrainz5::CFetchCompletion::ResponseHeader(const std::string& Name) const
+{
+	std::string LowerName=Name;
+	for (std::string::size_type count=0;count<LowerName.length();count++)
+		LowerName[count]=tolower(LowerName[count]);
+
+	std::map<std::string,std::string>::const_iterator Header=m_d->m_Headers.find(LowerName);
+	if (Header!=m_d->m_Headers.end())
+		return (*Header).second;
+
+	return "";
+}
+
+std::map<std::string,std::string> MusicBrainz5::CFetchCompletion::ResponseHeaders() const
+{
+	return m_d->m_Headers;
+}
+
+std::vector<unsigned char> MusicBrainz5::CFetchCompletion::Data() const
+{
+	return m_d->m_Data;
+}
+
+MusicBrainz5::CFetchCallback::~CFetchCallback()
+{
+}
+
+class MusicBrainz5::CFetchEnginePrivate
+{
+	public:
+		enum tState
+		{
+			eConnecting,
+			eSending,
+			eReadingHeader,
+			eReadingBody,
+			eReadingChunkSize,
+			eReadingChunk,
+			eReadingChunkEnd,
+			eReadingTrailer,
+			eComplete,
+			eIdle
+		};
+
+		enum tEvents
+		{
+			eRead=1,
+			eWrite=2
+		};
+
+		class CRequest
+		{
+		public:
+			CRequest(int ID, const std::string& URL, const std::map<std::string,std::string>& Headers, long long Deadline)
+			:	m_ID(ID),
+				m_URL(URL),
+				m_Headers(Headers),
+				m_Deadline(Deadline),
+				m_Retried(false)
+			{
+			}
+
+			int m_ID;
+			std::string m_URL;
+			std::map<std::string,std::string> m_Headers;
+			long long m_Deadline;
+			bool m_Retried;
+		};
+
+		class CConnection
+		{
+		public:
+			CConnection()
+			:	m_Socket(-1),
+				m_State(eIdle),
+				m_Events(0),
+				m_Address(0),
+				m_Request(0),
+				m_Sent(0),
+				m_Reused(false),
+				m_ResponseStarted(false),
+				m_KeepAlive(true),
+				m_UntilClose(false),
+				m_Remaining(0),
+				m_Status(0),
+				m_IdleSince(0)
+			{
+			}
+
+			int m_Socket;
+			tState m_State;
+			int m_Events;
+			struct addrinfo *m_Address;
+			CRequest *m_Request;
+			std::string m_Out;
+			std::string::size_type m_Sent;
+			std::string m_In;
+			bool m_Reused;
+			bool m_ResponseStarted;
+			bool m_KeepAlive;
+			bool m_UntilClose;
+			unsigned long m_Remaining;
+			int m_Status;
+			std::map<std::string,std::string> m_Headers;
+			std::vector<unsigned char> m_Body;
+			long long m_IdleSince;
+		};
+
+		CFetchEnginePrivate()
+		:	m_Port(80),
+			m_MaxConnections(16),
+			m_Timeout(30),
+			m_IdleTimeout(30),
+			m_Callback(0),
+			m_NextID(1),
+			m_Completed(0),
+			m_Addresses(0),
+			m_Poll(-1),
+			m_SetupError(0),
+			m_Interrupted(false)
+		{
+			m_Wake[0]=-1;
+			m_Wake[1]=-1;
+		}
+
+		std::string m_UserAgent;
+		std::string m_Host;
+		int m_Port;
+		int m_MaxConnections;
+		int m_Timeout;
+		int m_IdleTimeout;
+		CFetchCallback *m_Callback;
+		int m_NextID;
+		int m_Completed;
+		struct addrinfo *m_Addresses;
+		int m_Poll;
+		int m_Wake[2];
+		int m_SetupError;
+		bool m_Interrupted;
+		std::deque<CRequest *> m_Queue;
+		std::list<CConnection *> m_Connections;
+		std::deque<CFetchCompletion> m_Completions;
+
+		static long long Now();
+
+		bool Resolve();
+		void StartRequests();
+		void StartRequest(CConnection *Connection, CRequest *Request);
+		bool Connect(CConnection *Connection);
+		void Watch(CConnection *Connection, int Events);
+		void Wait(long long Timeout);
+		void Drain();
+		void HandleEvent(CConnection *Connection);
+		void FinishConnect(CConnection *Connection);
+		void Send(CConnection *Connection);
+		void Receive(CConnection *Connection);
+		int ProcessInput(CConnection *Connection);
+		bool ParseHeader(CConnection *Connection, const std::string& Header);
+		void Finish(CConnection *Connection);
+		void Fail(CConnection *Connection, int Result, const std::string& ErrorMessage);
+		void Close(CConnection *Connection);
+		void Expire();
+		void Complete(CRequest *Request, int Result, int Status, const std::string& ErrorMessage, std::map<std::string,std::string>& Headers, std::vector<unsigned char>& Data);
+		int NumActive() const;
+};
+
+long long MusicBrainz5::CFetchEnginePrivate::Now()
+{
+	struct timespec TimeNow;
+	clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+	return (long long)TimeNow.tv_sec*1000+TimeNow.tv_nsec/1000000;
+}
+
+bool MusicBrainz5::CFetchEnginePrivate::Resolve()
+{
+	if (m_Addresses)
+		return true;
+
+	struct addrinfo Hints;
+	memset(&Hints,0,sizeof(Hints));
+	Hints.ai_family=AF_UNSPEC;
+	Hints.ai_socktype=SOCK_STREAM;
+
+	std::stringstream Port;
+	Port << m_Port;
+
+	int Ret=getaddrinfo(m_Host.c_str(),Port.str().c_str(),&Hints,&m_Addresses);
+	if (0!=Ret)
+	{
+		m_Addresses=0;
+
+		//Fail everything that is waiting for a connection
+
+		std::string ErrorMessage="Unable to resolve '" + m_Host + "': " + gai_strerror(Ret);
+		while (!m_Queue.empty())
+		{
+			CRequest *Request=m_Queue.front();
+			m_Queue.pop_front();
+
+			std::map<std::string,std::string> Headers;
+			std::vector<unsigned char> Data;
+			Complete(Request,EHOSTUNREACH,0,ErrorMessage,Headers,Data);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::StartRequests()
+{
+	if (m_Queue.empty() || !Resolve())
+		return;
+
+	std::list<CConnection *>::iterator ThisConnection=m_Connections.begin();
+	while (!m_Queue.empty() && ThisConnection!=m_Connections.end())
+	{
+		CConnection *Connection=*ThisConnection;
+		++ThisConnection;
+
+		if (eIdle==Connection->m_State)
+		{
+			CRequest *Request=m_Queue.front();
+			m_Queue.pop_front();
+
+			StartRequest(Connection,Request);
+		}
+	}
+
+	while (!m_Queue.empty() && (int)m_Connections.size()<m_MaxConnections)
+	{
+		CRequest *Request=m_Queue.front();
+		m_Queue.pop_front();
+
+		CConnection *Connection=new CConnection;
+		Connection->m_Address=m_Addresses;
+		m_Connections.push_back(Connection);
+
+		StartRequest(Connection,Request);
+	}
+}
+
+void MusicBrainz5::CFetchEnginePrivate::StartRequest(CConnection *Connection, CRequest *Request)
+{
+	std::stringstream os;
+	os << "GET " << Request->m_URL << " HTTP/1.1\r\n";
+	os << "Host: " << m_Host;
+	if (80!=m_Port)
+		os << ":" << m_Port;
+	os << "\r\n";
+	os << "User-Agent: " << m_UserAgent << "\r\n";
+
+	for (std::map<std::string,std::string>::const_iterator ThisHeader=Request->m_Headers.begin();ThisHeader!=Request->m_Headers.end();++ThisHeader)
+		os << (*ThisHeader).first << ": " << (*ThisHeader).second << "\r\n";
+
+	os << "Connection: keep-alive\r\n";
+	os << "\r\n";
+
+	Connection->m_Request=Request;
+	Connection->m_Out=os.str();
+	Connection->m_Sent=0;
+	Connection->m_In.clear();
+	Connection->m_ResponseStarted=false;
+	Connection->m_KeepAlive=true;
+	Connection->m_UntilClose=false;
+	Connection->m_Remaining=0;
+	Connection->m_Status=0;
+	Connection->m_Headers.clear();
+	Connection->m_Body.clear();
+
+	if (-1==Connection->m_Socket)
+	{
+		if (!Connect(Connection))
+			Fail(Connection,errno,strerror(errno));
+	}
+	else
+	{
+		Connection->m_Reused=true;
+		Connection->m_State=eSending;
+		Send(Connection);
+	}
+}
+
+bool MusicBrainz5::CFetchEnginePrivate::Connect(CConnection *Connection)
+{
+	int Error=ECONNREFUSED;
+
+	while (Connection->m_Address)
+	{
+		struct addrinfo *Address=Connection->m_Address;
+
+		int Socket=socket(Address->ai_family,Address->ai_socktype,Address->ai_protocol);
+		if (-1!=Socket)
+		{
+			fcntl(Socket,F_SETFL,fcntl(Socket,F_GETFL)|O_NONBLOCK);
+			fcntl(Socket,F_SETFD,FD_CLOEXEC);
+
+			if (0==connect(Socket,Address->ai_addr,Address->ai_addrlen) || EINPROGRESS==errno)
+			{
+				Connection->m_Socket=Socket;
+				Connection->m_State=eConnecting;
+				Watch(Connection,eWrite);
+
+				return true;
+			}
+
+			Error=errno;
+			close(Socket);
+		}
+		else
+			Error=errno;
+
+		Connection->m_Address=Address->ai_next;
+	}
+
+	errno=Error;
+	return false;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Watch(CConnection *Connection, int Events)
+{
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event Event;
+	memset(&Event,0,sizeof(Event));
+	Event.data.ptr=Connection;
+	if (Events & eRead)
+		Event.events|=EPOLLIN;
+	if (Events & eWrite)
+		Event.events|=EPOLLOUT;
+
+	if (0==Connection->m_Events)
+		epoll_ctl(m_Poll,EPOLL_CTL_ADD,Connection->m_Socket,&Event);
+	else if (Events!=Connection->m_Events)
+		epoll_ctl(m_Poll,EPOLL_CTL_MOD,Connection->m_Socket,&Event);
+#endif
+
+	Connection->m_Events=Events;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Wait(long long Timeout)
+{
+	if (Timeout>1000*60*60)
+		Timeout=1000*60*60;
+
+	std::vector<CConnection *> Ready;
+
+#ifdef HAVE_SYS_EPOLL_H
+	struct epoll_event Events[64];
+
+	int Ret=epoll_wait(m_Poll,Events,sizeof(Events)/sizeof(Events[0]),Timeout);
+	for (int count=0;count<Ret;count++)
+	{
+		if (Events[count].data.ptr)
+			Ready.push_back((CConnection *)Events[count].data.ptr);
+		else
+			Drain();
+	}
+#else
+	std::vector<struct pollfd> Sockets;
+	std::vector<CConnection *> Connections;
+
+	//The wake up pipe comes first, with no connection
+
+	struct pollfd Wake;
+	memset(&Wake,0,sizeof(Wake));
+	Wake.fd=m_Wake[0];
+	Wake.events=POLLIN;
+
+	Sockets.push_back(Wake);
+	Connections.push_back(0);
+
+	std::list<CConnection *>::const_iterator ThisConnection=m_Connections.begin();
+	while (ThisConnection!=m_Connections.end())
+	{
+		CConnection *Connection=*ThisConnection;
+
+		struct pollfd Socket;
+		memset(&Socket,0,sizeof(Socket));
+		Socket.fd=Connection->m_Socket;
+		if (Connection->m_Events & eRead)
+			Socket.events|=POLLIN;
+		if (Connection->m_Events & eWrite)
+			Socket.events|=POLLOUT;
+
+		Sockets.push_back(Socket);
+		Connections.push_back(Connection);
+
+		++ThisConnection;
+	}
+
+	int Ret=poll(&Sockets[0],Sockets.size(),Timeout);
+	for (std::vector<struct pollfd>::size_type count=0;Ret>0 && count<Sockets.size();count++)
+	{
+		if (Sockets[count].revents)
+		{
+			if (Connections[count])
+				Ready.push_back(Connections[count]);
+			else
+				Drain();
+		}
+	}
+#endif
+
+	//Handling an event only ever closes the connection being handled, so the
+	//remaining connections in the list stay valid
+
+	for (std::vector<CConnection *>::size_type count=0;count<Ready.size();count++)
+		HandleEvent(Ready[count]);
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Drain()
+{
+	char Buffer[64];
+
+	while (read(m_Wake[0],Buffer,sizeof(Buffer))>0)
+		;
+
+	m_Interrupted=true;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::HandleEvent(CConnection *Connection)
+{
+	switch (Connection->m_State)
+	{
+		case eConnecting:
+			FinishConnect(Connection);
+			break;
+
+		case eSending:
+			Send(Connection);
+			break;
+
+		default:
+			Receive(Connection);
+			break;
+	}
+}
+
+void MusicBrainz5::CFetchEnginePrivate::FinishConnect(CConnection *Connection)
+{
+	int Error=0;
+	socklen_t Len=sizeof(Error);
+
+	if (0!=getsockopt(Connection->m_Socket,SOL_SOCKET,SO_ERROR,&Error,&Len))
+		Error=errno;
+
+	if (0!=Error)
+	{
+		//Try the next address for the host, if there is one
+
+		close(Connection->m_Socket);
+		Connection->m_Socket=-1;
+		Connection->m_Events=0;
+		Connection->m_Address=Connection->m_Address->ai_next;
+
+		if (!Connect(Connection))
+			Fail(Connection,Error,strerror(Error));
+
+		return;
+	}
+
+	Connection->m_State=eSending;
+	Send(Connection);
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Send(CConnection *Connection)
+{
+	while (Connection->m_Sent<Connection->m_Out.length())
+	{
+		ssize_t Ret=send(Connection->m_Socket,Connection->m_Out.c_str()+Connection->m_Sent,
+									Connection->m_Out.length()-Connection->m_Sent,MSG_NOSIGNAL);
+		if (Ret<0)
+		{
+			if (EINTR==errno)
+				continue;
+
+			if (EAGAIN==errno || EWOULDBLOCK==errno)
+			{
+				Watch(Connection,eWrite);
+				return;
+			}
+
+			Fail(Connection,errno,strerror(errno));
+			return;
+		}
+
+		Connection->m_Sent+=Ret;
+	}
+
+	Connection->m_State=eReadingHeader;
+	Watch(Connection,eRead);
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Receive(CConnection *Connection)
+{
+	char Buffer[16384];
+
+	for (;;)
+	{
+		ssize_t Ret=recv(Connection->m_Socket,Buffer,sizeof(Buffer),0);
+		if (Ret<0)
+		{
+			if (EINTR==errno)
+				continue;
+
+			if (EAGAIN!=errno && EWOULDBLOCK!=errno)
+			{
+				if (eIdle==Connection->m_State)
+					Close(Connection);
+				else
+					Fail(Connection,errno,strerror(errno));
+			}
+
+			return;
+		}
+
+		if (0==Ret)
+		{
+			if (eIdle==Connection->m_State)
+				Close(Connection);
+			else if (eReadingBody==Connection->m_State && Connection->m_UntilClose)
+				Finish(Connection);
+			else
+				Fail(Connection,ECONNRESET,"Connection closed by server");
+
+			return;
+		}
+
+		if (eIdle==Connection->m_State)
+		{
+			//Nothing should arrive on an idle connection
+
+			Close(Connection);
+			return;
+		}
+
+		Connection->m_ResponseStarted=true;
+		Connection->m_In.append(Buffer,Ret);
+
+		int Status=ProcessInput(Connection);
+		if (Status<0)
+		{
+			Fail(Connection,EPROTO,"Malformed response from '" + m_Host + "'");
+			return;
+		}
+
+		if (Status>0)
+		{
+			Finish(Connection);
+			return;
+		}
+	}
+}
+
+int MusicBrainz5::CFetchEnginePrivate::ProcessInput(CConnection *Connection)
+{
+	std::string& In=Connection->m_In;
+	std::string::size_type Pos=0;
+	bool More=true;
+
+	while (More && eComplete!=Connection->m_State)
+	{
+		switch (Connection->m_State)
+		{
+			case eReadingHeader:
+			{
+				std::string::size_type End=In.find("\r\n\r\n",Pos);
+				if (std::string::npos==End)
+				{
+					if (In.length()-Pos>65536)
+						return -1;
+
+					More=false;
+				}
+				else
+				{
+					if (!ParseHeader(Connection,In.substr(Pos,End-Pos)))
+						return -1;
+
+					Pos=End+4;
+				}
+
+				break;
+			}
+
+			case eReadingBody:
+			case eReadingChunk:
+			{
+				std::string::size_type Len=In.length()-Pos;
+				if (!Connection->m_UntilClose && Len>Connection->m_Remaining)
+					Len=Connection->m_Remaining;
+
+				Connection->m_Body.insert(Connection->m_Body.end(),In.begin()+Pos,In.begin()+Pos+Len);
+				Pos+=Len;
+
+				if (!Connection->m_UntilClose)
+					Connection->m_Remaining-=Len;
+
+				if (Connection->m_UntilClose || 0!=Connection->m_Remaining)
+					More=false;
+				else if (eReadingChunk==Connection->m_State)
+					Connection->m_State=eReadingChunkEnd;
+				else
+					Connection->m_State=eComplete;
+
+				break;
+			}
+
+			case eReadingChunkSize:
+			{
+				std::string::size_type End=In.find("\r\n",Pos);
+				if (std::string::npos==End)
+				{
+					More=false;
+				}
+				else
+				{
+					char *EndPtr=0;
+					unsigned long Size=strtoul(In.c_str()+Pos,&EndPtr,16);
+					if (EndPtr==In.c_str()+Pos)
+						return -1;
+
+					Pos=End+2;
+
+					if (0==Size)
+						Connection->m_State=eReadingTrailer;
+					else
+					{
+						Connection->m_Remaining=Size;
+						Connection->m_State=eReadingChunk;
+					}
+				}
+
+				break;
+			}
+
+			case eReadingChunkEnd:
+				if (In.length()-Pos<2)
+					More=false;
+				else
+				{
+					if (0!=In.compare(Pos,2,"\r\n"))
+						return -1;
+
+					Pos+=2;
+					Connection->m_State=eReadingChunkSize;
+				}
+
+				break;
+
+			case eReadingTrailer:
+			{
+				std::string::size_type End=In.find("\r\n",Pos);
+				if (std::string::npos==End)
+					More=false;
+				else
+				{
+					if (End==Pos)
+						Connection->m_State=eComplete;
+
+					Pos=End+2;
+				}
+
+				break;
+			}
+
+			default:
+				return -1;
+		}
+	}
+
+	In.erase(0,Pos);
+
+	return eComplete==Connection->m_State ? 1 : 0;
+}
+
+bool MusicBrainz5::CFetchEnginePrivate::ParseHeader(CConnection *Connection, const std::string& Header)
+{
+	int Major=0;
+	int Minor=0;
+	int Status=0;
+
+	if (3!=sscanf(Header.c_str(),"HTTP/%d.%d %d",&Major,&Minor,&Status))
+		return false;
+
+	if (Status>=100 && Status<200)
+	{
+		//Informational response, the real one follows
+
+		return true;
+	}
+
+	Connection->m_Status=Status;
+	Connection->m_KeepAlive=(Major>1 || (1==Major && Minor>=1));
+
+	bool Chunked=false;
+	bool HaveLength=false;
+	unsigned long Length=0;
+
+	std::string::size_type Start=Header.find("\r\n");
+	while (std::string::npos!=Start)
+	{
+		Start+=2;
+
+		std::string::size_type End=Header.find("\r\n",Start);
+		std::string Line=Header.substr(Start,std::string::npos==End ? std::string::npos : End-Start);
+		Start=End;
+
+		std::string::size_type Colon=Line.find(':');
+		if (std::string::npos==Colon)
+			continue;
+
+		std::string Name=Line.substr(0,Colon);
+		std::string Value=Line.substr(Colon+1);
+
+		std::string::size_type ValueStart=Value.find_first_not_of(" \t");
+		Value=std::string::npos==ValueStart ? "" : Value.substr(ValueStart);
+
+		for (std::string::size_type count=0;count<Name.length();count++)
+			Name[count]=tolower(Name[count]);
+
+		//Repeated headers are combined, as allowed by RFC 2616
+
+		std::string& Combined=Connection->m_Headers[Name];
+		if (!Combined.empty())
+			Combined+=", ";
+		Combined+=Value;
+
+		for (std::string::size_type count=0;count<Value.length();count++)
+			Value[count]=tolower(Value[count]);
+
+		if (Name=="content-length")
+		{
+			HaveLength=true;
+			Length=strtoul(Value.c_str(),0,10);
+		}
+		else if (Name=="transfer-encoding")
+		{
+			if (std::string::npos!=Value.find("chunked"))
+				Chunked=true;
+		}
+		else if (Name=="connection")
+		{
+			if (std::string::npos!=Value.find("close"))
+				Connection->m_KeepAlive=false;
+			else if (std::string::npos!=Value.find("keep-alive"))
+				Connection->m_KeepAlive=true;
+		}
+	}
+
+	if (204==Status || 304==Status)
+		Connection->m_State=eComplete;
+	else if (Chunked)
+		Connection->m_State=eReadingChunkSize;
+	else if (HaveLength)
+	{
+		Connection->m_Remaining=Length;
+		Connection->m_State=0==Length ? eComplete : eReadingBody;
+	}
+	else
+	{
+		Connection->m_UntilClose=true;
+		Connection->m_KeepAlive=false;
+		Connection->m_State=eReadingBody;
+	}
+
+	return true;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Finish(CConnection *Connection)
+{
+	CRequest *Request=Connection->m_Request;
+	Connection->m_Request=0;
+
+	std::map<std::string,std::string> Headers;
+	Headers.swap(Connection->m_Headers);
+	std::vector<unsigned char> Data;
+	Data.swap(Connection->m_Body);
+	int Status=Connection->m_Status;
+
+	if (Connection->m_KeepAlive)
+	{
+		Connection->m_State=eIdle;
+		Connection->m_In.clear();
+		Connection->m_IdleSince=Now();
+		Watch(Connection,eRead);
+	}
+	else
+		Close(Connection);
+
+	Complete(Request,0,Status,"",Headers,Data);
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Fail(CConnection *Connection, int Result, const std::string& ErrorMessage)
+{
+	CRequest *Request=Connection->m_Request;
+	bool Retry=Connection->m_Reused && !Connection->m_ResponseStarted;
+
+	Connection->m_Request=0;
+	Close(Connection);
+
+	if (Request)
+	{
+		//The server may have closed a keep-alive connection just as we reused it,
+		//so give the request one more chance on a new connection
+
+		if (Retry && !Request->m_Retried)
+		{
+			Request->m_Retried=true;
+			m_Queue.push_front(Request);
+		}
+		else
+		{
+			std::map<std::string,std::string> Headers;
+			std::vector<unsigned char> Data;
+			Complete(Request,Result,0,ErrorMessage,Headers,Data);
+		}
+	}
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Close(CConnection *Connection)
+{
+	if (-1!=Connection->m_Socket)
+		close(Connection->m_Socket);
+
+	m_Connections.remove(Connection);
+	delete Connection;
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Expire()
+{
+	long long TimeNow=Now();
+	std::map<std::string,std::string> Headers;
+	std::vector<unsigned char> Data;
+
+	while (!m_Queue.empty() && m_Queue.front()->m_Deadline<=TimeNow)
+	{
+		CRequest *Request=m_Queue.front();
+		m_Queue.pop_front();
+
+		Complete(Request,ETIMEDOUT,0,strerror(ETIMEDOUT),Headers,Data);
+	}
+
+	std::list<CConnection *>::iterator ThisConnection=m_Connections.begin();
+	while (ThisConnection!=m_Connections.end())
+	{
+		CConnection *Connection=*ThisConnection;
+		++ThisConnection;
+
+		if (Connection->m_Request && Connection->m_Request->m_Deadline<=TimeNow)
+		{
+			CRequest *Request=Connection->m_Request;
+			Connection->m_Request=0;
+			Close(Connection);
+
+			Complete(Request,ETIMEDOUT,0,strerror(ETIMEDOUT),Headers,Data);
+		}
+		else if (eIdle==Connection->m_State && Connection->m_IdleSince+(long long)m_IdleTimeout*1000<=TimeNow)
+		{
+			//The server will close it soon, if it hasn't already
+
+			Close(Connection);
+		}
+	}
+}
+
+void MusicBrainz5::CFetchEnginePrivate::Complete(CRequest *Request, int Result, int Status, const std::string& ErrorMessage, std::map<std::string,std::string>& Headers, std::vector<unsigned char>& Data)
+{
+	CFetchCompletion Completion;
+	Completion.m_d->m_ID=Request->m_ID;
+	Completion.m_d->m_URL=Request->m_URL;
+	Completion.m_d->m_Result=Result;
+	Completion.m_d->m_Status=Status;
+	Completion.m_d->m_ErrorMessage=ErrorMessage;
+	Completion.m_d->m_Headers.swap(Headers);
+	Completion.m_d->m_Data.swap(Data);
+
+	delete Request;
+
+	m_Completed++;
+
+	if (m_Callback)
+		m_Callback->Completed(Completion);
+	else
+		m_Completions.push_back(Completion);
+}
+
+int MusicBrainz5::CFetchEnginePrivate::NumActive() const
+{
+	int Active=0;
+
+	std::list<CConnection *>::const_iterator ThisConnection=m_Connections.begin();
+	while (ThisConnection!=m_Connections.end())
+	{
+		if ((*ThisConnection)->m_Request)
+			Active++;
+
+		++ThisConnection;
+	}
+
+	return Active;
+}
+
+MusicBrainz5::CFetchEngine::CFetchEngine(const std::string& UserAgent, const std::string& Host, int Port, int MaxConnections)
+:	m_d(new CFetchEnginePrivate)
+{
+	m_d->m_UserAgent=UserAgent;
+
+	for (std::string::size_type Pos=0;Pos<m_d->m_UserAgent.length();Pos++)
+		if (m_d->m_UserAgent[Pos]=='-')
+			m_d->m_UserAgent[Pos]='/';
+
+	m_d->m_Host=Host;
+	m_d->m_Port=Port;
+	m_d->m_MaxConnections=MaxConnections;
+
+	//Interrupt wakes Run up by writing to a pipe that it waits on along with the connections
+
+	if (0==pipe(m_d->m_Wake))
+	{
+		for (int count=0;count<2;count++)
+		{
+			fcntl(m_d->m_Wake[count],F_SETFL,fcntl(m_d->m_Wake[count],F_GETFL)|O_NONBLOCK);
+			fcntl(m_d->m_Wake[count],F_SETFD,FD_CLOEXEC);
+		}
+	}
+	else
+	{
+		m_d->m_SetupError=errno;
+		m_d->m_Wake[0]=-1;
+		m_d->m_Wake[1]=-1;
+	}
+
+#ifdef HAVE_SYS_EPOLL_H
+	m_d->m_Poll=epoll_create(64);
+	if (-1!=m_d->m_Poll)
+	{
+		fcntl(m_d->m_Poll,F_SETFD,FD_CLOEXEC);
+
+		if (-1!=m_d->m_Wake[0])
+		{
+			struct epoll_event Event;
+			memset(&Event,0,sizeof(Event));
+			Event.data.ptr=0;
+			Event.events=EPOLLIN;
+
+			epoll_ctl(m_d->m_Poll,EPOLL_CTL_ADD,m_d->m_Wake[0],&Event);
+		}
+	}
+	else if (0==m_d->m_SetupError)
+		m_d->m_SetupError=errno;
+#endif
+}
+
+MusicBrainz5::CFetchEngine::~CFetchEngine()
+{
+	while (!m_d->m_Connections.empty())
+	{
+		CFetchEnginePrivate::CConnection *Connection=m_d->m_Connections.front();
+		delete Connection->m_Request;
+		Connection->m_Request=0;
+		m_d->Close(Connection);
+	}
+
+	while (!m_d->m_Queue.empty())
+	{
+		delete m_d->m_Queue.front();
+		m_d->m_Queue.pop_front();
+	}
+
+	if (m_d->m_Addresses)
+		freeaddrinfo(m_d->m_Addresses);
+
+	if (-1!=m_d->m_Poll)
+		close(m_d->m_Poll);
+
+	for (int count=0;count<2;count++)
+	{
+		if (-1!=m_d->m_Wake[count])
+			close(m_d->m_Wake[count]);
+	}
+
+	delete m_d;
+}
+
+void MusicBrainz5::CFetchEngine::SetCallback(CFetchCallback *Callback)
+{
+	m_d->m_Callback=Callback;
+}
+
+void MusicBrainz5::CFetchEngine::SetTimeout(int Timeout)
+{
+	m_d->m_Timeout=Timeout;
+}
+
+void MusicBrainz5::CFetchEngine::SetMaxConnections(int MaxConnections)
+{
+	m_d->m_MaxConnections=MaxConnections;
+}
+
+void MusicBrainz5::CFetchEngine::SetIdleTimeout(int IdleTimeout)
+{
+	m_d->m_IdleTimeout=IdleTimeout;
+}
+
+int MusicBrainz5::CFetchEngine::Add(const std::string& URL, const std::map<std::string,std::string>& Headers)
+{
+	int ID=m_d->m_NextID++;
+
+	m_d->m_Queue.push_back(new CFetchEnginePrivate::CRequest(ID,URL,Headers,CFetchEnginePrivate::Now()+(long long)m_d->m_Timeout*1000));
+
+	return ID;
+}
+
+int MusicBrainz5::CFetchEngine::Run(int Timeout)
+{
+	//Without these, waiting for events would return straight away every time
+
+	if (0!=m_d->m_SetupError)
+		throw CFetchError(std::string("Unable to create descriptors to wait on: ")+strerror(m_d->m_SetupError));
+
+	long long End=Timeout>=0 ? CFetchEnginePrivate::Now()+Timeout : -1;
+
+	m_d->m_Completed=0;
+	m_d->m_Interrupted=false;
+
+	//Connections that have been idle for too long mustn't be reused
+
+	m_d->Expire();
+
+	for (;;)
+	{
+		m_d->StartRequests();
+
+		if (0==NumPending())
+			break;
+
+		//Wake up in time to expire the oldest request
+
+		long long TimeNow=CFetchEnginePrivate::Now();
+		long long Wait=-1;
+
+		if (!m_d->m_Queue.empty())
+			Wait=m_d->m_Queue.front()->m_Deadline;
+
+		std::list<CFetchEnginePrivate::CConnection *>::const_iterator ThisConnection=m_d->m_Connections.begin();
+		while (ThisConnection!=m_d->m_Connections.end())
+		{
+			CFetchEnginePrivate::CRequest *Request=(*ThisConnection)->m_Request;
+			if (Request && (-1==Wait || Request->m_Deadline<Wait))
+				Wait=Request->m_Deadline;
+
+			++ThisConnection;
+		}
+
+		if (-1!=End && End<Wait)
+			Wait=End;
+
+		Wait-=TimeNow;
+		if (Wait<0)
+			Wait=0;
+
+		m_d->Wait(Wait);
+		m_d->Expire();
+
+		if (m_d->m_Interrupted || (-1!=End && CFetchEnginePrivate::Now()>=End))
+			break;
+	}
+
+	return m_d->m_Completed;
+}
+
+void MusicBrainz5::CFetchEngine::Interrupt()
+{
+	char Wake=0;
+
+	if (-1!=m_d->m_Wake[1])
+	{
+		while (-1==write(m_d->m_Wake[1],&Wake,1) && EINTR==errno)
+			;
+	}
+}
+
+int MusicBrainz5::CFetchEngine::NumPending() const
+{
+	return m_d->m_Queue.size()+m_d->NumActive();
+}
+
+int MusicBrainz5::CFetchEngine::NumConnections() const
+{
+	return m_d->m_Connections.size();
+}
+
+bool MusicBrainz5::CFetchEngine::NextCompletion(CFetchCompletion& Completion)
+{
+	if (m_d->m_Completions.empty())
+		return false;
+
+	Completion=m_d->m_Completions.front();
+	m_d->m_Completions.pop_front();
+
+	return true;
+}
@@ -0,0 +1,384 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/FetchEngineTransport.h"
+
+#include <deque>
+#include <sstream>
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "musicbrainz5/FetchEngine.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+namespace MusicBrainz5
+{
+	//A request waiting to be made by the engine thread
+
+	class CEngineRequest
+	{
+	public:
+		CEngineRequest(const std::string& URL, const std::map<std::string,std::string>& Headers)
+		:	m_URL(URL),
+			m_Headers(Headers),
+			m_Done(false)
+		{
+		}
+
+		std::string m_URL;
+		std::map<std::string,std::string> m_Headers;
+		bool m_Done;
+		std::string m_Error;
+		CFetchCompletion m_Completion;
+	};
+
+	//Runs the engine for one server on its own thread, on behalf of the threads
+	//making requests
+
+	class CEngineThread: public CFetchCallback
+	{
+	public:
+		CEngineThread(const std::string& UserAgent, const std::string& Host, int Port, int MaxConnections, int IdleTimeout)
+		:	m_Engine(UserAgent,Host,Port,MaxConnections),
+			m_IdleTimeout(IdleTimeout),
+			m_Stopping(false),
+			m_Started(false)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+			pthread_cond_init(&m_Cond,0);
+
+			m_Engine.SetCallback(this);
+			m_Engine.SetIdleTimeout(IdleTimeout);
+
+			if (0==pthread_create(&m_Thread,0,CEngineThread::Thread,this))
+				m_Started=true;
+			else
+				m_Error="Unable to start thread for '" + Host + "'";
+		}
+
+		~CEngineThread()
+		{
+			pthread_mutex_lock(&m_Mutex);
+			m_Stopping=true;
+			pthread_cond_broadcast(&m_Cond);
+			pthread_mutex_unlock(&m_Mutex);
+
+			m_Engine.Interrupt();
+
+			if (m_Started)
+				pthread_join(m_Thread,0);
+
+			pthread_cond_destroy(&m_Cond);
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		void Fetch(CEngineRequest& Request)
+		{
+			pthread_mutex_lock(&m_Mutex);
+
+			if (!m_Error.empty())
+			{
+				Request.m_Error=m_Error;
+				pthread_mutex_unlock(&m_Mutex);
+
+				return;
+			}
+
+			m_Queue.push_back(&Request);
+			pthread_cond_broadcast(&m_Cond);
+
+			//The engine thread may be waiting for other requests to complete
+
+			m_Engine.Interrupt();
+
+			while (!Request.m_Done)
+				pthread_cond_wait(&m_Cond,&m_Mutex);
+
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+		void Completed(const CFetchCompletion& Completion)
+		{
+			pthread_mutex_lock(&m_Mutex);
+
+			std::map<int,CEngineRequest *>::iterator Request=m_Waiting.find(Completion.ID());
+			if (Request!=m_Waiting.end())
+			{
+				(*Request).second->m_Completion=Completion;
+				(*Request).second->m_Done=true;
+				m_Waiting.erase(Request);
+
+				pthread_cond_broadcast(&m_Cond);
+			}
+
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+	private:
+		CFetchEngine m_Engine;
+		int m_IdleTimeout;
+		bool m_Stopping;
+		bool m_Started;
+		std::string m_Error;
+		pthread_t m_Thread;
+		pthread_mutex_t m_Mutex;
+		pthread_cond_t m_Cond;
+		std::deque<CEngineRequest *> m_Queue;
+		std::map<int,CEngineRequest *> m_Waiting;
+
+		static void *Thread(void *EngineThread)
+		{
+			static_cast<CEngineThread *>(EngineThread)->Work();
+
+			return 0;
+		}
+
+		void Work()
+		{
+			pthread_mutex_lock(&m_Mutex);
+
+			while (!m_Stopping)
+			{
+				while (!m_Queue.empty())
+				{
+					CEngineRequest *Request=m_Queue.front();
+					m_Queue.pop_front();
+
+					m_Waiting[m_Engine.Add(Request->m_URL,Request->m_Headers)]=Request;
+				}
+
+				if (0==m_Engine.NumPending())
+				{
+					if (0==m_Engine.NumConnections())
+						pthread_cond_wait(&m_Cond,&m_Mutex);
+					else
+					{
+						//Wake up to close the connections if they aren't used again in time
+
+						struct timespec Deadline;
+						clock_gettime(CLOCK_REALTIME,&Deadline);
+						Deadline.tv_sec+=m_IdleTimeout;
+
+						if (ETIMEDOUT==pthread_cond_timedwait(&m_Cond,&m_Mutex,&Deadline))
+						{
+							pthread_mutex_unlock(&m_Mutex);
+							RunEngine(0);
+							pthread_mutex_lock(&m_Mutex);
+						}
+					}
+				}
+				else
+				{
+					pthread_mutex_unlock(&m_Mutex);
+					RunEngine(-1);
+					pthread_mutex_lock(&m_Mutex);
+				}
+			}
+
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+		void RunEngine(int Timeout)
+		{
+			try
+			{
+				m_Engine.Run(Timeout);
+			}
+
+			catch (CFetchError& Error)
+			{
+				//The engine can't be used at all, so fail everything now and from now on
+
+				pthread_mutex_lock(&m_Mutex);
+
+				m_Error=Error.what();
+				m_Stopping=true;
+
+				std::map<int,CEngineRequest *>::iterator ThisRequest=m_Waiting.begin();
+				while (ThisRequest!=m_Waiting.end())
+				{
+					(*ThisRequest).second->m_Error=m_Error;
+					(*ThisRequest).second->m_Done=true;
+
+					++ThisRequest;
+				}
+
+				m_Waiting.clear();
+
+				while (!m_Queue.empty())
+				{
+					m_Queue.front()->m_Error=m_Error;
+					m_Queue.front()->m_Done=true;
+					m_Queue.pop_front();
+				}
+
+				pthread_cond_broadcast(&m_Cond);
+
+				pthread_mutex_unlock(&m_Mutex);
+			}
+		}
+	};
+
+	class CEngineFetch: public CFetch
+	{
+	public:
+		CEngineFetch(CEngineThread *EngineThread, const std::string& UserAgent, const std::string& Host, int Port)
+		:	CFetch(UserAgent,Host,Port),
+			m_EngineThread(EngineThread)
+		{
+		}
+
+		int Fetch(const std::string& URL, const std::string& Request)
+		{
+			Reset();
+
+			if (Request!="GET")
+			{
+				SetResult(EOPNOTSUPP);
+				SetErrorMessage("Unable to make " + Request + " request for '" + URL + "' through a fetch engine");
+				throw CFetchError(ErrorMessage());
+			}
+
+			CEngineRequest EngineRequest(URL,RequestHeaders());
+			m_EngineThread->Fetch(EngineRequest);
+
+			if (!EngineRequest.m_Error.empty())
+			{
+				SetResult(-1);
+				SetErrorMessage(EngineRequest.m_Error);
+				throw CFetchError(ErrorMessage());
+			}
+
+			const CFetchCompletion& Completion=EngineRequest.m_Completion;
+
+			SetResult(Completion.Result());
+
+			switch (Completion.Result())
+			{
+				case 0:
+					break;
+
+				case ECONNREFUSED:
+				case EHOSTUNREACH:
+				case ENETUNREACH:
+					SetErrorMessage(Completion.ErrorMessage());
+					throw CConnectionError(ErrorMessage());
+					break;
+
+				case ETIMEDOUT:
+					SetErrorMessage(Completion.ErrorMessage());
+					throw CTimeoutError(ErrorMessage());
+					break;
+
+				default:
+					SetErrorMessage(Completion.ErrorMessage());
+					throw CFetchError(ErrorMessage());
+					break;
+			}
+
+			SetStatus(Completion.Status());
+
+			std::map<std::string,std::string> Headers=Completion.ResponseHeaders();
+			for (std::map<std::string,std::string>::const_iterator ThisHeader=Headers.begin();ThisHeader!=Headers.end();++ThisHeader)
+				AddResponseHeader((*ThisHeader).first,(*ThisHeader).second);
+
+			//Only successful responses carry data, in the same way as CHTTPFetch
+
+			std::vector<unsigned char> Data=Completion.Data();
+			if (Status()>=200 && Status()<300 && !Data.empty())
+				AddData((const char *)&Data[0],Data.size());
+
+			CheckStatus();
+
+			return DataSize();
+		}
+
+	private:
+		CEngineThread *m_EngineThread;
+	};
+}
+
+class MusicBrainz5::CFetchEngineTransportPrivate
+{
+	public:
+		CFetchEngineTransportPrivate()
+		:	m_MaxConnections(4),
+			m_IdleTimeout(30)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CFetchEngineTransportPrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		int m_MaxConnections;
+		int m_IdleTimeout;
+		pthread_mutex_t m_Mutex;
+		std::map<std::string,CEngineThread *> m_Threads;
+};
+
+MusicBrainz5::CFetchEngineTransport::CFetchEngineTransport(int MaxConnections, int IdleTimeout)
+:	m_d(new CFetchEngineTransportPrivate)
+{
+	m_d->m_MaxConnections=MaxConnections;
+	m_d->m_IdleTimeout=IdleTimeout;
+}
+
+MusicBrainz5::CFetchEngineTransport::~CFetchEngineTransport()
+{
+	std::map<std::string,CEngineThread *>::iterator ThisThread=m_d->m_Threads.begin();
+	while (ThisThread!=m_d->m_Threads.end())
+	{
+		delete (*ThisThread).second;
+		++ThisThread;
+	}
+
+	delete m_d;
+}
+
+MusicBrainz5::CFetch *MusicBrainz5::CFetchEngineTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	//Each server, and user agent, gets its own engine
+
+	std::stringstream Key;
+	Key << Host << ":" << Port << " " << UserAgent;
+
+	pthread_mutex_lock(&m_d->m_Mutex);
+
+	CEngineThread *& EngineThread=m_d->m_Threads[Key.str()];
+	if (!EngineThread)
+		EngineThread=new CEngineThread(UserAgent,Host,Port,m_d->m_MaxConnections,m_d->m_IdleTimeout);
+
+	pthread_mutex_unlock(&m_d->m_Mutex);
+
+	return new CEngineFetch(EngineThread,UserAgent,Host,Port);
+}
@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/NonMBTrackList.h"
 #include "musicbrainz5/NonMBTrack.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CFreeDBDiscPrivate
+class MusicBrainz5::CFreeDBDiscPrivate: public CSharedPrivate
 {
 	public:
 		CFreeDBDiscPrivate()
@@ -39,6 +41,24 @@ class MusicBrainz5::CFreeDBDiscPrivate
 		{
 		}
 
+		CFreeDBDiscPrivate(const CFreeDBDiscPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Title(Other.m_Title),
+			m_Artist(Other.m_Artist),
+			m_Category(Other.m_Category),
+			m_Year(Other.m_Year),
+			m_NonMBTrackList(0)
+		{
+			if (Other.m_NonMBTrackList)
+				m_NonMBTrackList=new CNonMBTrackList(*Other.m_NonMBTrackList);
+		}
+
+		~CFreeDBDiscPrivate()
+		{
+			delete m_NonMBTrackList;
+		}
+
 		std::string m_ID;
 		std::string m_Title;
 		std::string m_Artist;
@@ -60,44 +80,46 @@ MusicBrainz5::CFreeDBDisc::CFreeDBDisc(const XMLNode& Node)
 }
 
 MusicBrainz5::CFreeDBDisc::CFreeDBDisc(const CFreeDBDisc& Other)
-:	CEntity(),
-	m_d(new CFreeDBDiscPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CFreeDBDisc& MusicBrainz5::CFreeDBDisc::operator =(const CFreeDBDisc& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Category=Other.m_d->m_Category;
-		m_d->m_Year=Other.m_d->m_Year;
-
-		if (Other.m_d->m_NonMBTrackList)
-			m_d->m_NonMBTrackList=new CNonMBTrackList(*Other.m_d->m_NonMBTrackList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CFreeDBDisc::~CFreeDBDisc()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CFreeDBDisc::CFreeDBDisc(CFreeDBDisc&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CFreeDBDiscPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CFreeDBDisc& MusicBrainz5::CFreeDBDisc::operator =(CFreeDBDisc&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CFreeDBDisc::Cleanup()
+MusicBrainz5::CFreeDBDisc::~CFreeDBDisc()
 {
-	delete m_d->m_NonMBTrackList;
-	m_d->m_NonMBTrackList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CFreeDBDisc *MusicBrainz5::CFreeDBDisc::Clone()
@@ -107,6 +129,8 @@ MusicBrainz5::CFreeDBDisc *MusicBrainz5::CFreeDBDisc::Clone()
 
 void MusicBrainz5::CFreeDBDisc::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -119,33 +143,35 @@ void MusicBrainz5::CFreeDBDisc::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CFreeDBDisc::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("category"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Category);
-	}
-	else if ("year"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Year);
-	}
-	else if ("nonmb-track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_NonMBTrackList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElementCategory:
+			ProcessItem(Node,m_d->m_Category);
+			break;
+
+		case eElementYear:
+			ProcessItem(Node,m_d->m_Year);
+			break;
+
+		case eElementNonmbTrackList:
+			ProcessItem(Node,m_d->m_NonMBTrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised freedb disc element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised freedb disc element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -154,36 +180,43 @@ std::string MusicBrainz5::CFreeDBDisc::GetElementName()
 	return "freedb-disc";
 }
 
-std::string MusicBrainz5::CFreeDBDisc::ID() const
+const std::string& MusicBrainz5::CFreeDBDisc::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CFreeDBDisc::Title() const
+const std::string& MusicBrainz5::CFreeDBDisc::Title() const
 {
 	return m_d->m_Title;
 }
 
-std::string MusicBrainz5::CFreeDBDisc::Artist() const
+const std::string& MusicBrainz5::CFreeDBDisc::Artist() const
 {
 	return m_d->m_Artist;
 }
 
-std::string MusicBrainz5::CFreeDBDisc::Category() const
+const std::string& MusicBrainz5::CFreeDBDisc::Category() const
 {
 	return m_d->m_Category;
 }
 
-std::string MusicBrainz5::CFreeDBDisc::Year() const
+const std::string& MusicBrainz5::CFreeDBDisc::Year() const
 {
 	return m_d->m_Year;
 }
 
-MusicBrainz5::CNonMBTrackList *MusicBrainz5::CFreeDBDisc::NonMBTrackList() const
+const MusicBrainz5::CNonMBTrackList *MusicBrainz5::CFreeDBDisc::NonMBTrackList() const
 {
 	return m_d->m_NonMBTrackList;
 }
 
+MusicBrainz5::CNonMBTrackList *MusicBrainz5::CFreeDBDisc::NonMBTrackList()
+{
+	Unshare(m_d);
+
+	return m_d->m_NonMBTrackList;
+}
+
 std::ostream& MusicBrainz5::CFreeDBDisc::Serialise(std::ostream& os) const
 {
 	os << "FreeDBDisc:" << std::endl;
@@ -27,6 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/HTTPSessionPool.h"
+
+#include <sstream>
 
 #include <stdlib.h>
 #include <string.h>
@@ -35,6 +38,7 @@
 #include "ne_auth.h"
 #include "ne_string.h"
 #include "ne_request.h"
+#include "ne_compress.h"
 
 #if defined(__GNUC__)
 __attribute__((constructor))
@@ -60,40 +64,22 @@ class MusicBrainz5::CHTTPFetchPrivate
 {
 	public:
 		CHTTPFetchPrivate()
-		:	m_Port(80),
-			m_Result(0),
-			m_Status(0),
-			m_ProxyPort(0)
+		:	m_SessionPool(0)
 		{
 		}
 
-		std::string m_UserAgent;
-		std::string m_Host;
-		int m_Port;
-		std::vector<unsigned char> m_Data;
-		int m_Result;
-		int m_Status;
-		std::string m_ErrorMessage;
-		std::string m_UserName;
-		std::string m_Password;
-		std::string m_ProxyHost;
-		int m_ProxyPort;
-		std::string m_ProxyUserName;
-		std::string m_ProxyPassword;
+		CHTTPSessionPool *m_SessionPool;
 };
 
-MusicBrainz5::CHTTPFetch::CHTTPFetch(const std::string& UserAgent, const std::string& Host, int Port)
-:	m_d(new CHTTPFetchPrivate)
-{
-	m_d->m_UserAgent=UserAgent;
-
-	for (std::string::size_type Pos=0;Pos<m_d->m_UserAgent.length();Pos++)
-		if (m_d->m_UserAgent[Pos]=='-')
-			m_d->m_UserAgent[Pos]='/';
+//Key used to find the current CHTTPFetch object from the authentication callbacks.
+//Sessions may outlive the object that created them when they're held in a pool.
 
- 	m_d->m_Host=Host;
-	m_d->m_Port=Port;
+static const char *SessionFetchKey="libmusicbrainz5-fetch";
 
+MusicBrainz5::CHTTPFetch::CHTTPFetch(const std::string& UserAgent, const std::string& Host, int Port)
+:	CFetch(UserAgent,Host,Port),
+	m_d(new CHTTPFetchPrivate)
+{
 	// Parse http_proxy environmnent variable
 	const char *http_proxy = getenv("http_proxy");
 	if (http_proxy)
@@ -102,9 +88,9 @@ MusicBrainz5::CHTTPFetch::CHTTPFetch(const std::string& UserAgent, const std::st
 		if (!ne_uri_parse(http_proxy, &uri))
 		{
 			if (uri.host)
-				m_d->m_ProxyHost = uri.host;
+				SetProxyHost(uri.host);
 			if (uri.port)
-				m_d->m_ProxyPort = uri.port;
+				SetProxyPort(uri.port);
 
 			if (uri.userinfo)
 			{
@@ -112,12 +98,12 @@ MusicBrainz5::CHTTPFetch::CHTTPFetch(const std::string& UserAgent, const std::st
 				if (pos)
 				{
 					*pos = '\0';
-					m_d->m_ProxyUserName = uri.userinfo;
-					m_d->m_ProxyPassword = pos + 1;
+					SetProxyUserName(uri.userinfo);
+					SetProxyPassword(pos + 1);
 				}
 				else
 				{
-					m_d->m_ProxyUserName = uri.userinfo;
+					SetProxyUserName(uri.userinfo);
 				}
 			}
 		}
@@ -131,55 +117,64 @@ MusicBrainz5::CHTTPFetch::~CHTTPFetch()
 	delete m_d;
 }
 
-void MusicBrainz5::CHTTPFetch::SetUserName(const std::string& UserName)
+void MusicBrainz5::CHTTPFetch::SetSessionPool(CHTTPSessionPool *SessionPool)
 {
-	m_d->m_UserName=UserName;
+	m_d->m_SessionPool=SessionPool;
 }
 
-void MusicBrainz5::CHTTPFetch::SetPassword(const std::string& Password)
+std::string MusicBrainz5::CHTTPFetch::SessionKey() const
 {
-	m_d->m_Password=Password;
-}
+	std::stringstream os;
 
-void MusicBrainz5::CHTTPFetch::SetProxyHost(const std::string& ProxyHost)
-{
-	m_d->m_ProxyHost=ProxyHost;
-}
+	os << Host() << ":" << Port();
 
-void MusicBrainz5::CHTTPFetch::SetProxyPort(int ProxyPort)
-{
-	m_d->m_ProxyPort=ProxyPort;
-}
+	if (!ProxyHost().empty())
+		os << " via " << ProxyHost() << ":" << ProxyPort();
 
-void MusicBrainz5::CHTTPFetch::SetProxyUserName(const std::string& ProxyUserName)
-{
-	m_d->m_ProxyUserName=ProxyUserName;
-}
+	if (!UserName().empty())
+		os << " as " << UserName();
 
-void MusicBrainz5::CHTTPFetch::SetProxyPassword(const std::string& ProxyPassword)
-{
-	m_d->m_ProxyPassword=ProxyPassword;
+	return os.str();
 }
 
 int MusicBrainz5::CHTTPFetch::Fetch(const std::string& URL, const std::string& Request)
 {
 	int Ret=0;
 
-	m_d->m_Data.clear();
+	Reset();
 
-	ne_session *sess=ne_session_create("http", m_d->m_Host.c_str(), m_d->m_Port);
-	if (sess)
-	{
-		ne_set_useragent(sess, m_d->m_UserAgent.c_str());
+	std::string Key=SessionKey();
 
-		ne_set_server_auth(sess, httpAuth, this);
+	ne_session *sess=0;
+	if (m_d->m_SessionPool)
+		sess=m_d->m_SessionPool->Acquire(Key);
 
-		// Use proxy server
-		if (!m_d->m_ProxyHost.empty())
+	if (!sess)
+	{
+		sess=ne_session_create("http", Host().c_str(), Port());
+		if (sess)
 		{
-			ne_session_proxy(sess, m_d->m_ProxyHost.c_str(), m_d->m_ProxyPort);
-			ne_set_proxy_auth(sess, proxyAuth, this);
+			ne_set_server_auth(sess, httpAuth, sess);
+
+			// Use proxy server
+			if (!ProxyHost().empty())
+			{
+				ne_session_proxy(sess, ProxyHost().c_str(), ProxyPort());
+				ne_set_proxy_auth(sess, proxyAuth, sess);
+			}
 		}
+	}
+	else if (Request!="GET")
+	{
+		// A request that can't safely be retried shouldn't go out on a connection
+		// that the server may have closed while it was idle
+		ne_close_connection(sess);
+	}
+
+	if (sess)
+	{
+		ne_set_session_private(sess, SessionFetchKey, this);
+		ne_set_useragent(sess, UserAgent().c_str());
 
 		ne_request *req = ne_request_create(sess, Request.c_str(), URL.c_str());
 		if (Request=="PUT")
@@ -188,64 +183,73 @@ int MusicBrainz5::CHTTPFetch::Fetch(const std::string& URL, const std::string& R
 		if (Request!="GET")
 			ne_set_request_flag(req, NE_REQFLAG_IDEMPOTENT, 0);
 
-		ne_add_response_body_reader(req, ne_accept_2xx, httpResponseReader, &m_d->m_Data);
+		std::map<std::string,std::string> Headers=RequestHeaders();
+		for (std::map<std::string,std::string>::const_iterator ThisHeader=Headers.begin();ThisHeader!=Headers.end();++ThisHeader)
+			ne_add_request_header(req, (*ThisHeader).first.c_str(), (*ThisHeader).second.c_str());
+
+		ne_decompress *decompress=0;
+		if (Compression())
+		{
+			// Sees the body as it arrives off the wire, before it is decompressed
+			ne_add_response_body_reader(req, ne_accept_2xx, httpCompressedReader, this);
+			decompress = ne_decompress_reader(req, ne_accept_2xx, httpResponseReader, this);
+		}
+		else
+			ne_add_response_body_reader(req, ne_accept_2xx, httpResponseReader, this);
+
+		int Result = ne_request_dispatch(req);
+		SetResult(Result);
+		SetStatus(ne_get_status(req)->code);
 
-		m_d->m_Result = ne_request_dispatch(req);
-		m_d->m_Status = ne_get_status(req)->code;
+		void *cursor = NULL;
+		const char *name = NULL;
+		const char *value = NULL;
+		while ((cursor = ne_response_header_iterate(req, cursor, &name, &value)))
+			AddResponseHeader(name, value);
 
-		Ret=m_d->m_Data.size();
+		if (decompress)
+			ne_decompress_destroy(decompress);
 
 		ne_request_destroy(req);
 
-		m_d->m_ErrorMessage = ne_get_error(sess);
+		std::string ErrorMessage = ne_get_error(sess);
+		SetErrorMessage(ErrorMessage);
 
-		ne_session_destroy(sess);
+		ne_set_session_private(sess, SessionFetchKey, 0);
 
-		switch (m_d->m_Result)
+		// Only hand the session back for reuse if the connection is known to be good
+		if (m_d->m_SessionPool && NE_OK==Result)
+			m_d->m_SessionPool->Release(Key,sess);
+		else
+			ne_session_destroy(sess);
+
+		switch (Result)
 		{
 			case NE_OK:
 				break;
 
 			case NE_CONNECT:
 			case NE_LOOKUP:
-				throw CConnectionError(m_d->m_ErrorMessage);
+				throw CConnectionError(ErrorMessage);
 				break;
 
 			case NE_TIMEOUT:
-				throw CTimeoutError(m_d->m_ErrorMessage);
+				throw CTimeoutError(ErrorMessage);
 				break;
 
 			case NE_AUTH:
 			case NE_PROXYAUTH:
-				throw CAuthenticationError(m_d->m_ErrorMessage);
+				throw CAuthenticationError(ErrorMessage);
 				break;
 
 			default:
-				throw CFetchError(m_d->m_ErrorMessage);
+				throw CFetchError(ErrorMessage);
 				break;
 		}
 
-		switch (m_d->m_Status)
-		{
-			case 200:
-				break;
-
-			case 400:
-				throw CRequestError(m_d->m_ErrorMessage);
-				break;
-
-			case 401:
-				throw CAuthenticationError(m_d->m_ErrorMessage);
-				break;
+		CheckStatus();
 
-			case 404:
-				throw CResourceNotFoundError(m_d->m_ErrorMessage);
-				break;
-
-			default:
-				throw CFetchError(m_d->m_ErrorMessage);
-				break;
-		}
+		Ret=DataSize();
 	}
 
 	return Ret;
@@ -256,9 +260,13 @@ int MusicBrainz5::CHTTPFetch::httpAuth(void *userdata, const char *realm, int at
 {
 	realm=realm;
 
-	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
-	strncpy(username, Fetch->m_d->m_UserName.c_str(), NE_ABUFSIZ);
-	strncpy(password, Fetch->m_d->m_Password.c_str(), NE_ABUFSIZ);
+	ne_session *sess = (ne_session *)userdata;
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)ne_get_session_private(sess, SessionFetchKey);
+	if (!Fetch)
+		return -1;
+
+	strncpy(username, Fetch->UserName().c_str(), NE_ABUFSIZ);
+	strncpy(password, Fetch->Password().c_str(), NE_ABUFSIZ);
 	return attempts;
 }
 
@@ -267,37 +275,32 @@ int MusicBrainz5::CHTTPFetch::proxyAuth(void *userdata, const char *realm, int a
 {
 	realm=realm;
 
-	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
-	strncpy(username, Fetch->m_d->m_ProxyUserName.c_str(), NE_ABUFSIZ);
-	strncpy(password, Fetch->m_d->m_ProxyPassword.c_str(), NE_ABUFSIZ);
+	ne_session *sess = (ne_session *)userdata;
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)ne_get_session_private(sess, SessionFetchKey);
+	if (!Fetch)
+		return -1;
+
+	strncpy(username, Fetch->ProxyUserName().c_str(), NE_ABUFSIZ);
+	strncpy(password, Fetch->ProxyPassword().c_str(), NE_ABUFSIZ);
 	return attempts;
 }
 
-int MusicBrainz5::CHTTPFetch::httpResponseReader(void *userdata, const char *buf, size_t len)
+int MusicBrainz5::CHTTPFetch::httpCompressedReader(void *userdata, const char *buf, size_t len)
 {
-	std::vector<unsigned char> *buffer = reinterpret_cast<std::vector<unsigned char> *>(userdata);
+	buf=buf;
 
-	buffer->insert(buffer->end(),buf,buf+len);
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
 
-	return 0;
-}
+	Fetch->AddCompressedSize(len);
 
-std::vector<unsigned char> MusicBrainz5::CHTTPFetch::Data() const
-{
-	return m_d->m_Data;
+	return 0;
 }
 
-int MusicBrainz5::CHTTPFetch::Result() const
+int MusicBrainz5::CHTTPFetch::httpResponseReader(void *userdata, const char *buf, size_t len)
 {
-	return m_d->m_Result;
-}
+	MusicBrainz5::CHTTPFetch *Fetch = (MusicBrainz5::CHTTPFetch *)userdata;
 
-int MusicBrainz5::CHTTPFetch::Status() const
-{
-	return m_d->m_Status;
-}
+	Fetch->AddData(buf,len);
 
-std::string MusicBrainz5::CHTTPFetch::ErrorMessage() const
-{
-	return m_d->m_ErrorMessage;
+	return 0;
 }
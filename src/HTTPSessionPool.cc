@@ -0,0 +1,205 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/HTTPSessionPool.h"
+
+#include <list>
+
+#include <pthread.h>
+#include <time.h>
+
+#include "ne_session.h"
+
+class MusicBrainz5::CHTTPSessionPoolPrivate
+{
+	public:
+		class CEntry
+		{
+		public:
+			CEntry(const std::string& Key, ne_session *Session, time_t LastUsed)
+			:	m_Key(Key),
+				m_Session(Session),
+				m_LastUsed(LastUsed)
+			{
+			}
+
+			std::string m_Key;
+			ne_session *m_Session;
+			time_t m_LastUsed;
+		};
+
+		CHTTPSessionPoolPrivate()
+		:	m_MaxSessions(4),
+			m_IdleTimeout(30)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CHTTPSessionPoolPrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		pthread_mutex_t m_Mutex;
+		int m_MaxSessions;
+		int m_IdleTimeout;
+
+		//Most recently used sessions are at the front of the list
+		std::list<CEntry> m_Sessions;
+};
+
+//Holds the pool locked for as long as it is in scope
+
+class CHTTPSessionPoolLock
+{
+	public:
+		CHTTPSessionPoolLock(pthread_mutex_t *Mutex)
+		:	m_Mutex(Mutex)
+		{
+			pthread_mutex_lock(m_Mutex);
+		}
+
+		~CHTTPSessionPoolLock()
+		{
+			pthread_mutex_unlock(m_Mutex);
+		}
+
+	private:
+		pthread_mutex_t *m_Mutex;
+};
+
+MusicBrainz5::CHTTPSessionPool::CHTTPSessionPool(int MaxSessions, int IdleTimeout)
+:	m_d(new CHTTPSessionPoolPrivate)
+{
+	m_d->m_MaxSessions=MaxSessions;
+	m_d->m_IdleTimeout=IdleTimeout;
+}
+
+MusicBrainz5::CHTTPSessionPool::~CHTTPSessionPool()
+{
+	Clear();
+
+	delete m_d;
+}
+
+void MusicBrainz5::CHTTPSessionPool::SetMaxSessions(int MaxSessions)
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	m_d->m_MaxSessions=MaxSessions;
+
+	Expire();
+}
+
+void MusicBrainz5::CHTTPSessionPool::SetIdleTimeout(int IdleTimeout)
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	m_d->m_IdleTimeout=IdleTimeout;
+
+	Expire();
+}
+
+int MusicBrainz5::CHTTPSessionPool::MaxSessions() const
+{
+	return m_d->m_MaxSessions;
+}
+
+int MusicBrainz5::CHTTPSessionPool::IdleTimeout() const
+{
+	return m_d->m_IdleTimeout;
+}
+
+int MusicBrainz5::CHTTPSessionPool::NumSessions() const
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Sessions.size();
+}
+
+void MusicBrainz5::CHTTPSessionPool::Clear()
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	while (!m_d->m_Sessions.empty())
+	{
+		ne_session_destroy(m_d->m_Sessions.back().m_Session);
+		m_d->m_Sessions.pop_back();
+	}
+}
+
+ne_session *MusicBrainz5::CHTTPSessionPool::Acquire(const std::string& Key)
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	Expire();
+
+	std::list<CHTTPSessionPoolPrivate::CEntry>::iterator ThisEntry=m_d->m_Sessions.begin();
+	while (ThisEntry!=m_d->m_Sessions.end())
+	{
+		if ((*ThisEntry).m_Key==Key)
+		{
+			ne_session *Session=(*ThisEntry).m_Session;
+			m_d->m_Sessions.erase(ThisEntry);
+
+			return Session;
+		}
+
+		++ThisEntry;
+	}
+
+	return 0;
+}
+
+void MusicBrainz5::CHTTPSessionPool::Release(const std::string& Key, ne_session *Session)
+{
+	CHTTPSessionPoolLock Lock(&m_d->m_Mutex);
+
+	m_d->m_Sessions.push_front(CHTTPSessionPoolPrivate::CEntry(Key,Session,Now()));
+
+	Expire();
+}
+
+time_t MusicBrainz5::CHTTPSessionPool::Now() const
+{
+	return time(0);
+}
+
+void MusicBrainz5::CHTTPSessionPool::Expire()
+{
+	time_t CurrentTime=Now();
+
+	//The list is ordered by last use, so expired sessions are all at the back
+
+	while (!m_d->m_Sessions.empty() &&
+			((int)m_d->m_Sessions.size()>m_d->m_MaxSessions || CurrentTime-m_d->m_Sessions.back().m_LastUsed>=m_d->m_IdleTimeout))
+	{
+		ne_session_destroy(m_d->m_Sessions.back().m_Session);
+		m_d->m_Sessions.pop_back();
+	}
+}
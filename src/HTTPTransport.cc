@@ -0,0 +1,66 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/HTTPTransport.h"
+
+#include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/HTTPSessionPool.h"
+
+class MusicBrainz5::CHTTPTransportPrivate
+{
+	public:
+		CHTTPTransportPrivate()
+		{
+		}
+
+		CHTTPSessionPool m_SessionPool;
+};
+
+MusicBrainz5::CHTTPTransport::CHTTPTransport()
+:	m_d(new CHTTPTransportPrivate)
+{
+}
+
+MusicBrainz5::CHTTPTransport::~CHTTPTransport()
+{
+	delete m_d;
+}
+
+MusicBrainz5::CFetch *MusicBrainz5::CHTTPTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	CHTTPFetch *Fetch=new CHTTPFetch(UserAgent,Host,Port);
+
+	Fetch->SetSessionPool(&m_d->m_SessionPool);
+
+	return Fetch;
+}
+
+MusicBrainz5::CHTTPSessionPool& MusicBrainz5::CHTTPTransport::SessionPool() const
+{
+	return m_d->m_SessionPool;
+}
@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/IPI.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CIPIPrivate
+class MusicBrainz5::CIPIPrivate: public CSharedPrivate
 {
 	public:
 		CIPIPrivate()
@@ -56,10 +57,9 @@ MusicBrainz5::CIPI::CIPI(const XMLNode& Node)
 }
 
 MusicBrainz5::CIPI::CIPI(const CIPI& Other)
-:	CEntity(),
-	m_d(new CIPIPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CIPI& MusicBrainz5::CIPI::operator =(const CIPI& Other)
@@ -68,15 +68,35 @@ MusicBrainz5::CIPI& MusicBrainz5::CIPI::operator =(const CIPI& Other)
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_IPI=Other.m_d->m_IPI;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CIPI::CIPI(CIPI&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CIPIPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CIPI& MusicBrainz5::CIPI::operator =(CIPI&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CIPI::~CIPI()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CIPI *MusicBrainz5::CIPI::Clone()
@@ -95,10 +115,10 @@ void MusicBrainz5::CIPI::ParseAttribute(const std::string& Name, const std::stri
 
 void MusicBrainz5::CIPI::ParseElement(const XMLNode& Node)
 {
-	std::string Name=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised IPI element: '" << Name << "'" << std::endl;
+	std::cerr << "Unrecognised IPI element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -107,7 +127,7 @@ std::string MusicBrainz5::CIPI::GetElementName()
 	return "ipi";
 }
 
-std::string MusicBrainz5::CIPI::IPI() const
+const std::string& MusicBrainz5::CIPI::IPI() const
 {
 	return m_d->m_IPI;
 }
@@ -26,9 +26,10 @@
 #include "config.h"
 
 #include "musicbrainz5/ISWC.h"
+#include "SharedPrivate.h"
 
 
-class MusicBrainz5::CISWCPrivate
+class MusicBrainz5::CISWCPrivate: public CSharedPrivate
 {
 	public:
 		CISWCPrivate()
@@ -54,35 +55,46 @@ MusicBrainz5::CISWC::CISWC(const XMLNode& Node)
 }
 
 MusicBrainz5::CISWC::CISWC(const CISWC& Other)
-:	CEntity(),
-	m_d(new CISWCPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CISWC& MusicBrainz5::CISWC::operator =(const CISWC& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ISWC=Other.m_d->m_ISWC;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CISWC::~CISWC()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CISWC::CISWC(CISWC&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CISWCPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
 
-	delete m_d;
+MusicBrainz5::CISWC& MusicBrainz5::CISWC::operator =(CISWC&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CISWC::Cleanup()
+MusicBrainz5::CISWC::~CISWC()
 {
+	m_d->Unref();
 }
 
 MusicBrainz5::CISWC *MusicBrainz5::CISWC::Clone()
@@ -101,10 +113,10 @@ void MusicBrainz5::CISWC::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CISWC::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised ISWC element: '" << NodeName << "'" << std::endl;
+	std::cerr << "Unrecognised ISWC element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -113,7 +125,7 @@ std::string MusicBrainz5::CISWC::GetElementName()
 	return "iswc";
 }
 
-std::string MusicBrainz5::CISWC::ISWC() const
+const std::string& MusicBrainz5::CISWC::ISWC() const
 {
 	return m_d->m_ISWC;
 }
@@ -29,8 +29,9 @@
 #include "musicbrainz5/ISWCList.h"
 
 #include "musicbrainz5/ISWC.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CISWCListPrivate
+class MusicBrainz5::CISWCListPrivate: public CSharedPrivate
 {
 	public:
 		CISWCListPrivate()
@@ -51,10 +52,9 @@ MusicBrainz5::CISWCList::CISWCList(const XMLNode& Node)
 }
 
 MusicBrainz5::CISWCList::CISWCList(const CISWCList& Other)
-:	CListImpl<CISWC>(),
-	m_d(new CISWCListPrivate)
+:	CListImpl<CISWC>(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CISWCList& MusicBrainz5::CISWCList::operator =(const CISWCList& Other)
@@ -62,14 +62,36 @@ MusicBrainz5::CISWCList& MusicBrainz5::CISWCList::operator =(const CISWCList& Ot
 	if (this!=&Other)
 	{
 		CListImpl<CISWC>::operator =(Other);
+
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CISWCList::CISWCList(CISWCList&& Other)
+:	CListImpl<CISWC>(std::move(Other)),
+	m_d(SharedEmpty<CISWCListPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CISWCList& MusicBrainz5::CISWCList::operator =(CISWCList&& Other)
+{
+	if (this!=&Other)
+	{
+		CListImpl<CISWC>::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CISWCList::~CISWCList()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CISWCList *MusicBrainz5::CISWCList::Clone()
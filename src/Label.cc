@@ -45,8 +45,10 @@
 #include "musicbrainz5/TagList.h"
 #include "musicbrainz5/UserTag.h"
 #include "musicbrainz5/UserTagList.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CLabelPrivate
+class MusicBrainz5::CLabelPrivate: public CSharedPrivate
 {
 	public:
 		CLabelPrivate()
@@ -63,6 +65,66 @@ class MusicBrainz5::CLabelPrivate
 		{
 		}
 
+		CLabelPrivate(const CLabelPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Type(Other.m_Type),
+			m_Name(Other.m_Name),
+			m_SortName(Other.m_SortName),
+			m_LabelCode(Other.m_LabelCode),
+			m_IPIList(0),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_Country(Other.m_Country),
+			m_Lifespan(0),
+			m_AliasList(0),
+			m_ReleaseList(0),
+			m_RelationListList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_Rating(0),
+			m_UserRating(0)
+		{
+			if (Other.m_IPIList)
+				m_IPIList=new CIPIList(*Other.m_IPIList);
+
+			if (Other.m_Lifespan)
+				m_Lifespan=new CLifespan(*Other.m_Lifespan);
+
+			if (Other.m_AliasList)
+				m_AliasList=new CAliasList(*Other.m_AliasList);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+		}
+
+		~CLabelPrivate()
+		{
+			delete m_IPIList;
+			delete m_Lifespan;
+			delete m_AliasList;
+			delete m_ReleaseList;
+			delete m_RelationListList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_Rating;
+			delete m_UserRating;
+		}
+
 		std::string m_ID;
 		std::string m_Type;
 		std::string m_Name;
@@ -93,95 +155,46 @@ MusicBrainz5::CLabel::CLabel(const XMLNode& Node)
 }
 
 MusicBrainz5::CLabel::CLabel(const CLabel& Other)
-:	CEntity(),
-	m_d(new CLabelPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CLabel& MusicBrainz5::CLabel::operator =(const CLabel& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Name=Other.m_d->m_Name;
-		m_d->m_SortName=Other.m_d->m_SortName;
-		m_d->m_LabelCode=Other.m_d->m_LabelCode;
-
-		if (Other.m_d->m_IPIList)
-			m_d->m_IPIList=new CIPIList(*Other.m_d->m_IPIList);
-
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_Country=Other.m_d->m_Country;
-
-		if (Other.m_d->m_Lifespan)
-			m_d->m_Lifespan=new CLifespan(*Other.m_d->m_Lifespan);
-
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
-
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
-
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
-
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CLabel::~CLabel()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CLabel::CLabel(CLabel&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CLabelPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CLabel::Cleanup()
+MusicBrainz5::CLabel& MusicBrainz5::CLabel::operator =(CLabel&& Other)
 {
-	delete m_d->m_IPIList;
-	m_d->m_IPIList=0;
-
-	delete m_d->m_Lifespan;
-	m_d->m_Lifespan=0;
-
-	delete m_d->m_AliasList;
-	m_d->m_AliasList=0;
-
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
-
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
-
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
-
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+MusicBrainz5::CLabel::~CLabel()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CLabel *MusicBrainz5::CLabel::Clone()
@@ -191,6 +204,8 @@ MusicBrainz5::CLabel *MusicBrainz5::CLabel::Clone()
 
 void MusicBrainz5::CLabel::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else if ("type"==Name)
@@ -205,73 +220,75 @@ void MusicBrainz5::CLabel::ParseAttribute(const std::string& Name, const std::st
 
 void MusicBrainz5::CLabel::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("sort-name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SortName);
-	}
-	else if ("label-code"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelCode);
-	}
-	else if ("ipi"==NodeName)
-	{
-		//Ignore IPI
-	}
-	else if ("ipi-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_IPIList);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("life-span"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Lifespan);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElementSortName:
+			ProcessItem(Node,m_d->m_SortName);
+			break;
+
+		case eElementLabelCode:
+			ProcessItem(Node,m_d->m_LabelCode);
+			break;
+
+		case eElementIpi:
+			//Ignore IPI
+			break;
+
+		case eElementIpiList:
+			ProcessItem(Node,m_d->m_IPIList);
+			break;
+
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElementCountry:
+			ProcessItem(Node,m_d->m_Country);
+			break;
+
+		case eElementLifeSpan:
+			ProcessItem(Node,m_d->m_Lifespan);
+			break;
+
+		case eElementAliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised label element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised label element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -280,22 +297,27 @@ std::string MusicBrainz5::CLabel::GetElementName()
 	return "label";
 }
 
-std::string MusicBrainz5::CLabel::ID() const
+const std::string& MusicBrainz5::CLabel::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CLabel::Type() const
+MusicBrainz5::CMBID MusicBrainz5::CLabel::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CLabel::Type() const
 {
 	return m_d->m_Type;
 }
 
-std::string MusicBrainz5::CLabel::Name() const
+const std::string& MusicBrainz5::CLabel::Name() const
 {
 	return m_d->m_Name;
 }
 
-std::string MusicBrainz5::CLabel::SortName() const
+const std::string& MusicBrainz5::CLabel::SortName() const
 {
 	return m_d->m_SortName;
 }
@@ -305,61 +327,124 @@ int MusicBrainz5::CLabel::LabelCode() const
 	return m_d->m_LabelCode;
 }
 
-MusicBrainz5::CIPIList *MusicBrainz5::CLabel::IPIList() const
+const MusicBrainz5::CIPIList *MusicBrainz5::CLabel::IPIList() const
 {
 	return m_d->m_IPIList;
 }
 
-std::string MusicBrainz5::CLabel::Disambiguation() const
+MusicBrainz5::CIPIList *MusicBrainz5::CLabel::IPIList()
+{
+	Unshare(m_d);
+
+	return m_d->m_IPIList;
+}
+
+const std::string& MusicBrainz5::CLabel::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-std::string MusicBrainz5::CLabel::Country() const
+const std::string& MusicBrainz5::CLabel::Country() const
 {
 	return m_d->m_Country;
 }
 
-MusicBrainz5::CLifespan *MusicBrainz5::CLabel::Lifespan() const
+const MusicBrainz5::CLifespan *MusicBrainz5::CLabel::Lifespan() const
 {
 	return m_d->m_Lifespan;
 }
 
-MusicBrainz5::CAliasList *MusicBrainz5::CLabel::AliasList() const
+MusicBrainz5::CLifespan *MusicBrainz5::CLabel::Lifespan()
+{
+	Unshare(m_d);
+
+	return m_d->m_Lifespan;
+}
+
+const MusicBrainz5::CAliasList *MusicBrainz5::CLabel::AliasList() const
 {
 	return m_d->m_AliasList;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CLabel::ReleaseList() const
+MusicBrainz5::CAliasList *MusicBrainz5::CLabel::AliasList()
+{
+	Unshare(m_d);
+
+	return m_d->m_AliasList;
+}
+
+const MusicBrainz5::CReleaseList *MusicBrainz5::CLabel::ReleaseList() const
+{
+	return m_d->m_ReleaseList;
+}
+
+MusicBrainz5::CReleaseList *MusicBrainz5::CLabel::ReleaseList()
 {
+	Unshare(m_d);
+
 	return m_d->m_ReleaseList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CLabel::RelationListList() const
+const MusicBrainz5::CRelationListList *MusicBrainz5::CLabel::RelationListList() const
 {
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CLabel::TagList() const
+MusicBrainz5::CRelationListList *MusicBrainz5::CLabel::RelationListList()
+{
+	Unshare(m_d);
+
+	return m_d->m_RelationListList;
+}
+
+const MusicBrainz5::CTagList *MusicBrainz5::CLabel::TagList() const
+{
+	return m_d->m_TagList;
+}
+
+MusicBrainz5::CTagList *MusicBrainz5::CLabel::TagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CLabel::UserTagList() const
+const MusicBrainz5::CUserTagList *MusicBrainz5::CLabel::UserTagList() const
 {
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CLabel::Rating() const
+MusicBrainz5::CUserTagList *MusicBrainz5::CLabel::UserTagList()
+{
+	Unshare(m_d);
+
+	return m_d->m_UserTagList;
+}
+
+const MusicBrainz5::CRating *MusicBrainz5::CLabel::Rating() const
+{
+	return m_d->m_Rating;
+}
+
+MusicBrainz5::CRating *MusicBrainz5::CLabel::Rating()
 {
+	Unshare(m_d);
+
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CLabel::UserRating() const
+const MusicBrainz5::CUserRating *MusicBrainz5::CLabel::UserRating() const
 {
 	return m_d->m_UserRating;
 }
 
+MusicBrainz5::CUserRating *MusicBrainz5::CLabel::UserRating()
+{
+	Unshare(m_d);
+
+	return m_d->m_UserRating;
+}
+
 std::ostream& MusicBrainz5::CLabel::Serialise(std::ostream& os) const
 {
 	os << "Label:" << std::endl;
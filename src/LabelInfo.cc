@@ -29,8 +29,10 @@
 #include "musicbrainz5/LabelInfo.h"
 
 #include "musicbrainz5/Label.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CLabelInfoPrivate
+class MusicBrainz5::CLabelInfoPrivate: public CSharedPrivate
 {
 	public:
 		CLabelInfoPrivate()
@@ -38,6 +40,20 @@ class MusicBrainz5::CLabelInfoPrivate
 		{
 		}
 
+		CLabelInfoPrivate(const CLabelInfoPrivate& Other)
+		:	CSharedPrivate(),
+			m_CatalogNumber(Other.m_CatalogNumber),
+			m_Label(0)
+		{
+			if (Other.m_Label)
+				m_Label=new CLabel(*Other.m_Label);
+		}
+
+		~CLabelInfoPrivate()
+		{
+			delete m_Label;
+		}
+
 		std::string m_CatalogNumber;
 		CLabel *m_Label;
 };
@@ -55,40 +71,46 @@ MusicBrainz5::CLabelInfo::CLabelInfo(const XMLNode& Node)
 }
 
 MusicBrainz5::CLabelInfo::CLabelInfo(const CLabelInfo& Other)
-:	CEntity(),
-	m_d(new CLabelInfoPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CLabelInfo& MusicBrainz5::CLabelInfo::operator =(const CLabelInfo& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_CatalogNumber=Other.m_d->m_CatalogNumber;
-
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CLabelInfo::~CLabelInfo()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CLabelInfo::CLabelInfo(CLabelInfo&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CLabelInfoPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
 
-	delete m_d;
+MusicBrainz5::CLabelInfo& MusicBrainz5::CLabelInfo::operator =(CLabelInfo&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CLabelInfo::Cleanup()
+MusicBrainz5::CLabelInfo::~CLabelInfo()
 {
-	delete m_d->m_Label;
-	m_d->m_Label=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CLabelInfo *MusicBrainz5::CLabelInfo::Clone()
@@ -107,21 +129,23 @@ void MusicBrainz5::CLabelInfo::ParseAttribute(const std::string& Name, const std
 
 void MusicBrainz5::CLabelInfo::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("catalog-number"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CatalogNumber);
-	}
-	else if ("label"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Label);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementCatalogNumber:
+			ProcessItem(Node,m_d->m_CatalogNumber);
+			break;
+
+		case eElementLabel:
+			ProcessItem(Node,m_d->m_Label);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised label info element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised label info element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -130,16 +154,23 @@ std::string MusicBrainz5::CLabelInfo::GetElementName()
 	return "label-info";
 }
 
-std::string MusicBrainz5::CLabelInfo::CatalogNumber() const
+const std::string& MusicBrainz5::CLabelInfo::CatalogNumber() const
 {
 	return m_d->m_CatalogNumber;
 }
 
-MusicBrainz5::CLabel *MusicBrainz5::CLabelInfo::Label() const
+const MusicBrainz5::CLabel *MusicBrainz5::CLabelInfo::Label() const
 {
 	return m_d->m_Label;
 }
 
+MusicBrainz5::CLabel *MusicBrainz5::CLabelInfo::Label()
+{
+	Unshare(m_d);
+
+	return m_d->m_Label;
+}
+
 std::ostream& MusicBrainz5::CLabelInfo::Serialise(std::ostream& os) const
 {
 	os << "Label info:" << std::endl;
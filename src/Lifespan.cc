@@ -27,8 +27,10 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Lifespan.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CLifespanPrivate
+class MusicBrainz5::CLifespanPrivate: public CSharedPrivate
 {
 	public:
 		std::string m_Begin;
@@ -49,10 +51,9 @@ MusicBrainz5::CLifespan::CLifespan(const XMLNode& Node)
 }
 
 MusicBrainz5::CLifespan::CLifespan(const CLifespan& Other)
-:	CEntity(),
-	m_d(new CLifespanPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CLifespan& MusicBrainz5::CLifespan::operator =(const CLifespan& Other)
@@ -61,17 +62,35 @@ MusicBrainz5::CLifespan& MusicBrainz5::CLifespan::operator =(const CLifespan& Ot
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Begin=Other.m_d->m_Begin;
-		m_d->m_End=Other.m_d->m_End;
-		m_d->m_Ended=Other.m_d->m_Ended;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CLifespan::CLifespan(CLifespan&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CLifespanPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CLifespan& MusicBrainz5::CLifespan::operator =(CLifespan&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CLifespan::~CLifespan()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CLifespan *MusicBrainz5::CLifespan::Clone()
@@ -90,25 +109,27 @@ void MusicBrainz5::CLifespan::ParseAttribute(const std::string& Name, const std:
 
 void MusicBrainz5::CLifespan::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("begin"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Begin);
-	}
-	else if ("end"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_End);
-	}
-	else if ("ended"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Ended);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementBegin:
+			ProcessItem(Node,m_d->m_Begin);
+			break;
+
+		case eElementEnd:
+			ProcessItem(Node,m_d->m_End);
+			break;
+
+		case eElementEnded:
+			ProcessItem(Node,m_d->m_Ended);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised lifespan element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised lifespan element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -117,17 +138,17 @@ std::string MusicBrainz5::CLifespan::GetElementName()
 	return "life-span";
 }
 
-std::string MusicBrainz5::CLifespan::Begin() const
+const std::string& MusicBrainz5::CLifespan::Begin() const
 {
 	return m_d->m_Begin;
 }
 
-std::string MusicBrainz5::CLifespan::End() const
+const std::string& MusicBrainz5::CLifespan::End() const
 {
 	return m_d->m_End;
 }
 
-std::string MusicBrainz5::CLifespan::Ended() const
+const std::string& MusicBrainz5::CLifespan::Ended() const
 {
 	return m_d->m_Ended;
 }
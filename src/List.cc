@@ -30,7 +30,9 @@
 
 #include <vector>
 
-class MusicBrainz5::CListPrivate
+#include "SharedPrivate.h"
+
+class MusicBrainz5::CListPrivate: public CSharedPrivate
 {
 public:
 	CListPrivate()
@@ -39,6 +41,29 @@ public:
 	{
 	}
 
+	CListPrivate(const CListPrivate& Other)
+	:	CSharedPrivate(),
+		m_Offset(Other.m_Offset),
+		m_Count(Other.m_Count)
+	{
+		std::vector<CEntity *>::const_iterator ThisItem=Other.m_Items.begin();
+		while (ThisItem!=Other.m_Items.end())
+		{
+			CEntity *Item=(*ThisItem);
+			m_Items.push_back(Item->Clone());
+			++ThisItem;
+		}
+	}
+
+	~CListPrivate()
+	{
+		while (!m_Items.empty())
+		{
+			delete m_Items.back();
+			m_Items.pop_back();
+		}
+	}
+
 	int m_Offset;
 	int m_Count;
 	std::vector<CEntity *> m_Items;
@@ -51,49 +76,46 @@ MusicBrainz5::CList::CList()
 }
 
 MusicBrainz5::CList::CList(const CList& Other)
-:	CEntity(),
-	m_d(new CListPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CList& MusicBrainz5::CList::operator =(const CList& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_Offset=Other.m_d->m_Offset;
-		m_d->m_Count=Other.m_d->m_Count;
-
-		std::vector<CEntity *>::const_iterator ThisItem=Other.m_d->m_Items.begin();
-		while (ThisItem!=Other.m_d->m_Items.end())
-		{
-			CEntity *Item=(*ThisItem);
-			m_d->m_Items.push_back(Item->Clone());
-			++ThisItem;
-		}
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CList::~CList()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CList::CList(CList&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CListPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CList::Cleanup()
+MusicBrainz5::CList& MusicBrainz5::CList::operator =(CList&& Other)
 {
-	while (!m_d->m_Items.empty())
+	if (this!=&Other)
 	{
-		delete m_d->m_Items.back();
-		m_d->m_Items.pop_back();
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
+
+	return *this;
+}
+#endif
+
+MusicBrainz5::CList::~CList()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CList *MusicBrainz5::CList::Clone()
@@ -103,6 +125,8 @@ MusicBrainz5::CList *MusicBrainz5::CList::Clone()
 
 void MusicBrainz5::CList::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("offset"==Name)
 		ProcessItem(Value,m_d->m_Offset);
 	else if ("count"==Name)
@@ -117,10 +141,10 @@ void MusicBrainz5::CList::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CList::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised list element: '" << NodeName << "'" << std::endl;
+	std::cerr << "Unrecognised list element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -131,6 +155,8 @@ std::string MusicBrainz5::CList::GetElementName()
 
 void MusicBrainz5::CList::AddItem(CEntity *Item)
 {
+	Detach(m_d);
+
 	m_d->m_Items.push_back(Item);
 }
 
@@ -139,7 +165,7 @@ int MusicBrainz5::CList::NumItems() const
 	return m_d->m_Items.size();
 }
 
-MusicBrainz5::CEntity *MusicBrainz5::CList::Item(int Item) const
+const MusicBrainz5::CEntity *MusicBrainz5::CList::Item(int Item) const
 {
 	CEntity *Ret=0;
 
@@ -149,6 +175,18 @@ MusicBrainz5::CEntity *MusicBrainz5::CList::Item(int Item) const
 	return Ret;
 }
 
+MusicBrainz5::CEntity *MusicBrainz5::CList::Item(int Item)
+{
+	Unshare(m_d);
+
+	CEntity *Ret=0;
+
+	if (Item<NumItems())
+		Ret=m_d->m_Items[Item];
+
+	return Ret;
+}
+
 int MusicBrainz5::CList::Offset() const
 {
 	return m_d->m_Offset;
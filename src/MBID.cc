@@ -0,0 +1,139 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/MBID.h"
+
+#include <stdint.h>
+
+//Position in the text of the first hex digit of each byte
+
+static const int BytePositions[16]={0,2,4,6,9,11,14,16,19,21,24,26,28,30,32,34};
+
+static int HexValue(unsigned char Char)
+{
+	if (Char>='0' && Char<='9')
+		return Char-'0';
+
+	Char|=0x20;
+	if (Char>='a' && Char<='f')
+		return Char-'a'+10;
+
+	return -1;
+}
+
+static bool ParseMBID(const std::string& Text, unsigned char *Bytes)
+{
+	if (Text.length()!=36 || Text[8]!='-' || Text[13]!='-' || Text[18]!='-' || Text[23]!='-')
+		return false;
+
+	for (int count=0;count<16;count++)
+	{
+		int High=HexValue(Text[BytePositions[count]]);
+		int Low=HexValue(Text[BytePositions[count]+1]);
+
+		if (High<0 || Low<0)
+			return false;
+
+		if (Bytes)
+			Bytes[count]=(unsigned char)((High<<4)|Low);
+	}
+
+	return true;
+}
+
+MusicBrainz5::CMBID::CMBID()
+{
+	memset(m_Bytes,0,sizeof(m_Bytes));
+}
+
+MusicBrainz5::CMBID::CMBID(const std::string& Text)
+{
+	if (!ParseMBID(Text,m_Bytes))
+		memset(m_Bytes,0,sizeof(m_Bytes));
+}
+
+bool MusicBrainz5::CMBID::IsValid(const std::string& Text)
+{
+	return ParseMBID(Text,0);
+}
+
+bool MusicBrainz5::CMBID::Parse(const std::string& Text)
+{
+	unsigned char Bytes[16];
+
+	if (!ParseMBID(Text,Bytes))
+		return false;
+
+	memcpy(m_Bytes,Bytes,sizeof(m_Bytes));
+
+	return true;
+}
+
+bool MusicBrainz5::CMBID::IsNil() const
+{
+	static const unsigned char Nil[16]={0};
+
+	return 0==memcmp(m_Bytes,Nil,sizeof(m_Bytes));
+}
+
+std::string MusicBrainz5::CMBID::ToString() const
+{
+	static const char Digits[]="0123456789abcdef";
+
+	std::string Ret("00000000-0000-0000-0000-000000000000");
+
+	for (int count=0;count<16;count++)
+	{
+		Ret[BytePositions[count]]=Digits[m_Bytes[count]>>4];
+		Ret[BytePositions[count]+1]=Digits[m_Bytes[count]&0x0f];
+	}
+
+	return Ret;
+}
+
+size_t MusicBrainz5::CMBID::Hash() const
+{
+	//Most of the bits of an ID are random already, so it is enough to mix the two
+	//halves together
+
+	uint64_t High;
+	uint64_t Low;
+
+	memcpy(&High,m_Bytes,sizeof(High));
+	memcpy(&Low,m_Bytes+sizeof(High),sizeof(Low));
+
+	uint64_t Hash=High^(Low*0x9e3779b97f4a7c15ULL);
+	Hash^=Hash>>32;
+
+	return (size_t)Hash;
+}
+
+std::ostream& operator << (std::ostream& os, const MusicBrainz5::CMBID& MBID)
+{
+	return os << MBID.ToString();
+}
@@ -32,20 +32,45 @@
 #include "musicbrainz5/DiscList.h"
 #include "musicbrainz5/Track.h"
 #include "musicbrainz5/TrackList.h"
+#include "ElementTables.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CMediumPrivate
+class MusicBrainz5::CMediumPrivate: public CSharedPrivate
 {
 	public:
 		CMediumPrivate()
 		:	m_Position(0),
+			m_Format(&CStringPool::Empty()),
 			m_DiscList(0),
 			m_TrackList(0)
 		{
 		}
 
+		CMediumPrivate(const CMediumPrivate& Other)
+		:	CSharedPrivate(),
+			m_Title(Other.m_Title),
+			m_Position(Other.m_Position),
+			m_Format(Other.m_Format),
+			m_DiscList(0),
+			m_TrackList(0)
+		{
+			if (Other.m_DiscList)
+				m_DiscList=new CDiscList(*Other.m_DiscList);
+
+			if (Other.m_TrackList)
+				m_TrackList=new CTrackList(*Other.m_TrackList);
+		}
+
+		~CMediumPrivate()
+		{
+			delete m_DiscList;
+			delete m_TrackList;
+		}
+
 		std::string m_Title;
 		int m_Position;
-		std::string m_Format;
+		const std::string *m_Format;
 		CDiscList *m_DiscList;
 		CTrackList *m_TrackList;
 };
@@ -63,48 +88,46 @@ MusicBrainz5::CMedium::CMedium(const XMLNode& Node)
 }
 
 MusicBrainz5::CMedium::CMedium(const CMedium& Other)
-:	CEntity(),
-	m_d(new CMediumPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CMedium& MusicBrainz5::CMedium::operator =(const CMedium& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Format=Other.m_d->m_Format;
-
-		if (Other.m_d->m_DiscList)
-			m_d->m_DiscList=new CDiscList(*Other.m_d->m_DiscList);
-
-		if (Other.m_d->m_TrackList)
-			m_d->m_TrackList=new CTrackList(*Other.m_d->m_TrackList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CMedium::~CMedium()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CMedium::CMedium(CMedium&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CMediumPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CMedium::Cleanup()
+MusicBrainz5::CMedium& MusicBrainz5::CMedium::operator =(CMedium&& Other)
 {
-	delete m_d->m_DiscList;
-	m_d->m_DiscList=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_TrackList;
-	m_d->m_TrackList=0;
+	return *this;
+}
+#endif
+
+MusicBrainz5::CMedium::~CMedium()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CMedium *MusicBrainz5::CMedium::Clone()
@@ -123,33 +146,35 @@ void MusicBrainz5::CMedium::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CMedium::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("position"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Position);
-	}
-	else if ("format"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Format);
-	}
-	else if ("disc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_DiscList);
-	}
-	else if ("track-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TrackList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementPosition:
+			ProcessItem(Node,m_d->m_Position);
+			break;
+
+		case eElementFormat:
+			InternItem(Node,m_d->m_Format);
+			break;
+
+		case eElementDiscList:
+			ProcessItem(Node,m_d->m_DiscList);
+			break;
+
+		case eElementTrackList:
+			ProcessItem(Node,m_d->m_TrackList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised medium element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised medium element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -158,7 +183,7 @@ std::string MusicBrainz5::CMedium::GetElementName()
 	return "medium";
 }
 
-std::string MusicBrainz5::CMedium::Title() const
+const std::string& MusicBrainz5::CMedium::Title() const
 {
 	return m_d->m_Title;
 }
@@ -168,18 +193,32 @@ int MusicBrainz5::CMedium::Position() const
 	return m_d->m_Position;
 }
 
-std::string MusicBrainz5::CMedium::Format() const
+const std::string& MusicBrainz5::CMedium::Format() const
+{
+	return *m_d->m_Format;
+}
+
+const MusicBrainz5::CDiscList *MusicBrainz5::CMedium::DiscList() const
 {
-	return m_d->m_Format;
+	return m_d->m_DiscList;
 }
 
-MusicBrainz5::CDiscList *MusicBrainz5::CMedium::DiscList() const
+MusicBrainz5::CDiscList *MusicBrainz5::CMedium::DiscList()
 {
+	Unshare(m_d);
+
 	return m_d->m_DiscList;
 }
 
-MusicBrainz5::CTrackList *MusicBrainz5::CMedium::TrackList() const
+const MusicBrainz5::CTrackList *MusicBrainz5::CMedium::TrackList() const
+{
+	return m_d->m_TrackList;
+}
+
+MusicBrainz5::CTrackList *MusicBrainz5::CMedium::TrackList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TrackList;
 }
 
@@ -191,7 +230,7 @@ bool MusicBrainz5::CMedium::ContainsDiscID(const std::string& DiscID) const
 	{
 		for (int count=0;!RetVal && count<m_d->m_DiscList->NumItems();count++)
 		{
-			CDisc *Disc=m_d->m_DiscList->Item(count);
+			const CDisc *Disc=m_d->m_DiscList->Item(count);
 
 			if (Disc->ID()==DiscID)
 				RetVal=true;
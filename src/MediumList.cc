@@ -29,8 +29,10 @@
 #include "musicbrainz5/MediumList.h"
 
 #include "musicbrainz5/Medium.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CMediumListPrivate
+class MusicBrainz5::CMediumListPrivate: public CSharedPrivate
 {
 	public:
 		CMediumListPrivate()
@@ -54,10 +56,9 @@ MusicBrainz5::CMediumList::CMediumList(const XMLNode& Node)
 }
 
 MusicBrainz5::CMediumList::CMediumList(const CMediumList& Other)
-:	CListImpl<CMedium>(),
-	m_d(new CMediumListPrivate)
+:	CListImpl<CMedium>(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CMediumList& MusicBrainz5::CMediumList::operator =(const CMediumList& Other)
@@ -66,15 +67,35 @@ MusicBrainz5::CMediumList& MusicBrainz5::CMediumList::operator =(const CMediumLi
 	{
 		CListImpl<CMedium>::operator =(Other);
 
-		m_d->m_TrackCount=Other.m_d->m_TrackCount;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CMediumList::CMediumList(CMediumList&& Other)
+:	CListImpl<CMedium>(std::move(Other)),
+	m_d(SharedEmpty<CMediumListPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CMediumList& MusicBrainz5::CMediumList::operator =(CMediumList&& Other)
+{
+	if (this!=&Other)
+	{
+		CListImpl<CMedium>::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CMediumList::~CMediumList()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CMediumList *MusicBrainz5::CMediumList::Clone()
@@ -89,15 +110,17 @@ void MusicBrainz5::CMediumList::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CMediumList::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("track-count"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TrackCount);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
-		CListImpl<CMedium>::ParseElement(Node);
+		case eElementTrackCount:
+			ProcessItem(Node,m_d->m_TrackCount);
+			break;
+
+		default:
+			CListImpl<CMedium>::ParseElement(Node);
+			break;
 	}
 }
 
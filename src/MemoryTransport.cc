@@ -0,0 +1,221 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/MemoryTransport.h"
+
+#include <deque>
+#include <map>
+#include <fstream>
+#include <sstream>
+
+#include <pthread.h>
+
+namespace MusicBrainz5
+{
+	class CMemoryFetch: public CFetch
+	{
+	public:
+		CMemoryFetch(CMemoryTransport *Transport, const std::string& UserAgent, const std::string& Host, int Port)
+		:	CFetch(UserAgent,Host,Port),
+			m_Transport(Transport)
+		{
+		}
+
+		int Fetch(const std::string& URL, const std::string& Request)
+		{
+			Reset();
+
+			std::string Body;
+			int Status=404;
+			std::map<std::string,std::string> Headers;
+
+			if (!m_Transport->Response(URL,Request,Body,Status,Headers))
+			{
+				if (Request=="GET")
+					SetErrorMessage("No response available for '" + URL + "'");
+				else
+					Status=200;
+			}
+
+			SetStatus(Status);
+
+			for (std::map<std::string,std::string>::const_iterator ThisHeader=Headers.begin();ThisHeader!=Headers.end();++ThisHeader)
+				AddResponseHeader((*ThisHeader).first,(*ThisHeader).second);
+
+			if (Status>=200 && Status<300)
+				AddData(Body.c_str(),Body.length());
+
+			CheckStatus();
+
+			return DataSize();
+		}
+
+	private:
+		CMemoryTransport *m_Transport;
+	};
+}
+
+class CMemoryResponse
+{
+	public:
+		int m_Status;
+		std::string m_Body;
+		std::map<std::string,std::string> m_Headers;
+};
+
+class MusicBrainz5::CMemoryTransportPrivate
+{
+	public:
+		CMemoryTransportPrivate()
+		:	m_NumRequests(0)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CMemoryTransportPrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		pthread_mutex_t m_Mutex;
+		std::string m_Directory;
+		std::map<std::string,std::pair<int,std::string> > m_Responses;
+		std::map<std::string,std::deque<CMemoryResponse> > m_Queued;
+		int m_NumRequests;
+};
+
+MusicBrainz5::CMemoryTransport::CMemoryTransport(const std::string& Directory)
+:	m_d(new CMemoryTransportPrivate)
+{
+	m_d->m_Directory=Directory;
+}
+
+MusicBrainz5::CMemoryTransport::~CMemoryTransport()
+{
+	delete m_d;
+}
+
+MusicBrainz5::CFetch *MusicBrainz5::CMemoryTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CMemoryFetch(this,UserAgent,Host,Port);
+}
+
+void MusicBrainz5::CMemoryTransport::AddResponse(const std::string& URL, const std::string& Body, int Status)
+{
+	pthread_mutex_lock(&m_d->m_Mutex);
+	m_d->m_Responses[URL]=std::make_pair(Status,Body);
+	pthread_mutex_unlock(&m_d->m_Mutex);
+}
+
+void MusicBrainz5::CMemoryTransport::QueueResponse(const std::string& URL, const std::string& Body, int Status, const std::map<std::string,std::string>& Headers)
+{
+	CMemoryResponse Response;
+	Response.m_Status=Status;
+	Response.m_Body=Body;
+	Response.m_Headers=Headers;
+
+	pthread_mutex_lock(&m_d->m_Mutex);
+	m_d->m_Queued[URL].push_back(Response);
+	pthread_mutex_unlock(&m_d->m_Mutex);
+}
+
+int MusicBrainz5::CMemoryTransport::NumRequests() const
+{
+	return m_d->m_NumRequests;
+}
+
+std::string MusicBrainz5::CMemoryTransport::FileName(const std::string& URL)
+{
+	std::string Name=URL;
+
+	const std::string Prefix="/ws/2/";
+	if (Prefix==Name.substr(0,Prefix.length()))
+		Name=Name.substr(Prefix.length());
+
+	for (std::string::size_type Pos=0;Pos<Name.length();Pos++)
+		if (Name[Pos]=='/' || Name[Pos]=='?' || Name[Pos]=='&')
+			Name[Pos]='_';
+
+	return Name+".xml";
+}
+
+bool MusicBrainz5::CMemoryTransport::Response(const std::string& URL, const std::string& Request, std::string& Body, int& Status, std::map<std::string,std::string>& Headers)
+{
+	//Edits are only answered by queued responses, and aren't counted
+
+	bool Get=Request=="GET";
+	if (Get)
+		__sync_fetch_and_add(&m_d->m_NumRequests,1);
+
+	//Requests may be made from several threads while responses are being added
+
+	pthread_mutex_lock(&m_d->m_Mutex);
+
+	bool Found=false;
+	std::map<std::string,std::pair<int,std::string> >::const_iterator ThisResponse=m_d->m_Responses.find(URL);
+	std::map<std::string,std::deque<CMemoryResponse> >::iterator Queued=m_d->m_Queued.find(URL);
+	if (Queued!=m_d->m_Queued.end() && !(*Queued).second.empty())
+	{
+		const CMemoryResponse& Response=(*Queued).second.front();
+		Status=Response.m_Status;
+		Body=Response.m_Body;
+		Headers=Response.m_Headers;
+		Found=true;
+
+		(*Queued).second.pop_front();
+	}
+	else if (Get && ThisResponse!=m_d->m_Responses.end())
+	{
+		Status=(*ThisResponse).second.first;
+		Body=(*ThisResponse).second.second;
+		Found=true;
+	}
+
+	pthread_mutex_unlock(&m_d->m_Mutex);
+
+	if (Found || !Get)
+		return Found;
+
+	if (!m_d->m_Directory.empty())
+	{
+		std::string Path=m_d->m_Directory+"/"+FileName(URL);
+		std::ifstream File(Path.c_str(),std::ios::in | std::ios::binary);
+		if (File.is_open())
+		{
+			std::stringstream os;
+			os << File.rdbuf();
+
+			Status=200;
+			Body=os.str();
+
+			return true;
+		}
+	}
+
+	return false;
+}
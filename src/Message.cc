@@ -27,10 +27,12 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Message.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CMessagePrivate
+class MusicBrainz5::CMessagePrivate: public CSharedPrivate
 {
-public:
+	public:
 		std::string m_Text;
 };
 
@@ -47,10 +49,9 @@ MusicBrainz5::CMessage::CMessage(const XMLNode& Node)
 }
 
 MusicBrainz5::CMessage::CMessage(const CMessage& Other)
-:	CEntity(),
-	m_d(new CMessagePrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CMessage& MusicBrainz5::CMessage::operator =(const CMessage& Other)
@@ -59,15 +60,35 @@ MusicBrainz5::CMessage& MusicBrainz5::CMessage::operator =(const CMessage& Other
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Text=Other.m_d->m_Text;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CMessage::CMessage(CMessage&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CMessagePrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CMessage& MusicBrainz5::CMessage::operator =(CMessage&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CMessage::~CMessage()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CMessage *MusicBrainz5::CMessage::Clone()
@@ -86,15 +107,19 @@ void MusicBrainz5::CMessage::ParseAttribute(const std::string& Name, const std::
 
 void MusicBrainz5::CMessage::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if (NodeName=="text")
-		ProcessItem(Node,m_d->m_Text);
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementText:
+			ProcessItem(Node,m_d->m_Text);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised message element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised message element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -103,7 +128,7 @@ std::string MusicBrainz5::CMessage::GetElementName()
 	return "message";
 }
 
-std::string MusicBrainz5::CMessage::Text() const
+const std::string& MusicBrainz5::CMessage::Text() const
 {
 	return m_d->m_Text;
 }
@@ -61,8 +61,10 @@
 #include "musicbrainz5/LabelInfo.h"
 #include "musicbrainz5/LabelInfoList.h"
 #include "musicbrainz5/Message.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CMetadataPrivate
+class MusicBrainz5::CMetadataPrivate: public CSharedPrivate
 {
 	public:
 		CMetadataPrivate()
@@ -97,6 +99,158 @@ class MusicBrainz5::CMetadataPrivate
 		{
 		}
 
+		CMetadataPrivate(const CMetadataPrivate& Other)
+		:	CSharedPrivate(),
+			m_XMLNS(Other.m_XMLNS),
+			m_XMLNSExt(Other.m_XMLNSExt),
+			m_Generator(Other.m_Generator),
+			m_Created(Other.m_Created),
+			m_Artist(0),
+			m_Release(0),
+			m_ReleaseGroup(0),
+			m_Recording(0),
+			m_Label(0),
+			m_Work(0),
+			m_PUID(0),
+			m_ISRC(0),
+			m_Disc(0),
+			m_LabelInfoList(0),
+			m_Rating(0),
+			m_UserRating(0),
+			m_Collection(0),
+			m_ArtistList(0),
+			m_ReleaseList(0),
+			m_ReleaseGroupList(0),
+			m_RecordingList(0),
+			m_LabelList(0),
+			m_WorkList(0),
+			m_ISRCList(0),
+			m_AnnotationList(0),
+			m_CDStubList(0),
+			m_FreeDBDiscList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_CollectionList(0),
+			m_CDStub(0),
+			m_Message(0)
+		{
+			if (Other.m_Artist)
+				m_Artist=new CArtist(*Other.m_Artist);
+
+			if (Other.m_Release)
+				m_Release=new CRelease(*Other.m_Release);
+
+			if (Other.m_ReleaseGroup)
+				m_ReleaseGroup=new CReleaseGroup(*Other.m_ReleaseGroup);
+
+			if (Other.m_Recording)
+				m_Recording=new CRecording(*Other.m_Recording);
+
+			if (Other.m_Label)
+				m_Label=new CLabel(*Other.m_Label);
+
+			if (Other.m_Work)
+				m_Work=new CWork(*Other.m_Work);
+
+			if (Other.m_PUID)
+				m_PUID=new CPUID(*Other.m_PUID);
+
+			if (Other.m_ISRC)
+				m_ISRC=new CISRC(*Other.m_ISRC);
+
+			if (Other.m_Disc)
+				m_Disc=new CDisc(*Other.m_Disc);
+
+			if (Other.m_LabelInfoList)
+				m_LabelInfoList=new CLabelInfoList(*Other.m_LabelInfoList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+
+			if (Other.m_Collection)
+				m_Collection=new CCollection(*Other.m_Collection);
+
+			if (Other.m_ArtistList)
+				m_ArtistList=new CArtistList(*Other.m_ArtistList);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+
+			if (Other.m_ReleaseGroupList)
+				m_ReleaseGroupList=new CReleaseGroupList(*Other.m_ReleaseGroupList);
+
+			if (Other.m_RecordingList)
+				m_RecordingList=new CRecordingList(*Other.m_RecordingList);
+
+			if (Other.m_LabelList)
+				m_LabelList=new CLabelList(*Other.m_LabelList);
+
+			if (Other.m_WorkList)
+				m_WorkList=new CWorkList(*Other.m_WorkList);
+
+			if (Other.m_ISRCList)
+				m_ISRCList=new CISRCList(*Other.m_ISRCList);
+
+			if (Other.m_AnnotationList)
+				m_AnnotationList=new CAnnotationList(*Other.m_AnnotationList);
+
+			if (Other.m_CDStubList)
+				m_CDStubList=new CCDStubList(*Other.m_CDStubList);
+
+			if (Other.m_FreeDBDiscList)
+				m_FreeDBDiscList=new CFreeDBDiscList(*Other.m_FreeDBDiscList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_CollectionList)
+				m_CollectionList=new CCollectionList(*Other.m_CollectionList);
+
+			if (Other.m_CDStub)
+				m_CDStub=new CCDStub(*Other.m_CDStub);
+
+			if (Other.m_Message)
+				m_Message=new CMessage(*Other.m_Message);
+		}
+
+		~CMetadataPrivate()
+		{
+			delete m_Artist;
+			delete m_Release;
+			delete m_ReleaseGroup;
+			delete m_Recording;
+			delete m_Label;
+			delete m_Work;
+			delete m_PUID;
+			delete m_ISRC;
+			delete m_Disc;
+			delete m_LabelInfoList;
+			delete m_Rating;
+			delete m_UserRating;
+			delete m_Collection;
+			delete m_ArtistList;
+			delete m_ReleaseList;
+			delete m_ReleaseGroupList;
+			delete m_RecordingList;
+			delete m_LabelList;
+			delete m_WorkList;
+			delete m_ISRCList;
+			delete m_AnnotationList;
+			delete m_CDStubList;
+			delete m_FreeDBDiscList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_CollectionList;
+			delete m_CDStub;
+			delete m_Message;
+		}
+
 		std::string m_XMLNS;
 		std::string m_XMLNSExt;
 		std::string m_Generator;
@@ -144,347 +298,192 @@ MusicBrainz5::CMetadata::CMetadata(const XMLNode& Node)
 }
 
 MusicBrainz5::CMetadata::CMetadata(const CMetadata& Other)
-:	CEntity(),
-	m_d(new CMetadataPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CMetadata& MusicBrainz5::CMetadata::operator =(const CMetadata& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_XMLNS=Other.m_d->m_XMLNS;
-		m_d->m_XMLNSExt=Other.m_d->m_XMLNSExt;
-		m_d->m_Generator=Other.m_d->m_Generator;
-		m_d->m_Created=Other.m_d->m_Created;
-
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
-
-		if (Other.m_d->m_Release)
-			m_d->m_Release=new CRelease(*Other.m_d->m_Release);
-
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
-
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
-
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
-
-		if (Other.m_d->m_Work)
-			m_d->m_Work=new CWork(*Other.m_d->m_Work);
-
-		if (Other.m_d->m_PUID)
-			m_d->m_PUID=new CPUID(*Other.m_d->m_PUID);
-
-		if (Other.m_d->m_ISRC)
-			m_d->m_ISRC=new CISRC(*Other.m_d->m_ISRC);
-
-		if (Other.m_d->m_Disc)
-			m_d->m_Disc=new CDisc(*Other.m_d->m_Disc);
-
-		if (Other.m_d->m_LabelInfoList)
-			m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
-
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
-
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
-
-		if (Other.m_d->m_Collection)
-			m_d->m_Collection=new CCollection(*Other.m_d->m_Collection);
-
-		if (Other.m_d->m_ArtistList)
-			m_d->m_ArtistList=new CArtistList(*Other.m_d->m_ArtistList);
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
-
-		if (Other.m_d->m_ReleaseGroupList)
-			m_d->m_ReleaseGroupList=new CReleaseGroupList(*Other.m_d->m_ReleaseGroupList);
-
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
-
-		if (Other.m_d->m_LabelList)
-			m_d->m_LabelList=new CLabelList(*Other.m_d->m_LabelList);
-
-		if (Other.m_d->m_WorkList)
-			m_d->m_WorkList=new CWorkList(*Other.m_d->m_WorkList);
-
-		if (Other.m_d->m_ISRCList)
-			m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
-
-		if (Other.m_d->m_AnnotationList)
-			m_d->m_AnnotationList=new CAnnotationList(*Other.m_d->m_AnnotationList);
-
-		if (Other.m_d->m_CDStubList)
-			m_d->m_CDStubList=new CCDStubList(*Other.m_d->m_CDStubList);
-
-		if (Other.m_d->m_FreeDBDiscList)
-			m_d->m_FreeDBDiscList=new CFreeDBDiscList(*Other.m_d->m_FreeDBDiscList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
-
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+		Assign(m_d,Other.m_d);
+	}
 
-		if (Other.m_d->m_CollectionList)
-			m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
+	return *this;
+}
 
-		if (Other.m_d->m_CDStub)
-			m_d->m_CDStub=new CCDStub(*Other.m_d->m_CDStub);
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CMetadata::CMetadata(CMetadata&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CMetadataPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
 
-		if (Other.m_d->m_Message)
-			m_d->m_Message=new CMessage(*Other.m_d->m_Message);
+MusicBrainz5::CMetadata& MusicBrainz5::CMetadata::operator =(CMetadata&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CMetadata::~CMetadata()
 {
-	Cleanup();
+	m_d->Unref();
+}
 
-	delete m_d;
+MusicBrainz5::CMetadata *MusicBrainz5::CMetadata::Clone()
+{
+	return new CMetadata(*this);
 }
 
-void MusicBrainz5::CMetadata::Cleanup()
+void MusicBrainz5::CMetadata::ParseAttribute(const std::string& Name, const std::string& Value)
 {
-	delete m_d->m_Artist;
-	m_d->m_Artist=0;
+	Detach(m_d);
 
-	delete m_d->m_Release;
-	m_d->m_Release=0;
+	if ("xmlns"==Name)
+		m_d->m_XMLNS=Value;
+	else if ("xmlns:ext"==Name)
+		m_d->m_XMLNSExt=Value;
+	else if ("generator"==Name)
+		m_d->m_Generator=Value;
+	else if ("created"==Name)
+		m_d->m_Created=Value;
+	else
+	{
+#ifdef _MB5_DEBUG_
+		std::cerr << "Unrecognised metadata attribute: '" << Name << "'" << std::endl;
+#endif
+	}
+}
 
-	delete m_d->m_ReleaseGroup;
-	m_d->m_ReleaseGroup=0;
+void MusicBrainz5::CMetadata::ParseElement(const XMLNode& Node)
+{
+	Detach(m_d);
 
-	delete m_d->m_Recording;
-	m_d->m_Recording=0;
+	switch (ElementID(Node.getName()))
+	{
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
 
-	delete m_d->m_Label;
-	m_d->m_Label=0;
+		case eElementRelease:
+			ProcessItem(Node,m_d->m_Release);
+			break;
 
-	delete m_d->m_Work;
-	m_d->m_Work=0;
+		case eElementReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
 
-	delete m_d->m_PUID;
-	m_d->m_PUID=0;
+		case eElementRecording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
 
-	delete m_d->m_ISRC;
-	m_d->m_ISRC=0;
+		case eElementLabel:
+			ProcessItem(Node,m_d->m_Label);
+			break;
 
-	delete m_d->m_Disc;
-	m_d->m_Disc=0;
+		case eElementWork:
+			ProcessItem(Node,m_d->m_Work);
+			break;
 
-	delete m_d->m_LabelInfoList;
-	m_d->m_LabelInfoList=0;
+		case eElementPuid:
+			ProcessItem(Node,m_d->m_PUID);
+			break;
 
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+		case eElementIsrc:
+			ProcessItem(Node,m_d->m_ISRC);
+			break;
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+		case eElementDisc:
+			ProcessItem(Node,m_d->m_Disc);
+			break;
 
-	delete m_d->m_Collection;
-	m_d->m_Collection=0;
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
 
-	delete m_d->m_ArtistList;
-	m_d->m_ArtistList=0;
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
 
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
+		case eElementCollection:
+			ProcessItem(Node,m_d->m_Collection);
+			break;
 
-	delete m_d->m_ReleaseGroupList;
-	m_d->m_ReleaseGroupList=0;
+		case eElementArtistList:
+			ProcessItem(Node,m_d->m_ArtistList);
+			break;
 
-	delete m_d->m_RecordingList;
-	m_d->m_RecordingList=0;
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
 
-	delete m_d->m_LabelList;
-	m_d->m_LabelList=0;
+		case eElementReleaseGroupList:
+			ProcessItem(Node,m_d->m_ReleaseGroupList);
+			break;
 
-	delete m_d->m_WorkList;
-	m_d->m_WorkList=0;
+		case eElementRecordingList:
+			ProcessItem(Node,m_d->m_RecordingList);
+			break;
 
-	delete m_d->m_ISRCList;
-	m_d->m_ISRCList=0;
+		case eElementLabelList:
+			ProcessItem(Node,m_d->m_LabelList);
+			break;
 
-	delete m_d->m_AnnotationList;
-	m_d->m_AnnotationList=0;
+		case eElementWorkList:
+			ProcessItem(Node,m_d->m_WorkList);
+			break;
 
-	delete m_d->m_CDStubList;
-	m_d->m_CDStubList=0;
+		case eElementIsrcList:
+			ProcessItem(Node,m_d->m_ISRCList);
+			break;
 
-	delete m_d->m_FreeDBDiscList;
-	m_d->m_FreeDBDiscList=0;
+		case eElementAnnotationList:
+			ProcessItem(Node,m_d->m_AnnotationList);
+			break;
 
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
+		case eElementCdstubList:
+			ProcessItem(Node,m_d->m_CDStubList);
+			break;
 
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
+		case eElementFreedbDiscList:
+			ProcessItem(Node,m_d->m_FreeDBDiscList);
+			break;
 
-	delete m_d->m_CollectionList;
-	m_d->m_CollectionList=0;
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
 
-	delete m_d->m_CDStub;
-	m_d->m_CDStub=0;
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
 
-	delete m_d->m_Message;
-	m_d->m_Message=0;
-}
+		case eElementCollectionList:
+			ProcessItem(Node,m_d->m_CollectionList);
+			break;
 
-MusicBrainz5::CMetadata *MusicBrainz5::CMetadata::Clone()
-{
-	return new CMetadata(*this);
-}
+		case eElementCdstub:
+			ProcessItem(Node,m_d->m_CDStub);
+			break;
 
-void MusicBrainz5::CMetadata::ParseAttribute(const std::string& Name, const std::string& Value)
-{
-	if ("xmlns"==Name)
-		m_d->m_XMLNS=Value;
-	else if ("xmlns:ext"==Name)
-		m_d->m_XMLNSExt=Value;
-	else if ("generator"==Name)
-		m_d->m_Generator=Value;
-	else if ("created"==Name)
-		m_d->m_Created=Value;
-	else
-	{
-#ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised metadata attribute: '" << Name << "'" << std::endl;
-#endif
-	}
-}
-
-void MusicBrainz5::CMetadata::ParseElement(const XMLNode& Node)
-{
-	std::string NodeName=Node.getName();
+		case eElementMessage:
+			ProcessItem(Node,m_d->m_Message);
+			break;
 
-	if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("release"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Release);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("label"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Label);
-	}
-	else if ("work"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Work);
-	}
-	else if ("puid"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PUID);
-	}
-	else if ("isrc"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRC);
-	}
-	else if ("disc"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disc);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("collection"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Collection);
-	}
-	else if ("artist-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistList);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("release-group-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroupList);
-	}
-	else if ("recording-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_RecordingList);
-	}
-	else if ("label-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelList);
-	}
-	else if ("work-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_WorkList);
-	}
-	else if ("isrc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRCList);
-	}
-	else if ("annotation-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AnnotationList);
-	}
-	else if ("cdstub-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CDStubList);
-	}
-	else if ("freedb-disc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_FreeDBDiscList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("collection-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CollectionList);
-	}
-	else if ("cdstub"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CDStub);
-	}
-	else if ("message"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Message);
-	}
-	else
-	{
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised metadata element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised metadata element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -493,163 +492,359 @@ std::string MusicBrainz5::CMetadata::GetElementName()
 	return "metadata";
 }
 
-std::string MusicBrainz5::CMetadata::XMLNS() const
+const std::string& MusicBrainz5::CMetadata::XMLNS() const
 {
 	return m_d->m_XMLNS;
 }
 
-std::string MusicBrainz5::CMetadata::XMLNSExt() const
+const std::string& MusicBrainz5::CMetadata::XMLNSExt() const
 {
 	return m_d->m_XMLNSExt;
 }
 
-std::string MusicBrainz5::CMetadata::Generator() const
+const std::string& MusicBrainz5::CMetadata::Generator() const
 {
 	return m_d->m_Generator;
 }
 
-std::string MusicBrainz5::CMetadata::Created() const
+const std::string& MusicBrainz5::CMetadata::Created() const
 {
 	return m_d->m_Created;
 }
 
-MusicBrainz5::CArtist *MusicBrainz5::CMetadata::Artist() const
+const MusicBrainz5::CArtist *MusicBrainz5::CMetadata::Artist() const
 {
 	return m_d->m_Artist;
 }
 
-MusicBrainz5::CRelease *MusicBrainz5::CMetadata::Release() const
+MusicBrainz5::CArtist *MusicBrainz5::CMetadata::Artist()
 {
+	Unshare(m_d);
+
+	return m_d->m_Artist;
+}
+
+const MusicBrainz5::CRelease *MusicBrainz5::CMetadata::Release() const
+{
+	return m_d->m_Release;
+}
+
+MusicBrainz5::CRelease *MusicBrainz5::CMetadata::Release()
+{
+	Unshare(m_d);
+
 	return m_d->m_Release;
 }
 
-MusicBrainz5::CReleaseGroup *MusicBrainz5::CMetadata::ReleaseGroup() const
+const MusicBrainz5::CReleaseGroup *MusicBrainz5::CMetadata::ReleaseGroup() const
 {
 	return m_d->m_ReleaseGroup;
 }
 
-MusicBrainz5::CRecording *MusicBrainz5::CMetadata::Recording() const
+MusicBrainz5::CReleaseGroup *MusicBrainz5::CMetadata::ReleaseGroup()
+{
+	Unshare(m_d);
+
+	return m_d->m_ReleaseGroup;
+}
+
+const MusicBrainz5::CRecording *MusicBrainz5::CMetadata::Recording() const
 {
 	return m_d->m_Recording;
 }
 
-MusicBrainz5::CLabel *MusicBrainz5::CMetadata::Label() const
+MusicBrainz5::CRecording *MusicBrainz5::CMetadata::Recording()
+{
+	Unshare(m_d);
+
+	return m_d->m_Recording;
+}
+
+const MusicBrainz5::CLabel *MusicBrainz5::CMetadata::Label() const
 {
 	return m_d->m_Label;
 }
 
-MusicBrainz5::CWork *MusicBrainz5::CMetadata::Work() const
+MusicBrainz5::CLabel *MusicBrainz5::CMetadata::Label()
 {
+	Unshare(m_d);
+
+	return m_d->m_Label;
+}
+
+const MusicBrainz5::CWork *MusicBrainz5::CMetadata::Work() const
+{
+	return m_d->m_Work;
+}
+
+MusicBrainz5::CWork *MusicBrainz5::CMetadata::Work()
+{
+	Unshare(m_d);
+
 	return m_d->m_Work;
 }
 
-MusicBrainz5::CPUID *MusicBrainz5::CMetadata::PUID() const
+const MusicBrainz5::CPUID *MusicBrainz5::CMetadata::PUID() const
+{
+	return m_d->m_PUID;
+}
+
+MusicBrainz5::CPUID *MusicBrainz5::CMetadata::PUID()
 {
+	Unshare(m_d);
+
 	return m_d->m_PUID;
 }
 
-MusicBrainz5::CISRC *MusicBrainz5::CMetadata::ISRC() const
+const MusicBrainz5::CISRC *MusicBrainz5::CMetadata::ISRC() const
+{
+	return m_d->m_ISRC;
+}
+
+MusicBrainz5::CISRC *MusicBrainz5::CMetadata::ISRC()
 {
+	Unshare(m_d);
+
 	return m_d->m_ISRC;
 }
 
-MusicBrainz5::CDisc *MusicBrainz5::CMetadata::Disc() const
+const MusicBrainz5::CDisc *MusicBrainz5::CMetadata::Disc() const
 {
 	return m_d->m_Disc;
 }
 
-MusicBrainz5::CLabelInfoList *MusicBrainz5::CMetadata::LabelInfoList() const
+MusicBrainz5::CDisc *MusicBrainz5::CMetadata::Disc()
+{
+	Unshare(m_d);
+
+	return m_d->m_Disc;
+}
+
+const MusicBrainz5::CLabelInfoList *MusicBrainz5::CMetadata::LabelInfoList() const
 {
 	return m_d->m_LabelInfoList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CMetadata::Rating() const
+MusicBrainz5::CLabelInfoList *MusicBrainz5::CMetadata::LabelInfoList()
 {
+	Unshare(m_d);
+
+	return m_d->m_LabelInfoList;
+}
+
+const MusicBrainz5::CRating *MusicBrainz5::CMetadata::Rating() const
+{
+	return m_d->m_Rating;
+}
+
+MusicBrainz5::CRating *MusicBrainz5::CMetadata::Rating()
+{
+	Unshare(m_d);
+
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CMetadata::UserRating() const
+const MusicBrainz5::CUserRating *MusicBrainz5::CMetadata::UserRating() const
 {
 	return m_d->m_UserRating;
 }
 
-MusicBrainz5::CCollection *MusicBrainz5::CMetadata::Collection() const
+MusicBrainz5::CUserRating *MusicBrainz5::CMetadata::UserRating()
+{
+	Unshare(m_d);
+
+	return m_d->m_UserRating;
+}
+
+const MusicBrainz5::CCollection *MusicBrainz5::CMetadata::Collection() const
 {
 	return m_d->m_Collection;
 }
 
-MusicBrainz5::CArtistList *MusicBrainz5::CMetadata::ArtistList() const
+MusicBrainz5::CCollection *MusicBrainz5::CMetadata::Collection()
+{
+	Unshare(m_d);
+
+	return m_d->m_Collection;
+}
+
+const MusicBrainz5::CArtistList *MusicBrainz5::CMetadata::ArtistList() const
+{
+	return m_d->m_ArtistList;
+}
+
+MusicBrainz5::CArtistList *MusicBrainz5::CMetadata::ArtistList()
 {
+	Unshare(m_d);
+
 	return m_d->m_ArtistList;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CMetadata::ReleaseList() const
+const MusicBrainz5::CReleaseList *MusicBrainz5::CMetadata::ReleaseList() const
 {
 	return m_d->m_ReleaseList;
 }
 
-MusicBrainz5::CReleaseGroupList *MusicBrainz5::CMetadata::ReleaseGroupList() const
+MusicBrainz5::CReleaseList *MusicBrainz5::CMetadata::ReleaseList()
+{
+	Unshare(m_d);
+
+	return m_d->m_ReleaseList;
+}
+
+const MusicBrainz5::CReleaseGroupList *MusicBrainz5::CMetadata::ReleaseGroupList() const
 {
 	return m_d->m_ReleaseGroupList;
 }
 
-MusicBrainz5::CRecordingList *MusicBrainz5::CMetadata::RecordingList() const
+MusicBrainz5::CReleaseGroupList *MusicBrainz5::CMetadata::ReleaseGroupList()
+{
+	Unshare(m_d);
+
+	return m_d->m_ReleaseGroupList;
+}
+
+const MusicBrainz5::CRecordingList *MusicBrainz5::CMetadata::RecordingList() const
 {
 	return m_d->m_RecordingList;
 }
 
-MusicBrainz5::CLabelList *MusicBrainz5::CMetadata::LabelList() const
+MusicBrainz5::CRecordingList *MusicBrainz5::CMetadata::RecordingList()
+{
+	Unshare(m_d);
+
+	return m_d->m_RecordingList;
+}
+
+const MusicBrainz5::CLabelList *MusicBrainz5::CMetadata::LabelList() const
 {
 	return m_d->m_LabelList;
 }
 
-MusicBrainz5::CWorkList *MusicBrainz5::CMetadata::WorkList() const
+MusicBrainz5::CLabelList *MusicBrainz5::CMetadata::LabelList()
 {
+	Unshare(m_d);
+
+	return m_d->m_LabelList;
+}
+
+const MusicBrainz5::CWorkList *MusicBrainz5::CMetadata::WorkList() const
+{
+	return m_d->m_WorkList;
+}
+
+MusicBrainz5::CWorkList *MusicBrainz5::CMetadata::WorkList()
+{
+	Unshare(m_d);
+
 	return m_d->m_WorkList;
 }
 
-MusicBrainz5::CISRCList *MusicBrainz5::CMetadata::ISRCList() const
+const MusicBrainz5::CISRCList *MusicBrainz5::CMetadata::ISRCList() const
 {
 	return m_d->m_ISRCList;
 }
 
-MusicBrainz5::CAnnotationList *MusicBrainz5::CMetadata::AnnotationList() const
+MusicBrainz5::CISRCList *MusicBrainz5::CMetadata::ISRCList()
+{
+	Unshare(m_d);
+
+	return m_d->m_ISRCList;
+}
+
+const MusicBrainz5::CAnnotationList *MusicBrainz5::CMetadata::AnnotationList() const
 {
 	return m_d->m_AnnotationList;
 }
 
-MusicBrainz5::CCDStubList *MusicBrainz5::CMetadata::CDStubList() const
+MusicBrainz5::CAnnotationList *MusicBrainz5::CMetadata::AnnotationList()
+{
+	Unshare(m_d);
+
+	return m_d->m_AnnotationList;
+}
+
+const MusicBrainz5::CCDStubList *MusicBrainz5::CMetadata::CDStubList() const
 {
 	return m_d->m_CDStubList;
 }
 
-MusicBrainz5::CFreeDBDiscList *MusicBrainz5::CMetadata::FreeDBDiscList() const
+MusicBrainz5::CCDStubList *MusicBrainz5::CMetadata::CDStubList()
 {
+	Unshare(m_d);
+
+	return m_d->m_CDStubList;
+}
+
+const MusicBrainz5::CFreeDBDiscList *MusicBrainz5::CMetadata::FreeDBDiscList() const
+{
+	return m_d->m_FreeDBDiscList;
+}
+
+MusicBrainz5::CFreeDBDiscList *MusicBrainz5::CMetadata::FreeDBDiscList()
+{
+	Unshare(m_d);
+
 	return m_d->m_FreeDBDiscList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CMetadata::TagList() const
+const MusicBrainz5::CTagList *MusicBrainz5::CMetadata::TagList() const
+{
+	return m_d->m_TagList;
+}
+
+MusicBrainz5::CTagList *MusicBrainz5::CMetadata::TagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CMetadata::UserTagList() const
+const MusicBrainz5::CUserTagList *MusicBrainz5::CMetadata::UserTagList() const
+{
+	return m_d->m_UserTagList;
+}
+
+MusicBrainz5::CUserTagList *MusicBrainz5::CMetadata::UserTagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CCollectionList *MusicBrainz5::CMetadata::CollectionList() const
+const MusicBrainz5::CCollectionList *MusicBrainz5::CMetadata::CollectionList() const
 {
 	return m_d->m_CollectionList;
 }
 
-MusicBrainz5::CCDStub *MusicBrainz5::CMetadata::CDStub() const
+MusicBrainz5::CCollectionList *MusicBrainz5::CMetadata::CollectionList()
+{
+	Unshare(m_d);
+
+	return m_d->m_CollectionList;
+}
+
+const MusicBrainz5::CCDStub *MusicBrainz5::CMetadata::CDStub() const
 {
 	return m_d->m_CDStub;
 }
 
-MusicBrainz5::CMessage *MusicBrainz5::CMetadata::Message() const
+MusicBrainz5::CCDStub *MusicBrainz5::CMetadata::CDStub()
 {
+	Unshare(m_d);
+
+	return m_d->m_CDStub;
+}
+
+const MusicBrainz5::CMessage *MusicBrainz5::CMetadata::Message() const
+{
+	return m_d->m_Message;
+}
+
+MusicBrainz5::CMessage *MusicBrainz5::CMetadata::Message()
+{
+	Unshare(m_d);
+
 	return m_d->m_Message;
 }
 
@@ -29,8 +29,10 @@
 #include "musicbrainz5/NameCredit.h"
 
 #include "musicbrainz5/Artist.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CNameCreditPrivate
+class MusicBrainz5::CNameCreditPrivate: public CSharedPrivate
 {
 	public:
 		CNameCreditPrivate()
@@ -38,6 +40,21 @@ class MusicBrainz5::CNameCreditPrivate
 		{
 		}
 
+		CNameCreditPrivate(const CNameCreditPrivate& Other)
+		:	CSharedPrivate(),
+			m_JoinPhrase(Other.m_JoinPhrase),
+			m_Name(Other.m_Name),
+			m_Artist(0)
+		{
+			if (Other.m_Artist)
+				m_Artist=new CArtist(*Other.m_Artist);
+		}
+
+		~CNameCreditPrivate()
+		{
+			delete m_Artist;
+		}
+
 		std::string m_JoinPhrase;
 		std::string m_Name;
 		CArtist *m_Artist;
@@ -56,41 +73,46 @@ MusicBrainz5::CNameCredit::CNameCredit(const XMLNode& Node)
 }
 
 MusicBrainz5::CNameCredit::CNameCredit(const CNameCredit& Other)
-:	CEntity(),
-	m_d(new CNameCreditPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CNameCredit& MusicBrainz5::CNameCredit::operator =(const CNameCredit& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_JoinPhrase=Other.m_d->m_JoinPhrase;
-		m_d->m_Name=Other.m_d->m_Name;
-
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CNameCredit::~CNameCredit()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CNameCredit::CNameCredit(CNameCredit&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CNameCreditPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CNameCredit& MusicBrainz5::CNameCredit::operator =(CNameCredit&& Other)
 {
-	Cleanup();
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CNameCredit::Cleanup()
+MusicBrainz5::CNameCredit::~CNameCredit()
 {
-	delete m_d->m_Artist;
-	m_d->m_Artist=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CNameCredit *MusicBrainz5::CNameCredit::Clone()
@@ -100,6 +122,8 @@ MusicBrainz5::CNameCredit *MusicBrainz5::CNameCredit::Clone()
 
 void MusicBrainz5::CNameCredit::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("joinphrase"==Name)
 		m_d->m_JoinPhrase=Value;
 	else
@@ -112,21 +136,23 @@ void MusicBrainz5::CNameCredit::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CNameCredit::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised name credit element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised name credit element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -135,18 +161,25 @@ std::string MusicBrainz5::CNameCredit::GetElementName()
 	return "name-credit";
 }
 
-std::string MusicBrainz5::CNameCredit::JoinPhrase() const
+const std::string& MusicBrainz5::CNameCredit::JoinPhrase() const
 {
 	return m_d->m_JoinPhrase;
 }
 
-std::string MusicBrainz5::CNameCredit::Name() const
+const std::string& MusicBrainz5::CNameCredit::Name() const
 {
 	return m_d->m_Name;
 }
 
-MusicBrainz5::CArtist *MusicBrainz5::CNameCredit::Artist() const
+const MusicBrainz5::CArtist *MusicBrainz5::CNameCredit::Artist() const
+{
+	return m_d->m_Artist;
+}
+
+MusicBrainz5::CArtist *MusicBrainz5::CNameCredit::Artist()
 {
+	Unshare(m_d);
+
 	return m_d->m_Artist;
 }
 
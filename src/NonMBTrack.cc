@@ -27,8 +27,10 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/NonMBTrack.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CNonMBTrackPrivate
+class MusicBrainz5::CNonMBTrackPrivate: public CSharedPrivate
 {
 	public:
 		CNonMBTrackPrivate()
@@ -54,10 +56,9 @@ MusicBrainz5::CNonMBTrack::CNonMBTrack(const XMLNode& Node)
 }
 
 MusicBrainz5::CNonMBTrack::CNonMBTrack(const CNonMBTrack& Other)
-:	CEntity(),
-	m_d(new CNonMBTrackPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CNonMBTrack& MusicBrainz5::CNonMBTrack::operator =(const CNonMBTrack& Other)
@@ -66,17 +67,35 @@ MusicBrainz5::CNonMBTrack& MusicBrainz5::CNonMBTrack::operator =(const CNonMBTra
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Artist=Other.m_d->m_Artist;
-		m_d->m_Length=Other.m_d->m_Length;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CNonMBTrack::CNonMBTrack(CNonMBTrack&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CNonMBTrackPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CNonMBTrack& MusicBrainz5::CNonMBTrack::operator =(CNonMBTrack&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CNonMBTrack::~CNonMBTrack()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CNonMBTrack *MusicBrainz5::CNonMBTrack::Clone()
@@ -95,25 +114,27 @@ void MusicBrainz5::CNonMBTrack::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CNonMBTrack::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("length"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Length);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElementLength:
+			ProcessItem(Node,m_d->m_Length);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised non MB track element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised non MB track element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -122,12 +143,12 @@ std::string MusicBrainz5::CNonMBTrack::GetElementName()
 	return "track";
 }
 
-std::string MusicBrainz5::CNonMBTrack::Title() const
+const std::string& MusicBrainz5::CNonMBTrack::Title() const
 {
 	return m_d->m_Title;
 }
 
-std::string MusicBrainz5::CNonMBTrack::Artist() const
+const std::string& MusicBrainz5::CNonMBTrack::Artist() const
 {
 	return m_d->m_Artist;
 }
@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Offset.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::COffsetPrivate
+class MusicBrainz5::COffsetPrivate: public CSharedPrivate
 {
 	public:
 		COffsetPrivate()
@@ -57,36 +58,46 @@ MusicBrainz5::COffset::COffset(const XMLNode& Node)
 }
 
 MusicBrainz5::COffset::COffset(const COffset& Other)
-:	CEntity(),
-	m_d(new COffsetPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::COffset& MusicBrainz5::COffset::operator =(const COffset& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Offset=Other.m_d->m_Offset;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::COffset::~COffset()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::COffset::COffset(COffset&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<COffsetPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::COffset& MusicBrainz5::COffset::operator =(COffset&& Other)
 {
-	Cleanup();
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::COffset::Cleanup()
+MusicBrainz5::COffset::~COffset()
 {
+	m_d->Unref();
 }
 
 MusicBrainz5::COffset *MusicBrainz5::COffset::Clone()
@@ -96,6 +107,8 @@ MusicBrainz5::COffset *MusicBrainz5::COffset::Clone()
 
 void MusicBrainz5::COffset::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("position"==Name)
 		ProcessItem(Value,m_d->m_Position);
 	else
@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/RecordingList.h"
 #include "musicbrainz5/Recording.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CPUIDPrivate
+class MusicBrainz5::CPUIDPrivate: public CSharedPrivate
 {
 	public:
 		CPUIDPrivate()
@@ -39,6 +41,20 @@ class MusicBrainz5::CPUIDPrivate
 		{
 		}
 
+		CPUIDPrivate(const CPUIDPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_RecordingList(0)
+		{
+			if (Other.m_RecordingList)
+				m_RecordingList=new CRecordingList(*Other.m_RecordingList);
+		}
+
+		~CPUIDPrivate()
+		{
+			delete m_RecordingList;
+		}
+
 		std::string m_ID;
 		CRecordingList *m_RecordingList;
 };
@@ -56,40 +72,46 @@ MusicBrainz5::CPUID::CPUID(const XMLNode& Node)
 }
 
 MusicBrainz5::CPUID::CPUID(const CPUID& Other)
-:	CEntity(),
-	m_d(new CPUIDPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CPUID& MusicBrainz5::CPUID::operator =(const CPUID& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-
-		if (Other.m_d->m_RecordingList)
-			m_d->m_RecordingList=new CRecordingList(*Other.m_d->m_RecordingList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CPUID::~CPUID()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CPUID::CPUID(CPUID&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CPUIDPrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CPUID& MusicBrainz5::CPUID::operator =(CPUID&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d;
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CPUID::Cleanup()
+MusicBrainz5::CPUID::~CPUID()
 {
-	delete m_d->m_RecordingList;
-	m_d->m_RecordingList=0;
+	m_d->Unref();
 }
 
 MusicBrainz5::CPUID *MusicBrainz5::CPUID::Clone()
@@ -99,6 +121,8 @@ MusicBrainz5::CPUID *MusicBrainz5::CPUID::Clone()
 
 void MusicBrainz5::CPUID::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -111,17 +135,19 @@ void MusicBrainz5::CPUID::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CPUID::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("recording-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_RecordingList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementRecordingList:
+			ProcessItem(Node,m_d->m_RecordingList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised PUID element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised PUID element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -130,16 +156,23 @@ std::string MusicBrainz5::CPUID::GetElementName()
 	return "puid";
 }
 
-std::string MusicBrainz5::CPUID::ID() const
+const std::string& MusicBrainz5::CPUID::ID() const
 {
 	return m_d->m_ID;
 }
 
-MusicBrainz5::CRecordingList *MusicBrainz5::CPUID::RecordingList() const
+const MusicBrainz5::CRecordingList *MusicBrainz5::CPUID::RecordingList() const
 {
 	return m_d->m_RecordingList;
 }
 
+MusicBrainz5::CRecordingList *MusicBrainz5::CPUID::RecordingList()
+{
+	Unshare(m_d);
+
+	return m_d->m_RecordingList;
+}
+
 std::ostream& MusicBrainz5::CPUID::Serialise(std::ostream& os) const
 {
 	os << "PUID:" << std::endl;
@@ -32,21 +32,75 @@
 
 #include "musicbrainz5/Query.h"
 
+#include <deque>
+#include <set>
 #include <sstream>
 #include <iostream>
 #include <cstdlib>
 
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
-#include <sys/time.h>
+#include <time.h>
 
 #include <ne_uri.h>
+#include <libxml/parser.h>
 
 #include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/HTTPTransport.h"
+#include "musicbrainz5/HTTPSessionPool.h"
+#include "musicbrainz5/RateLimiter.h"
+#include "musicbrainz5/ResponseCache.h"
+#include "musicbrainz5/DiskCache.h"
 #include "musicbrainz5/Disc.h"
 #include "musicbrainz5/Message.h"
 #include "musicbrainz5/ReleaseList.h"
 #include "musicbrainz5/Release.h"
+#include "musicbrainz5/MBID.h"
+
+class CLastStatus
+{
+	public:
+		CLastStatus()
+		:	m_Result(MusicBrainz5::CQuery::eQuery_Success),
+			m_HTTPCode(200),
+			m_CompressedSize(0),
+			m_UncompressedSize(0)
+		{
+		}
+
+		MusicBrainz5::CQuery::tQueryResult m_Result;
+		int m_HTTPCode;
+		std::string m_ErrorMessage;
+		int m_CompressedSize;
+		int m_UncompressedSize;
+};
+
+//A request being made by one thread, which other threads making the same request
+//wait for rather than making it again
+
+class MusicBrainz5::CInFlightQuery
+{
+	public:
+		CInFlightQuery()
+		:	m_References(1),
+			m_Done(false)
+		{
+			pthread_cond_init(&m_Cond,0);
+		}
+
+		~CInFlightQuery()
+		{
+			pthread_cond_destroy(&m_Cond);
+		}
+
+		int m_References;
+		bool m_Done;
+		pthread_cond_t m_Cond;
+		CLookupResult m_Result;
+		CMetadata m_Metadata;
+};
 
 class MusicBrainz5::CQueryPrivate
 {
@@ -54,9 +108,33 @@ class MusicBrainz5::CQueryPrivate
 		CQueryPrivate()
 		:	m_Port(80),
 			m_ProxyPort(0),
-			m_LastResult(CQuery::eQuery_Success),
-			m_LastHTTPCode(200)
+			m_Transport(&m_HTTPTransport),
+			m_RateLimiter(&CRateLimiter::Default()),
+			m_ResponseCache(0),
+			m_DiskCache(0),
+			m_MaxRetries(3),
+			m_BatchConcurrency(4),
+			m_AsyncThreads(2),
+			m_Executor(0),
+			m_BatchExecutor(0),
+			m_RandomSeed(time(0)^(unsigned int)(size_t)this),
+			m_Compression(false),
+			m_ServeStale(false),
+			m_RefreshCallback(0),
+			m_Serial(__sync_add_and_fetch(&m_NextSerial,1))
+		{
+			//libxml2 must be initialised before it is used from more than one thread
+
+			xmlInitParser();
+
+			pthread_mutex_init(&m_ExecutorMutex,0);
+			pthread_mutex_init(&m_InFlightMutex,0);
+		}
+
+		~CQueryPrivate()
 		{
+			pthread_mutex_destroy(&m_InFlightMutex);
+			pthread_mutex_destroy(&m_ExecutorMutex);
 		}
 
 		std::string m_UserAgent;
@@ -68,248 +146,1534 @@ class MusicBrainz5::CQueryPrivate
 		int m_ProxyPort;
 		std::string m_ProxyUserName;
 		std::string m_ProxyPassword;
-		CQuery::tQueryResult m_LastResult;
-		int m_LastHTTPCode;
-		std::string m_LastErrorMessage;
+		CHTTPTransport m_HTTPTransport;
+		CTransport *m_Transport;
+		CRateLimiter *m_RateLimiter;
+		CResponseCache *m_ResponseCache;
+		CDiskCache *m_DiskCache;
+		int m_MaxRetries;
+		int m_BatchConcurrency;
+		int m_AsyncThreads;
+		CQueryExecutor *m_Executor;
+		CQueryExecutor *m_BatchExecutor;
+		pthread_mutex_t m_ExecutorMutex;
+		unsigned int m_RandomSeed;
+		bool m_Compression;
+		bool m_ServeStale;
+		CQueryCallback *m_RefreshCallback;
+		std::set<std::string> m_Refreshing;
+		std::map<std::string,CInFlightQuery *> m_InFlight;
+		pthread_mutex_t m_InFlightMutex;
+		unsigned long m_Serial;
+
+		CLastStatus& Last();
+		void ForgetLast();
+
+	private:
+		static unsigned long m_NextSerial;
 };
 
-MusicBrainz5::CQuery::CQuery(const std::string& UserAgent, const std::string& Server, int Port)
-:	m_d(new CQueryPrivate)
+unsigned long MusicBrainz5::CQueryPrivate::m_NextSerial=0;
+
+//The status of the last query made by each thread, for each CQuery object. This is
+//kept per thread so that one thread's queries don't overwrite the status another
+//thread is about to read. Each thread's map is also registered centrally, so that a
+//CQuery being destroyed can remove its status from threads that are still running.
+
+class CLastStatusMap
 {
-	m_d->m_UserAgent=UserAgent;
-	m_d->m_Server=Server;
-	m_d->m_Port=Port;
-}
+	public:
+		CLastStatusMap()
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
 
-MusicBrainz5::CQuery::~CQuery()
+		~CLastStatusMap()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		pthread_mutex_t m_Mutex;
+		std::map<unsigned long,CLastStatus> m_Status;
+};
+
+static pthread_key_t LastStatusKey;
+static pthread_once_t LastStatusOnce=PTHREAD_ONCE_INIT;
+static pthread_mutex_t LastStatusMapsMutex;
+static std::set<CLastStatusMap *> *LastStatusMaps=0;
+
+static void DeleteLastStatus(void *Data)
 {
-	delete m_d;
+	CLastStatusMap *Map=static_cast<CLastStatusMap *>(Data);
+
+	pthread_mutex_lock(&LastStatusMapsMutex);
+	LastStatusMaps->erase(Map);
+	pthread_mutex_unlock(&LastStatusMapsMutex);
+
+	delete Map;
 }
 
-void MusicBrainz5::CQuery::SetUserName(const std::string& UserName)
+static void CreateLastStatusKey()
 {
-	m_d->m_UserName=UserName;
+	pthread_mutex_init(&LastStatusMapsMutex,0);
+	LastStatusMaps=new std::set<CLastStatusMap *>;
+	pthread_key_create(&LastStatusKey,DeleteLastStatus);
 }
 
-void MusicBrainz5::CQuery::SetPassword(const std::string& Password)
+CLastStatus& MusicBrainz5::CQueryPrivate::Last()
 {
-	m_d->m_Password=Password;
+	pthread_once(&LastStatusOnce,CreateLastStatusKey);
+
+	CLastStatusMap *Map=static_cast<CLastStatusMap *>(pthread_getspecific(LastStatusKey));
+	if (!Map)
+	{
+		Map=new CLastStatusMap;
+		pthread_setspecific(LastStatusKey,Map);
+
+		pthread_mutex_lock(&LastStatusMapsMutex);
+		LastStatusMaps->insert(Map);
+		pthread_mutex_unlock(&LastStatusMapsMutex);
+	}
+
+	//Entries are only removed by other threads, and map entries don't move, so the
+	//returned reference stays valid after the lock is released
+
+	pthread_mutex_lock(&Map->m_Mutex);
+	CLastStatus& Ret=Map->m_Status[m_Serial];
+	pthread_mutex_unlock(&Map->m_Mutex);
+
+	return Ret;
 }
 
-void MusicBrainz5::CQuery::SetProxyHost(const std::string& ProxyHost)
+void MusicBrainz5::CQueryPrivate::ForgetLast()
 {
-	m_d->m_ProxyHost=ProxyHost;
+	pthread_once(&LastStatusOnce,CreateLastStatusKey);
+
+	pthread_mutex_lock(&LastStatusMapsMutex);
+
+	for (std::set<CLastStatusMap *>::const_iterator ThisMap=LastStatusMaps->begin();ThisMap!=LastStatusMaps->end();++ThisMap)
+	{
+		pthread_mutex_lock(&(*ThisMap)->m_Mutex);
+		(*ThisMap)->m_Status.erase(m_Serial);
+		pthread_mutex_unlock(&(*ThisMap)->m_Mutex);
+	}
+
+	pthread_mutex_unlock(&LastStatusMapsMutex);
 }
 
-void MusicBrainz5::CQuery::SetProxyPort(int ProxyPort)
+//Entities that are looked up by MusicBrainz ID. The server rejects a lookup of any
+//of these with an ID that isn't a valid MBID, so there's no need to send it.
+
+static bool LookedUpByMBID(const std::string& Entity)
 {
-	m_d->m_ProxyPort=ProxyPort;
+	static const char *Entities[]={"area","artist","collection","event","instrument","label","place",
+		"recording","release","release-group","series","url","work",0};
+
+	for (int count=0;Entities[count];count++)
+	{
+		if (Entity==Entities[count])
+			return true;
+	}
+
+	return false;
 }
 
-void MusicBrainz5::CQuery::SetProxyUserName(const std::string& ProxyUserName)
+//Check the ID in a query of the form /ws/2/Entity/ID/Resource?Params, returning
+//false and the ID if it can't be valid
+
+static bool CheckQueryID(const std::string& Query, std::string& ID)
 {
-	m_d->m_ProxyUserName=ProxyUserName;
+	static const std::string Prefix="/ws/2/";
+
+	if (0!=Query.compare(0,Prefix.length(),Prefix))
+		return true;
+
+	std::string::size_type EntityEnd=Query.find_first_of("/?",Prefix.length());
+	if (EntityEnd==std::string::npos || Query[EntityEnd]!='/')
+		return true;
+
+	std::string::size_type IDEnd=Query.find_first_of("/?",EntityEnd+1);
+	if (IDEnd==std::string::npos)
+		IDEnd=Query.length();
+
+	if (!LookedUpByMBID(Query.substr(Prefix.length(),EntityEnd-Prefix.length())))
+		return true;
+
+	ID=Query.substr(EntityEnd+1,IDEnd-EntityEnd-1);
+
+	return MusicBrainz5::CMBID::IsValid(ID);
 }
 
-void MusicBrainz5::CQuery::SetProxyPassword(const std::string& ProxyPassword)
+class MusicBrainz5::CLookupResultPrivate
 {
-	m_d->m_ProxyPassword=ProxyPassword;
+	public:
+		CLookupResultPrivate()
+		:	m_Result(CQuery::eQuery_Success),
+			m_HTTPCode(0),
+			m_CompressedSize(0),
+			m_UncompressedSize(0),
+			m_WaitTime(0),
+			m_TotalTime(0),
+			m_Retries(0),
+			m_Cached(false),
+			m_Stale(false),
+			m_Changed(false)
+		{
+		}
+
+		std::string m_ID;
+		CQuery::tQueryResult m_Result;
+		int m_HTTPCode;
+		std::string m_ErrorMessage;
+		int m_CompressedSize;
+		int m_UncompressedSize;
+		double m_WaitTime;
+		double m_TotalTime;
+		int m_Retries;
+		bool m_Cached;
+		bool m_Stale;
+		bool m_Changed;
+		CMetadata m_Metadata;
+};
+
+//Performs the lookups for CQuery::LookupBatch. The calling thread is helped by
+//threads from the query's batch executor, and each thread takes the next query
+//that hasn't been started until there are none left.
+
+class MusicBrainz5::CQueryBatch
+{
+	public:
+		CQueryBatch(CQuery *Query, const std::vector<std::string>& URLs, std::vector<CLookupResult>& Results)
+		:	m_Query(Query),
+			m_URLs(URLs),
+			m_Results(Results),
+			m_Next(0),
+			m_Helpers(0)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+			pthread_cond_init(&m_Cond,0);
+		}
+
+		~CQueryBatch()
+		{
+			pthread_cond_destroy(&m_Cond);
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		void Run(int Threads);
+
+		//Called by a helper task, or instead when the task is cancelled. The batch
+		//can't be destroyed until every helper has finished with it.
+
+		void Help(bool Cancelled)
+		{
+			if (!Cancelled)
+				Work();
+
+			pthread_mutex_lock(&m_Mutex);
+			if (0==--m_Helpers)
+				pthread_cond_signal(&m_Cond);
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+	private:
+		CQuery *m_Query;
+		const std::vector<std::string>& m_URLs;
+		std::vector<CLookupResult>& m_Results;
+		int m_Next;
+		int m_Helpers;
+		pthread_mutex_t m_Mutex;
+		pthread_cond_t m_Cond;
+
+		void Work()
+		{
+			int Item;
+
+			while ((Item=__sync_fetch_and_add(&m_Next,1))<(int)m_URLs.size())
+			{
+				CLookupResult& Result=m_Results[Item];
+
+				try
+				{
+					Result.m_d->m_Metadata=m_Query->PerformQuery(m_URLs[Item],Result);
+				}
+
+				catch (CExceptionBase& Error)
+				{
+					//The status has already been recorded in the result
+				}
+
+				catch (std::exception& Error)
+				{
+					Result.m_d->m_Result=CQuery::eQuery_FetchError;
+					Result.m_d->m_ErrorMessage=Error.what();
+				}
+			}
+		}
+};
+
+//State shared between the copies of a CQueryFuture and the task performing the query
+
+class MusicBrainz5::CQueryFuturePrivate
+{
+	public:
+		CQueryFuturePrivate(const std::string& ID, CQueryCallback *Callback)
+		:	m_References(1),
+			m_Done(false),
+			m_Result(ID),
+			m_Callback(Callback)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+			pthread_cond_init(&m_Cond,0);
+		}
+
+		~CQueryFuturePrivate()
+		{
+			pthread_cond_destroy(&m_Cond);
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		void AddReference()
+		{
+			__sync_fetch_and_add(&m_References,1);
+		}
+
+		void Release()
+		{
+			if (0==__sync_sub_and_fetch(&m_References,1))
+				delete this;
+		}
+
+		void Complete(const CLookupResult& Result)
+		{
+			pthread_mutex_lock(&m_Mutex);
+			m_Result=Result;
+			m_Done=true;
+			pthread_cond_broadcast(&m_Cond);
+			pthread_mutex_unlock(&m_Mutex);
+
+			if (m_Callback)
+				m_Callback->Completed(Result);
+		}
+
+		int m_References;
+		pthread_mutex_t m_Mutex;
+		pthread_cond_t m_Cond;
+		bool m_Done;
+		CLookupResult m_Result;
+		CQueryCallback *m_Callback;
+};
+
+//A query waiting to be performed by a CQueryExecutor. This is either an
+//asynchronous query, the background refresh of an expired response, or a
+//thread's share of the work of a batch lookup.
+
+class MusicBrainz5::CQueryTask
+{
+	public:
+		CQueryTask(CQuery *Query, const std::string& URL, CQueryFuturePrivate *Future)
+		:	m_Query(Query),
+			m_URL(URL),
+			m_Future(Future),
+			m_RefreshCallback(0),
+			m_Batch(0)
+		{
+			m_Future->AddReference();
+		}
+
+		CQueryTask(CQuery *Query, const std::string& URL, const std::string& ID, CQueryCallback *RefreshCallback)
+		:	m_Query(Query),
+			m_URL(URL),
+			m_ID(ID),
+			m_Future(0),
+			m_RefreshCallback(RefreshCallback),
+			m_Batch(0)
+		{
+		}
+
+		CQueryTask(CQuery *Query, CQueryBatch *Batch)
+		:	m_Query(Query),
+			m_Future(0),
+			m_RefreshCallback(0),
+			m_Batch(Batch)
+		{
+		}
+
+		~CQueryTask()
+		{
+			if (m_Future)
+				m_Future->Release();
+			else if (!m_Batch)
+				m_Query->RefreshFinished(m_URL);
+		}
+
+		void Run()
+		{
+			if (m_Batch)
+			{
+				m_Batch->Help(false);
+				return;
+			}
+
+			if (!m_Future)
+			{
+				Refresh();
+				return;
+			}
+
+			CLookupResult Result(m_Future->m_Result.ID());
+
+			try
+			{
+				Result.m_d->m_Metadata=m_Query->PerformQuery(m_URL,Result);
+			}
+
+			catch (CExceptionBase& Error)
+			{
+				//The status has already been recorded in the result
+			}
+
+			catch (std::exception& Error)
+			{
+				Result.m_d->m_Result=CQuery::eQuery_FetchError;
+				Result.m_d->m_ErrorMessage=Error.what();
+			}
+
+			m_Future->Complete(Result);
+		}
+
+		void Cancel()
+		{
+			if (m_Batch)
+				m_Batch->Help(true);
+
+			if (!m_Future)
+				return;
+
+			CLookupResult Result(m_Future->m_Result.ID());
+			Result.m_d->m_Result=CQuery::eQuery_FetchError;
+			Result.m_d->m_ErrorMessage="Query cancelled";
+
+			m_Future->Complete(Result);
+		}
+
+	private:
+		CQuery *m_Query;
+		std::string m_URL;
+		std::string m_ID;
+		CQueryFuturePrivate *m_Future;
+		CQueryCallback *m_RefreshCallback;
+		CQueryBatch *m_Batch;
+
+		void Refresh()
+		{
+			CLookupResult Result(m_ID);
+
+			try
+			{
+				Result.m_d->m_Metadata=m_Query->PerformQuery(m_URL,Result,true);
+			}
+
+			catch (CExceptionBase& Error)
+			{
+				//The expired response stays in the cache, to be retried next time
+			}
+
+			catch (std::exception& Error)
+			{
+			}
+
+			if (Result.m_d->m_Changed && m_RefreshCallback)
+				m_RefreshCallback->Completed(Result);
+		}
+};
+
+void MusicBrainz5::CQueryBatch::Run(int Threads)
+{
+	pthread_mutex_lock(&m_Mutex);
+	m_Helpers=Threads-1;
+	pthread_mutex_unlock(&m_Mutex);
+
+	for (int count=1;count<Threads;count++)
+		m_Query->SubmitBatchTask(new CQueryTask(m_Query,this));
+
+	//The calling thread does its share of the work too
+
+	Work();
+
+	//Helpers that start after the work has run out return straight away
+
+	pthread_mutex_lock(&m_Mutex);
+	while (m_Helpers)
+		pthread_cond_wait(&m_Cond,&m_Mutex);
+	pthread_mutex_unlock(&m_Mutex);
 }
 
-MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Query)
+//Pool of threads performing asynchronous queries, or helping with batch
+//lookups. Threads are started when there is work and no idle thread to do it,
+//up to the configured maximum, and kept until the pool is destroyed.
+
+class MusicBrainz5::CQueryExecutor
 {
-	WaitRequest();
+	public:
+		CQueryExecutor(int Threads)
+		:	m_Threads(Threads),
+			m_Idle(0),
+			m_Stopping(false)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+			pthread_cond_init(&m_Cond,0);
+		}
 
-	CMetadata Metadata;
+		~CQueryExecutor()
+		{
+			pthread_mutex_lock(&m_Mutex);
 
-	CHTTPFetch Fetch(UserAgent(),m_d->m_Server,m_d->m_Port);
+			m_Stopping=true;
 
-	if (!m_d->m_UserName.empty())
-		Fetch.SetUserName(m_d->m_UserName);
+			std::deque<CQueryTask *> Cancelled;
+			Cancelled.swap(m_Queue);
 
-	if (!m_d->m_Password.empty())
-		Fetch.SetPassword(m_d->m_Password);
+			pthread_cond_broadcast(&m_Cond);
+			pthread_mutex_unlock(&m_Mutex);
+
+			while (!Cancelled.empty())
+			{
+				Cancelled.front()->Cancel();
+				delete Cancelled.front();
+				Cancelled.pop_front();
+			}
+
+			for (std::vector<pthread_t>::size_type count=0;count<m_Workers.size();count++)
+				pthread_join(m_Workers[count],0);
+
+			pthread_cond_destroy(&m_Cond);
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		void SetThreads(int Threads)
+		{
+			pthread_mutex_lock(&m_Mutex);
+			m_Threads=Threads;
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+		void Submit(CQueryTask *Task)
+		{
+			pthread_mutex_lock(&m_Mutex);
+
+			m_Queue.push_back(Task);
+
+			if ((int)m_Queue.size()>m_Idle && ((int)m_Workers.size()<m_Threads || m_Workers.empty()))
+			{
+				pthread_t Thread;
+				if (0==pthread_create(&Thread,0,CQueryExecutor::Thread,this))
+					m_Workers.push_back(Thread);
+			}
+
+			pthread_cond_signal(&m_Cond);
+			pthread_mutex_unlock(&m_Mutex);
+		}
+
+	private:
+		int m_Threads;
+		int m_Idle;
+		bool m_Stopping;
+		pthread_mutex_t m_Mutex;
+		pthread_cond_t m_Cond;
+		std::deque<CQueryTask *> m_Queue;
+		std::vector<pthread_t> m_Workers;
+
+		static void *Thread(void *Executor)
+		{
+			static_cast<CQueryExecutor *>(Executor)->Work();
+
+			return 0;
+		}
+
+		void Work()
+		{
+			pthread_mutex_lock(&m_Mutex);
+
+			while (!m_Stopping)
+			{
+				if (m_Queue.empty())
+				{
+					m_Idle++;
+					pthread_cond_wait(&m_Cond,&m_Mutex);
+					m_Idle--;
+				}
+				else
+				{
+					CQueryTask *Task=m_Queue.front();
+					m_Queue.pop_front();
+
+					pthread_mutex_unlock(&m_Mutex);
+
+					Task->Run();
+					delete Task;
+
+					pthread_mutex_lock(&m_Mutex);
+				}
+			}
+
+			pthread_mutex_unlock(&m_Mutex);
+		}
+};
+
+//Deletes the fetch object created for a request when it goes out of scope
+
+class CFetchOwner
+{
+	public:
+		CFetchOwner(MusicBrainz5::CFetch *Fetch)
+		:	m_Fetch(Fetch)
+		{
+		}
+
+		~CFetchOwner()
+		{
+			delete m_Fetch;
+		}
+
+	private:
+		MusicBrainz5::CFetch *m_Fetch;
+};
+
+//Returns the number of seconds requested by a Retry-After header, which may
+//either be a number of seconds or a date
+
+static double RetryAfter(const std::string& Value)
+{
+	if (Value.empty())
+		return 0;
+
+	char *End=0;
+	long Seconds=strtol(Value.c_str(),&End,10);
+	if (End!=Value.c_str() && '\0'==*End)
+		return Seconds>0 ? Seconds : 0;
+
+	struct tm Date;
+	memset(&Date,0,sizeof(Date));
+	if (strptime(Value.c_str(),"%a, %d %b %Y %H:%M:%S GMT",&Date))
+	{
+		double Diff=difftime(timegm(&Date),time(0));
+		return Diff>0 ? Diff : 0;
+	}
+
+	return 0;
+}
+
+static double Now()
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC,&Time);
+
+	return Time.tv_sec+Time.tv_nsec/1e9;
+}
+
+static void Sleep(double Seconds)
+{
+	struct timespec Remaining;
+	Remaining.tv_sec=(time_t)Seconds;
+	Remaining.tv_nsec=(long)((Seconds-Remaining.tv_sec)*1e9);
+
+	while (0!=nanosleep(&Remaining,&Remaining) && EINTR==errno)
+		;
+}
+
+//Records the time taken by a query when it completes, however it completes
+
+class CLookupTimer
+{
+	public:
+		CLookupTimer(MusicBrainz5::CLookupResultPrivate *Result, double Start)
+		:	m_Result(Result),
+			m_Start(Start)
+		{
+		}
+
+		~CLookupTimer()
+		{
+			m_Result->m_TotalTime=Now()-m_Start;
+		}
+
+	private:
+		MusicBrainz5::CLookupResultPrivate *m_Result;
+		double m_Start;
+};
+
+//Parses a response as it is received
+
+class CXMLResponseReader: public MusicBrainz5::CResponseReader
+{
+	public:
+		CXMLResponseReader(std::string *Body=0)
+		:	m_Body(Body)
+		{
+		}
+
+		void Read(const char *Data, size_t Len)
+		{
+			m_Parser.parseChunk(Data,Len);
+
+			if (m_Body)
+				m_Body->append(Data,Len);
+		}
+
+		XMLNode *Finish(XMLResults *Results)
+		{
+			return m_Parser.finish(Results);
+		}
+
+	private:
+		XMLPushParser m_Parser;
+		std::string *m_Body;
+};
+
+MusicBrainz5::CQuery::CQuery(const std::string& UserAgent, const std::string& Server, int Port)
+:	m_d(new CQueryPrivate)
+{
+	m_d->m_UserAgent=UserAgent;
+	m_d->m_Server=Server;
+	m_d->m_Port=Port;
+}
+
+MusicBrainz5::CQuery::CQuery(const std::string& UserAgent, CTransport *Transport, const std::string& Server, int Port)
+:	m_d(new CQueryPrivate)
+{
+	m_d->m_UserAgent=UserAgent;
+	m_d->m_Server=Server;
+	m_d->m_Port=Port;
+
+	if (Transport)
+		m_d->m_Transport=Transport;
+}
+
+MusicBrainz5::CQuery::~CQuery()
+{
+	//Wait for any asynchronous queries in progress before the settings they use go away
+
+	delete m_d->m_Executor;
+	delete m_d->m_BatchExecutor;
+
+	m_d->ForgetLast();
+
+	delete m_d;
+}
+
+void MusicBrainz5::CQuery::SetUserName(const std::string& UserName)
+{
+	m_d->m_UserName=UserName;
+}
+
+void MusicBrainz5::CQuery::SetPassword(const std::string& Password)
+{
+	m_d->m_Password=Password;
+}
+
+void MusicBrainz5::CQuery::SetProxyHost(const std::string& ProxyHost)
+{
+	m_d->m_ProxyHost=ProxyHost;
+}
+
+void MusicBrainz5::CQuery::SetProxyPort(int ProxyPort)
+{
+	m_d->m_ProxyPort=ProxyPort;
+}
+
+void MusicBrainz5::CQuery::SetProxyUserName(const std::string& ProxyUserName)
+{
+	m_d->m_ProxyUserName=ProxyUserName;
+}
+
+void MusicBrainz5::CQuery::SetProxyPassword(const std::string& ProxyPassword)
+{
+	m_d->m_ProxyPassword=ProxyPassword;
+}
+
+void MusicBrainz5::CQuery::SetMaxIdleConnections(int MaxIdleConnections)
+{
+	m_d->m_HTTPTransport.SessionPool().SetMaxSessions(MaxIdleConnections);
+}
+
+void MusicBrainz5::CQuery::SetConnectionIdleTimeout(int IdleTimeout)
+{
+	m_d->m_HTTPTransport.SessionPool().SetIdleTimeout(IdleTimeout);
+}
+
+void MusicBrainz5::CQuery::SetRateLimiter(CRateLimiter *RateLimiter)
+{
+	m_d->m_RateLimiter=RateLimiter ? RateLimiter : &CRateLimiter::Default();
+}
+
+void MusicBrainz5::CQuery::SetResponseCache(CResponseCache *ResponseCache)
+{
+	m_d->m_ResponseCache=ResponseCache;
+}
+
+void MusicBrainz5::CQuery::SetDiskCache(CDiskCache *DiskCache)
+{
+	m_d->m_DiskCache=DiskCache;
+}
+
+void MusicBrainz5::CQuery::SetServeStale(bool ServeStale, CQueryCallback *RefreshCallback)
+{
+	m_d->m_ServeStale=ServeStale;
+	m_d->m_RefreshCallback=RefreshCallback;
+}
+
+void MusicBrainz5::CQuery::SetMaxRetries(int MaxRetries)
+{
+	m_d->m_MaxRetries=MaxRetries;
+}
+
+void MusicBrainz5::CQuery::SetCompression(bool Compression)
+{
+	m_d->m_Compression=Compression;
+}
+
+MusicBrainz5::CFetch *MusicBrainz5::CQuery::CreateFetch() const
+{
+	CFetch *Fetch=m_d->m_Transport->CreateFetch(UserAgent(),m_d->m_Server,m_d->m_Port);
+
+	if (!m_d->m_UserName.empty())
+		Fetch->SetUserName(m_d->m_UserName);
+
+	if (!m_d->m_Password.empty())
+		Fetch->SetPassword(m_d->m_Password);
+
+	if (!m_d->m_ProxyHost.empty())
+		Fetch->SetProxyHost(m_d->m_ProxyHost);
+
+	if (0!=m_d->m_ProxyPort)
+		Fetch->SetProxyPort(m_d->m_ProxyPort);
+
+	if (!m_d->m_ProxyUserName.empty())
+		Fetch->SetProxyUserName(m_d->m_ProxyUserName);
+
+	if (!m_d->m_ProxyPassword.empty())
+		Fetch->SetProxyPassword(m_d->m_ProxyPassword);
+
+	Fetch->SetCompression(m_d->m_Compression);
+
+	return Fetch;
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Query)
+{
+	CLookupResult Result;
+
+	try
+	{
+		CMetadata Metadata=PerformQuery(Query,Result);
+
+		CLastStatus& Last=m_d->Last();
+		Last.m_CompressedSize=Result.CompressedSize();
+		Last.m_UncompressedSize=Result.UncompressedSize();
+
+		return Metadata;
+	}
+
+	catch (CExceptionBase& Error)
+	{
+		CLastStatus& Last=m_d->Last();
+		Last.m_Result=Result.Result();
+		Last.m_HTTPCode=Result.HTTPCode();
+		Last.m_ErrorMessage=Result.ErrorMessage();
+
+		throw;
+	}
+}
+
+std::string MusicBrainz5::CQuery::RequestKey(const std::string& Query) const
+{
+	//Responses to authenticated queries may depend on the user
+
+	std::stringstream Host;
+
+	if (!m_d->m_UserName.empty())
+		Host << m_d->m_UserName << "@";
+
+	Host << m_d->m_Server << ":" << m_d->m_Port;
+
+	return CResponseCache::Key(Host.str(),Query);
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::PerformQuery(const std::string& Query, CLookupResult& Result, bool Refresh)
+{
+	std::string InvalidID;
+	if (!CheckQueryID(Query,InvalidID))
+	{
+		Result.m_d->m_Result=eQuery_RequestError;
+		Result.m_d->m_HTTPCode=0;
+		Result.m_d->m_ErrorMessage="Invalid MusicBrainz ID '"+InvalidID+"'";
+
+		throw CRequestError(Result.m_d->m_ErrorMessage);
+	}
+
+	//Refreshes are already limited to one at a time for each request
+
+	std::string Key=RequestKey(Query);
+
+	if (Refresh)
+		return FetchQuery(Query,Key,Result,true);
+
+	pthread_mutex_lock(&m_d->m_InFlightMutex);
+
+	std::map<std::string,CInFlightQuery *>::iterator Existing=m_d->m_InFlight.find(Key);
+	if (Existing!=m_d->m_InFlight.end())
+	{
+		//The same request is already being made by another thread, so wait for its result
+
+		double Start=Now();
+
+		CInFlightQuery *InFlight=(*Existing).second;
+		InFlight->m_References++;
+
+		while (!InFlight->m_Done)
+			pthread_cond_wait(&InFlight->m_Cond,&m_d->m_InFlightMutex);
+
+		std::string ID=Result.ID();
+		Result=InFlight->m_Result;
+		Result.m_d->m_ID=ID;
+
+		CMetadata Metadata=InFlight->m_Metadata;
+
+		if (0==--InFlight->m_References)
+			delete InFlight;
+
+		pthread_mutex_unlock(&m_d->m_InFlightMutex);
+
+		Result.m_d->m_WaitTime=Now()-Start;
+		Result.m_d->m_TotalTime=Result.m_d->m_WaitTime;
+		Result.m_d->m_Retries=0;
+
+		switch (Result.Result())
+		{
+			case eQuery_Success:
+				return Metadata;
+
+			case eQuery_ConnectionError:
+				throw CConnectionError(Result.ErrorMessage());
+
+			case eQuery_Timeout:
+				throw CTimeoutError(Result.ErrorMessage());
+
+			case eQuery_AuthenticationError:
+				throw CAuthenticationError(Result.ErrorMessage());
+
+			case eQuery_RequestError:
+				throw CRequestError(Result.ErrorMessage());
+
+			case eQuery_ResourceNotFound:
+				throw CResourceNotFoundError(Result.ErrorMessage());
+
+			default:
+				if (503==Result.HTTPCode())
+					throw CServiceUnavailableError(Result.ErrorMessage());
+
+				throw CFetchError(Result.ErrorMessage());
+		}
+	}
+
+	CInFlightQuery *InFlight=new CInFlightQuery;
+	m_d->m_InFlight[Key]=InFlight;
+
+	pthread_mutex_unlock(&m_d->m_InFlightMutex);
+
+	CMetadata Metadata;
+
+	try
+	{
+		Metadata=FetchQuery(Query,Key,Result,false);
+	}
+
+	catch (...)
+	{
+		if (eQuery_Success==Result.Result())
+		{
+			Result.m_d->m_Result=eQuery_FetchError;
+			Result.m_d->m_ErrorMessage="Query failed";
+		}
+
+		FinishQuery(Key,InFlight,Result,Metadata);
+
+		throw;
+	}
+
+	FinishQuery(Key,InFlight,Result,Metadata);
+
+	return Metadata;
+}
+
+void MusicBrainz5::CQuery::FinishQuery(const std::string& Key, CInFlightQuery *InFlight, const CLookupResult& Result, const CMetadata& Metadata)
+{
+	pthread_mutex_lock(&m_d->m_InFlightMutex);
+
+	m_d->m_InFlight.erase(Key);
+
+	if (InFlight->m_References>1)
+	{
+		InFlight->m_Result=Result;
+		InFlight->m_Metadata=Metadata;
+	}
+
+	InFlight->m_Done=true;
+	pthread_cond_broadcast(&InFlight->m_Cond);
+
+	if (0==--InFlight->m_References)
+		delete InFlight;
+
+	pthread_mutex_unlock(&m_d->m_InFlightMutex);
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::FetchQuery(const std::string& Query, const std::string& CacheKey, CLookupResult& Result, bool Refresh)
+{
+	double Start=Now();
+
+	Result.m_d->m_WaitTime=0;
+	Result.m_d->m_Retries=0;
+	Result.m_d->m_Cached=false;
+	Result.m_d->m_Stale=false;
+	Result.m_d->m_Changed=false;
+
+	//An expired response, which can be reused if the server says it hasn't changed
+
+	bool Stale=false;
+	bool StaleParsed=false;
+	CMetadata StaleMetadata;
+	std::string StaleBody;
+	size_t StaleSize=0;
+	std::string ETag;
+	std::string LastModified;
+
+	if (m_d->m_ResponseCache || m_d->m_DiskCache)
+	{
+		if ((m_d->m_ResponseCache && m_d->m_ResponseCache->NotFound(CacheKey)) ||
+				(m_d->m_DiskCache && m_d->m_DiskCache->NotFound(CacheKey)))
+		{
+			CLookupTimer Timer(Result.m_d,Start);
+
+			Result.m_d->m_Result=CQuery::eQuery_ResourceNotFound;
+			Result.m_d->m_HTTPCode=404;
+			Result.m_d->m_ErrorMessage="404 Not Found";
+			Result.m_d->m_CompressedSize=0;
+			Result.m_d->m_UncompressedSize=0;
+			Result.m_d->m_Cached=true;
+
+			throw CResourceNotFoundError(Result.m_d->m_ErrorMessage);
+		}
+
+		CMetadata Metadata;
+		bool Found=m_d->m_ResponseCache && m_d->m_ResponseCache->Get(CacheKey,Metadata);
+
+		std::string Body;
+		if (!Found && m_d->m_DiskCache && m_d->m_DiskCache->Get(CacheKey,Body))
+		{
+			XMLResults Results;
+			XMLNode *TopNode=XMLPushParser::parseString(Body,&Results);
+			if (Results.code==eXMLErrorNone && !TopNode->isEmpty())
+			{
+				Metadata=CMetadata(*TopNode);
+				Found=true;
+
+				if (m_d->m_ResponseCache)
+					m_d->m_ResponseCache->Put(CacheKey,Metadata,Body.size());
+			}
+			delete TopNode;
+		}
+
+		if (Found)
+		{
+			CLookupTimer Timer(Result.m_d,Start);
+
+			Result.m_d->m_Result=CQuery::eQuery_Success;
+			Result.m_d->m_HTTPCode=200;
+			Result.m_d->m_CompressedSize=0;
+			Result.m_d->m_UncompressedSize=0;
+			Result.m_d->m_Cached=true;
+
+			return Metadata;
+		}
+
+		if (m_d->m_ResponseCache && m_d->m_ResponseCache->GetStale(CacheKey,StaleMetadata,ETag,LastModified,StaleSize))
+		{
+			Stale=true;
+			StaleParsed=true;
+		}
+
+		//Responses copied from the disk cache to the response cache don't carry their validators
+
+		if (m_d->m_DiskCache && ETag.empty() && LastModified.empty() &&
+				m_d->m_DiskCache->GetStale(CacheKey,StaleBody,ETag,LastModified))
+		{
+			Stale=true;
+			StaleSize=StaleBody.size();
+		}
+
+		if (Stale && !StaleParsed && (m_d->m_ServeStale || !ETag.empty() || !LastModified.empty()))
+		{
+			XMLResults Results;
+			XMLNode *TopNode=XMLPushParser::parseString(StaleBody,&Results);
+			if (Results.code==eXMLErrorNone && !TopNode->isEmpty())
+			{
+				StaleMetadata=CMetadata(*TopNode);
+				StaleParsed=true;
+			}
+			delete TopNode;
+		}
+
+		if (StaleParsed && m_d->m_ServeStale && !Refresh)
+		{
+			//Only one refresh of each response is queued at a time
+
+			pthread_mutex_lock(&m_d->m_ExecutorMutex);
+			bool Queue=m_d->m_Refreshing.insert(Query).second;
+			pthread_mutex_unlock(&m_d->m_ExecutorMutex);
+
+			if (Queue)
+				SubmitTask(new CQueryTask(this,Query,Result.ID(),m_d->m_RefreshCallback));
+
+			CLookupTimer Timer(Result.m_d,Start);
+
+			Result.m_d->m_Result=CQuery::eQuery_Success;
+			Result.m_d->m_HTTPCode=200;
+			Result.m_d->m_CompressedSize=0;
+			Result.m_d->m_UncompressedSize=0;
+			Result.m_d->m_Cached=true;
+			Result.m_d->m_Stale=true;
+
+			return StaleMetadata;
+		}
+	}
+
+	for (int Retry=0;;Retry++)
+	{
+		double WaitStart=Now();
+
+		WaitRequest();
+
+		Result.m_d->m_WaitTime+=Now()-WaitStart;
+		Result.m_d->m_Retries=Retry;
+
+		CLookupTimer Timer(Result.m_d,Start);
+
+		CMetadata Metadata;
+
+		CFetch& Fetch=*CreateFetch();
+		CFetchOwner FetchOwner(&Fetch);
+
+		std::string Body;
+		CXMLResponseReader Reader(m_d->m_DiskCache || Stale ? &Body : 0);
+		Fetch.SetResponseReader(&Reader);
+
+		if (StaleParsed)
+		{
+			Fetch.SetRequestHeader("If-None-Match",ETag);
+			Fetch.SetRequestHeader("If-Modified-Since",LastModified);
+		}
+
+		try
+		{
+			int Ret=Fetch.Fetch(Query);
+
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			Result.m_d->m_Result=CQuery::eQuery_Success;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_CompressedSize=Fetch.CompressedSize();
+			Result.m_d->m_UncompressedSize=Fetch.UncompressedSize();
+
+#ifdef _MB5_DEBUG_
+			//std::cerr << "Ret: " << Ret << std::endl;
+#endif
+
+			if (304==Fetch.Status() && StaleParsed)
+			{
+				if (m_d->m_ResponseCache && !m_d->m_ResponseCache->Refresh(CacheKey))
+					m_d->m_ResponseCache->Put(CacheKey,StaleMetadata,StaleSize,ETag,LastModified);
+
+				if (m_d->m_DiskCache)
+					m_d->m_DiskCache->Refresh(CacheKey);
+
+				Result.m_d->m_Cached=true;
+
+				return StaleMetadata;
+			}
+
+			if (Ret>0)
+			{
+				XMLResults Results;
+				XMLNode *TopNode = Reader.Finish(&Results);
+				if (Results.code==eXMLErrorNone)
+				{
+					XMLNode MetadataNode=*TopNode;
+					if (!MetadataNode.isEmpty())
+					{
+						Metadata=CMetadata(MetadataNode);
+
+						if (m_d->m_ResponseCache)
+							m_d->m_ResponseCache->Put(CacheKey,Metadata,Fetch.UncompressedSize(),Fetch.ResponseHeader("ETag"),Fetch.ResponseHeader("Last-Modified"));
+
+						if (m_d->m_DiskCache)
+							m_d->m_DiskCache->Put(CacheKey,Body,Fetch.ResponseHeader("ETag"),Fetch.ResponseHeader("Last-Modified"));
+
+						//A response with the same ETag or body as the expired one hasn't changed
+
+						if (StaleParsed)
+							Result.m_d->m_Changed=(ETag.empty() || ETag!=Fetch.ResponseHeader("ETag")) &&
+								(StaleBody.empty() || StaleBody!=Body);
+					}
+				}
+				delete TopNode;
+			}
+
+			return Metadata;
+		}
+
+		catch (CServiceUnavailableError& Error)
+		{
+			double Delay=RetryAfter(Fetch.ResponseHeader("Retry-After"));
+
+			m_d->m_RateLimiter->Throttled(m_d->m_Server,Delay);
+
+			if (Retry>=m_d->m_MaxRetries)
+			{
+				Result.m_d->m_Result=CQuery::eQuery_FetchError;
+				Result.m_d->m_HTTPCode=Fetch.Status();
+				Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+				throw;
+			}
+
+			//Exponential backoff, with jitter so that clients that were rejected together
+			//don't all come back together
+
+			unsigned int Seed=__sync_add_and_fetch(&m_d->m_RandomSeed,0x9e3779b9);
+			double Backoff=1<<(Retry<6 ? Retry : 6);
+			Backoff=Backoff/2+Backoff/2*rand_r(&Seed)/RAND_MAX;
+
+			double SleepStart=Now();
+
+			Sleep(Backoff>Delay ? Backoff : Delay);
+
+			Result.m_d->m_WaitTime+=Now()-SleepStart;
+		}
+
+		catch (CConnectionError& Error)
+		{
+			Result.m_d->m_Result=CQuery::eQuery_ConnectionError;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CTimeoutError& Error)
+		{
+			Result.m_d->m_Result=CQuery::eQuery_Timeout;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CAuthenticationError& Error)
+		{
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			Result.m_d->m_Result=CQuery::eQuery_AuthenticationError;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CFetchError& Error)
+		{
+			//Any answer other than 503 shows the server isn't overloaded, but a
+			//transfer that failed without an answer shows nothing
+
+			if (0!=Fetch.Status())
+				m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			Result.m_d->m_Result=CQuery::eQuery_FetchError;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CRequestError& Error)
+		{
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			Result.m_d->m_Result=CQuery::eQuery_RequestError;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CResourceNotFoundError& Error)
+		{
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			Result.m_d->m_Result=CQuery::eQuery_ResourceNotFound;
+			Result.m_d->m_HTTPCode=Fetch.Status();
+			Result.m_d->m_ErrorMessage=Fetch.ErrorMessage();
+
+			if (m_d->m_ResponseCache)
+				m_d->m_ResponseCache->PutNotFound(CacheKey);
+
+			if (m_d->m_DiskCache)
+				m_d->m_DiskCache->PutNotFound(CacheKey);
+
+			throw;
+		}
+	}
+}
+
+std::string MusicBrainz5::CQuery::BuildQuery(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
+{
+	std::stringstream os;
+
+	os << "/ws/2/" << Entity;
+
+	if (!ID.empty())
+	{
+		os << "/" << ID;
+
+		if (!Resource.empty())
+			os << "/" << Resource;
+	}
+
+	if (!Params.empty())
+		os << "?" << URLEncode(Params);
+
+	return os.str();
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQuery::Query(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
+{
+	std::string Query=BuildQuery(Entity,ID,Resource,Params);
+
+#ifdef _MB5_DEBUG_
+	//std::cerr << "Query is '" << Query << "'" << std::endl;
+#endif
+
+	return PerformQuery(Query);
+}
+
+MusicBrainz5::CLookupResult MusicBrainz5::CQuery::Lookup(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
+{
+	CLookupResult Result(ID);
+
+	try
+	{
+		Result.m_d->m_Metadata=PerformQuery(BuildQuery(Entity,ID,Resource,Params),Result);
+	}
+
+	catch (CExceptionBase& Error)
+	{
+	}
+
+	return Result;
+}
+
+MusicBrainz5::CReleaseList MusicBrainz5::CQuery::LookupDiscID(const std::string& DiscID)
+{
+	//Will this work soon (and return disc IDs as well)?
+	//http://musicbrainz.org/ws/2/discid/arIS30RPWowvwNEqsqdDnZzDGhk-?inc=artists+labels+recordings+release-groups+artist-credits
+
+	MusicBrainz5::CReleaseList ReleaseList;
+
+	CMetadata Metadata=Query("discid",DiscID);
+
+	CDisc *Disc=Metadata.Disc();
+	if (Disc && Disc->ReleaseList())
+	{
+#ifdef LIBMB5_MOVE_SEMANTICS
+		ReleaseList=std::move(*Disc->ReleaseList());
+#else
+		ReleaseList=*Disc->ReleaseList();
+#endif
+	}
+
+	return ReleaseList;
+}
+
+MusicBrainz5::CRelease MusicBrainz5::CQuery::LookupRelease(const std::string& ReleaseID)
+{
+	MusicBrainz5::CRelease Release;
+
+	tParamMap Params;
+	Params["inc"]="artists labels recordings release-groups url-rels discids artist-credits";
+
+	CMetadata Metadata=Query("release",ReleaseID,"",Params);
+	if (Metadata.Release())
+	{
+#ifdef LIBMB5_MOVE_SEMANTICS
+		Release=std::move(*Metadata.Release());
+#else
+		Release=*Metadata.Release();
+#endif
+	}
+
+	return Release;
+}
+
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupReleases(const std::vector<std::string>& ReleaseIDs)
+{
+	tParamMap Params;
+	Params["inc"]="artists labels recordings release-groups url-rels discids artist-credits";
+
+	return LookupBatch("release",ReleaseIDs,Params);
+}
+
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupArtists(const std::vector<std::string>& ArtistIDs, const tParamMap& Params)
+{
+	return LookupBatch("artist",ArtistIDs,Params);
+}
+
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupRecordings(const std::vector<std::string>& RecordingIDs, const tParamMap& Params)
+{
+	return LookupBatch("recording",RecordingIDs,Params);
+}
 
-	if (!m_d->m_ProxyHost.empty())
-		Fetch.SetProxyHost(m_d->m_ProxyHost);
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupLabels(const std::vector<std::string>& LabelIDs, const tParamMap& Params)
+{
+	return LookupBatch("label",LabelIDs,Params);
+}
 
-	if (0!=m_d->m_ProxyPort)
-		Fetch.SetProxyPort(m_d->m_ProxyPort);
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupWorks(const std::vector<std::string>& WorkIDs, const tParamMap& Params)
+{
+	return LookupBatch("work",WorkIDs,Params);
+}
 
-	if (!m_d->m_ProxyUserName.empty())
-		Fetch.SetProxyUserName(m_d->m_ProxyUserName);
+std::vector<MusicBrainz5::CLookupResult> MusicBrainz5::CQuery::LookupBatch(const std::string& Entity, const std::vector<std::string>& IDs, const tParamMap& Params)
+{
+	//Only look up each ID once
 
-	if (!m_d->m_ProxyPassword.empty())
-		Fetch.SetProxyPassword(m_d->m_ProxyPassword);
+	std::map<std::string,int> Unique;
+	std::vector<int> Item;
+	std::vector<std::string> URLs;
+	std::vector<CLookupResult> UniqueResults;
 
-	try
+	for (std::vector<std::string>::size_type count=0;count<IDs.size();count++)
 	{
-		int Ret=Fetch.Fetch(Query);
+		const std::string& ID=IDs[count];
 
-#ifdef _MB5_DEBUG_
-		//std::cerr << "Ret: " << Ret << std::endl;
-#endif
-
-		if (Ret>0)
+		std::map<std::string,int>::const_iterator ThisID=Unique.find(ID);
+		if (ThisID==Unique.end())
 		{
-			std::vector<unsigned char> Data=Fetch.Data();
-			std::string strData(Data.begin(),Data.end());
-
-#ifdef _MB5_DEBUG_
-			//std::cerr << "Ret is '" << strData << "'" << std::endl;
-#endif
-
-			XMLResults Results;
-			XMLNode *TopNode = XMLRootNode::parseString(strData, &Results);
-			if (Results.code==eXMLErrorNone)
-			{
-				XMLNode MetadataNode=*TopNode;
-				if (!MetadataNode.isEmpty())
-				{
-					Metadata=CMetadata(MetadataNode);
-				}
-			}
-			delete TopNode;
+			ThisID=Unique.insert(std::make_pair(ID,(int)URLs.size())).first;
+			URLs.push_back(BuildQuery(Entity,ID,"",Params));
+			UniqueResults.push_back(CLookupResult(ID));
 		}
+
+		Item.push_back((*ThisID).second);
 	}
 
-	catch (CConnectionError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_ConnectionError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+	int Threads=m_d->m_BatchConcurrency;
+	if (Threads>(int)URLs.size())
+		Threads=URLs.size();
+	if (Threads<1)
+		Threads=1;
 
-		throw;
-	}
+	CQueryBatch Batch(this,URLs,UniqueResults);
+	Batch.Run(Threads);
 
-	catch (CTimeoutError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_Timeout;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+	std::vector<CLookupResult> Results;
+	Results.reserve(IDs.size());
 
-		throw;
-	}
+	for (std::vector<int>::size_type count=0;count<Item.size();count++)
+		Results.push_back(UniqueResults[Item[count]]);
 
-	catch (CAuthenticationError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_AuthenticationError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+	return Results;
+}
 
-		throw;
-	}
+void MusicBrainz5::CQuery::SetBatchConcurrency(int Concurrency)
+{
+	pthread_mutex_lock(&m_d->m_ExecutorMutex);
 
-	catch (CFetchError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_FetchError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+	m_d->m_BatchConcurrency=Concurrency;
 
-		throw;
-	}
+	//The thread calling LookupBatch is one of the threads doing the work
 
-	catch (CRequestError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_RequestError;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+	if (m_d->m_BatchExecutor)
+		m_d->m_BatchExecutor->SetThreads(Concurrency-1);
 
-		throw;
-	}
+	pthread_mutex_unlock(&m_d->m_ExecutorMutex);
+}
 
-	catch (CResourceNotFoundError& Error)
-	{
-		m_d->m_LastResult=CQuery::eQuery_ResourceNotFound;
-		m_d->m_LastHTTPCode=Fetch.Status();
-		m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+MusicBrainz5::CQueryFuture MusicBrainz5::CQuery::QueryAsync(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params, CQueryCallback *Callback)
+{
+	CQueryFuture Future;
+	Future.m_d=new CQueryFuturePrivate(ID,Callback);
 
-		throw;
-	}
+	SubmitTask(new CQueryTask(this,BuildQuery(Entity,ID,Resource,Params),Future.m_d));
 
-	return Metadata;
+	return Future;
 }
 
-MusicBrainz5::CMetadata MusicBrainz5::CQuery::Query(const std::string& Entity, const std::string& ID, const std::string& Resource, const tParamMap& Params)
+void MusicBrainz5::CQuery::SubmitTask(CQueryTask *Task)
 {
-	std::stringstream os;
-
-	os << "/ws/2/" << Entity;
+	pthread_mutex_lock(&m_d->m_ExecutorMutex);
 
-	if (!ID.empty())
+	if (!m_d->m_Executor)
 	{
-		os << "/" << ID;
-
-		if (!Resource.empty())
-			os << "/" << Resource;
+		m_d->m_Executor=new CQueryExecutor(m_d->m_AsyncThreads);
 	}
 
-	if (!Params.empty())
-		os << "?" << URLEncode(Params);
-
-#ifdef _MB5_DEBUG_
-	//std::cerr << "Query is '" << os.str() << "'" << std::endl;
-#endif
+	m_d->m_Executor->Submit(Task);
 
-	return PerformQuery(os.str());
+	pthread_mutex_unlock(&m_d->m_ExecutorMutex);
 }
 
-MusicBrainz5::CReleaseList MusicBrainz5::CQuery::LookupDiscID(const std::string& DiscID)
+void MusicBrainz5::CQuery::SubmitBatchTask(CQueryTask *Task)
 {
-	//Will this work soon (and return disc IDs as well)?
-	//http://musicbrainz.org/ws/2/discid/arIS30RPWowvwNEqsqdDnZzDGhk-?inc=artists+labels+recordings+release-groups+artist-credits
-
-	MusicBrainz5::CReleaseList ReleaseList;
+	pthread_mutex_lock(&m_d->m_ExecutorMutex);
 
-	CMetadata Metadata=Query("discid",DiscID);
+	if (!m_d->m_BatchExecutor)
+		m_d->m_BatchExecutor=new CQueryExecutor(m_d->m_BatchConcurrency-1);
 
-	CDisc *Disc=Metadata.Disc();
-	if (Disc && Disc->ReleaseList())
-		ReleaseList=*Disc->ReleaseList();
+	m_d->m_BatchExecutor->Submit(Task);
 
-	return ReleaseList;
+	pthread_mutex_unlock(&m_d->m_ExecutorMutex);
 }
 
-MusicBrainz5::CRelease MusicBrainz5::CQuery::LookupRelease(const std::string& ReleaseID)
+void MusicBrainz5::CQuery::RefreshFinished(const std::string& Query)
 {
-	MusicBrainz5::CRelease Release;
+	pthread_mutex_lock(&m_d->m_ExecutorMutex);
+	m_d->m_Refreshing.erase(Query);
+	pthread_mutex_unlock(&m_d->m_ExecutorMutex);
+}
 
+MusicBrainz5::CQueryFuture MusicBrainz5::CQuery::LookupReleaseAsync(const std::string& ReleaseID, CQueryCallback *Callback)
+{
 	tParamMap Params;
 	Params["inc"]="artists labels recordings release-groups url-rels discids artist-credits";
 
-	CMetadata Metadata=Query("release",ReleaseID,"",Params);
-	if (Metadata.Release())
-		Release=*Metadata.Release();
-
-	return Release;
+	return QueryAsync("release",ReleaseID,"",Params,Callback);
 }
 
-void MusicBrainz5::CQuery::WaitRequest() const
+void MusicBrainz5::CQuery::SetAsyncThreads(int Threads)
 {
-	if (m_d->m_Server.find("musicbrainz.org")!=std::string::npos)
-	{
-		static struct timeval LastRequest;
-		const int TimeBetweenRequests=2;
+	pthread_mutex_lock(&m_d->m_ExecutorMutex);
 
-		struct timeval TimeNow;
-		gettimeofday(&TimeNow,0);
+	m_d->m_AsyncThreads=Threads;
 
-		if (LastRequest.tv_sec!=0 || LastRequest.tv_usec!=0)
-		{
-			struct timeval Diff;
-
-			do
-			{
-				gettimeofday(&TimeNow,0);
-				timersub(&TimeNow,&LastRequest,&Diff);
+	if (m_d->m_Executor)
+		m_d->m_Executor->SetThreads(Threads);
 
-				if (Diff.tv_sec<TimeBetweenRequests)
-					usleep(100000);
-			}	while (Diff.tv_sec<TimeBetweenRequests);
-		}
+	pthread_mutex_unlock(&m_d->m_ExecutorMutex);
+}
 
-		memcpy(&LastRequest,&TimeNow,sizeof(LastRequest));
-	}
+void MusicBrainz5::CQuery::WaitRequest() const
+{
+	m_d->m_RateLimiter->Acquire(m_d->m_Server);
 }
 
 bool MusicBrainz5::CQuery::AddCollectionEntries(const std::string& CollectionID, const std::vector<std::string>& Entries)
@@ -324,7 +1688,27 @@ bool MusicBrainz5::CQuery::DeleteCollectionEntries(const std::string& Collection
 
 bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const std::vector<std::string>& Entries, const std::string& Action)
 {
-	bool RetVal=false;
+	bool RetVal=true;
+
+	//Don't send a request the server would reject because of an invalid ID
+
+	bool Valid=CMBID::IsValid(CollectionID);
+	std::string InvalidID=CollectionID;
+
+	for (std::vector<std::string>::const_iterator ThisEntry=Entries.begin();Valid && ThisEntry!=Entries.end();++ThisEntry)
+	{
+		Valid=CMBID::IsValid(*ThisEntry);
+		InvalidID=*ThisEntry;
+	}
+
+	if (!Valid)
+	{
+		m_d->Last().m_Result=CQuery::eQuery_RequestError;
+		m_d->Last().m_HTTPCode=0;
+		m_d->Last().m_ErrorMessage="Invalid MusicBrainz ID '"+InvalidID+"'";
+
+		throw CRequestError(m_d->Last().m_ErrorMessage);
+	}
 
 	std::vector<std::string> ToProcess=Entries;
 
@@ -354,25 +1738,15 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 
 		Query+="?client="+m_d->m_UserAgent;
 
-		CHTTPFetch Fetch(UserAgent(),m_d->m_Server,m_d->m_Port);
-
-		if (!m_d->m_UserName.empty())
-			Fetch.SetUserName(m_d->m_UserName);
-
-		if (!m_d->m_Password.empty())
-			Fetch.SetPassword(m_d->m_Password);
-
-		if (!m_d->m_ProxyHost.empty())
-			Fetch.SetProxyHost(m_d->m_ProxyHost);
+		//Edits count towards the rate limit like any other request
 
-		if (0!=m_d->m_ProxyPort)
-			Fetch.SetProxyPort(m_d->m_ProxyPort);
+		WaitRequest();
 
-		if (!m_d->m_ProxyUserName.empty())
-			Fetch.SetProxyUserName(m_d->m_ProxyUserName);
+		CFetch& Fetch=*CreateFetch();
+		CFetchOwner FetchOwner(&Fetch);
 
-		if (!m_d->m_ProxyPassword.empty())
-			Fetch.SetProxyPassword(m_d->m_ProxyPassword);
+		CXMLResponseReader Reader;
+		Fetch.SetResponseReader(&Reader);
 
 		try
 		{
@@ -382,21 +1756,22 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 
 			int Ret=Fetch.Fetch(Query,Action);
 
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
 #ifdef _MB5_DEBUG_
 			//std::cerr << "Collection Ret: " << Ret << std::endl;
 #endif
 
-			if (Ret>0)
-			{
-				std::vector<unsigned char> Data=Fetch.Data();
-				std::string strData(Data.begin(),Data.end());
+			ForgetCollection(CollectionID);
 
-#ifdef _MB5_DEBUG_
-				//std::cerr << "Collection " << Action << " ret is '" << strData << "'" << std::endl;
-#endif
+			//Only a response with an OK message confirms the edit
+
+			bool Confirmed=false;
 
+			if (Ret>0)
+			{
 				XMLResults Results;
-				XMLNode *TopNode = XMLRootNode::parseString(strData, &Results);
+				XMLNode *TopNode = Reader.Finish(&Results);
 				if (Results.code==eXMLErrorNone)
 				{
 					XMLNode MetadataNode=*TopNode;
@@ -405,63 +1780,86 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 						CMetadata Metadata(MetadataNode);
 
 						if (Metadata.Message() && Metadata.Message()->Text()=="OK")
-							RetVal=RetVal && true;
+							Confirmed=true;
 					}
 				}
 				delete TopNode;
 			}
+
+			if (!Confirmed)
+				RetVal=false;
 		}
 
 		catch (CConnectionError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_ConnectionError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			m_d->Last().m_Result=CQuery::eQuery_ConnectionError;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
 
 		catch (CTimeoutError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_Timeout;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			m_d->Last().m_Result=CQuery::eQuery_Timeout;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
 
 		catch (CAuthenticationError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_AuthenticationError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			m_d->Last().m_Result=CQuery::eQuery_AuthenticationError;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
+
+			throw;
+		}
+
+		catch (CServiceUnavailableError& Error)
+		{
+			m_d->m_RateLimiter->Throttled(m_d->m_Server,RetryAfter(Fetch.ResponseHeader("Retry-After")));
+
+			m_d->Last().m_Result=CQuery::eQuery_FetchError;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
 
 		catch (CFetchError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_FetchError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			if (0!=Fetch.Status())
+				m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			m_d->Last().m_Result=CQuery::eQuery_FetchError;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
 
 		catch (CRequestError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_RequestError;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			m_d->Last().m_Result=CQuery::eQuery_RequestError;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
 
 		catch (CResourceNotFoundError& Error)
 		{
-			m_d->m_LastResult=CQuery::eQuery_ResourceNotFound;
-			m_d->m_LastHTTPCode=Fetch.Status();
-			m_d->m_LastErrorMessage=Fetch.ErrorMessage();
+			m_d->m_RateLimiter->Succeeded(m_d->m_Server);
+
+			m_d->Last().m_Result=CQuery::eQuery_ResourceNotFound;
+			m_d->Last().m_HTTPCode=Fetch.Status();
+			m_d->Last().m_ErrorMessage=Fetch.ErrorMessage();
 
 			throw;
 		}
@@ -470,6 +1868,39 @@ bool MusicBrainz5::CQuery::EditCollection(const std::string& CollectionID, const
 	return RetVal;
 }
 
+void MusicBrainz5::CQuery::ForgetCollection(const std::string& CollectionID)
+{
+	//The collection may have been looked up with or without the user name, and the
+	//list of the user's collections holds the number of releases in each
+
+	std::stringstream Server;
+	Server << m_d->m_Server << ":" << m_d->m_Port;
+
+	std::vector<std::string> Hosts;
+	Hosts.push_back(Server.str());
+	if (!m_d->m_UserName.empty())
+		Hosts.push_back(m_d->m_UserName+"@"+Server.str());
+
+	for (std::vector<std::string>::const_iterator ThisHost=Hosts.begin();ThisHost!=Hosts.end();++ThisHost)
+	{
+		std::string Collections=*ThisHost+"/ws/2/collection";
+
+		if (m_d->m_ResponseCache)
+		{
+			m_d->m_ResponseCache->RemovePrefix(Collections+"/"+CollectionID);
+			m_d->m_ResponseCache->RemovePrefix(Collections+"?");
+			m_d->m_ResponseCache->Remove(Collections);
+		}
+
+		if (m_d->m_DiskCache)
+		{
+			m_d->m_DiskCache->RemovePrefix(Collections+"/"+CollectionID);
+			m_d->m_DiskCache->RemovePrefix(Collections+"?");
+			m_d->m_DiskCache->Remove(Collections);
+		}
+	}
+}
+
 std::string MusicBrainz5::CQuery::UserAgent() const
 {
 	std::string UserAgent=m_d->m_UserAgent;
@@ -507,17 +1938,251 @@ std::string MusicBrainz5::CQuery::URLEncode(const std::map<std::string,std::stri
 
 MusicBrainz5::CQuery::tQueryResult MusicBrainz5::CQuery::LastResult() const
 {
-	return m_d->m_LastResult;
+	return m_d->Last().m_Result;
 }
 
 int MusicBrainz5::CQuery::LastHTTPCode() const
 {
-	return m_d->m_LastHTTPCode;
+	return m_d->Last().m_HTTPCode;
 }
 
 std::string MusicBrainz5::CQuery::LastErrorMessage() const
 {
-	return m_d->m_LastErrorMessage;
+	return m_d->Last().m_ErrorMessage;
+}
+
+int MusicBrainz5::CQuery::LastCompressedSize() const
+{
+	return m_d->Last().m_CompressedSize;
+}
+
+int MusicBrainz5::CQuery::LastUncompressedSize() const
+{
+	return m_d->Last().m_UncompressedSize;
+}
+
+MusicBrainz5::CLookupResult::CLookupResult(const std::string& ID)
+:	m_d(new CLookupResultPrivate)
+{
+	m_d->m_ID=ID;
+}
+
+MusicBrainz5::CLookupResult::CLookupResult(const CLookupResult& Other)
+:	m_d(new CLookupResultPrivate)
+{
+	*this=Other;
+}
+
+MusicBrainz5::CLookupResult& MusicBrainz5::CLookupResult::operator =(const CLookupResult& Other)
+{
+	if (this!=&Other)
+		*m_d=*Other.m_d;
+
+	return *this;
+}
+
+MusicBrainz5::CLookupResult::~CLookupResult()
+{
+	delete m_d;
+}
+
+std::string MusicBrainz5::CLookupResult::ID() const
+{
+	return m_d->m_ID;
+}
+
+MusicBrainz5::CQuery::tQueryResult MusicBrainz5::CLookupResult::Result() const
+{
+	return m_d->m_Result;
+}
+
+int MusicBrainz5::CLookupResult::HTTPCode() const
+{
+	return m_d->m_HTTPCode;
+}
+
+std::string MusicBrainz5::CLookupResult::ErrorMessage() const
+{
+	return m_d->m_ErrorMessage;
+}
+
+int MusicBrainz5::CLookupResult::CompressedSize() const
+{
+	return m_d->m_CompressedSize;
+}
+
+int MusicBrainz5::CLookupResult::UncompressedSize() const
+{
+	return m_d->m_UncompressedSize;
+}
+
+double MusicBrainz5::CLookupResult::WaitTime() const
+{
+	return m_d->m_WaitTime;
+}
+
+double MusicBrainz5::CLookupResult::FetchTime() const
+{
+	return m_d->m_TotalTime-m_d->m_WaitTime;
+}
+
+double MusicBrainz5::CLookupResult::TotalTime() const
+{
+	return m_d->m_TotalTime;
+}
+
+int MusicBrainz5::CLookupResult::Retries() const
+{
+	return m_d->m_Retries;
+}
+
+bool MusicBrainz5::CLookupResult::Cached() const
+{
+	return m_d->m_Cached;
+}
+
+bool MusicBrainz5::CLookupResult::Stale() const
+{
+	return m_d->m_Stale;
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CLookupResult::Metadata() const
+{
+	return m_d->m_Metadata;
+}
+
+MusicBrainz5::CQueryCallback::~CQueryCallback()
+{
+}
+
+MusicBrainz5::CQueryFuture::CQueryFuture()
+:	m_d(0)
+{
+}
+
+MusicBrainz5::CQueryFuture::CQueryFuture(const CQueryFuture& Other)
+:	m_d(Other.m_d)
+{
+	if (m_d)
+		m_d->AddReference();
+}
+
+MusicBrainz5::CQueryFuture& MusicBrainz5::CQueryFuture::operator =(const CQueryFuture& Other)
+{
+	if (Other.m_d)
+		Other.m_d->AddReference();
+
+	if (m_d)
+		m_d->Release();
+
+	m_d=Other.m_d;
+
+	return *this;
+}
+
+MusicBrainz5::CQueryFuture::~CQueryFuture()
+{
+	if (m_d)
+		m_d->Release();
+}
+
+bool MusicBrainz5::CQueryFuture::Valid() const
+{
+	return 0!=m_d;
+}
+
+bool MusicBrainz5::CQueryFuture::Ready() const
+{
+	return Wait(0);
+}
+
+bool MusicBrainz5::CQueryFuture::Wait(int Timeout) const
+{
+	if (!m_d)
+		return false;
+
+	struct timespec Until;
+	if (Timeout>0)
+	{
+		clock_gettime(CLOCK_REALTIME,&Until);
+		Until.tv_sec+=Timeout/1000;
+		Until.tv_nsec+=(Timeout%1000)*1000000;
+		if (Until.tv_nsec>=1000000000)
+		{
+			Until.tv_sec++;
+			Until.tv_nsec-=1000000000;
+		}
+	}
+
+	pthread_mutex_lock(&m_d->m_Mutex);
+
+	while (!m_d->m_Done && 0!=Timeout)
+	{
+		if (Timeout<0)
+			pthread_cond_wait(&m_d->m_Cond,&m_d->m_Mutex);
+		else if (ETIMEDOUT==pthread_cond_timedwait(&m_d->m_Cond,&m_d->m_Mutex,&Until))
+			break;
+	}
+
+	bool Done=m_d->m_Done;
+
+	pthread_mutex_unlock(&m_d->m_Mutex);
+
+	return Done;
+}
+
+MusicBrainz5::CLookupResult MusicBrainz5::CQueryFuture::Result() const
+{
+	if (!m_d)
+		return CLookupResult();
+
+	Wait();
+
+	pthread_mutex_lock(&m_d->m_Mutex);
+	CLookupResult Result=m_d->m_Result;
+	pthread_mutex_unlock(&m_d->m_Mutex);
+
+	return Result;
+}
+
+MusicBrainz5::CMetadata MusicBrainz5::CQueryFuture::Get() const
+{
+	CLookupResult Result=this->Result();
+
+	switch (Result.Result())
+	{
+		case CQuery::eQuery_Success:
+			break;
+
+		case CQuery::eQuery_ConnectionError:
+			throw CConnectionError(Result.ErrorMessage());
+			break;
+
+		case CQuery::eQuery_Timeout:
+			throw CTimeoutError(Result.ErrorMessage());
+			break;
+
+		case CQuery::eQuery_AuthenticationError:
+			throw CAuthenticationError(Result.ErrorMessage());
+			break;
+
+		case CQuery::eQuery_FetchError:
+			if (503==Result.HTTPCode())
+				throw CServiceUnavailableError(Result.ErrorMessage());
+
+			throw CFetchError(Result.ErrorMessage());
+			break;
+
+		case CQuery::eQuery_RequestError:
+			throw CRequestError(Result.ErrorMessage());
+			break;
+
+		case CQuery::eQuery_ResourceNotFound:
+			throw CResourceNotFoundError(Result.ErrorMessage());
+			break;
+	}
+
+	return Result.Metadata();
 }
 
 std::string MusicBrainz5::CQuery::Version() const
@@ -0,0 +1,533 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/RateLimiter.h"
+
+#include <map>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//Layout of the file used to share buckets between processes. A zero filled file
+//is a valid, empty, table. Slots are only claimed while holding an flock() on the
+//file, which is released by the kernel if a process dies, so a slot is never left
+//half claimed. Once claimed, the times and intervals in a slot are updated with
+//atomic operations.
+
+namespace
+{
+	const int SharedVersion=2;
+	const int SharedSlots=64;
+
+	enum tSlotState
+	{
+		eSlotFree=0,
+		eSlotReady
+	};
+
+	struct CSharedSlot
+	{
+		volatile int m_State;
+		char m_Host[236];
+		volatile long long m_Next;
+		volatile long long m_Interval;
+	};
+
+	struct CSharedFile
+	{
+		volatile int m_Version;
+		int m_Reserved;
+		CSharedSlot m_Slots[SharedSlots];
+	};
+}
+
+class MusicBrainz5::CRateLimiterPrivate
+{
+	public:
+		//The bucket is stored as the 'theoretical arrival time' of the next request
+		//(the generic cell rate algorithm). A request may go once the current time
+		//is no more than (Burst-1) intervals before it, and each request moves it on
+		//by one interval. This is equivalent to a token bucket, but needs no refill,
+		//so a single compare and swap is enough to take a token.
+
+		class CBucket
+		{
+		public:
+			CBucket(long long Interval=0, int Burst=1)
+			:	m_MinInterval(Interval),
+				m_Burst(Burst>1 ? Burst : 1),
+				m_LocalNext(0),
+				m_LocalInterval(Interval),
+				m_SharedNext(0),
+				m_SharedInterval(0)
+			{
+			}
+
+			//The configured interval is the minimum, the current interval grows when
+			//the server is overloaded. When the bucket is shared the current interval
+			//is shared too, so every process slows down when one is throttled.
+
+			long long m_MinInterval;
+			int m_Burst;
+			volatile long long m_LocalNext;
+			volatile long long m_LocalInterval;
+			volatile long long *m_SharedNext;
+			volatile long long *m_SharedInterval;
+
+			volatile long long *Next()
+			{
+				return m_SharedNext ? m_SharedNext : &m_LocalNext;
+			}
+
+			volatile long long *IntervalPtr()
+			{
+				return m_SharedInterval ? m_SharedInterval : &m_LocalInterval;
+			}
+
+			//Processes may configure different limits for a host, so each never goes
+			//faster than its own limit
+
+			long long Interval() const
+			{
+				long long Interval=m_SharedInterval ? *m_SharedInterval : m_LocalInterval;
+
+				return Interval>m_MinInterval ? Interval : m_MinInterval;
+			}
+
+			long long Tolerance(long long Interval) const
+			{
+				return Interval*(m_Burst-1);
+			}
+		};
+
+		CRateLimiterPrivate()
+		:	m_SharedFD(-1),
+			m_Shared(0)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CRateLimiterPrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		pthread_mutex_t m_Mutex;
+		std::map<std::string,CBucket> m_Buckets;
+		std::string m_SharedFile;
+		int m_SharedFD;
+		CSharedFile *m_Shared;
+
+		CBucket *Find(const std::string& Host);
+		const CBucket *Find(const std::string& Host) const;
+		void Attach(const std::string& Host, CBucket& Bucket);
+		long long Take(CBucket& Bucket, bool Wait, long long TimeNow);
+};
+
+//Holds a mutex locked for as long as it is in scope
+
+class CRateLimiterLock
+{
+	public:
+		CRateLimiterLock(pthread_mutex_t *Mutex)
+		:	m_Mutex(Mutex)
+		{
+			pthread_mutex_lock(m_Mutex);
+		}
+
+		~CRateLimiterLock()
+		{
+			pthread_mutex_unlock(m_Mutex);
+		}
+
+	private:
+		pthread_mutex_t *m_Mutex;
+};
+
+MusicBrainz5::CRateLimiterPrivate::CBucket *MusicBrainz5::CRateLimiterPrivate::Find(const std::string& Host)
+{
+	std::map<std::string,CBucket>::iterator ThisBucket=m_Buckets.begin();
+	while (ThisBucket!=m_Buckets.end())
+	{
+		const std::string& Domain=(*ThisBucket).first;
+
+		if (Host==Domain ||
+				(Host.length()>Domain.length() &&
+					'.'==Host[Host.length()-Domain.length()-1] &&
+					0==Host.compare(Host.length()-Domain.length(),Domain.length(),Domain)))
+			return &(*ThisBucket).second;
+
+		++ThisBucket;
+	}
+
+	return 0;
+}
+
+const MusicBrainz5::CRateLimiterPrivate::CBucket *MusicBrainz5::CRateLimiterPrivate::Find(const std::string& Host) const
+{
+	return const_cast<CRateLimiterPrivate *>(this)->Find(Host);
+}
+
+void MusicBrainz5::CRateLimiterPrivate::Attach(const std::string& Host, CBucket& Bucket)
+{
+	Bucket.m_SharedNext=0;
+	Bucket.m_SharedInterval=0;
+
+	if (!m_Shared || Host.length()>=sizeof(m_Shared->m_Slots[0].m_Host))
+		return;
+
+	while (0!=flock(m_SharedFD,LOCK_EX) && EINTR==errno)
+		;
+
+	CSharedSlot *Found=0;
+	CSharedSlot *Free=0;
+
+	for (int count=0;!Found && count<SharedSlots;count++)
+	{
+		CSharedSlot& Slot=m_Shared->m_Slots[count];
+
+		if (eSlotReady==Slot.m_State)
+		{
+			if (Host==Slot.m_Host)
+				Found=&Slot;
+		}
+		else if (!Free)
+			Free=&Slot;
+	}
+
+	if (!Found && Free)
+	{
+		memset(Free->m_Host,0,sizeof(Free->m_Host));
+		strncpy(Free->m_Host,Host.c_str(),sizeof(Free->m_Host)-1);
+		Free->m_Next=0;
+		Free->m_Interval=Bucket.m_MinInterval;
+		__sync_synchronize();
+		Free->m_State=eSlotReady;
+
+		Found=Free;
+	}
+
+	flock(m_SharedFD,LOCK_UN);
+
+	//If the table is full, this host can only be limited within this process
+
+	if (Found)
+	{
+		Bucket.m_SharedNext=&Found->m_Next;
+		Bucket.m_SharedInterval=&Found->m_Interval;
+	}
+}
+
+long long MusicBrainz5::CRateLimiterPrivate::Take(CBucket& Bucket, bool Wait, long long TimeNow)
+{
+	volatile long long *Next=Bucket.Next();
+	long long Interval=Bucket.Interval();
+	long long Tolerance=Bucket.Tolerance(Interval);
+	long long Old;
+	long long Start;
+
+	do
+	{
+		Old=*Next;
+		Start=Old;
+
+		//A value far in the future can only be left over from before a reboot
+
+		if (Start<TimeNow || Start-TimeNow>3600*1000000000LL)
+			Start=TimeNow;
+
+		if (!Wait && Start-Tolerance>TimeNow)
+			return -1;
+
+	}	while (!__sync_bool_compare_and_swap(Next,Old,Start+Interval));
+
+	long long Delay=Start-Tolerance-TimeNow;
+
+	return Delay>0 ? Delay : 0;
+}
+
+MusicBrainz5::CRateLimiter::CRateLimiter()
+:	m_d(new CRateLimiterPrivate)
+{
+}
+
+MusicBrainz5::CRateLimiter::~CRateLimiter()
+{
+	if (m_d->m_Shared)
+		munmap(m_d->m_Shared,sizeof(CSharedFile));
+
+	if (-1!=m_d->m_SharedFD)
+		close(m_d->m_SharedFD);
+
+	delete m_d;
+}
+
+MusicBrainz5::CRateLimiter& MusicBrainz5::CRateLimiter::Default()
+{
+	static CRateLimiter *Limiter=0;
+	static pthread_once_t Once=PTHREAD_ONCE_INIT;
+
+	struct CCreate
+	{
+		static void Create()
+		{
+			//The MusicBrainz server allows one request a second on average, this
+			//matches the gap the library has always left between requests
+
+			Limiter=new CRateLimiter;
+			Limiter->SetLimit("musicbrainz.org",0.5);
+		}
+	};
+
+	pthread_once(&Once,CCreate::Create);
+
+	return *Limiter;
+}
+
+void MusicBrainz5::CRateLimiter::SetLimit(const std::string& Host, double RequestsPerSecond, int Burst)
+{
+	if (RequestsPerSecond<=0)
+	{
+		RemoveLimit(Host);
+		return;
+	}
+
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	CRateLimiterPrivate::CBucket& Bucket=m_d->m_Buckets[Host];
+	Bucket=CRateLimiterPrivate::CBucket((long long)(1000000000/RequestsPerSecond),Burst);
+	m_d->Attach(Host,Bucket);
+}
+
+void MusicBrainz5::CRateLimiter::RemoveLimit(const std::string& Host)
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	m_d->m_Buckets.erase(Host);
+}
+
+double MusicBrainz5::CRateLimiter::Reserve(const std::string& Host)
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->Find(Host);
+	if (!Bucket)
+		return 0;
+
+	return m_d->Take(*Bucket,true,(long long)(Now()*1e9))/1e9;
+}
+
+bool MusicBrainz5::CRateLimiter::TryAcquire(const std::string& Host)
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->Find(Host);
+	if (!Bucket)
+		return true;
+
+	return -1!=m_d->Take(*Bucket,false,(long long)(Now()*1e9));
+}
+
+void MusicBrainz5::CRateLimiter::Acquire(const std::string& Host)
+{
+	double Wait=Reserve(Host);
+	if (Wait>0)
+	{
+		struct timespec Remaining;
+		Remaining.tv_sec=(time_t)Wait;
+		Remaining.tv_nsec=(long)((Wait-Remaining.tv_sec)*1e9);
+
+		while (0!=nanosleep(&Remaining,&Remaining) && EINTR==errno)
+			;
+	}
+}
+
+void MusicBrainz5::CRateLimiter::Throttled(const std::string& Host, double RetryAfter)
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->Find(Host);
+	if (!Bucket)
+		return;
+
+	//Multiplicative decrease, down to 1/64th of the configured rate. Other processes
+	//sharing the bucket may be changing the interval at the same time.
+
+	volatile long long *Current=Bucket->IntervalPtr();
+	long long OldInterval;
+	long long Interval;
+
+	do
+	{
+		OldInterval=*Current;
+
+		Interval=(OldInterval>Bucket->m_MinInterval ? OldInterval : Bucket->m_MinInterval)*2;
+		if (Interval>Bucket->m_MinInterval*64)
+			Interval=Bucket->m_MinInterval*64;
+
+	}	while (!__sync_bool_compare_and_swap(Current,OldInterval,Interval));
+
+	//Nothing may go until the retry delay has passed. The bucket is also emptied,
+	//so requests don't burst as soon as the delay ends
+
+	long long Hold=(long long)(Now()*1e9)+(long long)(RetryAfter*1e9)+Bucket->Tolerance(Interval);
+	volatile long long *Next=Bucket->Next();
+	long long Old;
+
+	do
+	{
+		Old=*Next;
+		if (Old>=Hold)
+			break;
+
+	}	while (!__sync_bool_compare_and_swap(Next,Old,Hold));
+}
+
+void MusicBrainz5::CRateLimiter::Succeeded(const std::string& Host)
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	CRateLimiterPrivate::CBucket *Bucket=m_d->Find(Host);
+	if (!Bucket)
+		return;
+
+	//Additive increase, of a tenth of the configured rate per success
+
+	double MaxRate=1e9/Bucket->m_MinInterval;
+	volatile long long *Current=Bucket->IntervalPtr();
+	long long OldInterval;
+	long long Interval;
+
+	do
+	{
+		OldInterval=*Current;
+		if (OldInterval<=Bucket->m_MinInterval)
+			return;
+
+		double NewRate=1e9/OldInterval+MaxRate/10;
+
+		Interval=(long long)(1e9/NewRate);
+		if (Interval<Bucket->m_MinInterval)
+			Interval=Bucket->m_MinInterval;
+
+	}	while (!__sync_bool_compare_and_swap(Current,OldInterval,Interval));
+}
+
+double MusicBrainz5::CRateLimiter::Rate(const std::string& Host) const
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	const CRateLimiterPrivate::CBucket *Bucket=m_d->Find(Host);
+	if (!Bucket)
+		return 0;
+
+	return 1e9/Bucket->Interval();
+}
+
+bool MusicBrainz5::CRateLimiter::SetSharedFile(const std::string& FileName)
+{
+	int File=open(FileName.c_str(),O_RDWR|O_CREAT,0666);
+	if (-1==File)
+		return false;
+
+	fcntl(File,F_SETFD,FD_CLOEXEC);
+
+	//Extending the file fills it with zeros, which is a valid empty table. Every
+	//process extends it to the same size, so it doesn't matter who gets there first
+
+	struct stat Stat;
+	if (0!=fstat(File,&Stat) ||
+			(Stat.st_size<(off_t)sizeof(CSharedFile) && 0!=ftruncate(File,sizeof(CSharedFile))))
+	{
+		close(File);
+		return false;
+	}
+
+	void *Map=mmap(0,sizeof(CSharedFile),PROT_READ|PROT_WRITE,MAP_SHARED,File,0);
+	if (MAP_FAILED==Map)
+	{
+		close(File);
+		return false;
+	}
+
+	CSharedFile *Shared=(CSharedFile *)Map;
+	__sync_bool_compare_and_swap(&Shared->m_Version,0,SharedVersion);
+	if (SharedVersion!=Shared->m_Version)
+	{
+		munmap(Map,sizeof(CSharedFile));
+		close(File);
+		return false;
+	}
+
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	if (m_d->m_Shared)
+		munmap(m_d->m_Shared,sizeof(CSharedFile));
+
+	if (-1!=m_d->m_SharedFD)
+		close(m_d->m_SharedFD);
+
+	//The descriptor is kept open to lock the file while claiming slots
+
+	m_d->m_SharedFD=File;
+	m_d->m_Shared=Shared;
+	m_d->m_SharedFile=FileName;
+
+	std::map<std::string,CRateLimiterPrivate::CBucket>::iterator ThisBucket=m_d->m_Buckets.begin();
+	while (ThisBucket!=m_d->m_Buckets.end())
+	{
+		m_d->Attach((*ThisBucket).first,(*ThisBucket).second);
+		++ThisBucket;
+	}
+
+	return true;
+}
+
+std::string MusicBrainz5::CRateLimiter::SharedFile() const
+{
+	CRateLimiterLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_SharedFile;
+}
+
+double MusicBrainz5::CRateLimiter::Now() const
+{
+	//The monotonic clock is system wide, so it can be compared between processes
+
+	struct timespec TimeNow;
+	clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+	return TimeNow.tv_sec+TimeNow.tv_nsec/1e9;
+}
@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Rating.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CRatingPrivate
+class MusicBrainz5::CRatingPrivate: public CSharedPrivate
 {
 	public:
 		CRatingPrivate()
@@ -59,10 +60,9 @@ MusicBrainz5::CRating::CRating(const XMLNode& Node)
 }
 
 MusicBrainz5::CRating::CRating(const CRating& Other)
-:	CEntity(),
-	m_d(new CRatingPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRating& MusicBrainz5::CRating::operator =(const CRating& Other)
@@ -71,16 +71,35 @@ MusicBrainz5::CRating& MusicBrainz5::CRating::operator =(const CRating& Other)
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_VotesCount=Other.m_d->m_VotesCount;
-		m_d->m_Rating=Other.m_d->m_Rating;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRating::CRating(CRating&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CRatingPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CRating& MusicBrainz5::CRating::operator =(CRating&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CRating::~CRating()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CRating *MusicBrainz5::CRating::Clone()
@@ -90,6 +109,8 @@ MusicBrainz5::CRating *MusicBrainz5::CRating::Clone()
 
 void MusicBrainz5::CRating::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("votes-count"==Name)
 	{
 		ProcessItem(Value,m_d->m_VotesCount);
@@ -104,10 +125,10 @@ void MusicBrainz5::CRating::ParseAttribute(const std::string& Name, const std::s
 
 void MusicBrainz5::CRating::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised rating attribute: '" << NodeName << "'" << std::endl;
+	std::cerr << "Unrecognised rating attribute: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -43,8 +43,10 @@
 #include "musicbrainz5/Tag.h"
 #include "musicbrainz5/UserTagList.h"
 #include "musicbrainz5/UserTag.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CRecordingPrivate
+class MusicBrainz5::CRecordingPrivate: public CSharedPrivate
 {
 	public:
 		CRecordingPrivate()
@@ -61,6 +63,63 @@ class MusicBrainz5::CRecordingPrivate
 		{
 		}
 
+		CRecordingPrivate(const CRecordingPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Title(Other.m_Title),
+			m_Length(Other.m_Length),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_ArtistCredit(0),
+			m_ReleaseList(0),
+			m_PUIDList(0),
+			m_ISRCList(0),
+			m_RelationListList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_Rating(0),
+			m_UserRating(0)
+		{
+			if (Other.m_ArtistCredit)
+				m_ArtistCredit=new CArtistCredit(*Other.m_ArtistCredit);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+
+			if (Other.m_PUIDList)
+				m_PUIDList=new CPUIDList(*Other.m_PUIDList);
+
+			if (Other.m_ISRCList)
+				m_ISRCList=new CISRCList(*Other.m_ISRCList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+		}
+
+		~CRecordingPrivate()
+		{
+			delete m_ArtistCredit;
+			delete m_ReleaseList;
+			delete m_PUIDList;
+			delete m_ISRCList;
+			delete m_RelationListList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_Rating;
+			delete m_UserRating;
+		}
+
 		std::string m_ID;
 		std::string m_Title;
 		int m_Length;
@@ -89,61 +148,46 @@ MusicBrainz5::CRecording::CRecording(const XMLNode& Node)
 }
 
 MusicBrainz5::CRecording::CRecording(const CRecording& Other)
-:	CEntity(),
-	m_d(new CRecordingPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRecording& MusicBrainz5::CRecording::operator =(const CRecording& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Length=Other.m_d->m_Length;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
-
-		if (Other.m_d->m_PUIDList)
-			m_d->m_PUIDList=new CPUIDList(*Other.m_d->m_PUIDList);
-
-		if (Other.m_d->m_ISRCList)
-			m_d->m_ISRCList=new CISRCList(*Other.m_d->m_ISRCList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
+		Assign(m_d,Other.m_d);
+	}
 
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
+	return *this;
+}
 
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRecording::CRecording(CRecording&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CRecordingPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
 
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
+MusicBrainz5::CRecording& MusicBrainz5::CRecording::operator =(CRecording&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CRecording::~CRecording()
 {
-	Cleanup();
-
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CRecording *MusicBrainz5::CRecording::Clone()
@@ -153,6 +197,8 @@ MusicBrainz5::CRecording *MusicBrainz5::CRecording::Clone()
 
 void MusicBrainz5::CRecording::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -165,105 +211,82 @@ void MusicBrainz5::CRecording::ParseAttribute(const std::string& Name, const std
 
 void MusicBrainz5::CRecording::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("length"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Length);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("puid-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PUIDList);
-	}
-	else if ("isrc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISRCList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
-#ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised recording element: '" << NodeName << "'" << std::endl;
-#endif
-	}
-}
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
 
-std::string MusicBrainz5::CRecording::GetElementName()
-{
-	return "recording";
-}
+		case eElementLength:
+			ProcessItem(Node,m_d->m_Length);
+			break;
 
-void MusicBrainz5::CRecording::Cleanup()
-{
-	delete m_d->m_ArtistCredit;
-	m_d->m_ArtistCredit=0;
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
 
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
+		case eElementArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
 
-	delete m_d->m_PUIDList;
-	m_d->m_PUIDList=0;
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
 
-	delete m_d->m_ISRCList;
-	m_d->m_ISRCList=0;
+		case eElementPuidList:
+			ProcessItem(Node,m_d->m_PUIDList);
+			break;
 
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
+		case eElementIsrcList:
+			ProcessItem(Node,m_d->m_ISRCList);
+			break;
 
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
 
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
 
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		default:
+#ifdef _MB5_DEBUG_
+			std::cerr << "Unrecognised recording element: '" << Node.getName() << "'" << std::endl;
+#endif
+			break;
+	}
+}
+
+std::string MusicBrainz5::CRecording::GetElementName()
+{
+	return "recording";
 }
 
-std::string MusicBrainz5::CRecording::ID() const
+const std::string& MusicBrainz5::CRecording::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CRecording::Title() const
+MusicBrainz5::CMBID MusicBrainz5::CRecording::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CRecording::Title() const
 {
 	return m_d->m_Title;
 }
@@ -273,53 +296,116 @@ int MusicBrainz5::CRecording::Length() const
 	return m_d->m_Length;
 }
 
-std::string MusicBrainz5::CRecording::Disambiguation() const
+const std::string& MusicBrainz5::CRecording::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-MusicBrainz5::CArtistCredit *MusicBrainz5::CRecording::ArtistCredit() const
+const MusicBrainz5::CArtistCredit *MusicBrainz5::CRecording::ArtistCredit() const
 {
 	return m_d->m_ArtistCredit;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CRecording::ReleaseList() const
+MusicBrainz5::CArtistCredit *MusicBrainz5::CRecording::ArtistCredit()
 {
+	Unshare(m_d);
+
+	return m_d->m_ArtistCredit;
+}
+
+const MusicBrainz5::CReleaseList *MusicBrainz5::CRecording::ReleaseList() const
+{
+	return m_d->m_ReleaseList;
+}
+
+MusicBrainz5::CReleaseList *MusicBrainz5::CRecording::ReleaseList()
+{
+	Unshare(m_d);
+
 	return m_d->m_ReleaseList;
 }
 
-MusicBrainz5::CPUIDList *MusicBrainz5::CRecording::PUIDList() const
+const MusicBrainz5::CPUIDList *MusicBrainz5::CRecording::PUIDList() const
 {
 	return m_d->m_PUIDList;
 }
 
-MusicBrainz5::CISRCList *MusicBrainz5::CRecording::ISRCList() const
+MusicBrainz5::CPUIDList *MusicBrainz5::CRecording::PUIDList()
+{
+	Unshare(m_d);
+
+	return m_d->m_PUIDList;
+}
+
+const MusicBrainz5::CISRCList *MusicBrainz5::CRecording::ISRCList() const
 {
 	return m_d->m_ISRCList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CRecording::RelationListList() const
+MusicBrainz5::CISRCList *MusicBrainz5::CRecording::ISRCList()
+{
+	Unshare(m_d);
+
+	return m_d->m_ISRCList;
+}
+
+const MusicBrainz5::CRelationListList *MusicBrainz5::CRecording::RelationListList() const
 {
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CRecording::TagList() const
+MusicBrainz5::CRelationListList *MusicBrainz5::CRecording::RelationListList()
+{
+	Unshare(m_d);
+
+	return m_d->m_RelationListList;
+}
+
+const MusicBrainz5::CTagList *MusicBrainz5::CRecording::TagList() const
 {
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CRecording::UserTagList() const
+MusicBrainz5::CTagList *MusicBrainz5::CRecording::TagList()
 {
+	Unshare(m_d);
+
+	return m_d->m_TagList;
+}
+
+const MusicBrainz5::CUserTagList *MusicBrainz5::CRecording::UserTagList() const
+{
+	return m_d->m_UserTagList;
+}
+
+MusicBrainz5::CUserTagList *MusicBrainz5::CRecording::UserTagList()
+{
+	Unshare(m_d);
+
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CRecording::Rating() const
+const MusicBrainz5::CRating *MusicBrainz5::CRecording::Rating() const
+{
+	return m_d->m_Rating;
+}
+
+MusicBrainz5::CRating *MusicBrainz5::CRecording::Rating()
 {
+	Unshare(m_d);
+
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CRecording::UserRating() const
+const MusicBrainz5::CUserRating *MusicBrainz5::CRecording::UserRating() const
+{
+	return m_d->m_UserRating;
+}
+
+MusicBrainz5::CUserRating *MusicBrainz5::CRecording::UserRating()
 {
+	Unshare(m_d);
+
 	return m_d->m_UserRating;
 }
 
@@ -36,12 +36,17 @@
 #include "musicbrainz5/Work.h"
 #include "musicbrainz5/AttributeList.h"
 #include "musicbrainz5/Attribute.h"
+#include "ElementTables.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CRelationPrivate
+class MusicBrainz5::CRelationPrivate: public CSharedPrivate
 {
 	public:
 		CRelationPrivate()
-		:	m_AttributeList(0),
+		:	m_Type(&CStringPool::Empty()),
+			m_Direction(&CStringPool::Empty()),
+			m_AttributeList(0),
 			m_Artist(0),
 			m_Release(0),
 			m_ReleaseGroup(0),
@@ -51,9 +56,58 @@ class MusicBrainz5::CRelationPrivate
 		{
 		}
 
-		std::string m_Type;
+		CRelationPrivate(const CRelationPrivate& Other)
+		:	CSharedPrivate(),
+			m_Type(Other.m_Type),
+			m_Target(Other.m_Target),
+			m_Direction(Other.m_Direction),
+			m_AttributeList(0),
+			m_Begin(Other.m_Begin),
+			m_End(Other.m_End),
+			m_Ended(Other.m_Ended),
+			m_Artist(0),
+			m_Release(0),
+			m_ReleaseGroup(0),
+			m_Recording(0),
+			m_Label(0),
+			m_Work(0)
+		{
+			if (Other.m_AttributeList)
+				m_AttributeList=new CAttributeList(*Other.m_AttributeList);
+
+			if (Other.m_Artist)
+				m_Artist=new CArtist(*Other.m_Artist);
+
+			if (Other.m_Release)
+				m_Release=new CRelease(*Other.m_Release);
+
+			if (Other.m_ReleaseGroup)
+				m_ReleaseGroup=new CReleaseGroup(*Other.m_ReleaseGroup);
+
+			if (Other.m_Recording)
+				m_Recording=new CRecording(*Other.m_Recording);
+
+			if (Other.m_Label)
+				m_Label=new CLabel(*Other.m_Label);
+
+			if (Other.m_Work)
+				m_Work=new CWork(*Other.m_Work);
+		}
+
+		~CRelationPrivate()
+		{
+			delete m_AttributeList;
+			delete m_Artist;
+			delete m_Release;
+			delete m_ReleaseGroup;
+			delete m_Recording;
+			delete m_Label;
+			delete m_Work;
+		}
+
+		const std::string *m_Type;
 		std::string m_Target;
-		std::string m_Direction;
+		const std::string *m_Direction;
 		CAttributeList *m_AttributeList;
 		std::string m_Begin;
 		std::string m_End;
@@ -79,82 +133,46 @@ MusicBrainz5::CRelation::CRelation(const XMLNode& Node)
 }
 
 MusicBrainz5::CRelation::CRelation(const CRelation& Other)
-:	CEntity(),
-	m_d(new CRelationPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRelation& MusicBrainz5::CRelation::operator =(const CRelation& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Target=Other.m_d->m_Target;
-		m_d->m_Direction=Other.m_d->m_Direction;
-
-		if (Other.m_d->m_AttributeList)
-			m_d->m_AttributeList=new CAttributeList(*Other.m_d->m_AttributeList);
-
-		m_d->m_Begin=Other.m_d->m_Begin;
-		m_d->m_End=Other.m_d->m_End;
-		m_d->m_Ended=Other.m_d->m_Ended;
-
-		if (Other.m_d->m_Artist)
-			m_d->m_Artist=new CArtist(*Other.m_d->m_Artist);
-
-		if (Other.m_d->m_Release)
-			m_d->m_Release=new CRelease(*Other.m_d->m_Release);
-
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
-
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
-
-		if (Other.m_d->m_Label)
-			m_d->m_Label=new CLabel(*Other.m_d->m_Label);
-
-		if (Other.m_d->m_Work)
-			m_d->m_Work=new CWork(*Other.m_d->m_Work);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CRelation::~CRelation()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRelation::CRelation(CRelation&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CRelationPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CRelation::Cleanup()
+MusicBrainz5::CRelation& MusicBrainz5::CRelation::operator =(CRelation&& Other)
 {
-	delete m_d->m_AttributeList;
-	m_d->m_AttributeList=0;
-
-	delete m_d->m_Artist;
-	m_d->m_Artist=0;
-
-	delete m_d->m_Release;
-	m_d->m_Release=0;
-
-	delete m_d->m_ReleaseGroup;
-	m_d->m_ReleaseGroup=0;
-
-	delete m_d->m_Recording;
-	m_d->m_Recording=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_Label;
-	m_d->m_Label=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_Work;
-	m_d->m_Work=0;
+MusicBrainz5::CRelation::~CRelation()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CRelation *MusicBrainz5::CRelation::Clone()
@@ -164,8 +182,10 @@ MusicBrainz5::CRelation *MusicBrainz5::CRelation::Clone()
 
 void MusicBrainz5::CRelation::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("type"==Name)
-		m_d->m_Type=Value;
+		InternItem(Value,m_d->m_Type);
 	else
 	{
 #ifdef _MB5_DEBUG_
@@ -176,61 +196,63 @@ void MusicBrainz5::CRelation::ParseAttribute(const std::string& Name, const std:
 
 void MusicBrainz5::CRelation::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("target"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Target);
-	}
-	else if ("direction"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Direction);
-	}
-	else if ("attribute-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AttributeList);
-	}
-	else if ("begin"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Begin);
-	}
-	else if ("end"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_End);
-	}
-	else if ("ended"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Ended);
-	}
-	else if ("artist"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Artist);
-	}
-	else if ("release"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Release);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("label"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Label);
-	}
-	else if ("work"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Work);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTarget:
+			ProcessItem(Node,m_d->m_Target);
+			break;
+
+		case eElementDirection:
+			InternItem(Node,m_d->m_Direction);
+			break;
+
+		case eElementAttributeList:
+			ProcessItem(Node,m_d->m_AttributeList);
+			break;
+
+		case eElementBegin:
+			ProcessItem(Node,m_d->m_Begin);
+			break;
+
+		case eElementEnd:
+			ProcessItem(Node,m_d->m_End);
+			break;
+
+		case eElementEnded:
+			ProcessItem(Node,m_d->m_Ended);
+			break;
+
+		case eElementArtist:
+			ProcessItem(Node,m_d->m_Artist);
+			break;
+
+		case eElementRelease:
+			ProcessItem(Node,m_d->m_Release);
+			break;
+
+		case eElementReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
+
+		case eElementRecording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
+
+		case eElementLabel:
+			ProcessItem(Node,m_d->m_Label);
+			break;
+
+		case eElementWork:
+			ProcessItem(Node,m_d->m_Work);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised relation element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised relation element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -239,68 +261,124 @@ std::string MusicBrainz5::CRelation::GetElementName()
 	return "relation";
 }
 
-std::string MusicBrainz5::CRelation::Type() const
+const std::string& MusicBrainz5::CRelation::Type() const
 {
-	return m_d->m_Type;
+	return *m_d->m_Type;
 }
 
-std::string MusicBrainz5::CRelation::Target() const
+const std::string& MusicBrainz5::CRelation::Target() const
 {
 	return m_d->m_Target;
 }
 
-std::string MusicBrainz5::CRelation::Direction() const
+MusicBrainz5::CMBID MusicBrainz5::CRelation::TargetMBID() const
 {
-	return m_d->m_Direction;
+	//The target of a relation to a URL is the URL, which gives the nil ID
+
+	return CMBID(m_d->m_Target);
 }
 
-MusicBrainz5::CAttributeList *MusicBrainz5::CRelation::AttributeList() const
+const std::string& MusicBrainz5::CRelation::Direction() const
 {
+	return *m_d->m_Direction;
+}
+
+const MusicBrainz5::CAttributeList *MusicBrainz5::CRelation::AttributeList() const
+{
+	return m_d->m_AttributeList;
+}
+
+MusicBrainz5::CAttributeList *MusicBrainz5::CRelation::AttributeList()
+{
+	Unshare(m_d);
+
 	return m_d->m_AttributeList;
 }
 
-std::string MusicBrainz5::CRelation::Begin() const
+const std::string& MusicBrainz5::CRelation::Begin() const
 {
 	return m_d->m_Begin;
 }
 
-std::string MusicBrainz5::CRelation::End() const
+const std::string& MusicBrainz5::CRelation::End() const
 {
 	return m_d->m_End;
 }
 
-std::string MusicBrainz5::CRelation::Ended() const
+const std::string& MusicBrainz5::CRelation::Ended() const
 {
 	return m_d->m_Ended;
 }
 
-MusicBrainz5::CArtist *MusicBrainz5::CRelation::Artist() const
+const MusicBrainz5::CArtist *MusicBrainz5::CRelation::Artist() const
 {
 	return m_d->m_Artist;
 }
 
-MusicBrainz5::CRelease *MusicBrainz5::CRelation::Release() const
+MusicBrainz5::CArtist *MusicBrainz5::CRelation::Artist()
+{
+	Unshare(m_d);
+
+	return m_d->m_Artist;
+}
+
+const MusicBrainz5::CRelease *MusicBrainz5::CRelation::Release() const
 {
 	return m_d->m_Release;
 }
 
-MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelation::ReleaseGroup() const
+MusicBrainz5::CRelease *MusicBrainz5::CRelation::Release()
 {
+	Unshare(m_d);
+
+	return m_d->m_Release;
+}
+
+const MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelation::ReleaseGroup() const
+{
+	return m_d->m_ReleaseGroup;
+}
+
+MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelation::ReleaseGroup()
+{
+	Unshare(m_d);
+
 	return m_d->m_ReleaseGroup;
 }
 
-MusicBrainz5::CRecording *MusicBrainz5::CRelation::Recording() const
+const MusicBrainz5::CRecording *MusicBrainz5::CRelation::Recording() const
 {
 	return m_d->m_Recording;
 }
 
-MusicBrainz5::CLabel *MusicBrainz5::CRelation::Label() const
+MusicBrainz5::CRecording *MusicBrainz5::CRelation::Recording()
+{
+	Unshare(m_d);
+
+	return m_d->m_Recording;
+}
+
+const MusicBrainz5::CLabel *MusicBrainz5::CRelation::Label() const
 {
 	return m_d->m_Label;
 }
 
-MusicBrainz5::CWork *MusicBrainz5::CRelation::Work() const
+MusicBrainz5::CLabel *MusicBrainz5::CRelation::Label()
 {
+	Unshare(m_d);
+
+	return m_d->m_Label;
+}
+
+const MusicBrainz5::CWork *MusicBrainz5::CRelation::Work() const
+{
+	return m_d->m_Work;
+}
+
+MusicBrainz5::CWork *MusicBrainz5::CRelation::Work()
+{
+	Unshare(m_d);
+
 	return m_d->m_Work;
 }
 
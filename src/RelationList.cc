@@ -29,11 +29,18 @@
 #include "musicbrainz5/RelationList.h"
 
 #include "musicbrainz5/Relation.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CRelationListPrivate
+class MusicBrainz5::CRelationListPrivate: public CSharedPrivate
 {
 	public:
-		std::string m_TargetType;
+		CRelationListPrivate()
+		:	m_TargetType(&CStringPool::Empty())
+		{
+		}
+
+		const std::string *m_TargetType;
 };
 
 MusicBrainz5::CRelationList::CRelationList(const XMLNode& Node)
@@ -49,10 +56,9 @@ MusicBrainz5::CRelationList::CRelationList(const XMLNode& Node)
 }
 
 MusicBrainz5::CRelationList::CRelationList(const CRelationList& Other)
-:	CListImpl<CRelation>(),
-	m_d(new CRelationListPrivate)
+:	CListImpl<CRelation>(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRelationList& MusicBrainz5::CRelationList::operator =(const CRelationList& Other)
@@ -61,15 +67,35 @@ MusicBrainz5::CRelationList& MusicBrainz5::CRelationList::operator =(const CRela
 	{
 		CListImpl<CRelation>::operator =(Other);
 
-		m_d->m_TargetType=Other.m_d->m_TargetType;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRelationList::CRelationList(CRelationList&& Other)
+:	CListImpl<CRelation>(std::move(Other)),
+	m_d(SharedEmpty<CRelationListPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CRelationList& MusicBrainz5::CRelationList::operator =(CRelationList&& Other)
+{
+	if (this!=&Other)
+	{
+		CListImpl<CRelation>::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CRelationList::~CRelationList()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CRelationList *MusicBrainz5::CRelationList::Clone()
@@ -79,8 +105,14 @@ MusicBrainz5::CRelationList *MusicBrainz5::CRelationList::Clone()
 
 void MusicBrainz5::CRelationList::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("target-type"==Name)
-		ProcessItem(Value,m_d->m_TargetType);
+	{
+		std::string TargetType=*m_d->m_TargetType;
+		ProcessItem(Value,TargetType);
+		InternItem(TargetType,m_d->m_TargetType);
+	}
 	else
 		CListImpl<CRelation>::ParseAttribute(Name,Value);
 }
@@ -95,9 +127,9 @@ std::string MusicBrainz5::CRelationList::GetElementName()
 	return "relation-list";
 }
 
-std::string MusicBrainz5::CRelationList::TargetType() const
+const std::string& MusicBrainz5::CRelationList::TargetType() const
 {
-	return m_d->m_TargetType;
+	return *m_d->m_TargetType;
 }
 
 std::ostream& MusicBrainz5::CRelationList::Serialise(std::ostream& os) const
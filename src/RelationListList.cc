@@ -33,7 +33,9 @@
 #include "musicbrainz5/RelationList.h"
 #include "musicbrainz5/Relation.h"
 
-class MusicBrainz5::CRelationListListPrivate
+#include "SharedPrivate.h"
+
+class MusicBrainz5::CRelationListListPrivate: public CSharedPrivate
 {
 	public:
 		CRelationListListPrivate()
@@ -41,6 +43,37 @@ class MusicBrainz5::CRelationListListPrivate
 		{
 		}
 
+		CRelationListListPrivate(const CRelationListListPrivate& Other)
+		:	CSharedPrivate(),
+			m_ListGroup(0)
+		{
+			if (Other.m_ListGroup)
+			{
+				m_ListGroup=new std::vector<CRelationList *>;
+
+				for (std::vector<CRelationList *>::const_iterator ThisRelationList=Other.m_ListGroup->begin();ThisRelationList!=Other.m_ListGroup->end();++ThisRelationList)
+				{
+					CRelationList *RelationList=*ThisRelationList;
+					m_ListGroup->push_back(new CRelationList(*RelationList));
+				}
+			}
+		}
+
+		~CRelationListListPrivate()
+		{
+			if (m_ListGroup)
+			{
+				for (std::vector<CRelationList *>::const_iterator ThisRelationList=m_ListGroup->begin();ThisRelationList!=m_ListGroup->end();++ThisRelationList)
+				{
+					CRelationList *RelationList=*ThisRelationList;
+
+					delete RelationList;
+				}
+			}
+
+			delete m_ListGroup;
+		}
+
 		std::vector<CRelationList *> *m_ListGroup;
 };
 
@@ -50,57 +83,47 @@ MusicBrainz5::CRelationListList::CRelationListList()
 }
 
 MusicBrainz5::CRelationListList::CRelationListList(const CRelationListList& Other)
-:	m_d(new CRelationListListPrivate)
+:	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRelationListList& MusicBrainz5::CRelationListList::operator =(const CRelationListList& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
-		if (Other.m_d->m_ListGroup)
-		{
-			m_d->m_ListGroup=new std::vector<CRelationList *>;
-
-			for (std::vector<CRelationList *>::const_iterator ThisRelationList=Other.m_d->m_ListGroup->begin();ThisRelationList!=Other.m_d->m_ListGroup->end();++ThisRelationList)
-			{
-				CRelationList *RelationList=*ThisRelationList;
-				m_d->m_ListGroup->push_back(new CRelationList(*RelationList));
-			}
-		}
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CRelationListList::~CRelationListList()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRelationListList::CRelationListList(CRelationListList&& Other)
+:	m_d(SharedEmpty<CRelationListListPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CRelationListList::Cleanup()
+MusicBrainz5::CRelationListList& MusicBrainz5::CRelationListList::operator =(CRelationListList&& Other)
 {
-	if (m_d->m_ListGroup)
+	if (this!=&Other)
 	{
-		for (std::vector<CRelationList *>::const_iterator ThisRelationList=m_d->m_ListGroup->begin();ThisRelationList!=m_d->m_ListGroup->end();++ThisRelationList)
-		{
-			CRelationList *RelationList=*ThisRelationList;
-
-			delete RelationList;
-		}
+		Move(m_d,Other.m_d);
 	}
 
-	delete m_d->m_ListGroup;
-	m_d->m_ListGroup=0;
+	return *this;
+}
+#endif
+
+MusicBrainz5::CRelationListList::~CRelationListList()
+{
+	m_d->Unref();
 }
 
 void MusicBrainz5::CRelationListList::Add(CRelationList *RelationList)
 {
+	Detach(m_d);
+
 	if (!m_d->m_ListGroup)
 		m_d->m_ListGroup=new std::vector<CRelationList *>;
 
@@ -117,7 +140,7 @@ int MusicBrainz5::CRelationListList::NumItems() const
 	return Ret;
 }
 
-MusicBrainz5::CRelationList *MusicBrainz5::CRelationListList::Item(int Item) const
+const MusicBrainz5::CRelationList *MusicBrainz5::CRelationListList::Item(int Item) const
 {
 	CRelationList *RelationList=0;
 
@@ -127,6 +150,18 @@ MusicBrainz5::CRelationList *MusicBrainz5::CRelationListList::Item(int Item) con
 	return RelationList;
 }
 
+MusicBrainz5::CRelationList *MusicBrainz5::CRelationListList::Item(int Item)
+{
+	Unshare(m_d);
+
+	CRelationList *RelationList=0;
+
+	if (m_d->m_ListGroup && Item<(int)m_d->m_ListGroup->size())
+		RelationList=(*m_d->m_ListGroup)[Item];
+
+	return RelationList;
+}
+
 std::ostream& MusicBrainz5::CRelationListList::Serialise(std::ostream& os) const
 {
 	if (m_d->m_ListGroup && m_d->m_ListGroup->size()!=0)
@@ -43,14 +43,21 @@
 #include "musicbrainz5/Medium.h"
 #include "musicbrainz5/Collection.h"
 #include "musicbrainz5/CollectionList.h"
+#include "ElementTables.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CReleasePrivate
+class MusicBrainz5::CReleasePrivate: public CSharedPrivate
 {
 	public:
 		CReleasePrivate()
-		:	m_TextRepresentation(0),
+		:	m_Status(&CStringPool::Empty()),
+			m_Quality(&CStringPool::Empty()),
+			m_Packaging(&CStringPool::Empty()),
+			m_TextRepresentation(0),
 			m_ArtistCredit(0),
 			m_ReleaseGroup(0),
+			m_Country(&CStringPool::Empty()),
 			m_LabelInfoList(0),
 			m_MediumList(0),
 			m_RelationListList(0),
@@ -58,17 +65,70 @@ class MusicBrainz5::CReleasePrivate
 		{
 		}
 
+		CReleasePrivate(const CReleasePrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Title(Other.m_Title),
+			m_Status(Other.m_Status),
+			m_Quality(Other.m_Quality),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_Packaging(Other.m_Packaging),
+			m_TextRepresentation(0),
+			m_ArtistCredit(0),
+			m_ReleaseGroup(0),
+			m_Date(Other.m_Date),
+			m_Country(Other.m_Country),
+			m_Barcode(Other.m_Barcode),
+			m_ASIN(Other.m_ASIN),
+			m_LabelInfoList(0),
+			m_MediumList(0),
+			m_RelationListList(0),
+			m_CollectionList(0)
+		{
+			if (Other.m_TextRepresentation)
+				m_TextRepresentation=new CTextRepresentation(*Other.m_TextRepresentation);
+
+			if (Other.m_ArtistCredit)
+				m_ArtistCredit=new CArtistCredit(*Other.m_ArtistCredit);
+
+			if (Other.m_ReleaseGroup)
+				m_ReleaseGroup=new CReleaseGroup(*Other.m_ReleaseGroup);
+
+			if (Other.m_LabelInfoList)
+				m_LabelInfoList=new CLabelInfoList(*Other.m_LabelInfoList);
+
+			if (Other.m_MediumList)
+				m_MediumList=new CMediumList(*Other.m_MediumList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_CollectionList)
+				m_CollectionList=new CCollectionList(*Other.m_CollectionList);
+		}
+
+		~CReleasePrivate()
+		{
+			delete m_TextRepresentation;
+			delete m_ArtistCredit;
+			delete m_ReleaseGroup;
+			delete m_LabelInfoList;
+			delete m_MediumList;
+			delete m_RelationListList;
+			delete m_CollectionList;
+		}
+
 		std::string m_ID;
 		std::string m_Title;
-		std::string m_Status;
-		std::string m_Quality;
+		const std::string *m_Status;
+		const std::string *m_Quality;
 		std::string m_Disambiguation;
-		std::string m_Packaging;
+		const std::string *m_Packaging;
 		CTextRepresentation *m_TextRepresentation;
 		CArtistCredit *m_ArtistCredit;
 		CReleaseGroup *m_ReleaseGroup;
 		std::string m_Date;
-		std::string m_Country;
+		const std::string *m_Country;
 		std::string m_Barcode;
 		std::string m_ASIN;
 		CLabelInfoList *m_LabelInfoList;
@@ -90,83 +150,46 @@ MusicBrainz5::CRelease::CRelease(const XMLNode& Node)
 }
 
 MusicBrainz5::CRelease::CRelease(const CRelease& Other)
-:	CEntity(),
-	m_d(new CReleasePrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CRelease& MusicBrainz5::CRelease::operator =(const CRelease& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Status=Other.m_d->m_Status;
-		m_d->m_Quality=Other.m_d->m_Quality;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_Packaging=Other.m_d->m_Packaging;
-
-		if (Other.m_d->m_TextRepresentation)
-			m_d->m_TextRepresentation=new CTextRepresentation(*Other.m_d->m_TextRepresentation);
-
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
-
-		if (Other.m_d->m_ReleaseGroup)
-			m_d->m_ReleaseGroup=new CReleaseGroup(*Other.m_d->m_ReleaseGroup);
-
-		m_d->m_Date=Other.m_d->m_Date;
-		m_d->m_Country=Other.m_d->m_Country;
-		m_d->m_Barcode=Other.m_d->m_Barcode;
-		m_d->m_ASIN=Other.m_d->m_ASIN;
-
-		if (Other.m_d->m_LabelInfoList)
-			m_d->m_LabelInfoList=new CLabelInfoList(*Other.m_d->m_LabelInfoList);
-
-		if (Other.m_d->m_MediumList)
-			m_d->m_MediumList=new CMediumList(*Other.m_d->m_MediumList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_CollectionList)
-			m_d->m_CollectionList=new CCollectionList(*Other.m_d->m_CollectionList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CRelease::~CRelease()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CRelease::CRelease(CRelease&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CReleasePrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CRelease::Cleanup()
+MusicBrainz5::CRelease& MusicBrainz5::CRelease::operator =(CRelease&& Other)
 {
-	delete m_d->m_TextRepresentation;
-	m_d->m_TextRepresentation=0;
-
-	delete m_d->m_ArtistCredit;
-	m_d->m_ArtistCredit=0;
-
-	delete m_d->m_ReleaseGroup;
-	m_d->m_ReleaseGroup=0;
-
-	delete m_d->m_LabelInfoList;
-	m_d->m_LabelInfoList=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_MediumList;
-	m_d->m_MediumList=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
+MusicBrainz5::CRelease::~CRelease()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CRelease *MusicBrainz5::CRelease::Clone()
@@ -176,6 +199,8 @@ MusicBrainz5::CRelease *MusicBrainz5::CRelease::Clone()
 
 void MusicBrainz5::CRelease::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else
@@ -188,77 +213,79 @@ void MusicBrainz5::CRelease::ParseAttribute(const std::string& Name, const std::
 
 void MusicBrainz5::CRelease::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("status"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Status);
-	}
-	else if ("quality"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Quality);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("packaging"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Packaging);
-	}
-	else if ("text-representation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TextRepresentation);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-group"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseGroup);
-	}
-	else if ("date"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Date);
-	}
-	else if ("country"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Country);
-	}
-	else if ("barcode"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Barcode);
-	}
-	else if ("asin"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ASIN);
-	}
-	else if ("label-info-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_LabelInfoList);
-	}
-	else if ("medium-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_MediumList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("collection-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_CollectionList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementStatus:
+			InternItem(Node,m_d->m_Status);
+			break;
+
+		case eElementQuality:
+			InternItem(Node,m_d->m_Quality);
+			break;
+
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElementPackaging:
+			InternItem(Node,m_d->m_Packaging);
+			break;
+
+		case eElementTextRepresentation:
+			ProcessItem(Node,m_d->m_TextRepresentation);
+			break;
+
+		case eElementArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElementReleaseGroup:
+			ProcessItem(Node,m_d->m_ReleaseGroup);
+			break;
+
+		case eElementDate:
+			ProcessItem(Node,m_d->m_Date);
+			break;
+
+		case eElementCountry:
+			InternItem(Node,m_d->m_Country);
+			break;
+
+		case eElementBarcode:
+			ProcessItem(Node,m_d->m_Barcode);
+			break;
+
+		case eElementAsin:
+			ProcessItem(Node,m_d->m_ASIN);
+			break;
+
+		case eElementLabelInfoList:
+			ProcessItem(Node,m_d->m_LabelInfoList);
+			break;
+
+		case eElementMediumList:
+			ProcessItem(Node,m_d->m_MediumList);
+			break;
+
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElementCollectionList:
+			ProcessItem(Node,m_d->m_CollectionList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised release element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised release element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -267,88 +294,142 @@ std::string MusicBrainz5::CRelease::GetElementName()
 	return "release";
 }
 
-std::string MusicBrainz5::CRelease::ID() const
+const std::string& MusicBrainz5::CRelease::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CRelease::Title() const
+MusicBrainz5::CMBID MusicBrainz5::CRelease::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CRelease::Title() const
 {
 	return m_d->m_Title;
 }
 
-std::string MusicBrainz5::CRelease::Status() const
+const std::string& MusicBrainz5::CRelease::Status() const
 {
-	return m_d->m_Status;
+	return *m_d->m_Status;
 }
 
-std::string MusicBrainz5::CRelease::Quality() const
+const std::string& MusicBrainz5::CRelease::Quality() const
 {
-	return m_d->m_Quality;
+	return *m_d->m_Quality;
 }
 
-std::string MusicBrainz5::CRelease::Disambiguation() const
+const std::string& MusicBrainz5::CRelease::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-std::string MusicBrainz5::CRelease::Packaging() const
+const std::string& MusicBrainz5::CRelease::Packaging() const
 {
-	return m_d->m_Packaging;
+	return *m_d->m_Packaging;
 }
 
-MusicBrainz5::CTextRepresentation *MusicBrainz5::CRelease::TextRepresentation() const
+const MusicBrainz5::CTextRepresentation *MusicBrainz5::CRelease::TextRepresentation() const
 {
 	return m_d->m_TextRepresentation;
 }
 
-MusicBrainz5::CArtistCredit *MusicBrainz5::CRelease::ArtistCredit() const
+MusicBrainz5::CTextRepresentation *MusicBrainz5::CRelease::TextRepresentation()
 {
+	Unshare(m_d);
+
+	return m_d->m_TextRepresentation;
+}
+
+const MusicBrainz5::CArtistCredit *MusicBrainz5::CRelease::ArtistCredit() const
+{
+	return m_d->m_ArtistCredit;
+}
+
+MusicBrainz5::CArtistCredit *MusicBrainz5::CRelease::ArtistCredit()
+{
+	Unshare(m_d);
+
 	return m_d->m_ArtistCredit;
 }
 
-MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelease::ReleaseGroup() const
+const MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelease::ReleaseGroup() const
+{
+	return m_d->m_ReleaseGroup;
+}
+
+MusicBrainz5::CReleaseGroup *MusicBrainz5::CRelease::ReleaseGroup()
 {
+	Unshare(m_d);
+
 	return m_d->m_ReleaseGroup;
 }
 
-std::string MusicBrainz5::CRelease::Date() const
+const std::string& MusicBrainz5::CRelease::Date() const
 {
 	return m_d->m_Date;
 }
 
-std::string MusicBrainz5::CRelease::Country() const
+const std::string& MusicBrainz5::CRelease::Country() const
 {
-	return m_d->m_Country;
+	return *m_d->m_Country;
 }
 
-std::string MusicBrainz5::CRelease::Barcode() const
+const std::string& MusicBrainz5::CRelease::Barcode() const
 {
 	return m_d->m_Barcode;
 }
 
-std::string MusicBrainz5::CRelease::ASIN() const
+const std::string& MusicBrainz5::CRelease::ASIN() const
 {
 	return m_d->m_ASIN;
 }
 
-MusicBrainz5::CLabelInfoList *MusicBrainz5::CRelease::LabelInfoList() const
+const MusicBrainz5::CLabelInfoList *MusicBrainz5::CRelease::LabelInfoList() const
+{
+	return m_d->m_LabelInfoList;
+}
+
+MusicBrainz5::CLabelInfoList *MusicBrainz5::CRelease::LabelInfoList()
 {
+	Unshare(m_d);
+
 	return m_d->m_LabelInfoList;
 }
 
-MusicBrainz5::CMediumList *MusicBrainz5::CRelease::MediumList() const
+const MusicBrainz5::CMediumList *MusicBrainz5::CRelease::MediumList() const
+{
+	return m_d->m_MediumList;
+}
+
+MusicBrainz5::CMediumList *MusicBrainz5::CRelease::MediumList()
 {
+	Unshare(m_d);
+
 	return m_d->m_MediumList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CRelease::RelationListList() const
+const MusicBrainz5::CRelationListList *MusicBrainz5::CRelease::RelationListList() const
+{
+	return m_d->m_RelationListList;
+}
+
+MusicBrainz5::CRelationListList *MusicBrainz5::CRelease::RelationListList()
 {
+	Unshare(m_d);
+
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CCollectionList *MusicBrainz5::CRelease::CollectionList() const
+const MusicBrainz5::CCollectionList *MusicBrainz5::CRelease::CollectionList() const
+{
+	return m_d->m_CollectionList;
+}
+
+MusicBrainz5::CCollectionList *MusicBrainz5::CRelease::CollectionList()
 {
+	Unshare(m_d);
+
 	return m_d->m_CollectionList;
 }
 
@@ -360,7 +441,7 @@ MusicBrainz5::CMediumList MusicBrainz5::CRelease::MediaMatchingDiscID(const std:
 	{
 		for (int count=0;count<m_d->m_MediumList->NumItems();count++)
 		{
-			MusicBrainz5::CMedium *Medium=m_d->m_MediumList->Item(count);
+			const MusicBrainz5::CMedium *Medium=m_d->m_MediumList->Item(count);
 
 			if (Medium->ContainsDiscID(DiscID))
 				Ret.AddItem(new MusicBrainz5::CMedium(*Medium));
@@ -42,8 +42,10 @@
 #include "musicbrainz5/UserTag.h"
 #include "musicbrainz5/SecondaryTypeList.h"
 #include "musicbrainz5/SecondaryType.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CReleaseGroupPrivate
+class MusicBrainz5::CReleaseGroupPrivate: public CSharedPrivate
 {
 	public:
 		CReleaseGroupPrivate()
@@ -58,6 +60,59 @@ class MusicBrainz5::CReleaseGroupPrivate
 		{
 		}
 
+		CReleaseGroupPrivate(const CReleaseGroupPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_PrimaryType(Other.m_PrimaryType),
+			m_Title(Other.m_Title),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_FirstReleaseDate(Other.m_FirstReleaseDate),
+			m_ArtistCredit(0),
+			m_ReleaseList(0),
+			m_RelationListList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_Rating(0),
+			m_UserRating(0),
+			m_SecondaryTypeList(0)
+		{
+			if (Other.m_ArtistCredit)
+				m_ArtistCredit=new CArtistCredit(*Other.m_ArtistCredit);
+
+			if (Other.m_ReleaseList)
+				m_ReleaseList=new CReleaseList(*Other.m_ReleaseList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+
+			if (Other.m_SecondaryTypeList)
+				m_SecondaryTypeList=new CSecondaryTypeList(*Other.m_SecondaryTypeList);
+		}
+
+		~CReleaseGroupPrivate()
+		{
+			delete m_ArtistCredit;
+			delete m_ReleaseList;
+			delete m_RelationListList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_Rating;
+			delete m_UserRating;
+			delete m_SecondaryTypeList;
+		}
+
 		std::string m_ID;
 		std::string m_PrimaryType;
 		std::string m_Title;
@@ -86,86 +141,46 @@ MusicBrainz5::CReleaseGroup::CReleaseGroup(const XMLNode& Node)
 }
 
 MusicBrainz5::CReleaseGroup::CReleaseGroup(const CReleaseGroup& Other)
-:	CEntity(),
-	m_d(new CReleaseGroupPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CReleaseGroup& MusicBrainz5::CReleaseGroup::operator =(const CReleaseGroup& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_PrimaryType=Other.m_d->m_PrimaryType;
-		m_d->m_Title=Other.m_d->m_Title;
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-		m_d->m_FirstReleaseDate=Other.m_d->m_FirstReleaseDate;
-
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
-
-		if (Other.m_d->m_ReleaseList)
-			m_d->m_ReleaseList=new CReleaseList(*Other.m_d->m_ReleaseList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
-
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
-
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
-
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
-
-		if (Other.m_d->m_SecondaryTypeList)
-			m_d->m_SecondaryTypeList=new CSecondaryTypeList(*Other.m_d->m_SecondaryTypeList);
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CReleaseGroup::~CReleaseGroup()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CReleaseGroup::CReleaseGroup(CReleaseGroup&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CReleaseGroupPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CReleaseGroup::Cleanup()
+MusicBrainz5::CReleaseGroup& MusicBrainz5::CReleaseGroup::operator =(CReleaseGroup&& Other)
 {
-	delete m_d->m_ArtistCredit;
-	m_d->m_ArtistCredit=0;
-
-	delete m_d->m_ReleaseList;
-	m_d->m_ReleaseList=0;
-
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
-
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
-
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
-
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_SecondaryTypeList;
-	m_d->m_SecondaryTypeList=0;
+MusicBrainz5::CReleaseGroup::~CReleaseGroup()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CReleaseGroup *MusicBrainz5::CReleaseGroup::Clone()
@@ -175,6 +190,8 @@ MusicBrainz5::CReleaseGroup *MusicBrainz5::CReleaseGroup::Clone()
 
 void MusicBrainz5::CReleaseGroup::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else if ("type"==Name)
@@ -191,61 +208,63 @@ void MusicBrainz5::CReleaseGroup::ParseAttribute(const std::string& Name, const
 
 void MusicBrainz5::CReleaseGroup::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("primary-type"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_PrimaryType);
-	}
-	else if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("first-release-date"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_FirstReleaseDate);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("release-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ReleaseList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("secondary-type-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_SecondaryTypeList);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementPrimaryType:
+			ProcessItem(Node,m_d->m_PrimaryType);
+			break;
+
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElementFirstReleaseDate:
+			ProcessItem(Node,m_d->m_FirstReleaseDate);
+			break;
+
+		case eElementArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElementReleaseList:
+			ProcessItem(Node,m_d->m_ReleaseList);
+			break;
+
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		case eElementSecondaryTypeList:
+			ProcessItem(Node,m_d->m_SecondaryTypeList);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised release group element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised release group element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -254,68 +273,129 @@ std::string MusicBrainz5::CReleaseGroup::GetElementName()
 	return "release-group";
 }
 
-std::string MusicBrainz5::CReleaseGroup::ID() const
+const std::string& MusicBrainz5::CReleaseGroup::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CReleaseGroup::PrimaryType() const
+MusicBrainz5::CMBID MusicBrainz5::CReleaseGroup::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CReleaseGroup::PrimaryType() const
 {
 	return m_d->m_PrimaryType;
 }
 
-std::string MusicBrainz5::CReleaseGroup::Title() const
+const std::string& MusicBrainz5::CReleaseGroup::Title() const
 {
 	return m_d->m_Title;
 }
 
-std::string MusicBrainz5::CReleaseGroup::Disambiguation() const
+const std::string& MusicBrainz5::CReleaseGroup::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-std::string MusicBrainz5::CReleaseGroup::FirstReleaseDate() const
+const std::string& MusicBrainz5::CReleaseGroup::FirstReleaseDate() const
 {
 	return m_d->m_FirstReleaseDate;
 }
 
-MusicBrainz5::CArtistCredit *MusicBrainz5::CReleaseGroup::ArtistCredit() const
+const MusicBrainz5::CArtistCredit *MusicBrainz5::CReleaseGroup::ArtistCredit() const
+{
+	return m_d->m_ArtistCredit;
+}
+
+MusicBrainz5::CArtistCredit *MusicBrainz5::CReleaseGroup::ArtistCredit()
 {
+	Unshare(m_d);
+
 	return m_d->m_ArtistCredit;
 }
 
-MusicBrainz5::CReleaseList *MusicBrainz5::CReleaseGroup::ReleaseList() const
+const MusicBrainz5::CReleaseList *MusicBrainz5::CReleaseGroup::ReleaseList() const
 {
 	return m_d->m_ReleaseList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CReleaseGroup::RelationListList() const
+MusicBrainz5::CReleaseList *MusicBrainz5::CReleaseGroup::ReleaseList()
 {
+	Unshare(m_d);
+
+	return m_d->m_ReleaseList;
+}
+
+const MusicBrainz5::CRelationListList *MusicBrainz5::CReleaseGroup::RelationListList() const
+{
+	return m_d->m_RelationListList;
+}
+
+MusicBrainz5::CRelationListList *MusicBrainz5::CReleaseGroup::RelationListList()
+{
+	Unshare(m_d);
+
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CReleaseGroup::TagList() const
+const MusicBrainz5::CTagList *MusicBrainz5::CReleaseGroup::TagList() const
+{
+	return m_d->m_TagList;
+}
+
+MusicBrainz5::CTagList *MusicBrainz5::CReleaseGroup::TagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CReleaseGroup::UserTagList() const
+const MusicBrainz5::CUserTagList *MusicBrainz5::CReleaseGroup::UserTagList() const
+{
+	return m_d->m_UserTagList;
+}
+
+MusicBrainz5::CUserTagList *MusicBrainz5::CReleaseGroup::UserTagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CReleaseGroup::Rating() const
+const MusicBrainz5::CRating *MusicBrainz5::CReleaseGroup::Rating() const
 {
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CReleaseGroup::UserRating() const
+MusicBrainz5::CRating *MusicBrainz5::CReleaseGroup::Rating()
+{
+	Unshare(m_d);
+
+	return m_d->m_Rating;
+}
+
+const MusicBrainz5::CUserRating *MusicBrainz5::CReleaseGroup::UserRating() const
 {
 	return m_d->m_UserRating;
 }
 
-MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CReleaseGroup::SecondaryTypeList() const
+MusicBrainz5::CUserRating *MusicBrainz5::CReleaseGroup::UserRating()
 {
+	Unshare(m_d);
+
+	return m_d->m_UserRating;
+}
+
+const MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CReleaseGroup::SecondaryTypeList() const
+{
+	return m_d->m_SecondaryTypeList;
+}
+
+MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CReleaseGroup::SecondaryTypeList()
+{
+	Unshare(m_d);
+
 	return m_d->m_SecondaryTypeList;
 }
 
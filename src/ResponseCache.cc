@@ -0,0 +1,462 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/ResponseCache.h"
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+
+#include <pthread.h>
+#include <time.h>
+
+class MusicBrainz5::CResponseCachePrivate
+{
+	public:
+		class CEntry
+		{
+		public:
+			std::string m_Key;
+			CMetadata m_Metadata;
+			std::string m_ETag;
+			std::string m_LastModified;
+			size_t m_Size;
+			time_t m_Stored;
+			bool m_NotFound;
+		};
+
+		typedef std::list<CEntry> tEntryList;
+
+		CResponseCachePrivate()
+		:	m_MaxSize(0),
+			m_TTL(0),
+			m_NegativeTTL(60*60),
+			m_Size(0),
+			m_Hits(0),
+			m_Misses(0),
+			m_Evictions(0)
+		{
+			pthread_mutex_init(&m_Mutex,0);
+		}
+
+		~CResponseCachePrivate()
+		{
+			pthread_mutex_destroy(&m_Mutex);
+		}
+
+		mutable pthread_mutex_t m_Mutex;
+
+		//The most recently used entry is at the front of the list
+
+		tEntryList m_Entries;
+		std::map<std::string,tEntryList::iterator> m_Index;
+		size_t m_MaxSize;
+		int m_TTL;
+		int m_NegativeTTL;
+		size_t m_Size;
+		unsigned long m_Hits;
+		unsigned long m_Misses;
+		unsigned long m_Evictions;
+
+		static time_t Now();
+
+		tEntryList::iterator Find(const std::string& Key);
+		void Erase(tEntryList::iterator Entry);
+		void Trim(size_t MaxSize);
+		bool Add(const std::string& Key, size_t Size);
+};
+
+//Holds a mutex locked for as long as it is in scope
+
+class CResponseCacheLock
+{
+	public:
+		CResponseCacheLock(pthread_mutex_t *Mutex)
+		:	m_Mutex(Mutex)
+		{
+			pthread_mutex_lock(m_Mutex);
+		}
+
+		~CResponseCacheLock()
+		{
+			pthread_mutex_unlock(m_Mutex);
+		}
+
+	private:
+		pthread_mutex_t *m_Mutex;
+};
+
+time_t MusicBrainz5::CResponseCachePrivate::Now()
+{
+	struct timespec TimeNow;
+	clock_gettime(CLOCK_MONOTONIC,&TimeNow);
+
+	return TimeNow.tv_sec;
+}
+
+MusicBrainz5::CResponseCachePrivate::tEntryList::iterator MusicBrainz5::CResponseCachePrivate::Find(const std::string& Key)
+{
+	std::map<std::string,tEntryList::iterator>::iterator ThisEntry=m_Index.find(Key);
+	if (ThisEntry==m_Index.end())
+		return m_Entries.end();
+
+	return (*ThisEntry).second;
+}
+
+void MusicBrainz5::CResponseCachePrivate::Erase(tEntryList::iterator Entry)
+{
+	m_Size-=(*Entry).m_Size;
+	m_Index.erase((*Entry).m_Key);
+	m_Entries.erase(Entry);
+}
+
+void MusicBrainz5::CResponseCachePrivate::Trim(size_t MaxSize)
+{
+	while (m_Size>MaxSize && !m_Entries.empty())
+	{
+		Erase(--m_Entries.end());
+		m_Evictions++;
+	}
+}
+
+bool MusicBrainz5::CResponseCachePrivate::Add(const std::string& Key, size_t Size)
+{
+	//Adds an entry at the front of the list, which the caller fills in, replacing any
+	//entry for the key. Returns false if the entry is too large to be held.
+
+	tEntryList::iterator Existing=Find(Key);
+	if (Existing!=m_Entries.end())
+		Erase(Existing);
+
+	if (Size>m_MaxSize)
+		return false;
+
+	Trim(m_MaxSize-Size);
+
+	m_Entries.push_front(CEntry());
+
+	CEntry& Entry=m_Entries.front();
+	Entry.m_Key=Key;
+	Entry.m_Size=Size;
+	Entry.m_Stored=Now();
+	Entry.m_NotFound=false;
+
+	m_Index[Key]=m_Entries.begin();
+	m_Size+=Size;
+
+	return true;
+}
+
+MusicBrainz5::CResponseCache::CResponseCache(size_t MaxSize, int TTL)
+:	m_d(new CResponseCachePrivate)
+{
+	m_d->m_MaxSize=MaxSize;
+	m_d->m_TTL=TTL;
+}
+
+MusicBrainz5::CResponseCache::~CResponseCache()
+{
+	delete m_d;
+}
+
+void MusicBrainz5::CResponseCache::SetMaxSize(size_t MaxSize)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	m_d->m_MaxSize=MaxSize;
+	m_d->Trim(MaxSize);
+}
+
+size_t MusicBrainz5::CResponseCache::MaxSize() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_MaxSize;
+}
+
+void MusicBrainz5::CResponseCache::SetTTL(int TTL)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	m_d->m_TTL=TTL;
+}
+
+int MusicBrainz5::CResponseCache::TTL() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_TTL;
+}
+
+void MusicBrainz5::CResponseCache::SetNegativeTTL(int NegativeTTL)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	m_d->m_NegativeTTL=NegativeTTL;
+}
+
+int MusicBrainz5::CResponseCache::NegativeTTL() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_NegativeTTL;
+}
+
+bool MusicBrainz5::CResponseCache::Get(const std::string& Key, CMetadata& Metadata)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	CResponseCachePrivate::tEntryList::iterator Entry=m_d->Find(Key);
+
+	//Expired entries are kept in case they can be revalidated
+
+	if (Entry==m_d->m_Entries.end() || (*Entry).m_NotFound || CResponseCachePrivate::Now()-(*Entry).m_Stored>=m_d->m_TTL)
+	{
+		m_d->m_Misses++;
+		return false;
+	}
+
+	m_d->m_Entries.splice(m_d->m_Entries.begin(),m_d->m_Entries,Entry);
+	m_d->m_Hits++;
+
+	Metadata=(*Entry).m_Metadata;
+
+	return true;
+}
+
+bool MusicBrainz5::CResponseCache::GetStale(const std::string& Key, CMetadata& Metadata, std::string& ETag, std::string& LastModified)
+{
+	size_t Size;
+
+	return GetStale(Key,Metadata,ETag,LastModified,Size);
+}
+
+bool MusicBrainz5::CResponseCache::GetStale(const std::string& Key, CMetadata& Metadata, std::string& ETag, std::string& LastModified, size_t& Size)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	CResponseCachePrivate::tEntryList::iterator Entry=m_d->Find(Key);
+	if (Entry==m_d->m_Entries.end() || (*Entry).m_NotFound)
+		return false;
+
+	m_d->m_Entries.splice(m_d->m_Entries.begin(),m_d->m_Entries,Entry);
+
+	Metadata=(*Entry).m_Metadata;
+	ETag=(*Entry).m_ETag;
+	LastModified=(*Entry).m_LastModified;
+	Size=(*Entry).m_Size;
+
+	return true;
+}
+
+void MusicBrainz5::CResponseCache::Put(const std::string& Key, const CMetadata& Metadata, size_t Size, const std::string& ETag, const std::string& LastModified)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	if (!m_d->Add(Key,Size))
+		return;
+
+	CResponseCachePrivate::CEntry& Entry=m_d->m_Entries.front();
+	Entry.m_Metadata=Metadata;
+	Entry.m_ETag=ETag;
+	Entry.m_LastModified=LastModified;
+}
+
+void MusicBrainz5::CResponseCache::PutNotFound(const std::string& Key)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	//Only the key takes up any space
+
+	if (m_d->Add(Key,Key.length()))
+		m_d->m_Entries.front().m_NotFound=true;
+}
+
+bool MusicBrainz5::CResponseCache::NotFound(const std::string& Key)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	CResponseCachePrivate::tEntryList::iterator Entry=m_d->Find(Key);
+
+	return Entry!=m_d->m_Entries.end() && (*Entry).m_NotFound &&
+		CResponseCachePrivate::Now()-(*Entry).m_Stored<m_d->m_NegativeTTL;
+}
+
+bool MusicBrainz5::CResponseCache::Refresh(const std::string& Key)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	CResponseCachePrivate::tEntryList::iterator Entry=m_d->Find(Key);
+	if (Entry==m_d->m_Entries.end() || (*Entry).m_NotFound)
+		return false;
+
+	(*Entry).m_Stored=CResponseCachePrivate::Now();
+
+	return true;
+}
+
+void MusicBrainz5::CResponseCache::Remove(const std::string& Key)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	CResponseCachePrivate::tEntryList::iterator Entry=m_d->Find(Key);
+	if (Entry!=m_d->m_Entries.end())
+		m_d->Erase(Entry);
+}
+
+void MusicBrainz5::CResponseCache::RemovePrefix(const std::string& Prefix)
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	std::map<std::string,CResponseCachePrivate::tEntryList::iterator>::iterator ThisEntry=m_d->m_Index.lower_bound(Prefix);
+	while (ThisEntry!=m_d->m_Index.end() && 0==ThisEntry->first.compare(0,Prefix.length(),Prefix))
+	{
+		//Erase removes the index entry too
+
+		CResponseCachePrivate::tEntryList::iterator Entry=ThisEntry->second;
+		++ThisEntry;
+
+		m_d->Erase(Entry);
+	}
+}
+
+void MusicBrainz5::CResponseCache::Clear()
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	m_d->m_Entries.clear();
+	m_d->m_Index.clear();
+	m_d->m_Size=0;
+}
+
+int MusicBrainz5::CResponseCache::NumEntries() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Index.size();
+}
+
+size_t MusicBrainz5::CResponseCache::Size() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Size;
+}
+
+unsigned long MusicBrainz5::CResponseCache::Hits() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Hits;
+}
+
+unsigned long MusicBrainz5::CResponseCache::Misses() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Misses;
+}
+
+unsigned long MusicBrainz5::CResponseCache::Evictions() const
+{
+	CResponseCacheLock Lock(&m_d->m_Mutex);
+
+	return m_d->m_Evictions;
+}
+
+std::string MusicBrainz5::CResponseCache::Key(const std::string& Host, const std::string& URL)
+{
+	std::string::size_type QueryStart=URL.find('?');
+	if (QueryStart==std::string::npos)
+		return Host+URL;
+
+	std::vector<std::string> Params;
+
+	std::string::size_type Start=QueryStart+1;
+	while (Start<=URL.length())
+	{
+		std::string::size_type End=URL.find('&',Start);
+		if (End==std::string::npos)
+			End=URL.length();
+
+		std::string Param=URL.substr(Start,End-Start);
+
+		if (0==Param.compare(0,4,"inc="))
+		{
+			//The values may be separated by '+', or by an escaped or unescaped space
+
+			std::vector<std::string> Values;
+
+			std::string::size_type ValueStart=4;
+			while (ValueStart<=Param.length())
+			{
+				std::string::size_type ValueEnd=Param.find_first_of("+ %",ValueStart);
+				while (ValueEnd!=std::string::npos && '%'==Param[ValueEnd] && 0!=Param.compare(ValueEnd,3,"%20"))
+					ValueEnd=Param.find_first_of("+ %",ValueEnd+1);
+
+				if (ValueEnd==std::string::npos)
+					ValueEnd=Param.length();
+
+				if (ValueEnd>ValueStart)
+					Values.push_back(Param.substr(ValueStart,ValueEnd-ValueStart));
+
+				if (ValueEnd==Param.length())
+					break;
+
+				ValueStart=ValueEnd+('%'==Param[ValueEnd] ? 3 : 1);
+			}
+
+			std::sort(Values.begin(),Values.end());
+			Values.erase(std::unique(Values.begin(),Values.end()),Values.end());
+
+			Param="inc=";
+			for (std::vector<std::string>::size_type count=0;count<Values.size();count++)
+			{
+				if (count)
+					Param+="+";
+
+				Param+=Values[count];
+			}
+		}
+
+		if (!Param.empty())
+			Params.push_back(Param);
+
+		Start=End+1;
+	}
+
+	std::sort(Params.begin(),Params.end());
+
+	std::string Ret=Host+URL.substr(0,QueryStart);
+
+	for (std::vector<std::string>::size_type count=0;count<Params.size();count++)
+		Ret+=(count ? "&" : "?")+Params[count];
+
+	return Ret;
+}
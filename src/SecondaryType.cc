@@ -27,16 +27,19 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/SecondaryType.h"
+#include "musicbrainz5/StringPool.h"
+#include "SharedPrivate.h"
 
 
-class MusicBrainz5::CSecondaryTypePrivate
+class MusicBrainz5::CSecondaryTypePrivate: public CSharedPrivate
 {
 	public:
 		CSecondaryTypePrivate()
+		:	m_SecondaryType(&CStringPool::Empty())
 		{
 		}
 
-		std::string m_SecondaryType;
+		const std::string *m_SecondaryType;
 };
 
 MusicBrainz5::CSecondaryType::CSecondaryType(const XMLNode& Node)
@@ -50,40 +53,51 @@ MusicBrainz5::CSecondaryType::CSecondaryType(const XMLNode& Node)
 		Parse(Node);
 
 		if (Node.getText())
-			ProcessItem(Node,m_d->m_SecondaryType);
+			InternItem(Node,m_d->m_SecondaryType);
 	}
 }
 
 MusicBrainz5::CSecondaryType::CSecondaryType(const CSecondaryType& Other)
-:	CEntity(),
-	m_d(new CSecondaryTypePrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CSecondaryType& MusicBrainz5::CSecondaryType::operator =(const CSecondaryType& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_SecondaryType=Other.m_d->m_SecondaryType;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CSecondaryType::~CSecondaryType()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CSecondaryType::CSecondaryType(CSecondaryType&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CSecondaryTypePrivate>())
 {
-	Cleanup();
+	std::swap(m_d,Other.m_d);
+}
 
-	delete m_d;
+MusicBrainz5::CSecondaryType& MusicBrainz5::CSecondaryType::operator =(CSecondaryType&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
 }
+#endif
 
-void MusicBrainz5::CSecondaryType::Cleanup()
+MusicBrainz5::CSecondaryType::~CSecondaryType()
 {
+	m_d->Unref();
 }
 
 MusicBrainz5::CSecondaryType *MusicBrainz5::CSecondaryType::Clone()
@@ -102,10 +116,10 @@ void MusicBrainz5::CSecondaryType::ParseAttribute(const std::string& Name, const
 
 void MusicBrainz5::CSecondaryType::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised secondary type element: '" << NodeName << "'" << std::endl;
+	std::cerr << "Unrecognised secondary type element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -114,9 +128,9 @@ std::string MusicBrainz5::CSecondaryType::GetElementName()
 	return "secondary-type";
 }
 
-std::string MusicBrainz5::CSecondaryType::SecondaryType() const
+const std::string& MusicBrainz5::CSecondaryType::SecondaryType() const
 {
-	return m_d->m_SecondaryType;
+	return *m_d->m_SecondaryType;
 }
 
 std::ostream& MusicBrainz5::CSecondaryType::Serialise(std::ostream& os) const
@@ -29,8 +29,9 @@
 #include "musicbrainz5/SecondaryTypeList.h"
 
 #include "musicbrainz5/SecondaryType.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CSecondaryTypeListPrivate
+class MusicBrainz5::CSecondaryTypeListPrivate: public CSharedPrivate
 {
 	public:
 		CSecondaryTypeListPrivate()
@@ -51,10 +52,9 @@ MusicBrainz5::CSecondaryTypeList::CSecondaryTypeList(const XMLNode& Node)
 }
 
 MusicBrainz5::CSecondaryTypeList::CSecondaryTypeList(const CSecondaryTypeList& Other)
-:	CListImpl<CSecondaryType>(),
-	m_d(new CSecondaryTypeListPrivate)
+:	CListImpl<CSecondaryType>(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CSecondaryTypeList& MusicBrainz5::CSecondaryTypeList::operator =(const CSecondaryTypeList& Other)
@@ -62,14 +62,36 @@ MusicBrainz5::CSecondaryTypeList& MusicBrainz5::CSecondaryTypeList::operator =(c
 	if (this!=&Other)
 	{
 		CListImpl<CSecondaryType>::operator =(Other);
+
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CSecondaryTypeList::CSecondaryTypeList(CSecondaryTypeList&& Other)
+:	CListImpl<CSecondaryType>(std::move(Other)),
+	m_d(SharedEmpty<CSecondaryTypeListPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CSecondaryTypeList& MusicBrainz5::CSecondaryTypeList::operator =(CSecondaryTypeList&& Other)
+{
+	if (this!=&Other)
+	{
+		CListImpl<CSecondaryType>::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CSecondaryTypeList::~CSecondaryTypeList()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CSecondaryTypeList *MusicBrainz5::CSecondaryTypeList::Clone()
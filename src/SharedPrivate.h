@@ -0,0 +1,161 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_SHARED_PRIVATE_H
+#define _MUSICBRAINZ5_SHARED_PRIVATE_H
+
+namespace MusicBrainz5
+{
+	//Base for the private data of the entity classes. Copies of an entity share the
+	//same private data, which is reference counted and deleted along with the last
+	//copy. An entity calls Detach before modifying its private data, so that it gets
+	//its own copy if the data is shared.
+	//
+	//Once an entity has handed out a pointer through which one of its children may be
+	//modified, its private data is marked as unsharable and later copies of it get
+	//their own data instead, so that they don't see changes made through the pointer.
+
+	class CSharedPrivate
+	{
+	public:
+		CSharedPrivate()
+		:	m_References(1),
+			m_Sharable(true)
+		{
+		}
+
+		CSharedPrivate(const CSharedPrivate& /*Other*/)
+		:	m_References(1),
+			m_Sharable(true)
+		{
+		}
+
+		virtual ~CSharedPrivate()
+		{
+		}
+
+		void Ref()
+		{
+			__sync_add_and_fetch(&m_References,1);
+		}
+
+		void Unref()
+		{
+			if (0==__sync_sub_and_fetch(&m_References,1))
+				delete this;
+		}
+
+		//Only the owner of the sole reference can see 1 here, and nobody else can
+		//add a reference without going through it, so no barrier is needed
+
+		bool Shared() const
+		{
+			return m_References>1;
+		}
+
+		bool Sharable() const
+		{
+			return m_Sharable;
+		}
+
+		void SetUnsharable()
+		{
+			m_Sharable=false;
+		}
+
+	private:
+		int m_References;
+		bool m_Sharable;
+
+		CSharedPrivate& operator =(const CSharedPrivate& Other);
+	};
+
+	template <class T>
+	void Detach(T*& Private)
+	{
+		if (Private->Shared())
+		{
+			T *Copy=new T(*Private);
+			Private->Unref();
+			Private=Copy;
+		}
+	}
+
+	//Called by non-const accessors before returning a child that may be modified
+
+	template <class T>
+	void Unshare(T*& Private)
+	{
+		Detach(Private);
+		Private->SetUnsharable();
+	}
+
+	//Returns a reference to an empty private data object shared by every entity of a
+	//type that has been moved from, so that moving doesn't allocate. It is never
+	//modified, as an entity holding it is never its only user, and never deleted.
+
+	template <class T>
+	T *SharedEmpty()
+	{
+		static T *Empty=new T;
+
+		Empty->Ref();
+		return Empty;
+	}
+
+	//Takes the private data of an entity being moved from, leaving it with the shared
+	//empty data so that it is the same as a default constructed entity
+
+	template <class T>
+	void Move(T*& Private, T*& Other)
+	{
+		T *Empty=SharedEmpty<T>();
+		Private->Unref();
+		Private=Other;
+		Other=Empty;
+	}
+
+	//Returns the private data for a new copy of an entity
+
+	template <class T>
+	T *Share(T *Private)
+	{
+		if (!Private->Sharable())
+			return new T(*Private);
+
+		Private->Ref();
+		return Private;
+	}
+
+	template <class T>
+	void Assign(T*& Private, T *Other)
+	{
+		T *New=Share(Other);
+		Private->Unref();
+		Private=New;
+	}
+}
+
+#endif
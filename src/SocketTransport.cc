@@ -0,0 +1,262 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/SocketTransport.h"
+
+#include <sstream>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "musicbrainz5/HTTPFetch.h"
+
+//Closes a socket when it goes out of scope, so that it isn't leaked when a request
+//fails part way through
+
+class CSocketCloser
+{
+	public:
+		CSocketCloser(int Socket)
+		:	m_Socket(Socket)
+		{
+		}
+
+		~CSocketCloser()
+		{
+			close(m_Socket);
+		}
+
+	private:
+		int m_Socket;
+};
+
+namespace MusicBrainz5
+{
+	class CSocketFetch: public CFetch
+	{
+	public:
+		CSocketFetch(const std::string& SocketPath, const std::string& UserAgent, const std::string& Host, int Port)
+		:	CFetch(UserAgent,Host,Port),
+			m_SocketPath(SocketPath)
+		{
+		}
+
+		int Fetch(const std::string& URL, const std::string& Request)
+		{
+			Reset();
+
+			int Socket=Connect();
+			CSocketCloser Closer(Socket);
+
+			std::stringstream os;
+			os << Request << " " << URL << " HTTP/1.0\r\n";
+			os << "Host: " << Host() << "\r\n";
+			os << "User-Agent: " << UserAgent() << "\r\n";
+
+			std::map<std::string,std::string> Headers=RequestHeaders();
+			for (std::map<std::string,std::string>::const_iterator ThisHeader=Headers.begin();ThisHeader!=Headers.end();++ThisHeader)
+				os << (*ThisHeader).first << ": " << (*ThisHeader).second << "\r\n";
+
+			os << "Connection: close\r\n";
+			os << "\r\n";
+
+			std::string Header=os.str();
+			std::string::size_type Sent=0;
+			while (Sent<Header.length())
+			{
+				//A server that closes the connection early mustn't kill the process with SIGPIPE
+
+				ssize_t Ret=send(Socket,Header.c_str()+Sent,Header.length()-Sent,MSG_NOSIGNAL);
+				if (Ret<0 && errno!=EINTR)
+					Fail();
+
+				if (Ret>0)
+					Sent+=Ret;
+			}
+
+			std::string ResponseHeader;
+			bool InBody=false;
+			char Buffer[4096];
+
+			ssize_t Ret;
+			while (0!=(Ret=read(Socket,Buffer,sizeof(Buffer))))
+			{
+				if (Ret<0)
+				{
+					if (errno==EINTR)
+						continue;
+
+					Fail();
+				}
+
+				if (InBody)
+				{
+					AddBody(Buffer,Ret);
+				}
+				else
+				{
+					ResponseHeader.append(Buffer,Ret);
+
+					std::string::size_type HeaderEnd=ResponseHeader.find("\r\n\r\n");
+					if (HeaderEnd!=std::string::npos)
+					{
+						InBody=true;
+
+						int Status=0;
+						if (1!=sscanf(ResponseHeader.c_str(),"HTTP/%*d.%*d %d",&Status))
+						{
+							SetResult(-1);
+							SetErrorMessage("Malformed response from '" + m_SocketPath + "'");
+							throw CFetchError(ErrorMessage());
+						}
+
+						SetStatus(Status);
+						AddHeaders(ResponseHeader.substr(0,HeaderEnd));
+
+						AddBody(ResponseHeader.c_str()+HeaderEnd+4,ResponseHeader.length()-HeaderEnd-4);
+					}
+				}
+			}
+
+			if (!InBody)
+			{
+				SetResult(-1);
+				SetErrorMessage("Incomplete response from '" + m_SocketPath + "'");
+				throw CFetchError(ErrorMessage());
+			}
+
+			CheckStatus();
+
+			return DataSize();
+		}
+
+	private:
+		std::string m_SocketPath;
+
+		int Connect()
+		{
+			struct sockaddr_un Address;
+			memset(&Address,0,sizeof(Address));
+			Address.sun_family=AF_UNIX;
+
+			if (m_SocketPath.length()>=sizeof(Address.sun_path))
+			{
+				SetResult(ENAMETOOLONG);
+				SetErrorMessage("Socket path too long: '" + m_SocketPath + "'");
+				throw CConnectionError(ErrorMessage());
+			}
+
+			strncpy(Address.sun_path,m_SocketPath.c_str(),sizeof(Address.sun_path)-1);
+
+			int Socket=socket(AF_UNIX,SOCK_STREAM,0);
+			if (-1==Socket)
+				Fail();
+
+			if (0!=connect(Socket,(struct sockaddr *)&Address,sizeof(Address)))
+			{
+				SetResult(errno);
+				SetErrorMessage(strerror(errno));
+				close(Socket);
+				throw CConnectionError(ErrorMessage());
+			}
+
+			return Socket;
+		}
+
+		void Fail()
+		{
+			SetResult(errno);
+			SetErrorMessage(strerror(errno));
+
+			throw CFetchError(ErrorMessage());
+		}
+
+		void AddHeaders(const std::string& Header)
+		{
+			std::string::size_type Start=Header.find("\r\n");
+			while (std::string::npos!=Start)
+			{
+				Start+=2;
+
+				std::string::size_type End=Header.find("\r\n",Start);
+				std::string Line=Header.substr(Start,std::string::npos==End ? std::string::npos : End-Start);
+				Start=End;
+
+				std::string::size_type Colon=Line.find(':');
+				if (std::string::npos!=Colon)
+				{
+					std::string::size_type ValueStart=Line.find_first_not_of(" \t",Colon+1);
+					AddResponseHeader(Line.substr(0,Colon),std::string::npos==ValueStart ? "" : Line.substr(ValueStart));
+				}
+			}
+		}
+
+		void AddBody(const char *Data, size_t Len)
+		{
+			//Only successful responses carry data, in the same way as CHTTPFetch
+
+			if (Status()>=200 && Status()<300)
+				AddData(Data,Len);
+		}
+	};
+}
+
+class MusicBrainz5::CSocketTransportPrivate
+{
+	public:
+		CSocketTransportPrivate()
+		{
+		}
+
+		std::string m_SocketPath;
+};
+
+MusicBrainz5::CSocketTransport::CSocketTransport(const std::string& SocketPath)
+:	m_d(new CSocketTransportPrivate)
+{
+	m_d->m_SocketPath=SocketPath;
+}
+
+MusicBrainz5::CSocketTransport::~CSocketTransport()
+{
+	delete m_d;
+}
+
+MusicBrainz5::CFetch *MusicBrainz5::CSocketTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CSocketFetch(m_d->m_SocketPath,UserAgent,Host,Port);
+}
+
+std::string MusicBrainz5::CSocketTransport::SocketPath() const
+{
+	return m_d->m_SocketPath;
+}
@@ -0,0 +1,137 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/StringPool.h"
+
+#include <map>
+
+#include <pthread.h>
+#include <string.h>
+
+//The pool is keyed by the characters of each string, so that a value can be looked
+//up without first copying it into a std::string. The key of each entry points into
+//the string it maps to, which is never modified.
+
+namespace
+{
+	class CPoolKey
+	{
+		public:
+			CPoolKey(const char *Data, size_t Length)
+			:	m_Data(Data),
+				m_Length(Length)
+			{
+			}
+
+			bool operator <(const CPoolKey& Other) const
+			{
+				int Compare=memcmp(m_Data,Other.m_Data,m_Length<Other.m_Length ? m_Length : Other.m_Length);
+
+				return Compare<0 || (0==Compare && m_Length<Other.m_Length);
+			}
+
+		private:
+			const char *m_Data;
+			size_t m_Length;
+	};
+
+	typedef std::map<CPoolKey,const std::string *> tPool;
+}
+
+//The pool is created on first use and never destroyed, so that the strings it
+//holds stay valid for entities destroyed during static destruction
+
+static pthread_once_t PoolOnce=PTHREAD_ONCE_INIT;
+static pthread_rwlock_t PoolLock;
+static tPool *Pool=0;
+static const std::string *EmptyString=0;
+
+static void CreatePool()
+{
+	pthread_rwlock_init(&PoolLock,0);
+	Pool=new tPool;
+	EmptyString=new std::string;
+}
+
+const std::string& MusicBrainz5::CStringPool::Intern(const std::string& Value)
+{
+	return Intern(Value.data(),Value.length());
+}
+
+const std::string& MusicBrainz5::CStringPool::Intern(const char *Value, size_t Length)
+{
+	pthread_once(&PoolOnce,CreatePool);
+
+	if (0==Length)
+		return *EmptyString;
+
+	//Almost every value is in the pool already, so look for it while allowing
+	//other readers, and only take the lock exclusively to add a new one
+
+	pthread_rwlock_rdlock(&PoolLock);
+	tPool::const_iterator ThisString=Pool->find(CPoolKey(Value,Length));
+	const std::string *Ret=ThisString!=Pool->end() ? (*ThisString).second : 0;
+	pthread_rwlock_unlock(&PoolLock);
+
+	if (!Ret)
+	{
+		//Another thread may have added the same value since the lookup
+
+		std::string *New=new std::string(Value,Length);
+
+		pthread_rwlock_wrlock(&PoolLock);
+		std::pair<tPool::iterator,bool> Inserted=Pool->insert(std::make_pair(CPoolKey(New->data(),New->length()),New));
+		Ret=(*Inserted.first).second;
+		pthread_rwlock_unlock(&PoolLock);
+
+		if (!Inserted.second)
+			delete New;
+	}
+
+	return *Ret;
+}
+
+const std::string& MusicBrainz5::CStringPool::Empty()
+{
+	pthread_once(&PoolOnce,CreatePool);
+
+	return *EmptyString;
+}
+
+int MusicBrainz5::CStringPool::NumStrings()
+{
+	pthread_once(&PoolOnce,CreatePool);
+
+	//The empty string is held separately, but counts as one of the strings
+
+	pthread_rwlock_rdlock(&PoolLock);
+	int Ret=Pool->size()+1;
+	pthread_rwlock_unlock(&PoolLock);
+
+	return Ret;
+}
@@ -27,8 +27,10 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/Tag.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CTagPrivate
+class MusicBrainz5::CTagPrivate: public CSharedPrivate
 {
 	public:
 		CTagPrivate()
@@ -53,10 +55,9 @@ MusicBrainz5::CTag::CTag(const XMLNode& Node)
 }
 
 MusicBrainz5::CTag::CTag(const CTag& Other)
-:	CEntity(),
-	m_d(new CTagPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CTag& MusicBrainz5::CTag::operator =(const CTag& Other)
@@ -65,16 +66,35 @@ MusicBrainz5::CTag& MusicBrainz5::CTag::operator =(const CTag& Other)
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Count=Other.m_d->m_Count;
-		m_d->m_Name=Other.m_d->m_Name;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CTag::CTag(CTag&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CTagPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CTag& MusicBrainz5::CTag::operator =(CTag&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CTag::~CTag()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CTag *MusicBrainz5::CTag::Clone()
@@ -84,6 +104,8 @@ MusicBrainz5::CTag *MusicBrainz5::CTag::Clone()
 
 void MusicBrainz5::CTag::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("count"==Name)
 	{
 		ProcessItem(Value,m_d->m_Count);
@@ -98,17 +120,19 @@ void MusicBrainz5::CTag::ParseAttribute(const std::string& Name, const std::stri
 
 void MusicBrainz5::CTag::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised tag element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised tag element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -122,7 +146,7 @@ int MusicBrainz5::CTag::Count() const
 	return m_d->m_Count;
 }
 
-std::string MusicBrainz5::CTag::Name() const
+const std::string& MusicBrainz5::CTag::Name() const
 {
 	return m_d->m_Name;
 }
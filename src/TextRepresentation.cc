@@ -27,8 +27,10 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/TextRepresentation.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CTextRepresentationPrivate
+class MusicBrainz5::CTextRepresentationPrivate: public CSharedPrivate
 {
 	public:
 		std::string m_Language;
@@ -48,10 +50,9 @@ MusicBrainz5::CTextRepresentation::CTextRepresentation(const XMLNode& Node)
 }
 
 MusicBrainz5::CTextRepresentation::CTextRepresentation(const CTextRepresentation& Other)
-:	CEntity(),
-	m_d(new CTextRepresentationPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CTextRepresentation& MusicBrainz5::CTextRepresentation::operator =(const CTextRepresentation& Other)
@@ -60,16 +61,35 @@ MusicBrainz5::CTextRepresentation& MusicBrainz5::CTextRepresentation::operator =
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Language=Other.m_d->m_Language;
-		m_d->m_Script=Other.m_d->m_Script;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CTextRepresentation::CTextRepresentation(CTextRepresentation&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CTextRepresentationPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CTextRepresentation& MusicBrainz5::CTextRepresentation::operator =(CTextRepresentation&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CTextRepresentation::~CTextRepresentation()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CTextRepresentation *MusicBrainz5::CTextRepresentation::Clone()
@@ -88,21 +108,23 @@ void MusicBrainz5::CTextRepresentation::ParseAttribute(const std::string& Name,
 
 void MusicBrainz5::CTextRepresentation::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("language"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Language);
-	}
-	else if ("script"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Script);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementLanguage:
+			ProcessItem(Node,m_d->m_Language);
+			break;
+
+		case eElementScript:
+			ProcessItem(Node,m_d->m_Script);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised textrepresentation element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised textrepresentation element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -111,12 +133,12 @@ std::string MusicBrainz5::CTextRepresentation::GetElementName()
 	return "text-representation";
 }
 
-std::string MusicBrainz5::CTextRepresentation::Language() const
+const std::string& MusicBrainz5::CTextRepresentation::Language() const
 {
 	return m_d->m_Language;
 }
 
-std::string MusicBrainz5::CTextRepresentation::Script() const
+const std::string& MusicBrainz5::CTextRepresentation::Script() const
 {
 	return m_d->m_Script;
 }
@@ -30,8 +30,10 @@
 
 #include "musicbrainz5/Recording.h"
 #include "musicbrainz5/ArtistCredit.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CTrackPrivate
+class MusicBrainz5::CTrackPrivate: public CSharedPrivate
 {
 	public:
 		CTrackPrivate()
@@ -42,6 +44,28 @@ class MusicBrainz5::CTrackPrivate
 		{
 		}
 
+		CTrackPrivate(const CTrackPrivate& Other)
+		:	CSharedPrivate(),
+			m_Position(Other.m_Position),
+			m_Title(Other.m_Title),
+			m_Recording(0),
+			m_Length(Other.m_Length),
+			m_ArtistCredit(0),
+			m_Number(Other.m_Number)
+		{
+			if (Other.m_Recording)
+				m_Recording=new CRecording(*Other.m_Recording);
+
+			if (Other.m_ArtistCredit)
+				m_ArtistCredit=new CArtistCredit(*Other.m_ArtistCredit);
+		}
+
+		~CTrackPrivate()
+		{
+			delete m_Recording;
+			delete m_ArtistCredit;
+		}
+
 		int m_Position;
 		std::string m_Title;
 		CRecording *m_Recording;
@@ -63,51 +87,46 @@ MusicBrainz5::CTrack::CTrack(const XMLNode& Node)
 }
 
 MusicBrainz5::CTrack::CTrack(const CTrack& Other)
-:	CEntity(),
-	m_d(new CTrackPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CTrack& MusicBrainz5::CTrack::operator =(const CTrack& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_Position=Other.m_d->m_Position;
-		m_d->m_Title=Other.m_d->m_Title;
-
-		if (Other.m_d->m_Recording)
-			m_d->m_Recording=new CRecording(*Other.m_d->m_Recording);
-
-		m_d->m_Length=Other.m_d->m_Length;
-
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
-
-		m_d->m_Number=Other.m_d->m_Number;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CTrack::~CTrack()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CTrack::CTrack(CTrack&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CTrackPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CTrack::Cleanup()
+MusicBrainz5::CTrack& MusicBrainz5::CTrack::operator =(CTrack&& Other)
 {
-	delete m_d->m_Recording;
-	m_d->m_Recording=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_ArtistCredit;
-	m_d->m_ArtistCredit=0;
+	return *this;
+}
+#endif
+
+MusicBrainz5::CTrack::~CTrack()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CTrack *MusicBrainz5::CTrack::Clone()
@@ -126,37 +145,39 @@ void MusicBrainz5::CTrack::ParseAttribute(const std::string& Name, const std::st
 
 void MusicBrainz5::CTrack::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("position"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Position);
-	}
-	else if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("recording"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Recording);
-	}
-	else if ("length"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Length);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("number"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Number);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementPosition:
+			ProcessItem(Node,m_d->m_Position);
+			break;
+
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementRecording:
+			ProcessItem(Node,m_d->m_Recording);
+			break;
+
+		case eElementLength:
+			ProcessItem(Node,m_d->m_Length);
+			break;
+
+		case eElementArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElementNumber:
+			ProcessItem(Node,m_d->m_Number);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised track element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised track element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -170,27 +191,41 @@ int MusicBrainz5::CTrack::Position() const
 	return m_d->m_Position;
 }
 
-std::string MusicBrainz5::CTrack::Title() const
+const std::string& MusicBrainz5::CTrack::Title() const
 {
 	return m_d->m_Title;
 }
 
-MusicBrainz5::CRecording *MusicBrainz5::CTrack::Recording() const
+const MusicBrainz5::CRecording *MusicBrainz5::CTrack::Recording() const
 {
 	return m_d->m_Recording;
 }
 
+MusicBrainz5::CRecording *MusicBrainz5::CTrack::Recording()
+{
+	Unshare(m_d);
+
+	return m_d->m_Recording;
+}
+
 int MusicBrainz5::CTrack::Length() const
 {
 	return m_d->m_Length;
 }
 
-MusicBrainz5::CArtistCredit *MusicBrainz5::CTrack::ArtistCredit() const
+const MusicBrainz5::CArtistCredit *MusicBrainz5::CTrack::ArtistCredit() const
+{
+	return m_d->m_ArtistCredit;
+}
+
+MusicBrainz5::CArtistCredit *MusicBrainz5::CTrack::ArtistCredit()
 {
+	Unshare(m_d);
+
 	return m_d->m_ArtistCredit;
 }
 
-std::string MusicBrainz5::CTrack::Number() const
+const std::string& MusicBrainz5::CTrack::Number() const
 {
 	return m_d->m_Number;
 }
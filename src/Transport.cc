@@ -0,0 +1,350 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include "musicbrainz5/Transport.h"
+
+#include <ctype.h>
+
+#include "musicbrainz5/HTTPFetch.h"
+
+static std::string LowerCase(const std::string& Name)
+{
+	std::string Ret=Name;
+
+	for (std::string::size_type Pos=0;Pos<Ret.length();Pos++)
+		Ret[Pos]=tolower(Ret[Pos]);
+
+	return Ret;
+}
+
+class MusicBrainz5::CFetchPrivate
+{
+	public:
+		CFetchPrivate()
+		:	m_Port(80),
+			m_Result(0),
+			m_Status(0),
+			m_ProxyPort(0),
+			m_Reader(0),
+			m_DataSize(0),
+			m_Compression(false),
+			m_Compressed(false),
+			m_CompressedSize(0)
+		{
+		}
+
+		std::string m_UserAgent;
+		std::string m_Host;
+		int m_Port;
+		std::vector<unsigned char> m_Data;
+		int m_Result;
+		int m_Status;
+		std::string m_ErrorMessage;
+		std::map<std::string,std::string> m_RequestHeaders;
+		std::map<std::string,std::string> m_ResponseHeaders;
+		std::string m_UserName;
+		std::string m_Password;
+		std::string m_ProxyHost;
+		int m_ProxyPort;
+		std::string m_ProxyUserName;
+		std::string m_ProxyPassword;
+		CResponseReader *m_Reader;
+		size_t m_DataSize;
+		bool m_Compression;
+		bool m_Compressed;
+		size_t m_CompressedSize;
+};
+
+MusicBrainz5::CResponseReader::~CResponseReader()
+{
+}
+
+MusicBrainz5::CFetch::CFetch(const std::string& UserAgent, const std::string& Host, int Port)
+:	m_d(new CFetchPrivate)
+{
+	m_d->m_UserAgent=UserAgent;
+
+	for (std::string::size_type Pos=0;Pos<m_d->m_UserAgent.length();Pos++)
+		if (m_d->m_UserAgent[Pos]=='-')
+			m_d->m_UserAgent[Pos]='/';
+
+	m_d->m_Host=Host;
+	m_d->m_Port=Port;
+}
+
+MusicBrainz5::CFetch::~CFetch()
+{
+	delete m_d;
+}
+
+void MusicBrainz5::CFetch::SetUserName(const std::string& UserName)
+{
+	m_d->m_UserName=UserName;
+}
+
+void MusicBrainz5::CFetch::SetPassword(const std::string& Password)
+{
+	m_d->m_Password=Password;
+}
+
+void MusicBrainz5::CFetch::SetProxyHost(const std::string& ProxyHost)
+{
+	m_d->m_ProxyHost=ProxyHost;
+}
+
+void MusicBrainz5::CFetch::SetProxyPort(int ProxyPort)
+{
+	m_d->m_ProxyPort=ProxyPort;
+}
+
+void MusicBrainz5::CFetch::SetProxyUserName(const std::string& ProxyUserName)
+{
+	m_d->m_ProxyUserName=ProxyUserName;
+}
+
+void MusicBrainz5::CFetch::SetProxyPassword(const std::string& ProxyPassword)
+{
+	m_d->m_ProxyPassword=ProxyPassword;
+}
+
+void MusicBrainz5::CFetch::SetResponseReader(CResponseReader *Reader)
+{
+	m_d->m_Reader=Reader;
+}
+
+void MusicBrainz5::CFetch::SetCompression(bool Compression)
+{
+	m_d->m_Compression=Compression;
+}
+
+bool MusicBrainz5::CFetch::Compression() const
+{
+	return m_d->m_Compression;
+}
+
+void MusicBrainz5::CFetch::SetRequestHeader(const std::string& Name, const std::string& Value)
+{
+	if (Value.empty())
+		m_d->m_RequestHeaders.erase(Name);
+	else
+		m_d->m_RequestHeaders[Name]=Value;
+}
+
+std::map<std::string,std::string> MusicBrainz5::CFetch::RequestHeaders() const
+{
+	return m_d->m_RequestHeaders;
+}
+
+std::vector<unsigned char> MusicBrainz5::CFetch::Data() const
+{
+	return m_d->m_Data;
+}
+
+int MusicBrainz5::CFetch::Result() const
+{
+	return m_d->m_Result;
+}
+
+int MusicBrainz5::CFetch::Status() const
+{
+	return m_d->m_Status;
+}
+
+std::string MusicBrainz5::CFetch::ErrorMessage() const
+{
+	return m_d->m_ErrorMessage;
+}
+
+std::string MusicBrainz5::CFetch::ResponseHeader(const std::string& Name) const
+{
+	std::string Ret;
+
+	std::map<std::string,std::string>::const_iterator Header=m_d->m_ResponseHeaders.find(LowerCase(Name));
+	if (Header!=m_d->m_ResponseHeaders.end())
+		Ret=(*Header).second;
+
+	return Ret;
+}
+
+std::map<std::string,std::string> MusicBrainz5::CFetch::ResponseHeaders() const
+{
+	return m_d->m_ResponseHeaders;
+}
+
+size_t MusicBrainz5::CFetch::CompressedSize() const
+{
+	return m_d->m_Compressed ? m_d->m_CompressedSize : m_d->m_DataSize;
+}
+
+size_t MusicBrainz5::CFetch::UncompressedSize() const
+{
+	return m_d->m_DataSize;
+}
+
+std::string MusicBrainz5::CFetch::UserAgent() const
+{
+	return m_d->m_UserAgent;
+}
+
+std::string MusicBrainz5::CFetch::Host() const
+{
+	return m_d->m_Host;
+}
+
+int MusicBrainz5::CFetch::Port() const
+{
+	return m_d->m_Port;
+}
+
+std::string MusicBrainz5::CFetch::UserName() const
+{
+	return m_d->m_UserName;
+}
+
+std::string MusicBrainz5::CFetch::Password() const
+{
+	return m_d->m_Password;
+}
+
+std::string MusicBrainz5::CFetch::ProxyHost() const
+{
+	return m_d->m_ProxyHost;
+}
+
+int MusicBrainz5::CFetch::ProxyPort() const
+{
+	return m_d->m_ProxyPort;
+}
+
+std::string MusicBrainz5::CFetch::ProxyUserName() const
+{
+	return m_d->m_ProxyUserName;
+}
+
+std::string MusicBrainz5::CFetch::ProxyPassword() const
+{
+	return m_d->m_ProxyPassword;
+}
+
+void MusicBrainz5::CFetch::Reset()
+{
+	m_d->m_Data.clear();
+	m_d->m_DataSize=0;
+	m_d->m_Compressed=false;
+	m_d->m_CompressedSize=0;
+	m_d->m_Result=0;
+	m_d->m_Status=0;
+	m_d->m_ErrorMessage.clear();
+	m_d->m_ResponseHeaders.clear();
+}
+
+void MusicBrainz5::CFetch::AddData(const char *Data, size_t Len)
+{
+	m_d->m_DataSize+=Len;
+
+	if (m_d->m_Reader)
+		m_d->m_Reader->Read(Data,Len);
+	else
+		m_d->m_Data.insert(m_d->m_Data.end(),Data,Data+Len);
+}
+
+size_t MusicBrainz5::CFetch::DataSize() const
+{
+	return m_d->m_DataSize;
+}
+
+void MusicBrainz5::CFetch::AddCompressedSize(size_t Len)
+{
+	m_d->m_Compressed=true;
+	m_d->m_CompressedSize+=Len;
+}
+
+void MusicBrainz5::CFetch::SetResult(int Result)
+{
+	m_d->m_Result=Result;
+}
+
+void MusicBrainz5::CFetch::SetStatus(int Status)
+{
+	m_d->m_Status=Status;
+}
+
+void MusicBrainz5::CFetch::SetErrorMessage(const std::string& ErrorMessage)
+{
+	m_d->m_ErrorMessage=ErrorMessage;
+}
+
+void MusicBrainz5::CFetch::AddResponseHeader(const std::string& Name, const std::string& Value)
+{
+	std::string& Header=m_d->m_ResponseHeaders[LowerCase(Name)];
+
+	//Repeated headers are combined, as allowed by RFC 2616
+
+	if (!Header.empty())
+		Header+=", ";
+
+	Header+=Value;
+}
+
+void MusicBrainz5::CFetch::CheckStatus() const
+{
+	switch (m_d->m_Status)
+	{
+		case 200:
+			break;
+
+		//Not modified, in reply to a conditional request
+
+		case 304:
+			break;
+
+		case 400:
+			throw CRequestError(m_d->m_ErrorMessage);
+			break;
+
+		case 401:
+			throw CAuthenticationError(m_d->m_ErrorMessage);
+			break;
+
+		case 404:
+			throw CResourceNotFoundError(m_d->m_ErrorMessage);
+			break;
+
+		case 503:
+			throw CServiceUnavailableError(m_d->m_ErrorMessage);
+			break;
+
+		default:
+			throw CFetchError(m_d->m_ErrorMessage);
+			break;
+	}
+}
+
+MusicBrainz5::CTransport::~CTransport()
+{
+}
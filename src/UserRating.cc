@@ -27,8 +27,9 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/UserRating.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CUserRatingPrivate
+class MusicBrainz5::CUserRatingPrivate: public CSharedPrivate
 {
 	public:
 		CUserRatingPrivate()
@@ -57,10 +58,9 @@ MusicBrainz5::CUserRating::CUserRating(const XMLNode& Node)
 }
 
 MusicBrainz5::CUserRating::CUserRating(const CUserRating& Other)
-:	CEntity(),
-	m_d(new CUserRatingPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CUserRating& MusicBrainz5::CUserRating::operator =(const CUserRating& Other)
@@ -69,15 +69,35 @@ MusicBrainz5::CUserRating& MusicBrainz5::CUserRating::operator =(const CUserRati
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_UserRating=Other.m_d->m_UserRating;
+		Assign(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CUserRating::CUserRating(CUserRating&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CUserRatingPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CUserRating& MusicBrainz5::CUserRating::operator =(CUserRating&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
 	}
 
 	return *this;
 }
+#endif
 
 MusicBrainz5::CUserRating::~CUserRating()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CUserRating *MusicBrainz5::CUserRating::Clone()
@@ -96,10 +116,10 @@ void MusicBrainz5::CUserRating::ParseAttribute(const std::string& Name, const st
 
 void MusicBrainz5::CUserRating::ParseElement(const XMLNode& Node)
 {
-	std::string Name=Node.getName();
-
 #ifdef _MB5_DEBUG_
-	std::cerr << "Unrecognised userrating element: '" << Name << "'" << std::endl;
+	std::cerr << "Unrecognised userrating element: '" << Node.getName() << "'" << std::endl;
+#else
+	(void)Node;
 #endif
 }
 
@@ -27,8 +27,10 @@
 #include "musicbrainz5/defines.h"
 
 #include "musicbrainz5/UserTag.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CUserTagPrivate
+class MusicBrainz5::CUserTagPrivate: public CSharedPrivate
 {
 	public:
 		std::string m_Name;
@@ -47,10 +49,9 @@ MusicBrainz5::CUserTag::CUserTag(const XMLNode& Node)
 }
 
 MusicBrainz5::CUserTag::CUserTag(const CUserTag& Other)
-:	CEntity(),
-	m_d(new CUserTagPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CUserTag& MusicBrainz5::CUserTag::operator =(const CUserTag& Other)
@@ -59,15 +60,35 @@ MusicBrainz5::CUserTag& MusicBrainz5::CUserTag::operator =(const CUserTag& Other
 	{
 		CEntity::operator =(Other);
 
-		m_d->m_Name=Other.m_d->m_Name;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CUserTag::CUserTag(CUserTag&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CUserTagPrivate>())
+{
+	std::swap(m_d,Other.m_d);
+}
+
+MusicBrainz5::CUserTag& MusicBrainz5::CUserTag::operator =(CUserTag&& Other)
+{
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
+
+	return *this;
+}
+#endif
+
 MusicBrainz5::CUserTag::~CUserTag()
 {
-	delete m_d;
+	m_d->Unref();
 }
 
 MusicBrainz5::CUserTag *MusicBrainz5::CUserTag::Clone()
@@ -86,17 +107,19 @@ void MusicBrainz5::CUserTag::ParseAttribute(const std::string& Name, const std::
 
 void MusicBrainz5::CUserTag::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("name"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Name);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementName:
+			ProcessItem(Node,m_d->m_Name);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised UserTag element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised UserTag element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -105,7 +128,7 @@ std::string MusicBrainz5::CUserTag::GetElementName()
 	return "user-tag";
 }
 
-std::string MusicBrainz5::CUserTag::Name() const
+const std::string& MusicBrainz5::CUserTag::Name() const
 {
 	return m_d->m_Name;
 }
@@ -41,8 +41,10 @@
 #include "musicbrainz5/UserRating.h"
 #include "musicbrainz5/ISWC.h"
 #include "musicbrainz5/ISWCList.h"
+#include "ElementTables.h"
+#include "SharedPrivate.h"
 
-class MusicBrainz5::CWorkPrivate
+class MusicBrainz5::CWorkPrivate: public CSharedPrivate
 {
 	public:
 		CWorkPrivate()
@@ -57,6 +59,59 @@ class MusicBrainz5::CWorkPrivate
 		{
 		}
 
+		CWorkPrivate(const CWorkPrivate& Other)
+		:	CSharedPrivate(),
+			m_ID(Other.m_ID),
+			m_Type(Other.m_Type),
+			m_Title(Other.m_Title),
+			m_ArtistCredit(0),
+			m_ISWCList(0),
+			m_Disambiguation(Other.m_Disambiguation),
+			m_AliasList(0),
+			m_RelationListList(0),
+			m_TagList(0),
+			m_UserTagList(0),
+			m_Rating(0),
+			m_UserRating(0),
+			m_Language(Other.m_Language)
+		{
+			if (Other.m_ArtistCredit)
+				m_ArtistCredit=new CArtistCredit(*Other.m_ArtistCredit);
+
+			if (Other.m_ISWCList)
+				m_ISWCList=new CISWCList(*Other.m_ISWCList);
+
+			if (Other.m_AliasList)
+				m_AliasList=new CAliasList(*Other.m_AliasList);
+
+			if (Other.m_RelationListList)
+				m_RelationListList=new CRelationListList(*Other.m_RelationListList);
+
+			if (Other.m_TagList)
+				m_TagList=new CTagList(*Other.m_TagList);
+
+			if (Other.m_UserTagList)
+				m_UserTagList=new CUserTagList(*Other.m_UserTagList);
+
+			if (Other.m_Rating)
+				m_Rating=new CRating(*Other.m_Rating);
+
+			if (Other.m_UserRating)
+				m_UserRating=new CUserRating(*Other.m_UserRating);
+		}
+
+		~CWorkPrivate()
+		{
+			delete m_ArtistCredit;
+			delete m_ISWCList;
+			delete m_AliasList;
+			delete m_RelationListList;
+			delete m_TagList;
+			delete m_UserTagList;
+			delete m_Rating;
+			delete m_UserRating;
+		}
+
 		std::string m_ID;
 		std::string m_Type;
 		std::string m_Title;
@@ -85,88 +140,46 @@ MusicBrainz5::CWork::CWork(const XMLNode& Node)
 }
 
 MusicBrainz5::CWork::CWork(const CWork& Other)
-:	CEntity(),
-	m_d(new CWorkPrivate)
+:	CEntity(Other),
+	m_d(Share(Other.m_d))
 {
-	*this=Other;
 }
 
 MusicBrainz5::CWork& MusicBrainz5::CWork::operator =(const CWork& Other)
 {
 	if (this!=&Other)
 	{
-		Cleanup();
-
 		CEntity::operator =(Other);
 
-		m_d->m_ID=Other.m_d->m_ID;
-		m_d->m_Type=Other.m_d->m_Type;
-		m_d->m_Title=Other.m_d->m_Title;
-
-		if (Other.m_d->m_ArtistCredit)
-			m_d->m_ArtistCredit=new CArtistCredit(*Other.m_d->m_ArtistCredit);
-
-		if (Other.m_d->m_ISWCList)
-			m_d->m_ISWCList=new CISWCList(*Other.m_d->m_ISWCList);
-
-		m_d->m_Disambiguation=Other.m_d->m_Disambiguation;
-
-		if (Other.m_d->m_AliasList)
-			m_d->m_AliasList=new CAliasList(*Other.m_d->m_AliasList);
-
-		if (Other.m_d->m_RelationListList)
-			m_d->m_RelationListList=new CRelationListList(*Other.m_d->m_RelationListList);
-
-		if (Other.m_d->m_TagList)
-			m_d->m_TagList=new CTagList(*Other.m_d->m_TagList);
-
-		if (Other.m_d->m_UserTagList)
-			m_d->m_UserTagList=new CUserTagList(*Other.m_d->m_UserTagList);
-
-		if (Other.m_d->m_Rating)
-			m_d->m_Rating=new CRating(*Other.m_d->m_Rating);
-
-		if (Other.m_d->m_UserRating)
-			m_d->m_UserRating=new CUserRating(*Other.m_d->m_UserRating);
-
-		m_d->m_Language=Other.m_d->m_Language;
+		Assign(m_d,Other.m_d);
 	}
 
 	return *this;
 }
 
-MusicBrainz5::CWork::~CWork()
+#ifdef LIBMB5_MOVE_SEMANTICS
+MusicBrainz5::CWork::CWork(CWork&& Other)
+:	CEntity(std::move(Other)),
+	m_d(SharedEmpty<CWorkPrivate>())
 {
-	Cleanup();
-
-	delete m_d;
+	std::swap(m_d,Other.m_d);
 }
 
-void MusicBrainz5::CWork::Cleanup()
+MusicBrainz5::CWork& MusicBrainz5::CWork::operator =(CWork&& Other)
 {
-	delete m_d->m_ArtistCredit;
-	m_d->m_ArtistCredit=0;
-
-	delete m_d->m_ISWCList;
-	m_d->m_ISWCList=0;
-
-	delete m_d->m_AliasList;
-	m_d->m_AliasList=0;
-
-	delete m_d->m_RelationListList;
-	m_d->m_RelationListList=0;
-
-	delete m_d->m_TagList;
-	m_d->m_TagList=0;
-
-	delete m_d->m_UserTagList;
-	m_d->m_UserTagList=0;
+	if (this!=&Other)
+	{
+		CEntity::operator =(std::move(Other));
+		Move(m_d,Other.m_d);
+	}
 
-	delete m_d->m_Rating;
-	m_d->m_Rating=0;
+	return *this;
+}
+#endif
 
-	delete m_d->m_UserRating;
-	m_d->m_UserRating=0;
+MusicBrainz5::CWork::~CWork()
+{
+	m_d->Unref();
 }
 
 MusicBrainz5::CWork *MusicBrainz5::CWork::Clone()
@@ -176,6 +189,8 @@ MusicBrainz5::CWork *MusicBrainz5::CWork::Clone()
 
 void MusicBrainz5::CWork::ParseAttribute(const std::string& Name, const std::string& Value)
 {
+	Detach(m_d);
+
 	if ("id"==Name)
 		m_d->m_ID=Value;
 	else if ("type"==Name)
@@ -190,57 +205,59 @@ void MusicBrainz5::CWork::ParseAttribute(const std::string& Name, const std::str
 
 void MusicBrainz5::CWork::ParseElement(const XMLNode& Node)
 {
-	std::string NodeName=Node.getName();
+	Detach(m_d);
 
-	if ("title"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Title);
-	}
-	else if ("artist-credit"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ArtistCredit);
-	}
-	else if ("iswc-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_ISWCList);
-	}
-	else if ("disambiguation"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Disambiguation);
-	}
-	else if ("alias-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_AliasList);
-	}
-	else if ("relation-list"==NodeName)
-	{
-		ProcessRelationList(Node,m_d->m_RelationListList);
-	}
-	else if ("tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_TagList);
-	}
-	else if ("user-tag-list"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserTagList);
-	}
-	else if ("rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Rating);
-	}
-	else if ("user-rating"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_UserRating);
-	}
-	else if ("language"==NodeName)
-	{
-		ProcessItem(Node,m_d->m_Language);
-	}
-	else
+	switch (ElementID(Node.getName()))
 	{
+		case eElementTitle:
+			ProcessItem(Node,m_d->m_Title);
+			break;
+
+		case eElementArtistCredit:
+			ProcessItem(Node,m_d->m_ArtistCredit);
+			break;
+
+		case eElementIswcList:
+			ProcessItem(Node,m_d->m_ISWCList);
+			break;
+
+		case eElementDisambiguation:
+			ProcessItem(Node,m_d->m_Disambiguation);
+			break;
+
+		case eElementAliasList:
+			ProcessItem(Node,m_d->m_AliasList);
+			break;
+
+		case eElementRelationList:
+			ProcessRelationList(Node,m_d->m_RelationListList);
+			break;
+
+		case eElementTagList:
+			ProcessItem(Node,m_d->m_TagList);
+			break;
+
+		case eElementUserTagList:
+			ProcessItem(Node,m_d->m_UserTagList);
+			break;
+
+		case eElementRating:
+			ProcessItem(Node,m_d->m_Rating);
+			break;
+
+		case eElementUserRating:
+			ProcessItem(Node,m_d->m_UserRating);
+			break;
+
+		case eElementLanguage:
+			ProcessItem(Node,m_d->m_Language);
+			break;
+
+		default:
 #ifdef _MB5_DEBUG_
-		std::cerr << "Unrecognised work element: '" << NodeName << "'" << std::endl;
+			std::cerr << "Unrecognised work element: '" << Node.getName() << "'" << std::endl;
 #endif
+			break;
 	}
 }
 
@@ -249,67 +266,128 @@ std::string MusicBrainz5::CWork::GetElementName()
 	return "work";
 }
 
-std::string MusicBrainz5::CWork::ID() const
+const std::string& MusicBrainz5::CWork::ID() const
 {
 	return m_d->m_ID;
 }
 
-std::string MusicBrainz5::CWork::Type() const
+MusicBrainz5::CMBID MusicBrainz5::CWork::MBID() const
+{
+	return CMBID(m_d->m_ID);
+}
+
+const std::string& MusicBrainz5::CWork::Type() const
 {
 	return m_d->m_Type;
 }
 
-std::string MusicBrainz5::CWork::Title() const
+const std::string& MusicBrainz5::CWork::Title() const
 {
 	return m_d->m_Title;
 }
 
-MusicBrainz5::CArtistCredit *MusicBrainz5::CWork::ArtistCredit() const
+const MusicBrainz5::CArtistCredit *MusicBrainz5::CWork::ArtistCredit() const
 {
 	return m_d->m_ArtistCredit;
 }
 
-MusicBrainz5::CISWCList *MusicBrainz5::CWork::ISWCList() const
+MusicBrainz5::CArtistCredit *MusicBrainz5::CWork::ArtistCredit()
+{
+	Unshare(m_d);
+
+	return m_d->m_ArtistCredit;
+}
+
+const MusicBrainz5::CISWCList *MusicBrainz5::CWork::ISWCList() const
+{
+	return m_d->m_ISWCList;
+}
+
+MusicBrainz5::CISWCList *MusicBrainz5::CWork::ISWCList()
 {
+	Unshare(m_d);
+
 	return m_d->m_ISWCList;
 }
 
-std::string MusicBrainz5::CWork::Disambiguation() const
+const std::string& MusicBrainz5::CWork::Disambiguation() const
 {
 	return m_d->m_Disambiguation;
 }
 
-MusicBrainz5::CAliasList *MusicBrainz5::CWork::AliasList() const
+const MusicBrainz5::CAliasList *MusicBrainz5::CWork::AliasList() const
+{
+	return m_d->m_AliasList;
+}
+
+MusicBrainz5::CAliasList *MusicBrainz5::CWork::AliasList()
 {
+	Unshare(m_d);
+
 	return m_d->m_AliasList;
 }
 
-MusicBrainz5::CRelationListList *MusicBrainz5::CWork::RelationListList() const
+const MusicBrainz5::CRelationListList *MusicBrainz5::CWork::RelationListList() const
+{
+	return m_d->m_RelationListList;
+}
+
+MusicBrainz5::CRelationListList *MusicBrainz5::CWork::RelationListList()
 {
+	Unshare(m_d);
+
 	return m_d->m_RelationListList;
 }
 
-MusicBrainz5::CTagList *MusicBrainz5::CWork::TagList() const
+const MusicBrainz5::CTagList *MusicBrainz5::CWork::TagList() const
+{
+	return m_d->m_TagList;
+}
+
+MusicBrainz5::CTagList *MusicBrainz5::CWork::TagList()
 {
+	Unshare(m_d);
+
 	return m_d->m_TagList;
 }
 
-MusicBrainz5::CUserTagList *MusicBrainz5::CWork::UserTagList() const
+const MusicBrainz5::CUserTagList *MusicBrainz5::CWork::UserTagList() const
 {
 	return m_d->m_UserTagList;
 }
 
-MusicBrainz5::CRating *MusicBrainz5::CWork::Rating() const
+MusicBrainz5::CUserTagList *MusicBrainz5::CWork::UserTagList()
+{
+	Unshare(m_d);
+
+	return m_d->m_UserTagList;
+}
+
+const MusicBrainz5::CRating *MusicBrainz5::CWork::Rating() const
 {
 	return m_d->m_Rating;
 }
 
-MusicBrainz5::CUserRating *MusicBrainz5::CWork::UserRating() const
+MusicBrainz5::CRating *MusicBrainz5::CWork::Rating()
 {
+	Unshare(m_d);
+
+	return m_d->m_Rating;
+}
+
+const MusicBrainz5::CUserRating *MusicBrainz5::CWork::UserRating() const
+{
+	return m_d->m_UserRating;
+}
+
+MusicBrainz5::CUserRating *MusicBrainz5::CWork::UserRating()
+{
+	Unshare(m_d);
+
 	return m_d->m_UserRating;
 }
 
-std::string MusicBrainz5::CWork::Language() const
+const std::string& MusicBrainz5::CWork::Language() const
 {
 	return m_d->m_Language;
 }
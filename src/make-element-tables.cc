@@ -0,0 +1,310 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "musicbrainz5/defines.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <cctype>
+
+#include "musicbrainz5/xmlParser.h"
+
+//Both the generator and the generated ElementID must use this hash
+
+unsigned int Hash(unsigned int Seed, const std::string& Name)
+{
+	unsigned int Hash=Seed;
+
+	for (std::string::size_type count=0;count<Name.length();count++)
+	{
+		Hash^=(unsigned char)Name[count];
+		Hash*=16777619U;
+	}
+
+	return Hash;
+}
+
+bool FindSeed(const std::vector<std::string>& Names, unsigned int& Seed, unsigned int& NumSlots)
+{
+	//Look for a table size and seed for which no two names share a slot, so a lookup
+	//only ever needs to compare the name against a single entry
+
+	for (NumSlots=1;NumSlots<Names.size();NumSlots*=2)
+		;
+
+	for (;NumSlots<=65536;NumSlots*=2)
+	{
+		for (Seed=2166136261U;Seed!=2166136261U+65536;Seed++)
+		{
+			std::vector<bool> Used(NumSlots,false);
+			std::vector<std::string>::const_iterator ThisName=Names.begin();
+
+			while (ThisName!=Names.end())
+			{
+				unsigned int Slot=Hash(Seed,*ThisName)%NumSlots;
+				if (Used[Slot])
+					break;
+
+				Used[Slot]=true;
+				++ThisName;
+			}
+
+			if (ThisName==Names.end())
+				return true;
+		}
+	}
+
+	return false;
+}
+
+std::string EnumName(const std::string& Name)
+{
+	std::string Ret="eElement";
+	bool Upper=true;
+
+	for (std::string::size_type count=0;count<Name.length();count++)
+	{
+		if ('-'==Name[count])
+			Upper=true;
+		else
+		{
+			Ret+=Upper ? (char)toupper(Name[count]) : Name[count];
+			Upper=false;
+		}
+	}
+
+	return Ret;
+}
+
+void WriteHeader(std::ofstream& File)
+{
+	File << "/* --------------------------------------------------------------------------" << std::endl;
+	File << std::endl;
+	File << "   libmusicbrainz5 - Client library to access MusicBrainz" << std::endl;
+	File << std::endl;
+	File << "   Copyright (C) 2012 Andrew Hawkins" << std::endl;
+	File << std::endl;
+	File << "   This file is part of libmusicbrainz5." << std::endl;
+	File << std::endl;
+	File << "   This library is free software; you can redistribute it and/or" << std::endl;
+	File << "   modify it under the terms of the GNU Lesser General Public" << std::endl;
+	File << "   License as published by the Free Software Foundation; either" << std::endl;
+	File << "   version 2.1 of the License, or (at your option) any later version." << std::endl;
+	File << std::endl;
+	File << "   libmusicbrainz5 is distributed in the hope that it will be useful," << std::endl;
+	File << "   but WITHOUT ANY WARRANTY; without even the implied warranty of" << std::endl;
+	File << "   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU" << std::endl;
+	File << "   Lesser General Public License for more details." << std::endl;
+	File << std::endl;
+	File << "   You should have received a copy of the GNU General Public License" << std::endl;
+	File << "   along with this library.  If not, see <http://www.gnu.org/licenses/>." << std::endl;
+	File << std::endl;
+	File << "   THIS FILE IS AUTOMATICALLY GENERATED - DO NOT EDIT IT!" << std::endl;
+	File << std::endl;
+	File << "----------------------------------------------------------------------------*/" << std::endl;
+	File << std::endl;
+}
+
+int main(int argc, const char *argv[])
+{
+	for (int count=0;count<argc;count++)
+		std::cout << argv[count] << " ";
+
+	std::cout << std::endl;
+
+	if (argc==6)
+	{
+		std::string XMLFile=std::string(argv[1])+"/"+argv[2];
+		XMLResults Results;
+		XMLNode *TopNode=XMLRootNode::parseFile(XMLFile.c_str(),&Results);
+		if (TopNode->isEmpty())
+		{
+			std::cerr << "Error reading XML: " << Results.message << " at line " << Results.line << std::endl;
+			delete TopNode;
+			return 1;
+		}
+
+		std::set<std::string> Names;
+
+		for (XMLNode EntityNode=TopNode->getChildNode("entity");
+		     !EntityNode.isEmpty();
+		     EntityNode=EntityNode.next())
+		{
+			for (XMLNode ElementNode=EntityNode.getChildNode("element");
+			     !ElementNode.isEmpty();
+			     ElementNode=ElementNode.next())
+			{
+				if (ElementNode.isAttributeSet("name"))
+					Names.insert(ElementNode.getAttribute("name").value());
+				else
+				{
+					std::cerr << "Element with no name in entity '" << EntityNode.getAttribute("class").value() << "'" << std::endl;
+					delete TopNode;
+					return 1;
+				}
+			}
+		}
+
+		delete TopNode;
+
+		std::vector<std::string> SortedNames(Names.begin(),Names.end());
+		std::map<std::string,std::string> EnumNames;
+
+		for (std::vector<std::string>::const_iterator ThisName=SortedNames.begin();ThisName!=SortedNames.end();++ThisName)
+			EnumNames[*ThisName]=EnumName(*ThisName);
+
+		unsigned int Seed;
+		unsigned int NumSlots;
+
+		if (!FindSeed(SortedNames,Seed,NumSlots))
+		{
+			std::cerr << "Unable to find a perfect hash for " << SortedNames.size() << " elements" << std::endl;
+			return 1;
+		}
+
+		std::cout << "Generating '" << argv[3] << "/" << argv[4] << "' and '" << argv[3] << "/" << argv[5] << "'" << std::endl;
+
+		std::string IncludeName=std::string(argv[3])+"/"+argv[5];
+		std::ofstream Include(IncludeName.c_str());
+
+		std::string SourceName=std::string(argv[3])+"/" + argv[4];
+		std::ofstream Source(SourceName.c_str());
+
+		if (!Include.is_open())
+		{
+			std::cerr << "Error opening '" << IncludeName << "'" << std::endl;
+			return 1;
+		}
+
+		if (!Source.is_open())
+		{
+			std::cerr << "Error opening '" << SourceName << "'" << std::endl;
+			return 1;
+		}
+
+		WriteHeader(Include);
+
+		Include << "#ifndef _MUSICBRAINZ5_ELEMENT_TABLES_H" << std::endl;
+		Include << "#define _MUSICBRAINZ5_ELEMENT_TABLES_H" << std::endl;
+		Include << std::endl;
+		Include << "namespace MusicBrainz5" << std::endl;
+		Include << "{" << std::endl;
+		Include << "\tenum tElement" << std::endl;
+		Include << "\t{" << std::endl;
+		Include << "\t\teElementUnknown=0";
+
+		for (std::vector<std::string>::const_iterator ThisName=SortedNames.begin();ThisName!=SortedNames.end();++ThisName)
+			Include << "," << std::endl << "\t\t" << EnumNames[*ThisName];
+
+		Include << std::endl;
+
+		Include << "\t};" << std::endl;
+		Include << std::endl;
+		Include << "\t//Identify an element name, returning eElementUnknown for any name not in elements.xml" << std::endl;
+		Include << "\ttElement ElementID(const char *Name);" << std::endl;
+		Include << "}" << std::endl;
+		Include << std::endl;
+		Include << "#endif" << std::endl;
+
+		//Each slot holds the tElement value of the name that hashes to it, or
+		//eElementUnknown, and ElementNames the name for each value to confirm a match
+
+		std::vector<unsigned int> Slots(NumSlots,0);
+		for (std::vector<std::string>::size_type count=0;count<SortedNames.size();count++)
+			Slots[Hash(Seed,SortedNames[count])%NumSlots]=count+1;
+
+		std::string SlotType=SortedNames.size()<256 ? "unsigned char" : "unsigned short";
+
+		WriteHeader(Source);
+
+		Source << "#include \"config.h\"" << std::endl;
+		Source << "#include \"musicbrainz5/defines.h\"" << std::endl;
+		Source << std::endl;
+		Source << "#include \"" << argv[5] << "\"" << std::endl;
+		Source << std::endl;
+		Source << "#include <string.h>" << std::endl;
+		Source << std::endl;
+		Source << "namespace" << std::endl;
+		Source << "{" << std::endl;
+		Source << "\tconst unsigned int ElementSeed=" << Seed << "U;" << std::endl;
+		Source << "\tconst unsigned int NumElementSlots=" << NumSlots << ";" << std::endl;
+		Source << std::endl;
+		Source << "\tconst char * const ElementNames[]=" << std::endl;
+		Source << "\t{" << std::endl;
+		Source << "\t\t0";
+
+		for (std::vector<std::string>::const_iterator ThisName=SortedNames.begin();ThisName!=SortedNames.end();++ThisName)
+			Source << "," << std::endl << "\t\t\"" << *ThisName << "\"";
+
+		Source << std::endl;
+		Source << "\t};" << std::endl;
+		Source << std::endl;
+		Source << "\tconst " << SlotType << " ElementSlots[NumElementSlots]=" << std::endl;
+		Source << "\t{";
+
+		for (unsigned int count=0;count<NumSlots;count++)
+		{
+			if (0==count%16)
+				Source << std::endl << "\t\t";
+			else
+				Source << " ";
+
+			Source << Slots[count];
+			if (count!=NumSlots-1)
+				Source << ",";
+		}
+
+		Source << std::endl;
+		Source << "\t};" << std::endl;
+		Source << "}" << std::endl;
+		Source << std::endl;
+		Source << "MusicBrainz5::tElement MusicBrainz5::ElementID(const char *Name)" << std::endl;
+		Source << "{" << std::endl;
+		Source << "\tif (!Name)" << std::endl;
+		Source << "\t\treturn eElementUnknown;" << std::endl;
+		Source << std::endl;
+		Source << "\tunsigned int Hash=ElementSeed;" << std::endl;
+		Source << "\tfor (const char *Char=Name;*Char;Char++)" << std::endl;
+		Source << "\t{" << std::endl;
+		Source << "\t\tHash^=(unsigned char)*Char;" << std::endl;
+		Source << "\t\tHash*=16777619U;" << std::endl;
+		Source << "\t}" << std::endl;
+		Source << std::endl;
+		Source << "\t" << SlotType << " Element=ElementSlots[Hash%NumElementSlots];" << std::endl;
+		Source << "\tif (Element && 0==strcmp(ElementNames[Element],Name))" << std::endl;
+		Source << "\t\treturn (tElement)Element;" << std::endl;
+		Source << std::endl;
+		Source << "\treturn eElementUnknown;" << std::endl;
+		Source << "}" << std::endl;
+	}
+
+	return 0;
+}
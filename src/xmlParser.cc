@@ -29,7 +29,248 @@
 #include "musicbrainz5/xmlParser.h"
 
 #include <cstring>
+#include <cstdlib>
+#include <vector>
 #include <libxml/tree.h>
+#include <libxml/parser.h>
+#include <libxml/dict.h>
+
+struct XMLElementAttribute
+{
+    const char *name;
+    const char *value;
+    XMLElementAttribute *next;
+};
+
+struct XMLElement
+{
+    const char *name;
+    const char *text;
+    XMLElementAttribute *attributes;
+    XMLElementAttribute *lastAttribute;
+    XMLElement *children;
+    XMLElement *lastChild;
+    XMLElement *next;
+    XMLElement *parent;
+};
+
+/* Memory for a compact tree, which is all freed together. Element and
+ * attribute names point into the parser's dictionary, which is kept for as
+ * long as the tree. */
+class XMLArena
+{
+    public:
+        XMLArena(xmlDictPtr dict);
+        ~XMLArena();
+
+        void *allocate(size_t size);
+        const char *copy(const char *text, size_t length);
+
+    private:
+        XMLArena(const XMLArena &);
+        XMLArena &operator =(const XMLArena &);
+
+        static const size_t blockSize = 16384;
+
+        std::vector<char *> mBlocks;
+        char *mBlock;
+        size_t mUsed;
+        xmlDictPtr mDict;
+};
+
+XMLArena::XMLArena(xmlDictPtr dict)
+    : mBlock(NULL),
+      mUsed(blockSize),
+      mDict(dict)
+{
+    if (mDict != NULL)
+        xmlDictReference(mDict);
+}
+
+XMLArena::~XMLArena()
+{
+    for (std::vector<char *>::size_type i = 0; i < mBlocks.size(); i++)
+        free(mBlocks[i]);
+
+    if (mDict != NULL)
+        xmlDictFree(mDict);
+}
+
+void *XMLArena::allocate(size_t size)
+{
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+    /* Large allocations get a block of their own, leaving the current one
+     * to be filled */
+    if (size > blockSize / 4) {
+        char *block = (char *)malloc(size);
+        if (block != NULL)
+            mBlocks.push_back(block);
+        return block;
+    }
+
+    if (mUsed + size > blockSize) {
+        mBlock = (char *)malloc(blockSize);
+        if (mBlock == NULL) {
+            mUsed = blockSize;
+            return NULL;
+        }
+        mBlocks.push_back(mBlock);
+        mUsed = 0;
+    }
+
+    void *ret = mBlock + mUsed;
+    mUsed += size;
+
+    return ret;
+}
+
+const char *XMLArena::copy(const char *text, size_t length)
+{
+    char *ret = (char *)allocate(length + 1);
+    if (ret != NULL) {
+        memcpy(ret, text, length);
+        ret[length] = '\0';
+    }
+
+    return ret;
+}
+
+/* Receives the SAX events from the parser and builds the compact tree */
+class XMLTreeBuilder
+{
+    public:
+        XMLTreeBuilder(xmlDictPtr dict)
+            : mArena(new XMLArena(dict)),
+              mRoot(NULL),
+              mCurrent(NULL),
+              mFailed(false)
+        {
+        }
+
+        ~XMLTreeBuilder()
+        {
+            delete mArena;
+        }
+
+        static void startElement(void *ctx, const xmlChar *localname,
+                                 const xmlChar *prefix, const xmlChar *URI,
+                                 int nb_namespaces, const xmlChar **namespaces,
+                                 int nb_attributes, int nb_defaulted,
+                                 const xmlChar **attributes);
+        static void endElement(void *ctx, const xmlChar *localname,
+                               const xmlChar *prefix, const xmlChar *URI);
+        static void characters(void *ctx, const xmlChar *ch, int len);
+
+        XMLArena *mArena;
+        XMLElement *mRoot;
+        XMLElement *mCurrent;
+        std::string mText;
+        bool mFailed;
+
+    private:
+        void flushText(bool child);
+};
+
+void XMLTreeBuilder::flushText(bool child)
+{
+    if ((mCurrent != NULL) && (mCurrent->children == NULL) && !mText.empty()) {
+        /* Whitespace before an element's first child is only indentation */
+        if (!child || (mText.find_first_not_of(" \t\r\n") != std::string::npos)) {
+            mCurrent->text = mArena->copy(mText.c_str(), mText.length());
+            if (mCurrent->text == NULL)
+                mFailed = true;
+        }
+    }
+
+    mText.clear();
+}
+
+void XMLTreeBuilder::startElement(void *ctx, const xmlChar *localname,
+                                  const xmlChar */*prefix*/, const xmlChar */*URI*/,
+                                  int /*nb_namespaces*/, const xmlChar **/*namespaces*/,
+                                  int nb_attributes, int /*nb_defaulted*/,
+                                  const xmlChar **attributes)
+{
+    XMLTreeBuilder *builder = static_cast<XMLTreeBuilder *>(ctx);
+
+    builder->flushText(true);
+
+    XMLElement *element = (XMLElement *)builder->mArena->allocate(sizeof(XMLElement));
+    if (element == NULL) {
+        builder->mFailed = true;
+        return;
+    }
+
+    memset(element, 0, sizeof(XMLElement));
+    element->name = (const char *)localname;
+    element->parent = builder->mCurrent;
+
+    /* Each attribute is given as its local name, prefix, namespace URI,
+     * and the start and end of its value */
+    for (int i = 0; i < nb_attributes; i++) {
+        const xmlChar **attribute = attributes + i * 5;
+
+        XMLElementAttribute *attr = (XMLElementAttribute *)builder->mArena->allocate(sizeof(XMLElementAttribute));
+        if (attr == NULL) {
+            builder->mFailed = true;
+            return;
+        }
+
+        /* Without entity substitution, libxml2 escapes '&' in attribute
+         * values as a character reference */
+        std::string value((const char *)attribute[3], attribute[4] - attribute[3]);
+        for (std::string::size_type pos = value.find("&#38;"); pos != std::string::npos; pos = value.find("&#38;", pos + 1))
+            value.replace(pos, 5, "&");
+
+        attr->name = (const char *)attribute[0];
+        attr->value = builder->mArena->copy(value.c_str(), value.length());
+        attr->next = NULL;
+
+        if (attr->value == NULL) {
+            builder->mFailed = true;
+            return;
+        }
+
+        if (element->lastAttribute != NULL)
+            element->lastAttribute->next = attr;
+        else
+            element->attributes = attr;
+        element->lastAttribute = attr;
+    }
+
+    if (builder->mCurrent != NULL) {
+        if (builder->mCurrent->lastChild != NULL)
+            builder->mCurrent->lastChild->next = element;
+        else
+            builder->mCurrent->children = element;
+        builder->mCurrent->lastChild = element;
+    } else if (builder->mRoot == NULL) {
+        builder->mRoot = element;
+    }
+
+    builder->mCurrent = element;
+}
+
+void XMLTreeBuilder::endElement(void *ctx, const xmlChar */*localname*/,
+                                const xmlChar */*prefix*/, const xmlChar */*URI*/)
+{
+    XMLTreeBuilder *builder = static_cast<XMLTreeBuilder *>(ctx);
+
+    builder->flushText(false);
+
+    if (builder->mCurrent != NULL)
+        builder->mCurrent = builder->mCurrent->parent;
+}
+
+void XMLTreeBuilder::characters(void *ctx, const xmlChar *ch, int len)
+{
+    XMLTreeBuilder *builder = static_cast<XMLTreeBuilder *>(ctx);
+
+    /* getText() only returns text that comes before an element's first child */
+    if ((builder->mCurrent != NULL) && (builder->mCurrent->children == NULL))
+        builder->mText.append((const char *)ch, len);
+}
 
 XMLResults::XMLResults()
     : line(0),
@@ -37,7 +278,14 @@ XMLResults::XMLResults()
 {}
 
 XMLNode::XMLNode(xmlNodePtr node)
-    : mNode(node)
+    : mNode(node),
+      mElement(NULL)
+{
+}
+
+XMLNode::XMLNode(const XMLElement *element)
+    : mNode(NULL),
+      mElement(element)
 {
 }
 
@@ -47,7 +295,7 @@ XMLNode::~XMLNode()
 
 XMLNode XMLNode::emptyNode()
 {
-    return XMLNode(NULL);
+    return XMLNode((xmlNodePtr)NULL);
 }
 
 XMLNode *XMLRootNode::parseFile(const std::string &filename, XMLResults* results)
@@ -80,13 +328,98 @@ XMLNode *XMLRootNode::parseString(const std::string &xml, XMLResults* results)
     return new XMLRootNode(doc);
 }
 
+XMLPushParser::XMLPushParser()
+    : mCtxt(NULL),
+      mBuilder(NULL),
+      mFinished(false)
+{
+    /* Only the events needed to build the tree are handled, so no libxml2
+     * document is created */
+    xmlSAXHandler handler;
+    memset(&handler, 0, sizeof(handler));
+    handler.initialized = XML_SAX2_MAGIC;
+    handler.startElementNs = XMLTreeBuilder::startElement;
+    handler.endElementNs = XMLTreeBuilder::endElement;
+    handler.characters = XMLTreeBuilder::characters;
+    handler.cdataBlock = XMLTreeBuilder::characters;
+
+    mCtxt = xmlCreatePushParserCtxt(&handler, NULL, NULL, 0, NULL);
+    if (mCtxt != NULL) {
+        mBuilder = new XMLTreeBuilder(mCtxt->dict);
+        mCtxt->userData = mBuilder;
+    }
+}
+
+XMLPushParser::~XMLPushParser()
+{
+    if (mCtxt != NULL) {
+        if (mCtxt->myDoc != NULL)
+            xmlFreeDoc(mCtxt->myDoc);
+        xmlFreeParserCtxt(mCtxt);
+    }
+
+    delete mBuilder;
+}
+
+bool XMLPushParser::parseChunk(const char *chunk, int size)
+{
+    if ((mCtxt == NULL) || mFinished)
+        return false;
+
+    /* Errors are remembered by the context and reported from finish() */
+    return (xmlParseChunk(mCtxt, chunk, size, 0) == 0);
+}
+
+XMLNode *XMLPushParser::finish(XMLResults *results)
+{
+    if ((mCtxt != NULL) && !mFinished) {
+        mFinished = true;
+        xmlParseChunk(mCtxt, NULL, 0, 1);
+
+        if (mCtxt->wellFormed && !mBuilder->mFailed && (mBuilder->mRoot != NULL)) {
+            XMLRootNode *root = new XMLRootNode(mBuilder->mArena, mBuilder->mRoot);
+            mBuilder->mArena = NULL;
+            return root;
+        }
+
+        if (results != NULL) {
+            xmlErrorPtr error = xmlCtxtGetLastError(mCtxt);
+            if (error != NULL) {
+                results->message = error->message ? error->message : "";
+                results->line = error->line;
+                results->code = error->code;
+            } else {
+                results->message = "Out of memory";
+                results->code = XML_ERR_NO_MEMORY;
+            }
+        }
+    }
+
+    return new XMLRootNode((xmlDocPtr)NULL);
+}
+
+XMLNode *XMLPushParser::parseString(const std::string &xml, XMLResults *results)
+{
+    XMLPushParser parser;
+
+    parser.parseChunk(xml.c_str(), xml.length());
+
+    return parser.finish(results);
+}
+
 const char *XMLNode::getName() const
 {
+    if (mElement != NULL)
+        return mElement->name;
+
     return (char *)mNode->name;
 }
 
 const char *XMLNode::getText() const
 {
+    if (mElement != NULL)
+        return mElement->text;
+
     if (mNode->children == NULL)
         return NULL;
     if (!xmlNodeIsText(mNode->children))
@@ -110,6 +443,15 @@ const XMLAttribute XMLNode::getAttribute(const char *name) const
 {
     xmlAttrPtr attr;
 
+    if (mElement != NULL) {
+        const XMLElementAttribute *it = mElement->attributes;
+        if (name != NULL) {
+            while ((it != NULL) && (strcmp(name, it->name) != 0))
+                it = it->next;
+        }
+        return XMLAttribute(it);
+    }
+
     if (name == NULL)
         return XMLAttribute(mNode->properties);
 
@@ -117,17 +459,20 @@ const XMLAttribute XMLNode::getAttribute(const char *name) const
     if (attr != NULL)
         return XMLAttribute(attr);
 
-    return XMLAttribute(NULL);
+    return XMLAttribute((xmlAttrPtr)NULL);
 }
 
 bool XMLNode::isAttributeSet(const char *name) const
 {
+    if (mElement != NULL)
+        return !getAttribute(name).isEmpty();
+
     return (this->getAttributeRaw(name) != NULL);
 }
 
 bool XMLNode::operator ==(const XMLNode &rhs) const
 {
-    return mNode == rhs.mNode;
+    return (mNode == rhs.mNode) && (mElement == rhs.mElement);
 }
 
 bool operator !=(const XMLNode &lhs, const XMLNode &rhs)
@@ -136,7 +481,14 @@ bool operator !=(const XMLNode &lhs, const XMLNode &rhs)
 }
 
 XMLRootNode::XMLRootNode(xmlDocPtr doc): XMLNode(xmlDocGetRootElement(doc)),
-                                         mDoc(doc)
+                                         mDoc(doc),
+                                         mArena(NULL)
+{
+}
+
+XMLRootNode::XMLRootNode(XMLArena *arena, const XMLElement *root): XMLNode(root),
+                                                                   mDoc(NULL),
+                                                                   mArena(arena)
 {
 }
 
@@ -144,6 +496,8 @@ XMLRootNode::~XMLRootNode()
 {
     if (mDoc != NULL)
         xmlFreeDoc(mDoc);
+
+    delete mArena;
 }
 
 static xmlNodePtr skipTextNodes(xmlNodePtr node)
@@ -158,12 +512,25 @@ static xmlNodePtr skipTextNodes(xmlNodePtr node)
 
 XMLNode XMLNode::next() const
 {
+    if (mElement != NULL)
+        return XMLNode(mElement->next);
+
     return XMLNode(skipTextNodes(mNode->next));
 }
 
 XMLNode XMLNode::getChildNode(const char *name) const
 {
     xmlNodePtr it;
+
+    if (mElement != NULL) {
+        const XMLElement *child = mElement->children;
+        if (name != NULL) {
+            while ((child != NULL) && (strcmp(name, child->name) != 0))
+                child = child->next;
+        }
+        return XMLNode(child);
+    }
+
     if (name == NULL)
         return XMLNode(skipTextNodes(mNode->children));
 
@@ -179,27 +546,43 @@ XMLNode XMLNode::getChildNode(const char *name) const
 
 bool XMLNode::isEmpty() const
 {
-    return mNode == NULL;
+    return (mNode == NULL) && (mElement == NULL);
 }
 
 XMLAttribute::XMLAttribute(xmlAttrPtr attr)
-    : mAttr(attr)
+    : mAttr(attr),
+      mElementAttr(NULL)
+{
+}
+
+XMLAttribute::XMLAttribute(const XMLElementAttribute *attr)
+    : mAttr(NULL),
+      mElementAttr(attr)
 {
 }
 
 bool XMLAttribute::isEmpty() const {
-    return (mAttr == NULL);
+    return (mAttr == NULL) && (mElementAttr == NULL);
 }
 
 std::string XMLAttribute::name() const {
+    if (mElementAttr != NULL)
+        return std::string(mElementAttr->name);
+
     return std::string((const char *)mAttr->name);
 }
 
 std::string XMLAttribute::value() const {
+    if (mElementAttr != NULL)
+        return std::string(mElementAttr->value);
+
     return std::string((const char *)mAttr->children->content);
 }
 
 const XMLAttribute XMLAttribute::next() const {
+    if (mElementAttr != NULL)
+        return XMLAttribute(mElementAttr->next);
+
     return XMLAttribute(mAttr->next);
 }
 
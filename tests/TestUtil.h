@@ -0,0 +1,73 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#ifndef _MUSICBRAINZ5_TEST_UTIL_H
+#define _MUSICBRAINZ5_TEST_UTIL_H
+
+#include <iostream>
+#include <string>
+
+#include "musicbrainz5/RateLimiter.h"
+
+//Helpers shared by the tests. Each test counts its failed checks and returns a non
+//zero exit code from main if there were any.
+
+inline int& Failures()
+{
+	static int Count=0;
+
+	return Count;
+}
+
+inline void Check(bool Condition, const std::string& Message)
+{
+	if (!Condition)
+	{
+		std::cerr << Message << std::endl;
+		Failures()++;
+	}
+}
+
+inline int TestResult()
+{
+	if (Failures())
+		std::cerr << Failures() << " failures" << std::endl;
+
+	return Failures() ? 1 : 0;
+}
+
+//Limiter for tests whose requests are answered without reaching the server, so
+//that they don't have to wait between requests
+
+class CTestRateLimiter: public MusicBrainz5::CRateLimiter
+{
+public:
+	CTestRateLimiter()
+	{
+		SetLimit("musicbrainz.org",1000,100);
+	}
+};
+
+#endif
@@ -0,0 +1,313 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <pthread.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that asynchronous queries complete with the right results, that each
+//query's callback is called exactly once, and that queries still waiting to
+//start when the CQuery object is destroyed are cancelled rather than made.
+
+static std::string ReleaseID(int Number)
+{
+	std::stringstream os;
+	os << "76df3287-6cda-33eb-8e9a-044b5e15ff" << (10+Number);
+
+	return os.str();
+}
+
+//Counts the calls made for each ID, from whichever thread makes them
+
+class CCountingCallback: public MusicBrainz5::CQueryCallback
+{
+public:
+	CCountingCallback()
+	{
+		pthread_mutex_init(&m_Mutex,0);
+	}
+
+	~CCountingCallback()
+	{
+		pthread_mutex_destroy(&m_Mutex);
+	}
+
+	virtual void Completed(const MusicBrainz5::CLookupResult& Result)
+	{
+		pthread_mutex_lock(&m_Mutex);
+		m_Calls[Result.ID()]++;
+		m_Results[Result.ID()]=Result.Result();
+		pthread_mutex_unlock(&m_Mutex);
+	}
+
+	pthread_mutex_t m_Mutex;
+	std::map<std::string,int> m_Calls;
+	std::map<std::string,MusicBrainz5::CQuery::tQueryResult> m_Results;
+};
+
+//Holds every request until it is opened, so that later queries stay queued
+
+class CGatedTransport: public MusicBrainz5::CTransport
+{
+public:
+	CGatedTransport()
+	:	m_NumRequests(0),
+		m_Open(false)
+	{
+		pthread_mutex_init(&m_Mutex,0);
+		pthread_cond_init(&m_Cond,0);
+	}
+
+	~CGatedTransport()
+	{
+		pthread_cond_destroy(&m_Cond);
+		pthread_mutex_destroy(&m_Mutex);
+	}
+
+	virtual MusicBrainz5::CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+	void WaitForRequest()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		while (0==m_NumRequests)
+			pthread_cond_wait(&m_Cond,&m_Mutex);
+		pthread_mutex_unlock(&m_Mutex);
+	}
+
+	void Open()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		m_Open=true;
+		pthread_cond_broadcast(&m_Cond);
+		pthread_mutex_unlock(&m_Mutex);
+	}
+
+	pthread_mutex_t m_Mutex;
+	pthread_cond_t m_Cond;
+	int m_NumRequests;
+	bool m_Open;
+};
+
+class CGatedFetch: public MusicBrainz5::CFetch
+{
+public:
+	CGatedFetch(CGatedTransport *Transport, const std::string& UserAgent, const std::string& Host, int Port)
+	:	CFetch(UserAgent,Host,Port),
+		m_Transport(Transport)
+	{
+	}
+
+	int Fetch(const std::string& /*URL*/, const std::string& /*Request*/)
+	{
+		Reset();
+
+		pthread_mutex_lock(&m_Transport->m_Mutex);
+
+		m_Transport->m_NumRequests++;
+		pthread_cond_broadcast(&m_Transport->m_Cond);
+
+		while (!m_Transport->m_Open)
+			pthread_cond_wait(&m_Transport->m_Cond,&m_Transport->m_Mutex);
+
+		pthread_mutex_unlock(&m_Transport->m_Mutex);
+
+		SetStatus(200);
+		CheckStatus();
+
+		return DataSize();
+	}
+
+private:
+	CGatedTransport *m_Transport;
+};
+
+MusicBrainz5::CFetch *CGatedTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CGatedFetch(this,UserAgent,Host,Port);
+}
+
+static void TestResults()
+{
+	MusicBrainz5::CMemoryTransport Transport;
+
+	for (int count=0;count<4;count++)
+	{
+		std::stringstream os;
+		os << "<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">";
+		os << "<release id=\"" << ReleaseID(count) << "\"><title>Release " << count << "</title></release>";
+		os << "</metadata>";
+
+		Transport.AddResponse("/ws/2/release/"+ReleaseID(count),os.str());
+	}
+
+	CTestRateLimiter RateLimiter;
+	CCountingCallback Callback;
+
+	//The fifth release doesn't exist
+
+	MusicBrainz5::CQueryFuture Futures[5];
+
+	{
+		MusicBrainz5::CQuery Query("asynctest-1.0",&Transport);
+		Query.SetRateLimiter(&RateLimiter);
+		Query.SetAsyncThreads(3);
+
+		for (int count=0;count<5;count++)
+			Futures[count]=Query.QueryAsync("release",ReleaseID(count),"",MusicBrainz5::CQuery::tParamMap(),&Callback);
+
+		for (int count=0;count<5;count++)
+		{
+			Check(Futures[count].Valid(),"Future not valid");
+			Check(Futures[count].Wait(10000),"Query not completed");
+		}
+
+		//Destroying the query waits for the callbacks, which are made after the
+		//futures become ready
+	}
+
+	Check(!MusicBrainz5::CQueryFuture().Valid(),"Default constructed future is valid");
+
+	for (int count=0;count<5;count++)
+	{
+		const std::string ID=ReleaseID(count);
+
+		MusicBrainz5::CQueryFuture Copy=Futures[count];
+		MusicBrainz5::CLookupResult Result=Copy.Result();
+
+		Check(Copy.Ready() && Result.ID()==ID,"Wrong result for "+ID);
+		Check(1==Callback.m_Calls[ID],"Callback not called once for "+ID);
+		Check(Callback.m_Results[ID]==Result.Result(),"Callback given a different result for "+ID);
+
+		if (4==count)
+		{
+			Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Result.Result(),"Missing release not reported");
+
+			try
+			{
+				Futures[count].Get();
+				Check(false,"No exception for missing release");
+			}
+
+			catch (MusicBrainz5::CResourceNotFoundError& /*Error*/)
+			{
+			}
+		}
+		else
+		{
+			MusicBrainz5::CMetadata Metadata=Futures[count].Get();
+			Check(MusicBrainz5::CQuery::eQuery_Success==Result.Result() &&
+				Metadata.Release() && Metadata.Release()->ID()==ID,"Wrong release returned for "+ID);
+		}
+	}
+
+	Check(5==(int)Callback.m_Calls.size(),"Callback called for unknown queries");
+	Check(5==Transport.NumRequests(),"Wrong number of requests");
+}
+
+struct COpener
+{
+	CGatedTransport *m_Transport;
+	MusicBrainz5::CQueryFuture m_Future;
+};
+
+//Lets the request in progress finish once the queued queries have been cancelled
+
+static void *OpenWhenCancelled(void *Data)
+{
+	COpener *Opener=static_cast<COpener *>(Data);
+
+	Opener->m_Future.Wait();
+	Opener->m_Transport->Open();
+
+	return 0;
+}
+
+static void TestCancel()
+{
+	CGatedTransport Transport;
+	CTestRateLimiter RateLimiter;
+	CCountingCallback Callback;
+
+	MusicBrainz5::CQuery *Query=new MusicBrainz5::CQuery("asynctest-1.0",&Transport);
+	Query->SetRateLimiter(&RateLimiter);
+	Query->SetAsyncThreads(1);
+
+	//The only thread is busy with the first query, so the others queue behind it
+
+	MusicBrainz5::CQueryFuture InProgress=Query->QueryAsync("release",ReleaseID(0),"",MusicBrainz5::CQuery::tParamMap(),&Callback);
+	Transport.WaitForRequest();
+
+	MusicBrainz5::CQueryFuture Queued[2];
+	Queued[0]=Query->QueryAsync("release",ReleaseID(1),"",MusicBrainz5::CQuery::tParamMap(),&Callback);
+	Queued[1]=Query->QueryAsync("release",ReleaseID(2),"",MusicBrainz5::CQuery::tParamMap(),&Callback);
+
+	Check(!InProgress.Wait(50),"Query completed while held");
+	Check(!Queued[0].Ready() && !Queued[1].Ready(),"Queued query completed");
+
+	COpener Opener;
+	Opener.m_Transport=&Transport;
+	Opener.m_Future=Queued[1];
+
+	pthread_t Thread;
+	pthread_create(&Thread,0,OpenWhenCancelled,&Opener);
+
+	delete Query;
+
+	pthread_join(Thread,0);
+
+	Check(MusicBrainz5::CQuery::eQuery_Success==InProgress.Result().Result(),"Query in progress not completed");
+
+	for (int count=0;count<2;count++)
+	{
+		MusicBrainz5::CLookupResult Result=Queued[count].Result();
+
+		Check(MusicBrainz5::CQuery::eQuery_FetchError==Result.Result() &&
+			"Query cancelled"==Result.ErrorMessage(),"Queued query not cancelled");
+	}
+
+	for (int count=0;count<3;count++)
+		Check(1==Callback.m_Calls[ReleaseID(count)],"Callback not called once for "+ReleaseID(count));
+
+	Check(1==Transport.m_NumRequests,"Cancelled query was requested");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestResults();
+	TestCancel();
+
+	return TestResult();
+}
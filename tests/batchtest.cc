@@ -0,0 +1,107 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that LookupBatch returns a result for each ID in order, looks up each
+//distinct ID once, and reports failed lookups in their results.
+
+static std::string ReleaseID(int Number)
+{
+	std::stringstream os;
+	os << "76df3287-6cda-33eb-8e9a-044b5e15ff" << (10+Number);
+
+	return os.str();
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	MusicBrainz5::CMemoryTransport Transport;
+
+	for (int count=0;count<4;count++)
+	{
+		std::stringstream os;
+		os << "<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">";
+		os << "<release id=\"" << ReleaseID(count) << "\"><title>Release " << count << "</title></release>";
+		os << "</metadata>";
+
+		Transport.AddResponse("/ws/2/release/"+ReleaseID(count)+"?inc=artists",os.str());
+	}
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("batchtest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+	Query.SetBatchConcurrency(3);
+
+	//The fifth release doesn't exist, and the second is asked for twice
+
+	std::vector<std::string> IDs;
+	IDs.push_back(ReleaseID(0));
+	IDs.push_back(ReleaseID(1));
+	IDs.push_back(ReleaseID(4));
+	IDs.push_back(ReleaseID(1));
+	IDs.push_back(ReleaseID(2));
+	IDs.push_back(ReleaseID(3));
+
+	MusicBrainz5::CQuery::tParamMap Params;
+	Params["inc"]="artists";
+
+	//The second batch reuses the threads started for the first
+
+	for (int Batch=1;Batch<=2;Batch++)
+	{
+		std::vector<MusicBrainz5::CLookupResult> Results=Query.LookupBatch("release",IDs,Params);
+
+		Check(Results.size()==IDs.size(),"Wrong number of results");
+		Check(5*Batch==Transport.NumRequests(),"Wrong number of requests");
+
+		for (std::vector<MusicBrainz5::CLookupResult>::size_type count=0;count<Results.size();count++)
+		{
+			const MusicBrainz5::CLookupResult& Result=Results[count];
+			MusicBrainz5::CMetadata Metadata=Result.Metadata();
+
+			Check(Result.ID()==IDs[count],"Result for the wrong ID");
+
+			if (IDs[count]==ReleaseID(4))
+				Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Result.Result(),"Missing release not reported");
+			else
+				Check(MusicBrainz5::CQuery::eQuery_Success==Result.Result() &&
+					Metadata.Release() && Metadata.Release()->ID()==IDs[count],"Wrong release returned for "+IDs[count]);
+		}
+	}
+
+	return TestResult();
+}
@@ -0,0 +1,412 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <string>
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/Transport.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/ResponseCache.h"
+#include "musicbrainz5/DiskCache.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that responses are served from the response and disk caches, that
+//expired responses are revalidated with a conditional request whose 304 (not
+//modified) answer reuses and refreshes the cached response, that expired responses
+//can be returned while they are refreshed in the background, and that the disk
+//cache doesn't mistake one key for another with the same hash.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+static const std::string ReleaseURL="/ws/2/release/"+ReleaseID;
+static const std::string ReleaseBody=
+	"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+	"<release id=\""+ReleaseID+"\"><title>Test</title></release>"
+	"</metadata>";
+
+//Serves a single release with an ETag, answering a request carrying the same ETag
+//with 304 (not modified)
+
+class CTestTransport: public MusicBrainz5::CTransport
+{
+public:
+	CTestTransport()
+	:	m_NumRequests(0),
+		m_NumConditional(0),
+		m_ResponseCache(0)
+	{
+	}
+
+	virtual MusicBrainz5::CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+	int m_NumRequests;
+	int m_NumConditional;
+
+	//If set, the cache is cleared before a 304 is returned, as if the response had
+	//been evicted while the request was being made
+
+	MusicBrainz5::CResponseCache *m_ResponseCache;
+};
+
+class CTestFetch: public MusicBrainz5::CFetch
+{
+public:
+	CTestFetch(CTestTransport *Transport, const std::string& UserAgent, const std::string& Host, int Port)
+	:	CFetch(UserAgent,Host,Port),
+		m_Transport(Transport)
+	{
+	}
+
+	int Fetch(const std::string& URL, const std::string& /*Request*/)
+	{
+		Reset();
+
+		m_Transport->m_NumRequests++;
+
+		std::map<std::string,std::string> Headers=RequestHeaders();
+		bool Conditional=Headers["If-None-Match"]=="\"1\"";
+
+		if (Conditional)
+		{
+			m_Transport->m_NumConditional++;
+
+			if (m_Transport->m_ResponseCache)
+				m_Transport->m_ResponseCache->Clear();
+
+			SetStatus(304);
+		}
+		else if (URL==ReleaseURL)
+		{
+			SetStatus(200);
+			AddResponseHeader("ETag","\"1\"");
+			AddData(ReleaseBody.c_str(),ReleaseBody.length());
+		}
+		else
+		{
+			SetStatus(404);
+			SetErrorMessage("Not found");
+		}
+
+		CheckStatus();
+
+		return DataSize();
+	}
+
+private:
+	CTestTransport *m_Transport;
+};
+
+MusicBrainz5::CFetch *CTestTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CTestFetch(this,UserAgent,Host,Port);
+}
+
+static bool HasRelease(const MusicBrainz5::CLookupResult& Result)
+{
+	MusicBrainz5::CMetadata Metadata=Result.Metadata();
+
+	return Metadata.Release() && Metadata.Release()->Title()=="Test";
+}
+
+static void TestResponseCache(MusicBrainz5::CRateLimiter *RateLimiter)
+{
+	CTestTransport Transport;
+	MusicBrainz5::CResponseCache ResponseCache;
+
+	MusicBrainz5::CQuery Query("cachetest-1.0",&Transport);
+	Query.SetRateLimiter(RateLimiter);
+	Query.SetResponseCache(&ResponseCache);
+
+	MusicBrainz5::CLookupResult First=Query.Lookup("release",ReleaseID);
+	MusicBrainz5::CLookupResult Second=Query.Lookup("release",ReleaseID);
+
+	Check(1==Transport.m_NumRequests,"Response cache: response wasn't cached");
+	Check(!First.Cached() && Second.Cached() && HasRelease(Second),"Response cache: wrong result from cache");
+
+	//Once expired, the response is revalidated rather than fetched again
+
+	ResponseCache.SetTTL(0);
+
+	MusicBrainz5::CLookupResult Third=Query.Lookup("release",ReleaseID);
+	Check(2==Transport.m_NumRequests && 1==Transport.m_NumConditional,"Response cache: expired response wasn't revalidated");
+	Check(Third.Cached() && HasRelease(Third),"Response cache: revalidated response wasn't used");
+
+	//A response evicted while being revalidated is stored again with its real size
+
+	size_t Size=ResponseCache.Size();
+	Transport.m_ResponseCache=&ResponseCache;
+
+	MusicBrainz5::CLookupResult Fourth=Query.Lookup("release",ReleaseID);
+	Check(HasRelease(Fourth),"Response cache: revalidated response wasn't used after eviction");
+	Check(1==ResponseCache.NumEntries() && Size==ResponseCache.Size(),"Response cache: revalidated response stored with the wrong size");
+}
+
+static void TestNotModified(MusicBrainz5::CRateLimiter *RateLimiter)
+{
+	std::map<std::string,std::string> Headers;
+	Headers["ETag"]="\"1\"";
+
+	MusicBrainz5::CMemoryTransport Transport;
+	Transport.QueueResponse(ReleaseURL,ReleaseBody,200,Headers);
+	Transport.QueueResponse(ReleaseURL,"",304);
+
+	MusicBrainz5::CResponseCache ResponseCache(16*1024*1024,2);
+
+	MusicBrainz5::CQuery Query("cachetest-1.0",&Transport);
+	Query.SetRateLimiter(RateLimiter);
+	Query.SetResponseCache(&ResponseCache);
+
+	Query.Lookup("release",ReleaseID);
+
+	//The 304 has no body, so the expired response's metadata is used
+
+	sleep(2);
+
+	MusicBrainz5::CLookupResult Revalidated=Query.Lookup("release",ReleaseID);
+	Check(2==Transport.NumRequests(),"Not modified: expired response wasn't revalidated");
+	Check(304==Revalidated.HTTPCode() && Revalidated.Cached() && HasRelease(Revalidated),"Not modified: cached metadata wasn't used");
+
+	//Revalidating the response restarted its TTL, so it is served from the cache
+	//without another request
+
+	MusicBrainz5::CLookupResult Cached=Query.Lookup("release",ReleaseID);
+	Check(2==Transport.NumRequests(),"Not modified: TTL of the revalidated response wasn't refreshed");
+	Check(Cached.Cached() && HasRelease(Cached),"Not modified: wrong result after revalidation");
+}
+
+static std::string Title(const MusicBrainz5::CLookupResult& Result)
+{
+	MusicBrainz5::CMetadata Metadata=Result.Metadata();
+
+	return Metadata.Release() ? Metadata.Release()->Title() : "";
+}
+
+//Records the background refreshes that changed a response
+
+class CRefreshCallback: public MusicBrainz5::CQueryCallback
+{
+public:
+	CRefreshCallback()
+	:	m_NumCalls(0)
+	{
+	}
+
+	virtual void Completed(const MusicBrainz5::CLookupResult& Result)
+	{
+		m_NumCalls++;
+		m_Title=Title(Result);
+	}
+
+	int m_NumCalls;
+	std::string m_Title;
+};
+
+static void TestServeStale(MusicBrainz5::CRateLimiter *RateLimiter)
+{
+	std::map<std::string,std::string> Headers;
+	Headers["ETag"]="\"1\"";
+
+	MusicBrainz5::CMemoryTransport Transport;
+	Transport.QueueResponse(ReleaseURL,ReleaseBody,200,Headers);
+
+	Headers["ETag"]="\"2\"";
+	std::string NewBody=ReleaseBody;
+	NewBody.replace(NewBody.find("Test"),4,"New");
+	Transport.QueueResponse(ReleaseURL,NewBody,200,Headers);
+
+	Transport.QueueResponse(ReleaseURL,"",304);
+
+	//Responses expire as soon as they are stored
+
+	MusicBrainz5::CResponseCache ResponseCache(16*1024*1024,0);
+	CRefreshCallback Callback;
+
+	MusicBrainz5::CQuery Query("cachetest-1.0",&Transport);
+	Query.SetRateLimiter(RateLimiter);
+	Query.SetResponseCache(&ResponseCache);
+	Query.SetServeStale(true,&Callback);
+
+	//With a single background thread, a query queued after a refresh completes
+	//after it. Each of these queries is for a different resource, so that none is
+	//answered from the cache.
+
+	Query.SetAsyncThreads(1);
+
+	MusicBrainz5::CLookupResult First=Query.Lookup("release",ReleaseID);
+	Check(!First.Stale() && "Test"==Title(First),"Serve stale: wrong result from the server");
+
+	MusicBrainz5::CLookupResult Stale=Query.Lookup("release",ReleaseID);
+	Check(Stale.Stale() && Stale.Cached() && "Test"==Title(Stale),"Serve stale: expired response wasn't returned");
+
+	Check(Query.QueryAsync("artist").Wait(10000),"Serve stale: refresh didn't complete");
+	Check(3==Transport.NumRequests(),"Serve stale: expired response wasn't refreshed");
+	Check(1==Callback.m_NumCalls && "New"==Callback.m_Title,"Serve stale: callback wasn't given the changed response");
+
+	//The refreshed response replaced the expired one, and refreshing it again finds
+	//it unchanged, which isn't reported
+
+	MusicBrainz5::CLookupResult Refreshed=Query.Lookup("release",ReleaseID);
+	Check(Refreshed.Stale() && "New"==Title(Refreshed),"Serve stale: refreshed response wasn't cached");
+
+	Check(Query.QueryAsync("label").Wait(10000),"Serve stale: refresh didn't complete");
+	Check(5==Transport.NumRequests(),"Serve stale: refreshed response wasn't refreshed again");
+	Check(1==Callback.m_NumCalls,"Serve stale: callback called for an unchanged response");
+}
+
+static void TestDiskCache(MusicBrainz5::CRateLimiter *RateLimiter, const std::string& Directory)
+{
+	CTestTransport Transport;
+
+	{
+		MusicBrainz5::CDiskCache DiskCache(Directory);
+		MusicBrainz5::CQuery Query("cachetest-1.0",&Transport);
+		Query.SetRateLimiter(RateLimiter);
+		Query.SetDiskCache(&DiskCache);
+
+		Query.Lookup("release",ReleaseID);
+	}
+
+	//A new cache in the same directory finds the response
+
+	{
+		MusicBrainz5::CDiskCache DiskCache(Directory);
+		MusicBrainz5::CQuery Query("cachetest-1.0",&Transport);
+		Query.SetRateLimiter(RateLimiter);
+		Query.SetDiskCache(&DiskCache);
+
+		MusicBrainz5::CLookupResult Result=Query.Lookup("release",ReleaseID);
+		Check(1==Transport.m_NumRequests,"Disk cache: response wasn't cached");
+		Check(Result.Cached() && HasRelease(Result),"Disk cache: wrong result from cache");
+
+		DiskCache.SetTTL(0);
+
+		Result=Query.Lookup("release",ReleaseID);
+		Check(2==Transport.m_NumRequests && 1==Transport.m_NumConditional,"Disk cache: expired response wasn't revalidated");
+		Check(Result.Cached() && HasRelease(Result),"Disk cache: revalidated response wasn't used");
+
+		DiskCache.Clear();
+	}
+}
+
+//Replaces every occurrence of From with To, which must be the same length, in the
+//disk cache's segment files
+
+static void ReplaceInSegments(const std::string& Directory, const std::string& From, const std::string& To)
+{
+	DIR *Dir=opendir(Directory.c_str());
+	if (!Dir)
+		return;
+
+	struct dirent *Entry;
+	while ((Entry=readdir(Dir)))
+	{
+		std::string Name=Entry->d_name;
+		if (Name.length()<4 || ".seg"!=Name.substr(Name.length()-4))
+			continue;
+
+		std::string Path=Directory+"/"+Name;
+		std::fstream File(Path.c_str(),std::ios::in | std::ios::out | std::ios::binary);
+
+		std::stringstream os;
+		os << File.rdbuf();
+		std::string Contents=os.str();
+
+		std::string::size_type Pos=0;
+		while (std::string::npos!=(Pos=Contents.find(From,Pos)))
+		{
+			File.clear();
+			File.seekp(Pos);
+			File.write(To.c_str(),To.length());
+			Pos+=From.length();
+		}
+	}
+
+	closedir(Dir);
+}
+
+static void TestDiskCacheKeys(const std::string& Directory)
+{
+	//Finding a 64 bit hash collision isn't practical, so the keys in the records are
+	//changed on disk instead, leaving each slot's hash pointing at a record for a
+	//different key
+
+	const std::string NotFoundKey="musicbrainz.org:80/ws/2/release/1";
+	const std::string FoundKey="musicbrainz.org:80/ws/2/release/2";
+
+	MusicBrainz5::CDiskCache DiskCache(Directory);
+	DiskCache.PutNotFound(NotFoundKey);
+	DiskCache.Put(FoundKey,ReleaseBody);
+
+	Check(DiskCache.NotFound(NotFoundKey),"Disk cache keys: missing response wasn't cached");
+	Check(DiskCache.Refresh(FoundKey),"Disk cache keys: response couldn't be refreshed");
+
+	ReplaceInSegments(Directory,NotFoundKey,"musicbrainz.org:80/ws/2/release/3");
+	ReplaceInSegments(Directory,FoundKey,"musicbrainz.org:80/ws/2/release/4");
+
+	std::string Data;
+	Check(!DiskCache.NotFound(NotFoundKey),"Disk cache keys: another key's missing response was used");
+	Check(!DiskCache.Get(FoundKey,Data),"Disk cache keys: another key's response was used");
+	Check(!DiskCache.Refresh(FoundKey),"Disk cache keys: another key's response was refreshed");
+
+	DiskCache.Remove(FoundKey);
+	Check(2==DiskCache.NumEntries(),"Disk cache keys: another key's response was removed");
+
+	DiskCache.Clear();
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	char Directory[]="/tmp/cachetestXXXXXX";
+	if (!mkdtemp(Directory))
+	{
+		std::cerr << "Can't create cache directory" << std::endl;
+		return 1;
+	}
+
+	CTestRateLimiter RateLimiter;
+
+	TestResponseCache(&RateLimiter);
+	TestNotModified(&RateLimiter);
+	TestServeStale(&RateLimiter);
+	TestDiskCache(&RateLimiter,std::string(Directory)+"/cache");
+	TestDiskCacheKeys(std::string(Directory)+"/keys");
+
+	std::string Command="rm -rf ";
+	Command+=Directory;
+	if (0!=system(Command.c_str()))
+		std::cerr << "Can't remove " << Directory << std::endl;
+
+	return TestResult();
+}
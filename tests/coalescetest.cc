@@ -0,0 +1,178 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include <unistd.h>
+#include <pthread.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/Transport.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that identical queries made at the same time from several threads result
+//in a single request, whose result or failure is returned to every thread.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+static const std::string MissingID="76df3287-6cda-33eb-8e9a-044b5e15ffde";
+static const std::string ReleaseBody=
+	"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+	"<release id=\""+ReleaseID+"\"><title>Test</title></release>"
+	"</metadata>";
+
+static const int NumThreads=8;
+
+//Serves a single release, taking long enough over each request for every thread
+//to start the same query while it is in progress
+
+class CSlowTransport: public MusicBrainz5::CTransport
+{
+public:
+	CSlowTransport()
+	:	m_NumRequests(0)
+	{
+	}
+
+	virtual MusicBrainz5::CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+	int m_NumRequests;
+};
+
+class CSlowFetch: public MusicBrainz5::CFetch
+{
+public:
+	CSlowFetch(CSlowTransport *Transport, const std::string& UserAgent, const std::string& Host, int Port)
+	:	CFetch(UserAgent,Host,Port),
+		m_Transport(Transport)
+	{
+	}
+
+	int Fetch(const std::string& URL, const std::string& /*Request*/)
+	{
+		Reset();
+
+		__sync_add_and_fetch(&m_Transport->m_NumRequests,1);
+
+		usleep(300*1000);
+
+		if (URL=="/ws/2/release/"+ReleaseID)
+		{
+			SetStatus(200);
+			AddData(ReleaseBody.c_str(),ReleaseBody.length());
+		}
+		else
+		{
+			SetStatus(404);
+			SetErrorMessage("Not found");
+		}
+
+		CheckStatus();
+
+		return DataSize();
+	}
+
+private:
+	CSlowTransport *m_Transport;
+};
+
+MusicBrainz5::CFetch *CSlowTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CSlowFetch(this,UserAgent,Host,Port);
+}
+
+struct CLookup
+{
+	MusicBrainz5::CQuery *m_Query;
+	std::string m_ID;
+	MusicBrainz5::CLookupResult m_Result;
+};
+
+static void *Lookup(void *Data)
+{
+	CLookup *ThisLookup=static_cast<CLookup *>(Data);
+
+	ThisLookup->m_Result=ThisLookup->m_Query->Lookup("release",ThisLookup->m_ID);
+
+	return 0;
+}
+
+static void LookupFromThreads(MusicBrainz5::CQuery& Query, const std::string& ID, CLookup *Lookups)
+{
+	pthread_t Threads[NumThreads];
+
+	for (int count=0;count<NumThreads;count++)
+	{
+		Lookups[count].m_Query=&Query;
+		Lookups[count].m_ID=ID;
+		pthread_create(&Threads[count],0,Lookup,&Lookups[count]);
+	}
+
+	for (int count=0;count<NumThreads;count++)
+		pthread_join(Threads[count],0);
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	CSlowTransport Transport;
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("coalescetest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+
+	CLookup Found[NumThreads];
+	LookupFromThreads(Query,ReleaseID,Found);
+
+	Check(1==Transport.m_NumRequests,"Identical queries weren't coalesced");
+
+	for (int count=0;count<NumThreads;count++)
+	{
+		MusicBrainz5::CMetadata Metadata=Found[count].m_Result.Metadata();
+
+		Check(MusicBrainz5::CQuery::eQuery_Success==Found[count].m_Result.Result() &&
+			Metadata.Release() && Metadata.Release()->Title()=="Test","Coalesced query returned the wrong result");
+	}
+
+	//A failure is reported to every thread waiting for the query
+
+	CLookup Missing[NumThreads];
+	LookupFromThreads(Query,MissingID,Missing);
+
+	Check(2==Transport.m_NumRequests,"Identical failing queries weren't coalesced");
+
+	for (int count=0;count<NumThreads;count++)
+		Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Missing[count].m_Result.Result(),"Coalesced query didn't report the failure");
+
+	//A query made after the first has finished is sent again
+
+	Query.Lookup("release",ReleaseID);
+	Check(3==Transport.m_NumRequests,"Finished query wasn't made again");
+
+	return TestResult();
+}
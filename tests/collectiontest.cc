@@ -0,0 +1,162 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+
+#include <stdlib.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/ResponseCache.h"
+#include "musicbrainz5/DiskCache.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "TestUtil.h"
+
+//Checks that cached responses for a collection are removed when entries are
+//added to it, so that it isn't read back unchanged from either cache, and that
+//edits are confirmed by the server's response and count towards the rate limit.
+
+static const std::string CollectionID="f1bd8b38-6c6d-4c86-a5d2-0b3c8b24d8b1";
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+
+static void TestCollection(MusicBrainz5::CResponseCache *ResponseCache, MusicBrainz5::CDiskCache *DiskCache, const std::string& Name)
+{
+	MusicBrainz5::CMemoryTransport Transport;
+	Transport.AddResponse("/ws/2/collection/"+CollectionID+"/releases",
+		"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+		"<collection id=\""+CollectionID+"\"><name>Test</name><release-list count=\"0\"/></collection>"
+		"</metadata>");
+	Transport.AddResponse("/ws/2/collection",
+		"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+		"<collection-list count=\"1\"><collection id=\""+CollectionID+"\"><name>Test</name></collection></collection-list>"
+		"</metadata>");
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("collectiontest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+	Query.SetUserName("user");
+	Query.SetPassword("password");
+	Query.SetResponseCache(ResponseCache);
+	Query.SetDiskCache(DiskCache);
+
+	Query.Query("collection",CollectionID,"releases");
+	Query.Query("collection");
+	Query.Query("collection",CollectionID,"releases");
+	Query.Query("collection");
+	Check(2==Transport.NumRequests(),Name+": responses weren't cached");
+
+	std::vector<std::string> Entries;
+	Entries.push_back(ReleaseID);
+	Query.AddCollectionEntries(CollectionID,Entries);
+
+	Query.Query("collection",CollectionID,"releases");
+	Query.Query("collection");
+	Check(4==Transport.NumRequests(),Name+": responses weren't removed after editing the collection");
+}
+
+static void TestEdit()
+{
+	const std::string EditURL="/ws/2/collection/"+CollectionID+"/releases/"+ReleaseID+"?client=collectiontest-1.0";
+
+	MusicBrainz5::CMemoryTransport Transport;
+	Transport.QueueResponse(EditURL,
+		"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\"><message><text>OK</text></message></metadata>");
+
+	//Room for exactly two requests, so that a third would have to wait
+
+	MusicBrainz5::CRateLimiter RateLimiter;
+	RateLimiter.SetLimit("musicbrainz.org",0.001,2);
+
+	MusicBrainz5::CQuery Query("collectiontest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+	Query.SetUserName("user");
+	Query.SetPassword("password");
+
+	std::vector<std::string> Entries;
+	Entries.push_back(ReleaseID);
+
+	Check(Query.AddCollectionEntries(CollectionID,Entries),"Edit confirmed by the server reported as failed");
+	Check(!Query.DeleteCollectionEntries(CollectionID,Entries),"Edit without confirmation reported as successful");
+	Check(!RateLimiter.TryAcquire("musicbrainz.org"),"Edits didn't count towards the rate limit");
+
+	//A 503 slows down later requests, as it does for lookups
+
+	std::map<std::string,std::string> Headers;
+	Headers["Retry-After"]="1";
+	Transport.QueueResponse(EditURL,"",503,Headers);
+
+	CTestRateLimiter FastLimiter;
+	Query.SetRateLimiter(&FastLimiter);
+
+	bool Threw=false;
+
+	try
+	{
+		Query.AddCollectionEntries(CollectionID,Entries);
+	}
+
+	catch (MusicBrainz5::CFetchError& /*Error*/)
+	{
+		Threw=true;
+	}
+
+	Check(Threw,"503 for an edit didn't throw");
+	Check(FastLimiter.Rate("musicbrainz.org")<1000,"503 for an edit didn't reduce the rate");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestEdit();
+
+	char Directory[]="/tmp/collectiontestXXXXXX";
+	if (!mkdtemp(Directory))
+	{
+		std::cerr << "Can't create cache directory" << std::endl;
+		return 1;
+	}
+
+	{
+		MusicBrainz5::CResponseCache ResponseCache;
+		TestCollection(&ResponseCache,0,"Response cache");
+	}
+
+	{
+		MusicBrainz5::CDiskCache DiskCache(Directory);
+		TestCollection(0,&DiskCache,"Disk cache");
+		DiskCache.Clear();
+	}
+
+	std::string Command="rm -rf ";
+	Command+=Directory;
+	if (0!=system(Command.c_str()))
+		std::cerr << "Can't remove " << Directory << std::endl;
+
+	return TestResult();
+}
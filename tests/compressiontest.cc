@@ -0,0 +1,160 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/Transport.h"
+#include "musicbrainz5/ResponseCache.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that CQuery asks the transport for compressed responses only when
+//compression is enabled, and reports the sizes of the response before and after
+//decompression.
+//
+//The decompression itself is done by neon in CHTTPFetch, so a transport that
+//reports a compressed size for its response stands in for it here.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+static const std::string ReleaseBody=
+	"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">"
+	"<release id=\""+ReleaseID+"\"><title>Test</title></release>"
+	"</metadata>";
+
+//Size of the response as it would have been received compressed
+
+static const int WireSize=97;
+
+class CTestTransport: public MusicBrainz5::CTransport
+{
+public:
+	CTestTransport()
+	:	m_NumRequests(0),
+		m_Compression(false)
+	{
+	}
+
+	virtual MusicBrainz5::CFetch *CreateFetch(const std::string& UserAgent, const std::string& Host, int Port);
+
+	int m_NumRequests;
+	bool m_Compression;
+};
+
+class CTestFetch: public MusicBrainz5::CFetch
+{
+public:
+	CTestFetch(CTestTransport *Transport, const std::string& UserAgent, const std::string& Host, int Port)
+	:	CFetch(UserAgent,Host,Port),
+		m_Transport(Transport)
+	{
+	}
+
+	int Fetch(const std::string& /*URL*/, const std::string& /*Request*/)
+	{
+		Reset();
+
+		m_Transport->m_NumRequests++;
+		m_Transport->m_Compression=Compression();
+
+		SetStatus(200);
+
+		if (Compression())
+			AddCompressedSize(WireSize);
+
+		AddData(ReleaseBody.c_str(),ReleaseBody.length());
+
+		CheckStatus();
+
+		return DataSize();
+	}
+
+private:
+	CTestTransport *m_Transport;
+};
+
+MusicBrainz5::CFetch *CTestTransport::CreateFetch(const std::string& UserAgent, const std::string& Host, int Port)
+{
+	return new CTestFetch(this,UserAgent,Host,Port);
+}
+
+static bool HasRelease(const MusicBrainz5::CLookupResult& Result)
+{
+	MusicBrainz5::CMetadata Metadata=Result.Metadata();
+
+	return Metadata.Release() && Metadata.Release()->Title()=="Test";
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	CTestTransport Transport;
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("compressiontest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+
+	const int UncompressedSize=ReleaseBody.length();
+
+	//Compression is off by default, so both sizes are those of the body
+
+	MusicBrainz5::CLookupResult Result=Query.Lookup("release",ReleaseID);
+	Check(!Transport.m_Compression,"Compressed response requested by default");
+	Check(HasRelease(Result),"Uncompressed response not parsed");
+	Check(UncompressedSize==Result.CompressedSize() && UncompressedSize==Result.UncompressedSize(),"Wrong sizes for an uncompressed response");
+
+	//Query records the sizes for the Last* functions, which Lookup doesn't
+
+	Query.Query("release",ReleaseID);
+	Check(UncompressedSize==Query.LastCompressedSize() && UncompressedSize==Query.LastUncompressedSize(),"Wrong last sizes for an uncompressed response");
+
+	Query.SetCompression(true);
+
+	Result=Query.Lookup("release",ReleaseID);
+	Check(Transport.m_Compression,"Compressed response not requested");
+	Check(HasRelease(Result),"Compressed response not parsed");
+	Check(WireSize==Result.CompressedSize() && UncompressedSize==Result.UncompressedSize(),"Wrong sizes for a compressed response");
+
+	Query.Query("release",ReleaseID);
+	Check(WireSize==Query.LastCompressedSize() && UncompressedSize==Query.LastUncompressedSize(),"Wrong last sizes for a compressed response");
+
+	//Nothing is received for a response served from the cache
+
+	MusicBrainz5::CResponseCache ResponseCache;
+	Query.SetResponseCache(&ResponseCache);
+
+	Query.Lookup("release",ReleaseID);
+	Result=Query.Lookup("release",ReleaseID);
+	Check(5==Transport.m_NumRequests && Result.Cached(),"Response not cached");
+	Check(0==Result.CompressedSize() && 0==Result.UncompressedSize(),"Wrong sizes for a cached response");
+
+	Query.Query("release",ReleaseID);
+	Check(0==Query.LastCompressedSize() && 0==Query.LastUncompressedSize(),"Wrong last sizes for a cached response");
+
+	return TestResult();
+}
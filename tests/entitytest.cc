@@ -0,0 +1,156 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "musicbrainz5/Release.h"
+#include "musicbrainz5/ReleaseGroup.h"
+#include "musicbrainz5/Medium.h"
+#include "musicbrainz5/MediumList.h"
+#include "musicbrainz5/xmlParser.h"
+
+#include "TestUtil.h"
+
+//Checks that copies of an entity share their data until one of them is changed,
+//and that an entity that has been moved from is left empty and can be used again.
+
+static const std::string ReleaseXML=
+	"<release id=\"76df3287-6cda-33eb-8e9a-044b5e15ffdd\"><title>Original</title>"
+	"<release-group id=\"1cb8b2fa-0ef2-3f7a-a1e1-2a2b16a4a2f5\"><title>Group</title></release-group>"
+	"<medium-list count=\"1\"><medium><position>1</position></medium></medium-list>"
+	"</release>";
+
+static const std::string OtherXML=
+	"<release id=\"76df3287-6cda-33eb-8e9a-044b5e15ffde\"><title>Other</title></release>";
+
+template <class T>
+static T Parse(const std::string& XML)
+{
+	XMLResults Results;
+	XMLNode *Node=XMLRootNode::parseString(XML,&Results);
+
+	T Entity(*Node);
+	delete Node;
+
+	return Entity;
+}
+
+static MusicBrainz5::CRelease ParseRelease(const std::string& XML)
+{
+	return Parse<MusicBrainz5::CRelease>(XML);
+}
+
+static MusicBrainz5::CReleaseGroup ParseGroup(const std::string& Title)
+{
+	return Parse<MusicBrainz5::CReleaseGroup>("<release-group><title>"+Title+"</title></release-group>");
+}
+
+static std::string GroupTitle(const MusicBrainz5::CRelease& Release)
+{
+	return Release.ReleaseGroup() ? Release.ReleaseGroup()->Title() : "";
+}
+
+static int NumMedia(const MusicBrainz5::CRelease& Release)
+{
+	return Release.MediumList() ? Release.MediumList()->NumItems() : 0;
+}
+
+static bool IsEmpty(const MusicBrainz5::CRelease& Release)
+{
+	return Release.ID().empty() && Release.Title().empty() && !Release.ReleaseGroup() && !Release.MediumList();
+}
+
+static void TestCopyOnWrite()
+{
+	MusicBrainz5::CRelease Original=ParseRelease(ReleaseXML);
+
+	MusicBrainz5::CRelease Copy=Original;
+	Check(&Copy.Title()==&Original.Title(),"Copy on write: copy doesn't share data");
+
+	//Changing children of the copy doesn't change the original
+
+	*Copy.ReleaseGroup()=ParseGroup("Changed");
+	Copy.MediumList()->AddItem(new MusicBrainz5::CMedium);
+
+	Check("Group"==GroupTitle(Original) && 1==NumMedia(Original),"Copy on write: original changed through copy");
+	Check("Changed"==GroupTitle(Copy) && 2==NumMedia(Copy),"Copy on write: copy not changed");
+
+	//A copy made while a pointer to a child is held doesn't see changes made
+	//through the pointer
+
+	MusicBrainz5::CReleaseGroup *Group=Copy.ReleaseGroup();
+	MusicBrainz5::CRelease Later=Copy;
+	*Group=ParseGroup("Later");
+
+	Check("Later"==GroupTitle(Copy),"Copy on write: change through held pointer lost");
+	Check("Changed"==GroupTitle(Later),"Copy on write: later copy changed through held pointer");
+	Check("Group"==GroupTitle(Original),"Copy on write: original changed through held pointer");
+
+	//Assigning to the original leaves its copies as they were
+
+	MusicBrainz5::CRelease Unchanged=Original;
+	Original=ParseRelease(OtherXML);
+
+	Check("Original"==Unchanged.Title() && "Group"==GroupTitle(Unchanged) && 1==NumMedia(Unchanged),"Copy on write: copy changed by assignment to original");
+}
+
+static void TestMove()
+{
+	MusicBrainz5::CRelease Source=ParseRelease(ReleaseXML);
+
+	MusicBrainz5::CRelease Moved(std::move(Source));
+	Check("Original"==Moved.Title() && Moved.ReleaseGroup() && "Group"==Moved.ReleaseGroup()->Title(),"Move construction: data not moved");
+	Check(IsEmpty(Source),"Move construction: moved-from release not empty");
+
+	//Modifying one moved-from release leaves the others empty
+
+	Source.ReleaseGroup();
+	Source=ParseRelease(OtherXML);
+	Check("Other"==Source.Title(),"Move construction: moved-from release can't be assigned to");
+
+	MusicBrainz5::CRelease Target=ParseRelease(OtherXML);
+	Target=std::move(Moved);
+	Check("Original"==Target.Title() && Target.MediumList() && 1==Target.MediumList()->NumItems(),"Move assignment: data not moved");
+	Check(IsEmpty(Moved),"Move assignment: moved-from release not empty");
+
+	MusicBrainz5::CRelease Copy=Moved;
+	Check(IsEmpty(Copy),"Move assignment: copy of moved-from release not empty");
+
+	//Lists are left without any items
+
+	MusicBrainz5::CMediumList Media(std::move(*Target.MediumList()));
+	Check(1==Media.NumItems() && 1==Media.Item(0)->Position(),"List move: items not moved");
+	Check(0==Target.MediumList()->NumItems(),"List move: moved-from list not empty");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestCopyOnWrite();
+	TestMove();
+
+	return TestResult();
+}
@@ -0,0 +1,589 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/FetchEngine.h"
+#include "musicbrainz5/FetchEngineTransport.h"
+#include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks that CFetchEngine reads Content-Length and chunked responses, reuses
+//keep-alive connections, closes them once they have been idle for too long and
+//retries a request on a reused connection the server has closed. Also checks
+//that CQuery requests made through CFetchEngineTransport share connections and
+//are still rate limited, and that failing to set the engine up is reported
+//rather than leaving requests waiting.
+
+//Accepts connections on a local TCP port, serving each from its own thread
+
+class CServer
+{
+public:
+	CServer()
+	:	m_Socket(-1),
+		m_Port(0),
+		m_Connections(0),
+		m_Closed(0),
+		m_Requests(0)
+	{
+		pthread_mutex_init(&m_Mutex,0);
+	}
+
+	~CServer()
+	{
+		pthread_mutex_destroy(&m_Mutex);
+	}
+
+	int m_Socket;
+	int m_Port;
+	pthread_t m_Thread;
+	pthread_mutex_t m_Mutex;
+	std::vector<pthread_t> m_Threads;
+	int m_Connections;
+	int m_Closed;
+	int m_Requests;
+	std::string m_LastRequest;
+
+	int Connections()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		int Ret=m_Connections;
+		pthread_mutex_unlock(&m_Mutex);
+
+		return Ret;
+	}
+
+	int Closed()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		int Ret=m_Closed;
+		pthread_mutex_unlock(&m_Mutex);
+
+		return Ret;
+	}
+
+	int Requests()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		int Ret=m_Requests;
+		pthread_mutex_unlock(&m_Mutex);
+
+		return Ret;
+	}
+
+	std::string LastRequest()
+	{
+		pthread_mutex_lock(&m_Mutex);
+		std::string Ret=m_LastRequest;
+		pthread_mutex_unlock(&m_Mutex);
+
+		return Ret;
+	}
+};
+
+struct CConnection
+{
+	CServer *m_Server;
+	int m_Socket;
+};
+
+static std::string ReleaseID(int Number)
+{
+	std::stringstream os;
+	os << "76df3287-6cda-33eb-8e9a-044b5e15ff" << (10+Number);
+
+	return os.str();
+}
+
+static std::string ReleaseXML(int Number)
+{
+	std::stringstream os;
+	os << "<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\">";
+	os << "<release id=\"" << ReleaseID(Number) << "\"><title>Release " << Number << "</title></release>";
+	os << "</metadata>";
+
+	return os.str();
+}
+
+static void Send(int Socket, const std::string& Data)
+{
+	if ((ssize_t)Data.length()!=send(Socket,Data.c_str(),Data.length(),MSG_NOSIGNAL))
+		std::cerr << "Short write" << std::endl;
+}
+
+//Releases 0 to 4 exist. Even numbered releases are sent chunked, odd numbered
+//ones with a Content-Length, and each has an ETag.
+
+static bool Respond(int Socket, const std::string& Request)
+{
+	std::string Path=Request.substr(4,Request.find(' ',4)-4);
+
+	if (0==Path.find("/slow"))
+		sleep(1);
+
+	if (0==Path.find("/close") || 0==Path.find("/slow"))
+	{
+		//Closes the connection without saying so in the response
+
+		Send(Socket,"HTTP/1.1 200 OK\r\nContent-Length: 11\r\n\r\n<metadata/>");
+
+		return false;
+	}
+
+	for (int count=0;count<5;count++)
+	{
+		if (0==Path.find("/ws/2/release/"+ReleaseID(count)))
+		{
+			std::stringstream ETag;
+			ETag << "\"release-" << count << "\"";
+
+			if (std::string::npos!=Request.find("If-None-Match: "+ETag.str()))
+			{
+				Send(Socket,"HTTP/1.1 304 Not Modified\r\nETag: "+ETag.str()+"\r\n\r\n");
+				return true;
+			}
+
+			std::string Body=ReleaseXML(count);
+			std::stringstream os;
+
+			os << "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\nETag: " << ETag.str() << "\r\n";
+
+			if (0==count%2)
+			{
+				//Split into several chunks, sent separately
+
+				os << "Transfer-Encoding: chunked\r\n\r\n";
+				Send(Socket,os.str());
+
+				for (std::string::size_type Pos=0;Pos<Body.length();Pos+=40)
+				{
+					std::string Chunk=Body.substr(Pos,40);
+
+					std::stringstream Size;
+					Size << std::hex << Chunk.length() << "\r\n";
+					Send(Socket,Size.str()+Chunk+"\r\n");
+				}
+
+				Send(Socket,"0\r\n\r\n");
+			}
+			else
+			{
+				os << "Content-Length: " << Body.length() << "\r\n\r\n" << Body;
+				Send(Socket,os.str());
+			}
+
+			return true;
+		}
+	}
+
+	Send(Socket,"HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\nNot found");
+
+	return true;
+}
+
+static void *ServeConnection(void *Arg)
+{
+	CConnection *Connection=(CConnection *)Arg;
+	CServer *Server=Connection->m_Server;
+
+	std::string In;
+	char Buffer[4096];
+	bool Open=true;
+
+	while (Open)
+	{
+		std::string::size_type End=In.find("\r\n\r\n");
+		if (std::string::npos==End)
+		{
+			ssize_t Ret=read(Connection->m_Socket,Buffer,sizeof(Buffer));
+			if (Ret<=0)
+			{
+				pthread_mutex_lock(&Server->m_Mutex);
+				Server->m_Closed++;
+				pthread_mutex_unlock(&Server->m_Mutex);
+
+				break;
+			}
+
+			In.append(Buffer,Ret);
+		}
+		else
+		{
+			std::string Request=In.substr(0,End+4);
+			In.erase(0,End+4);
+
+			pthread_mutex_lock(&Server->m_Mutex);
+			Server->m_Requests++;
+			Server->m_LastRequest=Request;
+			pthread_mutex_unlock(&Server->m_Mutex);
+
+			Open=Respond(Connection->m_Socket,Request);
+		}
+	}
+
+	close(Connection->m_Socket);
+	delete Connection;
+
+	return 0;
+}
+
+static void *Serve(void *Arg)
+{
+	CServer *Server=(CServer *)Arg;
+
+	for (;;)
+	{
+		int Socket=accept(Server->m_Socket,0,0);
+		if (-1==Socket)
+			break;
+
+		CConnection *Connection=new CConnection;
+		Connection->m_Server=Server;
+		Connection->m_Socket=Socket;
+
+		//Counted before the response is sent, so that the client sees the count
+
+		pthread_mutex_lock(&Server->m_Mutex);
+
+		Server->m_Connections++;
+
+		pthread_t Thread;
+		pthread_create(&Thread,0,ServeConnection,Connection);
+		Server->m_Threads.push_back(Thread);
+
+		pthread_mutex_unlock(&Server->m_Mutex);
+	}
+
+	return 0;
+}
+
+static void StartServer(CServer& Server)
+{
+	struct sockaddr_in Address;
+	memset(&Address,0,sizeof(Address));
+	Address.sin_family=AF_INET;
+	Address.sin_addr.s_addr=htonl(INADDR_LOOPBACK);
+
+	socklen_t Len=sizeof(Address);
+
+	Server.m_Socket=socket(AF_INET,SOCK_STREAM,0);
+	if (-1==Server.m_Socket || 0!=bind(Server.m_Socket,(struct sockaddr *)&Address,sizeof(Address)) ||
+			0!=listen(Server.m_Socket,16) || 0!=getsockname(Server.m_Socket,(struct sockaddr *)&Address,&Len))
+	{
+		std::cerr << "Can't listen on a local port" << std::endl;
+		exit(1);
+	}
+
+	Server.m_Port=ntohs(Address.sin_port);
+
+	pthread_create(&Server.m_Thread,0,Serve,&Server);
+}
+
+static void StopServer(CServer& Server)
+{
+	shutdown(Server.m_Socket,SHUT_RDWR);
+	pthread_join(Server.m_Thread,0);
+	close(Server.m_Socket);
+
+	for (std::vector<pthread_t>::size_type count=0;count<Server.m_Threads.size();count++)
+		pthread_join(Server.m_Threads[count],0);
+}
+
+static double Now()
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC,&Time);
+
+	return Time.tv_sec+Time.tv_nsec/1e9;
+}
+
+//The server notices a connection has been closed some time after the client closes it
+
+static bool WaitClosed(CServer& Server, int Closed)
+{
+	for (int count=0;count<100 && Server.Closed()<Closed;count++)
+		usleep(10000);
+
+	return Server.Closed()>=Closed;
+}
+
+static std::string Body(const MusicBrainz5::CFetchCompletion& Completion)
+{
+	std::vector<unsigned char> Data=Completion.Data();
+
+	return std::string(Data.begin(),Data.end());
+}
+
+static void *Interrupt(void *Engine)
+{
+	usleep(100000);
+
+	static_cast<MusicBrainz5::CFetchEngine *>(Engine)->Interrupt();
+
+	return 0;
+}
+
+static void TestEngine(CServer& Server)
+{
+	int Connections=Server.Connections();
+	int Closed=Server.Closed();
+
+	MusicBrainz5::CFetchEngine Engine("fetchenginetest-1.0","127.0.0.1",Server.m_Port,1);
+	Engine.SetIdleTimeout(1);
+
+	int Chunked=Engine.Add("/ws/2/release/"+ReleaseID(0));
+	int Length=Engine.Add("/ws/2/release/"+ReleaseID(1));
+	int Missing=Engine.Add("/ws/2/release/"+ReleaseID(5));
+
+	Check(3==Engine.Run(),"Requests didn't all complete");
+	Check(0==Engine.NumPending(),"Requests still pending");
+
+	MusicBrainz5::CFetchCompletion Completion;
+	while (Engine.NextCompletion(Completion))
+	{
+		Check(0==Completion.Result(),"Transfer failed: "+Completion.ErrorMessage());
+
+		if (Chunked==Completion.ID())
+		{
+			Check(200==Completion.Status(),"Unexpected status for chunked response");
+			Check(ReleaseXML(0)==Body(Completion),"Chunked body not decoded");
+			Check("\"release-0\""==Completion.ResponseHeader("etag"),"ETag header not returned");
+		}
+		else if (Length==Completion.ID())
+		{
+			Check(200==Completion.Status(),"Unexpected status for Content-Length response");
+			Check(ReleaseXML(1)==Body(Completion),"Content-Length body not read");
+		}
+		else if (Missing==Completion.ID())
+			Check(404==Completion.Status(),"Missing release not reported");
+		else
+			Check(false,"Unexpected completion");
+	}
+
+	//All three went over the same connection, which is kept open
+
+	Check(Connections+1==Server.Connections(),"Keep-alive connection not reused");
+	Check(1==Engine.NumConnections(),"Keep-alive connection not kept");
+
+	std::map<std::string,std::string> Headers;
+	Headers["If-None-Match"]="\"release-1\"";
+
+	Engine.Add("/ws/2/release/"+ReleaseID(1),Headers);
+	Engine.Run();
+
+	Check(Engine.NextCompletion(Completion) && 304==Completion.Status(),"Request headers not sent");
+	Check(Connections+1==Server.Connections(),"Keep-alive connection not reused for conditional request");
+
+	//The idle connection is closed once it times out
+
+	usleep(1100000);
+	Engine.Run(0);
+
+	Check(0==Engine.NumConnections(),"Idle connection not closed");
+	Check(WaitClosed(Server,Closed+1),"Server didn't see idle connection closed");
+
+	//The server closes the connection after the first request without saying so,
+	//so the second is retried on a new connection
+
+	Engine.Add("/close");
+	Engine.Add("/ws/2/release/"+ReleaseID(3));
+	Engine.Run();
+
+	int Succeeded=0;
+	while (Engine.NextCompletion(Completion))
+	{
+		if (0==Completion.Result() && 200==Completion.Status())
+			Succeeded++;
+	}
+
+	Check(2==Succeeded,"Request on closed connection not retried");
+	Check(Connections+3==Server.Connections(),"Unexpected number of connections after close");
+
+	//Interrupting returns before the slow response has arrived
+
+	pthread_t Thread;
+	pthread_create(&Thread,0,Interrupt,&Engine);
+
+	Engine.Add("/slow");
+
+	double Start=Now();
+	Engine.Run();
+	Check(Now()-Start<0.9 && 1==Engine.NumPending(),"Run not interrupted");
+
+	pthread_join(Thread,0);
+
+	Engine.Run();
+	Check(0==Engine.NumPending() && Engine.NextCompletion(Completion) && 200==Completion.Status(),"Slow request not completed");
+}
+
+static void TestQuery(CServer& Server)
+{
+	int Connections=Server.Connections();
+	int Requests=Server.Requests();
+
+	MusicBrainz5::CFetchEngineTransport Transport(2);
+
+	//The requests are rate limited as usual, even though they share connections
+
+	MusicBrainz5::CRateLimiter RateLimiter;
+	RateLimiter.SetLimit("127.0.0.1",20,1);
+
+	MusicBrainz5::CQuery Query("fetchenginetest-1.0",&Transport,"127.0.0.1",Server.m_Port);
+	Query.SetRateLimiter(&RateLimiter);
+	Query.SetBatchConcurrency(4);
+
+	std::vector<std::string> IDs;
+	for (int count=0;count<6;count++)
+		IDs.push_back(ReleaseID(count));
+
+	double Start=Now();
+	std::vector<MusicBrainz5::CLookupResult> Results=Query.LookupBatch("release",IDs);
+
+	Check(Now()-Start>=0.25,"Requests not rate limited");
+	Check(Results.size()==IDs.size(),"Wrong number of results");
+
+	for (std::vector<MusicBrainz5::CLookupResult>::size_type count=0;count<Results.size();count++)
+	{
+		MusicBrainz5::CMetadata Metadata=Results[count].Metadata();
+
+		if (5==count)
+			Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Results[count].Result() &&
+				404==Results[count].HTTPCode(),"Missing release not reported");
+		else
+			Check(MusicBrainz5::CQuery::eQuery_Success==Results[count].Result() &&
+				Metadata.Release() && Metadata.Release()->ID()==IDs[count],"Wrong release returned for "+IDs[count]);
+	}
+
+	Check(Requests+6==Server.Requests(),"Unexpected number of requests");
+	Check(Server.Connections()<=Connections+2,"Connections not shared between threads");
+	Check(std::string::npos!=Server.LastRequest().find("User-Agent: fetchenginetest/1.0"),"User agent not sent");
+
+	try
+	{
+		Query.Query("release",ReleaseID(5));
+		Check(false,"No exception for missing release");
+	}
+
+	catch (MusicBrainz5::CResourceNotFoundError& /*Error*/)
+	{
+	}
+
+	Check(404==Query.LastHTTPCode(),"Missing release status not recorded");
+
+	//Only GET requests can be made
+
+	MusicBrainz5::CFetch *Fetch=Transport.CreateFetch("fetchenginetest-1.0","127.0.0.1",Server.m_Port);
+
+	try
+	{
+		Fetch->Fetch("/ws/2/collection/"+ReleaseID(0)+"/releases/"+ReleaseID(1),"PUT");
+		Check(false,"No exception for PUT request");
+	}
+
+	catch (MusicBrainz5::CFetchError& /*Error*/)
+	{
+	}
+
+	delete Fetch;
+}
+
+static void TestSetupFailure(CServer& Server)
+{
+	MusicBrainz5::CFetchEngineTransport Transport;
+
+	MusicBrainz5::CQuery Query("fetchenginetest-1.0",&Transport,"127.0.0.1",Server.m_Port);
+
+	MusicBrainz5::CRateLimiter RateLimiter;
+	RateLimiter.SetLimit("127.0.0.1",1000,100);
+	Query.SetRateLimiter(&RateLimiter);
+
+	//With no descriptors to spare, the engine can't create its pipe or epoll instance
+
+	int Lowest=dup(0);
+	close(Lowest);
+
+	struct rlimit Limit;
+	getrlimit(RLIMIT_NOFILE,&Limit);
+
+	struct rlimit Lowered=Limit;
+	Lowered.rlim_cur=Lowest;
+	setrlimit(RLIMIT_NOFILE,&Lowered);
+
+	bool Thrown=false;
+
+	{
+		MusicBrainz5::CFetchEngine Engine("fetchenginetest-1.0","127.0.0.1",Server.m_Port);
+		Engine.Add("/ws/2/release/"+ReleaseID(1));
+
+		try
+		{
+			Engine.Run();
+		}
+
+		catch (MusicBrainz5::CFetchError& /*Error*/)
+		{
+			Thrown=true;
+		}
+	}
+
+	MusicBrainz5::CLookupResult Result=Query.Lookup("release",ReleaseID(1));
+
+	setrlimit(RLIMIT_NOFILE,&Limit);
+
+	Check(Thrown,"No exception when the engine couldn't be set up");
+	Check(MusicBrainz5::CQuery::eQuery_FetchError==Result.Result(),"Query through an engine that couldn't be set up didn't fail");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	CServer Server;
+	StartServer(Server);
+
+	TestEngine(Server);
+	TestQuery(Server);
+	TestSetupFailure(Server);
+
+	StopServer(Server);
+
+	return TestResult();
+}
@@ -0,0 +1,135 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include <pthread.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "TestUtil.h"
+
+//Checks that two threads sharing a CQuery each see the status of their own last
+//query from LastResult, LastHTTPCode and LastErrorMessage, when one thread's query
+//fails and the other's succeeds at the same time.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+static const std::string MissingID="76df3287-6cda-33eb-8e9a-044b5e15ffde";
+
+static const int NumRounds=20;
+
+struct CThreadStatus
+{
+	MusicBrainz5::CQuery *m_Query;
+	pthread_barrier_t *m_Barrier;
+	std::string m_ID;
+	int m_Mismatches;
+};
+
+static void *QueryThread(void *Data)
+{
+	CThreadStatus *Status=static_cast<CThreadStatus *>(Data);
+	bool Missing=Status->m_ID==MissingID;
+
+	for (int count=0;count<NumRounds;count++)
+	{
+		try
+		{
+			Status->m_Query->Query("release",Status->m_ID);
+		}
+
+		catch (MusicBrainz5::CExceptionBase& /*Error*/)
+		{
+		}
+
+		//Both queries have finished before either thread reads its status
+
+		pthread_barrier_wait(Status->m_Barrier);
+
+		if (Missing)
+		{
+			if (MusicBrainz5::CQuery::eQuery_ResourceNotFound!=Status->m_Query->LastResult() ||
+					404!=Status->m_Query->LastHTTPCode() ||
+					std::string::npos==Status->m_Query->LastErrorMessage().find(MissingID))
+				Status->m_Mismatches++;
+		}
+		else
+		{
+			if (MusicBrainz5::CQuery::eQuery_Success!=Status->m_Query->LastResult() ||
+					200!=Status->m_Query->LastHTTPCode() ||
+					!Status->m_Query->LastErrorMessage().empty())
+				Status->m_Mismatches++;
+		}
+
+		pthread_barrier_wait(Status->m_Barrier);
+	}
+
+	return 0;
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	MusicBrainz5::CMemoryTransport Transport;
+	Transport.AddResponse("/ws/2/release/"+ReleaseID,"<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\"/>");
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("laststatustest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+
+	pthread_barrier_t Barrier;
+	pthread_barrier_init(&Barrier,0,2);
+
+	CThreadStatus Status[2];
+	pthread_t Threads[2];
+
+	for (int count=0;count<2;count++)
+	{
+		Status[count].m_Query=&Query;
+		Status[count].m_Barrier=&Barrier;
+		Status[count].m_ID=0==count ? MissingID : ReleaseID;
+		Status[count].m_Mismatches=0;
+
+		pthread_create(&Threads[count],0,QueryThread,&Status[count]);
+	}
+
+	for (int count=0;count<2;count++)
+		pthread_join(Threads[count],0);
+
+	pthread_barrier_destroy(&Barrier);
+
+	Check(0==Status[0].m_Mismatches,"Failed query's status not seen by its thread");
+	Check(0==Status[1].m_Mismatches,"Successful query's status not seen by its thread");
+
+	//The main thread hasn't made a query, so it sees the initial status
+
+	Check(MusicBrainz5::CQuery::eQuery_Success==Query.LastResult() && 200==Query.LastHTTPCode(),
+		"Status of other threads' queries seen by the main thread");
+
+	return TestResult();
+}
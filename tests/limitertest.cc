@@ -0,0 +1,293 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/RateLimiter.h"
+#include "musicbrainz5/Metadata.h"
+#include "musicbrainz5/Release.h"
+
+#include "TestUtil.h"
+
+//Checks the number of requests the rate limiter lets through in a burst, and
+//when it lets the next ones through, using a clock that only moves when told to.
+//Also checks that limiters using the same shared file draw from one bucket for
+//each host, that the rate halves when the server is overloaded and recovers a
+//step at a time, and that CQuery reports 503 responses, their Retry-After delay
+//and every other answer from the server to its limiter.
+
+//Shared by every limiter, like the real clock
+
+static double Time=1000;
+
+class CClockedRateLimiter: public MusicBrainz5::CRateLimiter
+{
+protected:
+	virtual double Now() const
+	{
+		return Time;
+	}
+};
+
+//Intervals are kept in whole nanoseconds, so rates are only close to exact
+
+static bool Near(double Value, double Expected)
+{
+	return fabs(Value-Expected)<Expected*1e-6;
+}
+
+static int Admitted(MusicBrainz5::CRateLimiter& Limiter, const std::string& Host)
+{
+	int Count=0;
+
+	while (Count<100 && Limiter.TryAcquire(Host))
+		Count++;
+
+	return Count;
+}
+
+static void TestBurst()
+{
+	CClockedRateLimiter Limiter;
+	Limiter.SetLimit("example.org",10,5);
+
+	//The bucket starts full, then refills at one request every tenth of a second
+
+	Check(5==Admitted(Limiter,"example.org"),"Wrong number of requests admitted in a burst");
+
+	Time+=0.1;
+	Check(1==Admitted(Limiter,"example.org"),"Bucket not refilled by one request");
+
+	Time+=0.35;
+	Check(3==Admitted(Limiter,"example.org"),"Bucket not refilled by three requests");
+
+	Time+=10;
+	Check(5==Admitted(Limiter,"example.org"),"Bucket refilled beyond the burst size");
+
+	//Reservations are made back to back, one interval apart
+
+	Check(Near(0.1,Limiter.Reserve("example.org")),"Wrong delay for first reservation");
+	Check(Near(0.2,Limiter.Reserve("example.org")),"Wrong delay for second reservation");
+	Check(!Limiter.TryAcquire("example.org"),"Request admitted ahead of reservations");
+
+	//Sub-domains share the bucket of the domain
+
+	Time+=0.3;
+	Check(1==Admitted(Limiter,"test.example.org"),"Sub-domain doesn't share the bucket");
+	Check(0==Admitted(Limiter,"example.org"),"Sub-domain request not taken from the bucket");
+
+	Check(100==Admitted(Limiter,"example.com"),"Host without a limit was limited");
+	Check(0==Limiter.Reserve("notexample.org"),"Host with a similar name was limited");
+
+	Limiter.RemoveLimit("example.org");
+	Check(100==Admitted(Limiter,"example.org"),"Limit not removed");
+}
+
+//Number of times a host name appears in the shared file, which is once for each
+//slot claimed for it
+
+static int NumSlots(const std::string& FileName, const std::string& Host)
+{
+	std::ifstream File(FileName.c_str(),std::ios::in | std::ios::binary);
+	std::stringstream os;
+	os << File.rdbuf();
+
+	std::string Contents=os.str();
+	std::string Name(Host.c_str(),Host.length()+1);
+
+	int Count=0;
+	for (std::string::size_type Pos=Contents.find(Name);std::string::npos!=Pos;Pos=Contents.find(Name,Pos+1))
+		Count++;
+
+	return Count;
+}
+
+static void TestShared()
+{
+	char FileName[]="/tmp/limitertestXXXXXX";
+	int File=mkstemp(FileName);
+	if (-1==File)
+	{
+		Check(false,"Can't create shared file");
+		return;
+	}
+
+	close(File);
+
+	//One limiter sets its limit before sharing, the other after
+
+	CClockedRateLimiter First;
+	First.SetLimit("shared.example.org",10,4);
+	Check(First.SetSharedFile(FileName),"Shared file not used");
+
+	CClockedRateLimiter Second;
+	Check(Second.SetSharedFile(FileName),"Shared file not used by second limiter");
+	Second.SetLimit("shared.example.org",10,4);
+	Second.SetLimit("other.example.org",10,4);
+
+	Check(FileName==Second.SharedFile(),"Wrong shared file name");
+	Check(1==NumSlots(FileName,"shared.example.org"),"Host not given exactly one slot");
+	Check(1==NumSlots(FileName,"other.example.org"),"Second host not given its own slot");
+
+	//Requests through either limiter empty the same bucket
+
+	Check(First.TryAcquire("shared.example.org") && First.TryAcquire("shared.example.org") &&
+		First.TryAcquire("shared.example.org"),"First limiter not admitted");
+	Check(1==Admitted(Second,"shared.example.org"),"Second limiter doesn't share the bucket");
+	Check(0==Admitted(First,"shared.example.org"),"First limiter doesn't see the second's request");
+	Check(4==Admitted(Second,"other.example.org"),"Hosts share a bucket");
+
+	Time+=0.1;
+	Check(1==Admitted(Second,"shared.example.org"),"Shared bucket not refilled");
+	Check(0==Admitted(First,"shared.example.org"),"Shared bucket refilled twice");
+
+	//Being throttled slows both down
+
+	First.Throttled("shared.example.org");
+	Check(Near(5,Second.Rate("shared.example.org")),"Throttled rate not shared");
+
+	//A limiter that goes away leaves its slots for the others
+
+	{
+		CClockedRateLimiter Third;
+		Third.SetLimit("shared.example.org",10,4);
+		Third.SetSharedFile(FileName);
+		Check(Near(5,Third.Rate("shared.example.org")),"New limiter doesn't see the shared rate");
+	}
+
+	Check(1==NumSlots(FileName,"shared.example.org"),"Slot claimed again");
+
+	unlink(FileName);
+}
+
+static void TestAdaptive()
+{
+	CClockedRateLimiter Limiter;
+	Limiter.SetLimit("example.org",10,2);
+
+	//Multiplicative decrease, down to a 64th of the configured rate
+
+	Limiter.Throttled("example.org");
+	Check(Near(5,Limiter.Rate("example.org")),"Rate not halved");
+
+	Limiter.Throttled("example.org");
+	Check(Near(2.5,Limiter.Rate("example.org")),"Rate not halved again");
+
+	for (int count=0;count<10;count++)
+		Limiter.Throttled("example.org");
+	Check(Near(10.0/64,Limiter.Rate("example.org")),"Rate not limited to a 64th");
+
+	//Additive increase, a tenth of the configured rate at a time
+
+	Limiter.SetLimit("example.org",10,2);
+	Limiter.Throttled("example.org");
+	Limiter.Throttled("example.org");
+
+	double Expected=2.5;
+	for (int count=0;count<8;count++)
+	{
+		Limiter.Succeeded("example.org");
+
+		Expected=Expected+1>10 ? 10 : Expected+1;
+		Check(Near(Expected,Limiter.Rate("example.org")),"Rate not increased by a tenth");
+	}
+
+	Check(Near(10,Limiter.Rate("example.org")),"Rate not back to the configured rate");
+
+	//Nothing goes until the server's retry delay has passed, and then not in a burst
+
+	Time+=10;
+	Limiter.Throttled("example.org",2);
+
+	Time+=1.9;
+	Check(!Limiter.TryAcquire("example.org"),"Request admitted before the retry delay");
+
+	Time+=0.2;
+	Check(1==Admitted(Limiter,"example.org"),"Requests not admitted one at a time after the retry delay");
+}
+
+static void TestQuery()
+{
+	const std::string ID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+	const std::string URL="/ws/2/release/"+ID;
+	const std::string Release="<metadata xmlns=\"http://musicbrainz.org/ns/mmd-2.0#\"><release id=\""+ID+"\"><title>Release</title></release></metadata>";
+
+	MusicBrainz5::CMemoryTransport Transport;
+
+	//The server is busy for a second, then answers
+
+	std::map<std::string,std::string> Headers;
+	Headers["Retry-After"]="1";
+
+	Transport.QueueResponse(URL,"",503,Headers);
+	Transport.AddResponse(URL,Release);
+
+	MusicBrainz5::CRateLimiter Limiter;
+	Limiter.SetLimit("musicbrainz.org",100,1);
+
+	MusicBrainz5::CQuery Query("limitertest-1.0",&Transport);
+	Query.SetRateLimiter(&Limiter);
+
+	MusicBrainz5::CLookupResult Result=Query.Lookup("release",ID);
+	MusicBrainz5::CMetadata Metadata=Result.Metadata();
+
+	Check(MusicBrainz5::CQuery::eQuery_Success==Result.Result() && Metadata.Release(),"Request not retried after 503");
+	Check(2==Transport.NumRequests() && 1==Result.Retries(),"Wrong number of requests after 503");
+	Check(Result.WaitTime()>=0.95,"Retry-After not honoured");
+
+	//Halved by the 503, then increased by the success
+
+	Check(Near(60,Limiter.Rate("musicbrainz.org")),"Rate not adapted to 503 and success");
+
+	//Answers other than 503 also show the server isn't overloaded
+
+	Transport.AddResponse("/ws/2/release/76df3287-6cda-33eb-8e9a-044b5e15ff40","",400);
+
+	Result=Query.Lookup("release","76df3287-6cda-33eb-8e9a-044b5e15ff40");
+	Check(MusicBrainz5::CQuery::eQuery_RequestError==Result.Result(),"400 not reported");
+	Check(Near(70,Limiter.Rate("musicbrainz.org")),"400 not reported to the limiter");
+
+	Result=Query.Lookup("release","76df3287-6cda-33eb-8e9a-044b5e15ff41");
+	Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Result.Result(),"404 not reported");
+	Check(Near(80,Limiter.Rate("musicbrainz.org")),"404 not reported to the limiter");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestBurst();
+	TestShared();
+	TestAdaptive();
+	TestQuery();
+
+	return TestResult();
+}
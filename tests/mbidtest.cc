@@ -0,0 +1,141 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "musicbrainz5/MBID.h"
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "TestUtil.h"
+
+//Checks that CMBID parses, prints and orders IDs, and that CQuery rejects lookups
+//of malformed IDs without sending a request.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+
+static const char *InvalidIDs[]=
+{
+	"", "not-an-id", "76df3287-6cda-33eb-8e9a-044b5e15ffd", "76df3287-6cda-33eb-8e9a-044b5e15ffddd",
+	"76df32876cda-33eb-8e9a-044b5e15ffdd-", "76df3287-6cda-33eb-8e9a-044b5e15ffdg",
+	"76df3287 6cda 33eb 8e9a 044b5e15ffdd", "{76df3287-6cda-33eb-8e9a-044b5e15ffd}",
+	0
+};
+
+static void TestMBID()
+{
+	MusicBrainz5::CMBID ID(ReleaseID);
+	Check(!ID.IsNil() && ID.ToString()==ReleaseID,"Valid ID not parsed");
+
+	MusicBrainz5::CMBID Upper("76DF3287-6CDA-33EB-8E9A-044B5E15FFDD");
+	Check(Upper==ID && Upper.Hash()==ID.Hash() && Upper.ToString()==ReleaseID,"Upper case ID not parsed");
+
+	for (int count=0;InvalidIDs[count];count++)
+	{
+		Check(!MusicBrainz5::CMBID::IsValid(InvalidIDs[count]),std::string("Invalid ID '")+InvalidIDs[count]+"' accepted");
+		Check(MusicBrainz5::CMBID(InvalidIDs[count]).IsNil(),std::string("Invalid ID '")+InvalidIDs[count]+"' not nil");
+	}
+
+	//IDs order as their text does
+
+	MusicBrainz5::CMBID Lower("0fffffff-ffff-ffff-ffff-ffffffffffff");
+	MusicBrainz5::CMBID Higher("10000000-0000-0000-0000-000000000000");
+	Check(Lower<Higher && Higher>Lower && Lower!=Higher && MusicBrainz5::CMBID()<Lower,"IDs ordered wrongly");
+}
+
+static void TestQuery()
+{
+	MusicBrainz5::CMemoryTransport Transport;
+
+	CTestRateLimiter RateLimiter;
+
+	MusicBrainz5::CQuery Query("mbidtest-1.0",&Transport);
+	Query.SetRateLimiter(&RateLimiter);
+
+	for (int count=0;InvalidIDs[count];count++)
+	{
+		//An empty ID is a search rather than a lookup
+
+		if (!*InvalidIDs[count])
+			continue;
+
+		MusicBrainz5::CLookupResult Result=Query.Lookup("release",InvalidIDs[count]);
+		Check(MusicBrainz5::CQuery::eQuery_RequestError==Result.Result() && 0==Result.HTTPCode(),std::string("Lookup of '")+InvalidIDs[count]+"' not rejected");
+
+		bool Thrown=false;
+
+		try
+		{
+			Query.Query("artist",InvalidIDs[count]);
+		}
+
+		catch (MusicBrainz5::CRequestError& /*Error*/)
+		{
+			Thrown=true;
+		}
+
+		Check(Thrown && MusicBrainz5::CQuery::eQuery_RequestError==Query.LastResult() && 0==Query.LastHTTPCode(),std::string("Query of '")+InvalidIDs[count]+"' not rejected");
+	}
+
+	Check(0==Transport.NumRequests(),"Request sent for an invalid ID");
+
+	//Valid IDs in either case, and entities not looked up by MBID, are sent
+
+	Query.Lookup("release",ReleaseID);
+	Query.Lookup("release","76DF3287-6CDA-33EB-8E9A-044B5E15FFDD");
+	Query.Lookup("discid","arIS30RPWowvwNEqsqdDnZzDGhk-");
+	Check(3==Transport.NumRequests(),"Request not sent for a valid ID");
+
+	//Collection edits are checked before anything is sent
+
+	std::vector<std::string> Entries;
+	Entries.push_back(ReleaseID);
+	Entries.push_back("not-an-id");
+
+	bool Thrown=false;
+
+	try
+	{
+		Query.AddCollectionEntries(ReleaseID,Entries);
+	}
+
+	catch (MusicBrainz5::CRequestError& /*Error*/)
+	{
+		Thrown=true;
+	}
+
+	Check(Thrown && 3==Transport.NumRequests(),"Collection edit with an invalid entry not rejected");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestMBID();
+	TestQuery();
+
+	return TestResult();
+}
@@ -25,6 +25,7 @@
 
 #include <iostream>
 
+#include <stdlib.h>
 #include <strings.h>
 
 #include "musicbrainz5/Query.h"
@@ -37,6 +38,7 @@
 #include "musicbrainz5/Artist.h"
 #include "musicbrainz5/Alias.h"
 #include "musicbrainz5/HTTPFetch.h"
+#include "musicbrainz5/MemoryTransport.h"
 #include "musicbrainz5/Track.h"
 #include "musicbrainz5/Recording.h"
 #include "musicbrainz5/Collection.h"
@@ -66,7 +68,13 @@ void PrintRelationList(MusicBrainz5::CRelationList *RelationList)
 
 int main(int argc, const char *argv[])
 {
-	MusicBrainz5::CQuery MB2("MBTest/v1.0","musicbrainz.org");
+	//Set MBTEST_RESPONSES to a directory of saved responses to run without a network
+
+	const char *Responses=getenv("MBTEST_RESPONSES");
+	MusicBrainz5::CMemoryTransport MemoryTransport(Responses?Responses:"");
+	MusicBrainz5::CTransport *Transport=Responses?&MemoryTransport:0;
+
+	MusicBrainz5::CQuery MB2("MBTest/v1.0",Transport,"musicbrainz.org");
 
 	MusicBrainz5::CQuery::tParamMap Params5;
 	Params5["inc"]="aliases";
@@ -194,7 +202,7 @@ int main(int argc, const char *argv[])
 
 //	return 0;
 
-	MusicBrainz5::CQuery MB("MBTest/v1.0");
+	MusicBrainz5::CQuery MB("MBTest/v1.0",Transport);
 
 	if (argc>1)
 	{
@@ -0,0 +1,144 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include <stdlib.h>
+
+#include "musicbrainz5/Query.h"
+#include "musicbrainz5/MemoryTransport.h"
+#include "musicbrainz5/ResponseCache.h"
+#include "musicbrainz5/DiskCache.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "TestUtil.h"
+
+//Checks that a lookup returning 404 is remembered by the response and disk caches,
+//so that repeating it fails without another request until the negative TTL expires.
+
+static const std::string ReleaseID="76df3287-6cda-33eb-8e9a-044b5e15ffdd";
+
+static bool NotFound(const MusicBrainz5::CLookupResult& Result)
+{
+	return MusicBrainz5::CQuery::eQuery_ResourceNotFound==Result.Result() && 404==Result.HTTPCode();
+}
+
+static void TestResponseCache(MusicBrainz5::CRateLimiter *RateLimiter)
+{
+	MusicBrainz5::CMemoryTransport Transport;
+	MusicBrainz5::CResponseCache ResponseCache;
+
+	MusicBrainz5::CQuery Query("negcachetest-1.0",&Transport);
+	Query.SetRateLimiter(RateLimiter);
+	Query.SetResponseCache(&ResponseCache);
+
+	MusicBrainz5::CLookupResult First=Query.Lookup("release",ReleaseID);
+	MusicBrainz5::CLookupResult Second=Query.Lookup("release",ReleaseID);
+
+	Check(1==Transport.NumRequests(),"Response cache: 404 wasn't cached");
+	Check(NotFound(First) && !First.Cached(),"Response cache: wrong result for 404");
+	Check(NotFound(Second) && Second.Cached(),"Response cache: wrong result for cached 404");
+
+	//Query reports a cached 404 with the same exception as a real one
+
+	bool Thrown=false;
+
+	try
+	{
+		Query.Query("release",ReleaseID);
+	}
+
+	catch (MusicBrainz5::CResourceNotFoundError& /*Error*/)
+	{
+		Thrown=true;
+	}
+
+	Check(Thrown && 1==Transport.NumRequests(),"Response cache: cached 404 not thrown");
+	Check(MusicBrainz5::CQuery::eQuery_ResourceNotFound==Query.LastResult() && 404==Query.LastHTTPCode(),"Response cache: wrong status for cached 404");
+
+	//Once the negative TTL expires the request is made again
+
+	ResponseCache.SetNegativeTTL(0);
+
+	Query.Lookup("release",ReleaseID);
+	Check(2==Transport.NumRequests(),"Response cache: expired 404 wasn't requested again");
+}
+
+static void TestDiskCache(MusicBrainz5::CRateLimiter *RateLimiter, const std::string& Directory)
+{
+	MusicBrainz5::CMemoryTransport Transport;
+
+	{
+		MusicBrainz5::CDiskCache DiskCache(Directory);
+		MusicBrainz5::CQuery Query("negcachetest-1.0",&Transport);
+		Query.SetRateLimiter(RateLimiter);
+		Query.SetDiskCache(&DiskCache);
+
+		Query.Lookup("release",ReleaseID);
+	}
+
+	//A new cache in the same directory remembers the 404
+
+	{
+		MusicBrainz5::CDiskCache DiskCache(Directory);
+		MusicBrainz5::CQuery Query("negcachetest-1.0",&Transport);
+		Query.SetRateLimiter(RateLimiter);
+		Query.SetDiskCache(&DiskCache);
+
+		MusicBrainz5::CLookupResult Result=Query.Lookup("release",ReleaseID);
+		Check(1==Transport.NumRequests(),"Disk cache: 404 wasn't cached");
+		Check(NotFound(Result) && Result.Cached(),"Disk cache: wrong result for cached 404");
+
+		DiskCache.SetNegativeTTL(0);
+
+		Result=Query.Lookup("release",ReleaseID);
+		Check(2==Transport.NumRequests() && NotFound(Result) && !Result.Cached(),"Disk cache: expired 404 wasn't requested again");
+
+		DiskCache.Clear();
+	}
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	char Directory[]="/tmp/negcachetestXXXXXX";
+	if (!mkdtemp(Directory))
+	{
+		std::cerr << "Can't create cache directory" << std::endl;
+		return 1;
+	}
+
+	CTestRateLimiter RateLimiter;
+
+	TestResponseCache(&RateLimiter);
+	TestDiskCache(&RateLimiter,std::string(Directory)+"/cache");
+
+	std::string Command="rm -rf ";
+	Command+=Directory;
+	if (0!=system(Command.c_str()))
+		std::cerr << "Can't remove " << Directory << std::endl;
+
+	return TestResult();
+}
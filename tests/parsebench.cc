@@ -0,0 +1,164 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "musicbrainz5/Entity.h"
+
+//Measures the cost of parsing one numeric field with the stream based templates
+//in CEntity, which every field used to go through, and with the fast paths.
+//
+//Usage: parsebench [iterations]
+
+class CParseBench: public MusicBrainz5::CEntity
+{
+public:
+	virtual CParseBench *Clone()
+	{
+		return new CParseBench(*this);
+	}
+
+	void StreamInt(const std::string& Text, int& RetVal)
+	{
+		ProcessItem<int>(Text,RetVal);
+	}
+
+	void FastInt(const std::string& Text, int& RetVal)
+	{
+		ProcessItem(Text,RetVal);
+	}
+
+	void StreamDouble(const std::string& Text, double& RetVal)
+	{
+		ProcessItem<double>(Text,RetVal);
+	}
+
+	void FastDouble(const std::string& Text, double& RetVal)
+	{
+		ProcessItem(Text,RetVal);
+	}
+
+protected:
+	virtual void ParseAttribute(const std::string& /*Name*/, const std::string& /*Value*/)
+	{
+	}
+
+	virtual void ParseElement(const XMLNode& /*Node*/)
+	{
+	}
+};
+
+static double Now()
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC,&Time);
+
+	return Time.tv_sec+Time.tv_nsec/1e9;
+}
+
+typedef void (CParseBench::*tIntParser)(const std::string&, int&);
+typedef void (CParseBench::*tDoubleParser)(const std::string&, double&);
+
+//Values of the kind found in track lengths, positions, sector offsets and ratings
+
+static std::vector<std::string> IntValues()
+{
+	static const char *Values[]={"1","12","243893","150","187265","5","98304","2",0};
+
+	return std::vector<std::string>(Values,Values+8);
+}
+
+static std::vector<std::string> DoubleValues()
+{
+	static const char *Values[]={"4.5","3","100","4.25","0.5","2.75","5","1.5",0};
+
+	return std::vector<std::string>(Values,Values+8);
+}
+
+static double TimeInts(CParseBench& Bench, tIntParser Parser, const std::vector<std::string>& Values, int Iterations, long& Sum)
+{
+	double Start=Now();
+
+	for (int count=0;count<Iterations;count++)
+	{
+		int Value=0;
+		(Bench.*Parser)(Values[count%Values.size()],Value);
+		Sum+=Value;
+	}
+
+	return (Now()-Start)*1e9/Iterations;
+}
+
+static double TimeDoubles(CParseBench& Bench, tDoubleParser Parser, const std::vector<std::string>& Values, int Iterations, double& Sum)
+{
+	double Start=Now();
+
+	for (int count=0;count<Iterations;count++)
+	{
+		double Value=0;
+		(Bench.*Parser)(Values[count%Values.size()],Value);
+		Sum+=Value;
+	}
+
+	return (Now()-Start)*1e9/Iterations;
+}
+
+int main(int argc, const char *argv[])
+{
+	int Iterations=1000000;
+	if (argc>1)
+		Iterations=atoi(argv[1]);
+
+	if (Iterations<1)
+		Iterations=1;
+
+	CParseBench Bench;
+	long IntSum=0;
+	double DoubleSum=0;
+
+	std::vector<std::string> Ints=IntValues();
+	std::vector<std::string> Doubles=DoubleValues();
+
+	double StreamInt=TimeInts(Bench,&CParseBench::StreamInt,Ints,Iterations,IntSum);
+	double FastInt=TimeInts(Bench,&CParseBench::FastInt,Ints,Iterations,IntSum);
+	double StreamDouble=TimeDoubles(Bench,&CParseBench::StreamDouble,Doubles,Iterations,DoubleSum);
+	double FastDouble=TimeDoubles(Bench,&CParseBench::FastDouble,Doubles,Iterations,DoubleSum);
+
+	std::cout << "Per field, " << Iterations << " iterations:" << std::endl;
+	std::cout << "int:    stream " << StreamInt << " ns, fast " << FastInt << " ns" << std::endl;
+	std::cout << "double: stream " << StreamDouble << " ns, fast " << FastDouble << " ns" << std::endl;
+
+	//Keep the results live so the loops aren't optimised away
+
+	if (IntSum==42 && DoubleSum==42)
+		std::cout << std::endl;
+
+	return 0;
+}
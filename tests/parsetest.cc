@@ -0,0 +1,133 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include <string.h>
+
+#include "musicbrainz5/Entity.h"
+
+//Checks that the numeric fields are parsed exactly as the stream based templates
+//in CEntity parse them, which is how they were parsed before the fast paths.
+
+class CParseTest: public MusicBrainz5::CEntity
+{
+public:
+	virtual CParseTest *Clone()
+	{
+		return new CParseTest(*this);
+	}
+
+	void StreamInt(const std::string& Text, int& RetVal)
+	{
+		ProcessItem<int>(Text,RetVal);
+	}
+
+	void FastInt(const std::string& Text, int& RetVal)
+	{
+		ProcessItem(Text,RetVal);
+	}
+
+	void StreamDouble(const std::string& Text, double& RetVal)
+	{
+		ProcessItem<double>(Text,RetVal);
+	}
+
+	void FastDouble(const std::string& Text, double& RetVal)
+	{
+		ProcessItem(Text,RetVal);
+	}
+
+protected:
+	virtual void ParseAttribute(const std::string& /*Name*/, const std::string& /*Value*/)
+	{
+	}
+
+	virtual void ParseElement(const XMLNode& /*Node*/)
+	{
+	}
+};
+
+static const char *IntTests[]=
+{
+	"0", "42", "-7", "+7", "  123", "\t\n 9", "12abc", "007", "-0",
+	"2147483647", "2147483648", "-2147483648", "-2147483649",
+	"4294967295", "4294967296", "4294967306", "42949672960",
+	"18446744073709551615", "18446744073709551616", "99999999999999999999999",
+	"-4294967296", "abc", "-", "+", "", "   ", "- 1", "1 2",
+	0
+};
+
+static const char *DoubleTests[]=
+{
+	"0", "1", "1.5", "-0.25", "0.1", "10.0", "5.", ".5", "4.5 stars",
+	"123456789012345", "1234567890123456", "0.000000000000001", "3.14159265358979",
+	"1e3", "2.5E-3", "1.7976931348623157e308", "1e400", "-1e400",
+	"abc", "-", "", "   ", "  7.25", "1..2",
+	0
+};
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	CParseTest Test;
+	int Failures=0;
+
+	for (int count=0;IntTests[count];count++)
+	{
+		int Stream=-12345;
+		int Fast=-12345;
+
+		Test.StreamInt(IntTests[count],Stream);
+		Test.FastInt(IntTests[count],Fast);
+
+		if (Stream!=Fast)
+		{
+			std::cerr << "int '" << IntTests[count] << "': stream " << Stream << ", fast " << Fast << std::endl;
+			Failures++;
+		}
+	}
+
+	for (int count=0;DoubleTests[count];count++)
+	{
+		double Stream=-12345.0;
+		double Fast=-12345.0;
+
+		Test.StreamDouble(DoubleTests[count],Stream);
+		Test.FastDouble(DoubleTests[count],Fast);
+
+		if (0!=memcmp(&Stream,&Fast,sizeof(Stream)))
+		{
+			std::cerr.precision(17);
+			std::cerr << "double '" << DoubleTests[count] << "': stream " << Stream << ", fast " << Fast << std::endl;
+			Failures++;
+		}
+	}
+
+	if (Failures)
+		std::cerr << Failures << " failures" << std::endl;
+
+	return Failures ? 1 : 0;
+}
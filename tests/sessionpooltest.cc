@@ -0,0 +1,174 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <string>
+
+#include "musicbrainz5/HTTPSessionPool.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "ne_session.h"
+
+#include "TestUtil.h"
+
+//Checks that the session pool hands back idle sessions only for the server, proxy
+//and user they were set up for, keeps no more than its maximum number of sessions,
+//and closes sessions that have been idle for the idle timeout.
+
+//Pool whose clock is set by the test
+
+class CTestSessionPool: public MusicBrainz5::CHTTPSessionPool
+{
+public:
+	CTestSessionPool(int MaxSessions, int IdleTimeout)
+	:	CHTTPSessionPool(MaxSessions,IdleTimeout),
+		m_Now(1000)
+	{
+	}
+
+	using CHTTPSessionPool::Acquire;
+	using CHTTPSessionPool::Release;
+
+	time_t m_Now;
+
+protected:
+	virtual time_t Now() const
+	{
+		return m_Now;
+	}
+};
+
+class CTestFetch: public MusicBrainz5::CHTTPFetch
+{
+public:
+	CTestFetch(const std::string& Host, int Port)
+	:	CHTTPFetch("sessionpooltest-1.0",Host,Port)
+	{
+	}
+
+	using CHTTPFetch::SessionKey;
+};
+
+static ne_session *CreateSession()
+{
+	return ne_session_create("http","musicbrainz.org",80);
+}
+
+static void TestKeys()
+{
+	CTestFetch Fetch("musicbrainz.org",80);
+	CTestFetch OtherPort("musicbrainz.org",8080);
+	CTestFetch Proxied("musicbrainz.org",80);
+	CTestFetch User("musicbrainz.org",80);
+
+	Proxied.SetProxyHost("proxy.example.com");
+	Proxied.SetProxyPort(3128);
+	User.SetUserName("user");
+
+	Check(Fetch.SessionKey()==CTestFetch("musicbrainz.org",80).SessionKey(),"Same server has different keys");
+	Check(Fetch.SessionKey()!=OtherPort.SessionKey(),"Different ports share a key");
+	Check(Fetch.SessionKey()!=Proxied.SessionKey(),"Proxied and direct sessions share a key");
+	Check(Fetch.SessionKey()!=User.SessionKey(),"Sessions for a user share a key with anonymous ones");
+}
+
+static void TestReuse()
+{
+	CTestSessionPool Pool(4,30);
+
+	ne_session *First=CreateSession();
+	ne_session *Second=CreateSession();
+
+	Pool.Release("a",First);
+	Check(0==Pool.Acquire("b"),"Session acquired for the wrong key");
+	Check(First==Pool.Acquire("a"),"Idle session not reused");
+	Check(0==Pool.Acquire("a") && 0==Pool.NumSessions(),"Acquired session left in the pool");
+
+	//The most recently used session is handed out first
+
+	Pool.Release("a",First);
+	Pool.Release("a",Second);
+	Check(Second==Pool.Acquire("a"),"Most recently used session not reused first");
+	Check(First==Pool.Acquire("a"),"Older session not reused");
+
+	ne_session_destroy(First);
+	ne_session_destroy(Second);
+}
+
+static void TestMaxSessions()
+{
+	CTestSessionPool Pool(2,30);
+
+	//Releasing a third session closes the least recently used one
+
+	Pool.Release("a",CreateSession());
+	Pool.Release("b",CreateSession());
+	Pool.Release("c",CreateSession());
+
+	Check(2==Pool.NumSessions(),"More sessions kept than the maximum");
+	Check(0==Pool.Acquire("a"),"Least recently used session not closed");
+
+	ne_session *Session=Pool.Acquire("b");
+	Check(0!=Session,"Session closed wrongly");
+	Pool.Release("b",Session);
+
+	Pool.SetMaxSessions(0);
+	Check(0==Pool.NumSessions(),"Sessions kept with reuse disabled");
+
+	Pool.Release("a",CreateSession());
+	Check(0==Pool.NumSessions(),"Session kept with reuse disabled");
+}
+
+static void TestIdleTimeout()
+{
+	CTestSessionPool Pool(4,30);
+
+	ne_session *Session=CreateSession();
+	Pool.Release("a",Session);
+
+	Pool.m_Now+=29;
+	Check(Session==Pool.Acquire("a"),"Session closed before the idle timeout");
+
+	//Releasing the session again restarts its idle time
+
+	Pool.Release("a",Session);
+	Pool.Release("b",CreateSession());
+
+	Pool.m_Now+=30;
+	Check(0==Pool.Acquire("a") && 0==Pool.NumSessions(),"Sessions kept after the idle timeout");
+
+	Pool.Release("a",CreateSession());
+	Pool.m_Now+=10;
+	Pool.SetIdleTimeout(10);
+	Check(0==Pool.NumSessions(),"Shortening the idle timeout didn't close idle sessions");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestKeys();
+	TestReuse();
+	TestMaxSessions();
+	TestIdleTimeout();
+
+	return TestResult();
+}
@@ -0,0 +1,215 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "musicbrainz5/SocketTransport.h"
+#include "musicbrainz5/HTTPFetch.h"
+
+#include "TestUtil.h"
+
+//Checks that CSocketTransport fetches a response from a server on a local socket,
+//that a server closing the connection before reading the request results in an
+//exception rather than SIGPIPE, and that the socket is closed when reading the
+//response fails.
+
+enum tServerMode
+{
+	eServer_Respond,
+	eServer_Close
+};
+
+struct CServer
+{
+	int m_Socket;
+	tServerMode m_Mode;
+};
+
+//Fails part way through reading a response
+
+class CFailingReader: public MusicBrainz5::CResponseReader
+{
+public:
+	virtual void Read(const char */*Data*/, size_t /*Len*/)
+	{
+		throw MusicBrainz5::CFetchError("Reader failed");
+	}
+};
+
+static void *Serve(void *Arg)
+{
+	CServer *Server=(CServer *)Arg;
+
+	int Socket=accept(Server->m_Socket,0,0);
+	if (-1==Socket)
+		return 0;
+
+	if (eServer_Respond==Server->m_Mode)
+	{
+		std::string Request;
+		char Buffer[4096];
+		ssize_t Ret;
+
+		while (std::string::npos==Request.find("\r\n\r\n") && 0<(Ret=read(Socket,Buffer,sizeof(Buffer))))
+			Request.append(Buffer,Ret);
+
+		std::string Response="HTTP/1.0 200 OK\r\nContent-Type: text/xml\r\n\r\n<metadata/>";
+		if ((ssize_t)Response.length()!=write(Socket,Response.c_str(),Response.length()))
+			std::cerr << "Short write" << std::endl;
+	}
+
+	close(Socket);
+
+	return 0;
+}
+
+static int Listen(const std::string& Path)
+{
+	struct sockaddr_un Address;
+	memset(&Address,0,sizeof(Address));
+	Address.sun_family=AF_UNIX;
+	strncpy(Address.sun_path,Path.c_str(),sizeof(Address.sun_path)-1);
+
+	int Socket=socket(AF_UNIX,SOCK_STREAM,0);
+	if (-1==Socket || 0!=bind(Socket,(struct sockaddr *)&Address,sizeof(Address)) || 0!=listen(Socket,1))
+	{
+		std::cerr << "Can't listen on " << Path << std::endl;
+		exit(1);
+	}
+
+	return Socket;
+}
+
+static int NumOpenFiles()
+{
+	int Count=0;
+
+	DIR *Dir=opendir("/proc/self/fd");
+	if (Dir)
+	{
+		while (readdir(Dir))
+			Count++;
+
+		closedir(Dir);
+	}
+
+	return Count;
+}
+
+static bool FetchThrows(MusicBrainz5::CFetch *Fetch)
+{
+	try
+	{
+		Fetch->Fetch("/ws/2/release/76df3287-6cda-33eb-8e9a-044b5e15ffdd");
+	}
+
+	catch (MusicBrainz5::CExceptionBase& /*Error*/)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+static void TestFetch(const std::string& Path, tServerMode Mode, bool FailReading=false)
+{
+	CServer Server;
+	Server.m_Socket=Listen(Path);
+	Server.m_Mode=Mode;
+
+	//Counted before the server accepts the connection, which it closes before it exits
+
+	int OpenFiles=NumOpenFiles();
+
+	pthread_t Thread;
+	pthread_create(&Thread,0,Serve,&Server);
+
+	MusicBrainz5::CSocketTransport Transport(Path);
+	MusicBrainz5::CFetch *Fetch=Transport.CreateFetch("sockettest-1.0","musicbrainz.org",80);
+
+	if (FailReading)
+	{
+		CFailingReader Reader;
+		Fetch->SetResponseReader(&Reader);
+
+		Check(FetchThrows(Fetch),"No exception when the reader failed");
+	}
+	else if (eServer_Respond==Mode)
+	{
+		int Ret=Fetch->Fetch("/ws/2/release/76df3287-6cda-33eb-8e9a-044b5e15ffdd");
+
+		std::vector<unsigned char> Data=Fetch->Data();
+		Check(200==Fetch->Status(),"Unexpected status");
+		Check(11==Ret && std::string(Data.begin(),Data.end())=="<metadata/>","Unexpected body");
+	}
+	else
+	{
+		//Larger than the socket buffer, so the request can't be sent before the
+		//server closes the connection
+
+		Fetch->SetRequestHeader("X-Padding",std::string(8*1024*1024,'x'));
+
+		Check(FetchThrows(Fetch),"No exception when the server closed the connection");
+	}
+
+	delete Fetch;
+
+	pthread_join(Thread,0);
+
+	Check(OpenFiles==NumOpenFiles(),"Socket left open after the request");
+
+	close(Server.m_Socket);
+	unlink(Path.c_str());
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	char Directory[]="/tmp/sockettestXXXXXX";
+	if (!mkdtemp(Directory))
+	{
+		std::cerr << "Can't create socket directory" << std::endl;
+		return 1;
+	}
+
+	std::string Path=std::string(Directory)+"/socket";
+
+	TestFetch(Path,eServer_Respond);
+	TestFetch(Path,eServer_Close);
+	TestFetch(Path,eServer_Respond,true);
+
+	rmdir(Directory);
+
+	return TestResult();
+}
@@ -0,0 +1,90 @@
+/* --------------------------------------------------------------------------
+
+   libmusicbrainz5 - Client library to access MusicBrainz
+
+   Copyright (C) 2012 Andrew Hawkins
+
+   This file is part of libmusicbrainz5.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   libmusicbrainz5 is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library.  If not, see <http://www.gnu.org/licenses/>.
+
+     $Id$
+
+----------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <string>
+
+#include "musicbrainz5/StringPool.h"
+#include "musicbrainz5/Release.h"
+#include "musicbrainz5/xmlParser.h"
+
+#include "TestUtil.h"
+
+//Checks that equal strings are interned to the same copy, however they are passed
+//to the pool, and that interned fields of parsed entities share that copy.
+
+static MusicBrainz5::CRelease ParseRelease(const std::string& Status)
+{
+	XMLResults Results;
+	XMLNode *Node=XMLRootNode::parseString("<release><status>"+Status+"</status></release>",&Results);
+
+	MusicBrainz5::CRelease Release(*Node);
+	delete Node;
+
+	return Release;
+}
+
+static void TestIntern()
+{
+	const std::string& Official=MusicBrainz5::CStringPool::Intern("stringpooltest-official");
+	int NumStrings=MusicBrainz5::CStringPool::NumStrings();
+
+	std::string Copy="stringpooltest-official";
+	Check(&Official==&MusicBrainz5::CStringPool::Intern(Copy),"Equal strings interned separately");
+	Check("stringpooltest-official"==Official,"Interned string has the wrong value");
+
+	//The buffer isn't null terminated after the value
+
+	const char Buffer[]="stringpooltest-officially";
+	Check(&Official==&MusicBrainz5::CStringPool::Intern(Buffer,23),"Buffer interned separately from equal string");
+	Check(NumStrings==MusicBrainz5::CStringPool::NumStrings(),"Interning an existing string added to the pool");
+
+	const std::string& Prefix=MusicBrainz5::CStringPool::Intern(Buffer,15);
+	const std::string& Longer=MusicBrainz5::CStringPool::Intern(Buffer,sizeof(Buffer)-1);
+	Check("stringpooltest-"==Prefix && &Prefix!=&Official,"Prefix interned as the whole string");
+	Check("stringpooltest-officially"==Longer && &Longer!=&Official,"Longer string interned as its prefix");
+	Check(NumStrings+2==MusicBrainz5::CStringPool::NumStrings(),"Interning new strings didn't add them to the pool");
+
+	Check(&MusicBrainz5::CStringPool::Empty()==&MusicBrainz5::CStringPool::Intern(""),"Empty string interned separately");
+	Check(&MusicBrainz5::CStringPool::Empty()==&MusicBrainz5::CStringPool::Intern(Buffer,0),"Empty buffer interned separately");
+}
+
+static void TestParse()
+{
+	MusicBrainz5::CRelease First=ParseRelease("Official");
+	MusicBrainz5::CRelease Second=ParseRelease("Official");
+
+	Check("Official"==First.Status(),"Interned field parsed wrongly");
+	Check(&First.Status()==&Second.Status(),"Interned fields of different entities not shared");
+	Check(&First.Status()==&MusicBrainz5::CStringPool::Intern("Official"),"Interned field not held by the pool");
+}
+
+int main(int /*argc*/, const char */*argv*/[])
+{
+	TestIntern();
+	TestParse();
+
+	return TestResult();
+}